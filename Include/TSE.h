@@ -105,6 +105,7 @@
 //	Forward references
 
 class CArmorClass;
+class CAStarPathFinder;
 class CBoundaryMarker;
 class CDeviceClass;
 class CDockScreenType;
@@ -264,34 +265,59 @@ class CAStarPathFinder
 			int iCostFromStart;
 			int iHeuristic;
 			int iTotalCost;
+			DWORD dwSeq;						//	Order in which we were added to the open list (for ties)
 
 			SNode *pParent;
-			SNode *pPrev;
-			SNode *pNext;
 			};
 
-		typedef SNode *SNodeRoot;
+		struct SIndexEntry
+			{
+			DWORD dwKey;						//	Packed node coordinates
+			DWORD dwFlags;						//	0 = empty slot
+			};
 
 		void AddToClosedList (SNode *pNew);
 		void AddToOpenList (SNode *pNew);
+		SNode *AllocNode (void);
 		int CalcHeuristic (const CVector &vPos, const CVector &vDest);
 		void CollapsePath (TArray<SNode *> &Path, int iStart, int iEnd);
 		void CreateInOpenList (const CVector &vEnd, SNode *pCurrent, int xDir, int yDir);
-		bool IsInClosedList (int x, int y);
+		inline int GetCellX (Metric x) const { return Max(0, Min(m_cxCells - 1, (int)((x - m_xMin) / m_rCellSize))); }
+		inline int GetCellY (Metric y) const { return Max(0, Min(m_cyCells - 1, (int)((y - m_yMin) / m_rCellSize))); }
+		DWORD GetNodeFlags (int x, int y) const;
+		void GrowIndex (void);
+		void InitObstacleIndex (void);
 		bool IsPathClear (const CVector &vStart, const CVector &vEnd);
 		bool IsPointClear (const CVector &vPos);
 		bool LineIntersectsRect (const CVector &vStart, const CVector &vEnd, const CVector &vUR, const CVector &vLL);
 		int OptimizePath (const CVector &vEnd, SNode *pFinal, CVector **retPathList);
+		SNode *PopOpenList (void);
 		void Reset (void);
+		void SetNodeFlags (int x, int y, DWORD dwFlags);
 
-		void AddToList (SNodeRoot &pRoot, SNode *pNew, SNode *pAddAfter = NULL);
-		void DeleteFromList (SNodeRoot &pRoot, SNode *pDelete);
-		void DeleteList (SNodeRoot &pRoot);
+		static bool IsBefore (const SNode *pA, const SNode *pB) { return (pA->iTotalCost < pB->iTotalCost || (pA->iTotalCost == pB->iTotalCost && pA->dwSeq < pB->dwSeq)); }
 
 		TArray<SObstacle> m_Obstacles;
-		SNodeRoot m_pOpenList;
-		SNodeRoot m_pClosedList;
-		CTileMap *m_pClosedMap;
+		bool m_bObstacleIndexValid;				//	FALSE if we need to rebuild the obstacle grid
+		Metric m_xMin;							//	Lower-left of obstacle grid
+		Metric m_yMin;
+		Metric m_xMax;							//	Upper-right of obstacle grid
+		Metric m_yMax;
+		Metric m_rCellSize;
+		int m_cxCells;
+		int m_cyCells;
+		TArray<int> m_CellStart;				//	Obstacles in cell i are m_CellObstacles[m_CellStart[i]..m_CellStart[i+1])
+		TArray<int> m_CellObstacles;
+		TArray<DWORD> m_ObstacleMark;			//	Last path test that looked at each obstacle
+		DWORD m_dwMark;
+
+		TArray<SNode *> m_OpenList;				//	Binary min-heap ordered by IsBefore
+		TArray<SIndexEntry> m_Index;			//	Open-addressed hash of node state by coordinates
+		int m_iIndexCount;						//	Number of used slots in m_Index
+		TArray<SNode *> m_NodeBlocks;			//	Node arena (reused across searches)
+		int m_iNextBlock;						//	Block from which we allocate next
+		int m_iNextNode;						//	Next free node in m_iNextBlock
+		DWORD m_dwNextSeq;
 
 #ifdef DEBUG_ASTAR_PERF
 		int m_iCallsToIsPathClear;
@@ -993,6 +1019,7 @@ class CSpaceObject : public CObject
 		CSovereign::Disposition GetDispositionTowards (CSpaceObject *pObj);
 		Metric GetDistance (CSpaceObject *pObj) const { return (pObj->GetPos() - GetPos()).Length(); }
 		Metric GetDistance2 (CSpaceObject *pObj) const { return (pObj->GetPos() - GetPos()).Length2(); }
+		inline CSpaceObjectPool::SNode *GetGridNode (void) const { return m_pGridNode; }
 		inline const CString &GetHighlightText (void) const { return m_sHighlightText; }
 		void GetHitRect (CVector *retvUR, CVector *retvLL) const;
 		Metric GetHitSize (void) const;
@@ -1127,6 +1154,7 @@ class CSpaceObject : public CObject
 		void SetDataInteger (const CString &sAttrib, int iValue);
 		inline void SetDestructionNotify (bool bNotify = true) { m_fNoObjectDestructionNotify = !bNotify; }
 		void SetEventFlags (void);
+		inline void SetGridNode (CSpaceObjectPool::SNode *pNode) { m_pGridNode = pNode; }
 		inline void SetHasGetDockScreenEvent (bool bHasEvent) { m_fHasGetDockScreenEvent = bHasEvent; }
 		inline void SetHasOnAttackedEvent (bool bHasEvent) { m_fHasOnAttackedEvent = bHasEvent; }
 		inline void SetHasOnAttackedByPlayerEvent (bool bHasEvent) { m_fHasOnAttackedByPlayerEvent = bHasEvent; }
@@ -1178,10 +1206,15 @@ class CSpaceObject : public CObject
 		//		momentum or gravity). Objects can be temporarily anchored
 		//		(e.g., when docked), so it is possible for an object to return
 		//		TRUE for both CanThrust and IsAnchored.
+		//
+		//	HasOnMove: Returns FALSE if OnMove would do nothing this tick. Such
+		//		objects (if they also move linearly) are moved in a single 
+		//		batch by CKinematicsStore instead of through Move.
 
 		virtual bool CanMove (void) const { return !IsAnchored(); }
 		virtual bool CanThrust (void) const { return false; }
 		virtual Metric GetMaxSpeed (void) { return (IsAnchored() ? 0.0 : MAX_SYSTEM_SPEED); }
+		virtual bool HasOnMove (void) { return true; }
 		virtual bool IsAnchored (void) const { return IsManuallyAnchored(); }
 
 		void Accelerate (const CVector &vPush, Metric rSeconds);
@@ -1194,7 +1227,8 @@ class CSpaceObject : public CObject
 		inline bool IsManuallyAnchored (void) const { return m_fManualAnchor; }
 		void Jump (const CVector &vPos);
 		void Move (SUpdateCtx &Ctx, Metric rSeconds);
-		inline void Place (const CVector &vPos, const CVector &vVel = NullVector) { CVector vOldPos = m_vPos; m_vPos = vPos; m_vOldPos = vPos; m_vVel = vVel; OnPlace(vOldPos); }
+		void MoveBatched (SUpdateCtx &Ctx, const CVector &vNewPos);
+		inline void Place (const CVector &vPos, const CVector &vVel = NullVector) { CVector vOldPos = m_vPos; m_vPos = vPos; m_vOldPos = vPos; m_vVel = vVel; if (m_pSystem) m_pSystem->InvalidatePosIndex(); OnPlace(vOldPos); }
 		inline void SetInsideBarrier (bool bInside = true) { m_fInsideBarrier = bInside; }
 		inline void SetManualAnchor (bool bAnchored = true) { m_fManualAnchor = bAnchored; }
 		inline void SetPos (const CVector &vPos) { m_vPos = vPos; }
@@ -1348,6 +1382,7 @@ class CSpaceObject : public CObject
 		virtual Metric GetStellarMass (void) const { return 0.0; }
 		virtual CDesignType *GetWreckType (void) const { return NULL; }
 		virtual bool HasAttribute (const CString &sAttribute) const { return sAttribute.IsBlank(); }
+		virtual bool HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const { return Required.IsEmpty(); }
 		virtual bool HasSpecialAttribute (const CString &sAttrib) const;
 		virtual bool HasVolumetricShadow (void) const { return false; }
 		virtual bool IsExplored (void) { return true; }
@@ -1398,6 +1433,7 @@ class CSpaceObject : public CObject
 		virtual int GetDamageEffectiveness (CSpaceObject *pAttacker, CInstalledDevice *pWeapon) { return 0; }
 		virtual DamageTypes GetDamageType (void) { return damageGeneric; }
 		virtual CSpaceObject *GetDestination (void) const { return NULL; }
+		virtual int GetDestinyTimeSpan (void) const { return 1; }
 		virtual CInstalledDevice *GetDevice (int iDev) { return NULL; }
 		virtual int GetDeviceCount (void) const { return 0; }
 		virtual CStationType *GetEncounterInfo (void) { return NULL; }
@@ -1479,6 +1515,8 @@ class CSpaceObject : public CObject
 		virtual bool FollowsObjThroughGate (CSpaceObject *pLeader = NULL) { return false; }
 		virtual CSpaceObject *GetBase (void) const { return NULL; }
 		virtual int GetRotation (void) const { return 0; }
+		virtual bool HasParallelBehavior (void) { return false; }
+		virtual void ParallelBehavior (void) { }
 		virtual void RepairDamage (int iHitPoints) { }
 		virtual void Resume (void) { }
 		virtual void Suspend (void) { }
@@ -1612,11 +1650,13 @@ class CSpaceObject : public CObject
 		CSpaceObject (void);
 
 		inline void InitItemEvents (void) { m_ItemEvents.Init(this); m_fItemEventsValid = true; }
+		void OnMoveDone (SUpdateCtx &Ctx);
 		void UpdateEffects (void);
 		void UpdatePlayerTarget (SUpdateCtx &Ctx);
 
 		CSystem *m_pSystem;						//	Current system
 		int m_iIndex;							//	Index in system
+		CSpaceObjectPool::SNode *m_pGridNode;	//	Our node in the system's object grid (or NULL)
 		DWORD m_dwID;							//	Universal ID
 		int m_iDestiny;							//	Random number 0..DestinyRange-1
 		CVector m_vPos;							//	Position of object in system
@@ -129,13 +129,16 @@ class CDesignTypeCriteria
 		CString AsString (void) const;
 		inline bool ChecksLevel (void) const { return (m_iGreaterThanLevel != INVALID_COMPARE || m_iLessThanLevel != INVALID_COMPARE); }
 		inline const CString &GetExcludedAttrib (int iIndex) const { return m_sExclude[iIndex]; }
+		inline const CAttributeSet &GetExcludedAttribAtoms (void) const { return m_ExcludeAtoms; }
 		inline int GetExcludedAttribCount (void) const { return m_sExclude.GetCount(); }
 		inline const CString &GetExcludedSpecialAttrib (int iIndex) const { return m_sExcludeSpecial[iIndex]; }
 		inline int GetExcludedSpecialAttribCount (void) const { return m_sExcludeSpecial.GetCount(); }
 		inline const CString &GetRequiredAttrib (int iIndex) const { return m_sRequire[iIndex]; }
+		inline const CAttributeSet &GetRequiredAttribAtoms (void) const { return m_RequireAtoms; }
 		inline int GetRequiredAttribCount (void) const { return m_sRequire.GetCount(); }
 		inline const CString &GetRequiredSpecialAttrib (int iIndex) const { return m_sRequireSpecial[iIndex]; }
 		inline int GetRequiredSpecialAttribCount (void) const { return m_sRequireSpecial.GetCount(); }
+		inline bool HasAttribAtoms (void) const { return m_bAttribAtoms; }
         inline void IncludeType (DesignTypes iType) { m_dwTypeSet |= (1 << iType); }
 		inline bool IncludesVirtual (void) const { return m_bIncludeVirtual; }
         inline bool IsEmpty (void) const { return (m_dwTypeSet == 0); }
@@ -160,12 +163,15 @@ class CDesignTypeCriteria
 		TArray<CString> m_sExclude;
 		TArray<CString> m_sRequireSpecial;
 		TArray<CString> m_sExcludeSpecial;
+		CAttributeSet m_RequireAtoms;				//	m_sRequire as atoms
+		CAttributeSet m_ExcludeAtoms;				//	m_sExclude as atoms
 
 		int m_iGreaterThanLevel;
 		int m_iLessThanLevel;
 
 		bool m_bIncludeVirtual;
         bool m_bStructuresOnly;
+		bool m_bAttribAtoms;						//	TRUE if m_RequireAtoms and m_ExcludeAtoms are valid
 	};
 
 //	CDesignType
@@ -306,7 +312,8 @@ class CDesignType
 		inline bool HasEvents (void) const { return !m_Events.IsEmpty() || (m_pInheritFrom && m_pInheritFrom->HasEvents()); }
 		bool HasLanguageBlock (void) const;
 		bool HasLanguageEntry (const CString &sID) const;
-		inline bool HasLiteralAttribute (const CString &sAttrib) const { return ::HasModifier(m_sAttributes, sAttrib); }
+		bool HasLiteralAttribute (const CString &sAttrib) const;
+		inline bool HasLiteralAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const { return (m_Attributes.HasAll(Required) && !m_Attributes.HasAny(Excluded)); }
 		bool HasSpecialAttribute (const CString &sAttrib) const;
         inline ICCItemPtr IncGlobalData (const CString &sAttrib, ICCItem *pValue = NULL) { return SetExtra()->GlobalData.IncData(sAttrib, pValue); }
 		bool InheritsFrom (DWORD dwUNID) const;
@@ -327,6 +334,7 @@ class CDesignType
 		bool TranslateText (CSpaceObject *pObj, const CString &sID, ICCItem *pData, CString *retsText) const;
 		bool TranslateText (const CItem &Item, const CString &sID, ICCItem *pData, CString *retsText) const;
 
+		static CString GetEventName (int iEventID);
 		static CString GetTypeChar (DesignTypes iType);
 
 		//	CDesignType overrides
@@ -401,6 +409,7 @@ class CDesignType
 		SEventHandlerDesc *GetInheritedCachedEvent (ECachedHandlers iEvent) const;
 		inline bool HasCachedEvent (ECachedHandlers iEvent) const { return (m_pExtra && m_pExtra->EventsCache[iEvent].pCode != NULL); }
 		void InitCachedEvents (void);
+		void InitEventTable (void);
 		bool InSelfReference (CDesignType *pType);
 		bool TranslateVersion2 (CSpaceObject *pObj, const CString &sID, ICCItem **retpResult) const;
 		SExtra *SetExtra (void) { if (!m_pExtra) m_pExtra.Set(new SExtra); return m_pExtra; }
@@ -416,7 +425,10 @@ class CDesignType
 		CDesignType *m_pInheritFrom = NULL;				//	Inherit from this type
 
 		CString m_sAttributes;							//	Type attributes
+		CAttributeSet m_Attributes;						//	m_sAttributes as atoms
 		CEventHandler m_Events;							//	Event handlers
+		TSortMap<int, SEventHandlerDesc> m_EventTable;	//	All handlers (including inherited), by event ID
+		bool m_bEventTable = false;						//	TRUE if m_EventTable is valid
 
 		TUniquePtr<SExtra> m_pExtra;					//	Extra type stuff (not all types need this, so we only
 														//		allocate when necessary).
@@ -1127,6 +1139,50 @@ class CDynamicDesignTable
 		TSortMap<DWORD, SEntry> m_Table;
 	};
 
+//	CLinkedCodeCache -----------------------------------------------------------
+//
+//	Keeps an extension's linked code on disk so that the next launch can
+//	rebuild the code trees without parsing the source again. A cache file is
+//	only used for the extension digest and API version it was written for.
+
+class CLinkedCodeCache
+	{
+	public:
+		CLinkedCodeCache (void) :
+				m_dwAPIVersion(0),
+				m_bModified(false)
+			{ }
+
+		ICCItemPtr Link (CCodeChain &CC, const CString &sCode, CCodeChain::SLinkOptions &Options);
+		void Load (const CString &sFilespec, const CIntegerIP &Digest, DWORD dwAPIVersion);
+		ALERROR Save (void);
+
+	private:
+		enum EItemTypes
+			{
+			itemNil =						1,
+			itemInteger =					2,
+			itemDouble =					3,
+			itemString =					4,
+			itemList =						5,
+
+			itemTypeMask =					0x000000ff,
+			itemQuoted =					0x00000100,
+			};
+
+		static bool ReadDWORD (char *&pPos, char *pEnd, DWORD *retdwValue);
+		static ICCItem *ReadItem (CCodeChain &CC, char *&pPos, char *pEnd);
+		static bool ReadString (char *&pPos, char *pEnd, CString *retsValue);
+		static bool WriteItem (IWriteStream &Stream, ICCItem *pItem);
+		static void WriteString (IWriteStream &Stream, const CString &sValue);
+
+		CString m_sFilespec;					//	Cache file
+		CIntegerIP m_Digest;					//	Digest of the extension file
+		DWORD m_dwAPIVersion;					//	API version of the extension
+		TSortMap<CString, CString> m_Entries;	//	Serialized code, keyed by source
+		bool m_bModified;						//	TRUE if we need to save
+	};
+
 struct SDesignLoadCtx
 	{
 	inline DWORD GetAPIVersion (void) const { return (pExtension ? pExtension->GetAPIVersion() : API_VERSION); }
@@ -1138,6 +1194,7 @@ struct SDesignLoadCtx
 	CString sFolder;						//	Folder context (used when loading images)
 	CExtension *pExtension = NULL;			//	Extension
 	CDesignType *pType = NULL;				//	Current type being loaded
+	CLinkedCodeCache *pCodeCache = NULL;	//	Code linked on previous launches (may be NULL)
 	bool bLoadAdventureDesc = false;		//	If TRUE, we are loading an adventure desc only
 	bool bLoadModule = false;				//	If TRUE, we are loading elements in a module
 	DWORD dwInheritAPIVersion = 0;			//	APIVersion of parent (if base file)
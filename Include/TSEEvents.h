@@ -19,7 +19,7 @@ class CSystemEvent
 			cRangeTypeEvent =				5,
 			};
 
-		CSystemEvent (DWORD dwTick) : m_dwTick(dwTick), m_bDestroyed(false) { }
+		CSystemEvent (DWORD dwTick) : m_dwTick(dwTick), m_dwSeq(0), m_bDestroyed(false), m_bQueued(false) { }
 		CSystemEvent (SLoadCtx &Ctx);
 		virtual ~CSystemEvent (void) { }
 
@@ -46,30 +46,58 @@ class CSystemEvent
 
 	private:
 		DWORD m_dwTick;
+		DWORD m_dwSeq;						//	Order in which we were added to our list (not saved)
 		bool m_bDestroyed;
+		bool m_bQueued;						//	TRUE if we're in CSystemEventList::m_Queue
+
+	friend class CSystemEventList;
 	};
 
 class CSystemEventList
 	{
 	public:
+		CSystemEventList (void) : m_dwNextSeq(0), m_iDestroyed(0), m_bSortedValid(false) { }
 		~CSystemEventList (void);
 
-		inline void AddEvent (CSystemEvent *pEvent) { m_List.Insert(pEvent); }
+		void AddEvent (CSystemEvent *pEvent);
 		bool CancelEvent (CSpaceObject *pObj, bool bInDoEvent);
 		bool CancelEvent (CSpaceObject *pObj, const CString &sEvent, bool bInDoEvent);
 		bool CancelEvent (CDesignType *pType, const CString &sEvent, bool bInDoEvent);
 		void DeleteAll (void);
-		inline int GetCount (void) const { return m_List.GetCount(); }
-		inline CSystemEvent *GetEvent (int iIndex) const { return m_List[iIndex]; }
-		inline void MoveEvent (int iIndex, CSystemEventList &Dest) { Dest.AddEvent(m_List[iIndex]); m_List.Delete(iIndex); }
+		inline int GetCount (void) const { return GetSorted().GetCount(); }
+		inline CSystemEvent *GetEvent (int iIndex) const { return GetSorted()[iIndex]; }
+		void MoveEvents (CSystemEventList &Dest, int iTickOffset);
+		void MoveObjEvents (CSpaceObject *pObj, CSystemEventList &Dest, int iTickOffset);
 		void OnObjDestroyed (CSpaceObject *pObj);
 		void OnStationDestroyed (CSpaceObject *pObj);
 		void ReadFromStream (SLoadCtx &Ctx);
-		inline void RemoveEvent (int iIndex) { delete m_List[iIndex]; m_List.Delete(iIndex); }
 		void Update (DWORD dwTick, CSystem *pSystem);
 		void WriteToStream (CSystem *pSystem, IWriteStream *pStream);
 
 	private:
-		TArray<CSystemEvent *> m_List;
-	};
+		void AddToIndex (CSystemEvent *pEvent);
+		void CollectEvents (TSortMap<DWORD, CSystemEvent *> &Result) const;
+		void CompactQueue (void);
+		void DeleteEvent (CSystemEvent *pEvent);
+		inline int GetQueuedCount (void) const { return m_Queue.GetCount() + m_Firing.GetCount(); }
+		inline CSystemEvent *GetQueuedEvent (int iIndex) const { return (iIndex < m_Queue.GetCount() ? m_Queue[iIndex] : m_Firing[iIndex - m_Queue.GetCount()]); }
+		const TArray<CSystemEvent *> &GetSorted (void) const;
+		void HeapifyQueue (void);
+		static bool IsBefore (const CSystemEvent *pEvent1, const CSystemEvent *pEvent2);
+		void MarkDestroyed (CSystemEvent *pEvent);
+		void MoveDown (int iPos);
+		void MoveUp (int iPos);
+		CSystemEvent *PopQueue (void);
+		void PushQueue (CSystemEvent *pEvent);
+		void RemoveFromIndex (CSystemEvent *pEvent);
 
+		TArray<CSystemEvent *> m_Queue;		//	Min-heap ordered by tick (then by order added)
+		TArray<CSystemEvent *> m_Firing;	//	Events popped by Update (may have NULL entries)
+		TSortMap<CSpaceObject *, TArray<CSystemEvent *>> m_ObjIndex;	//	Events by handler object
+		TSortMap<CDesignType *, TArray<CSystemEvent *>> m_TypeIndex;	//	Events by handler type
+		DWORD m_dwNextSeq;					//	Sequence number for next event added
+		int m_iDestroyed;					//	Number of destroyed events still in m_Queue
+
+		mutable TArray<CSystemEvent *> m_Sorted;	//	Live events in the order added (for GetEvent)
+		mutable bool m_bSortedValid;		//	FALSE if m_Sorted must be rebuilt
+	};
@@ -79,6 +79,7 @@ class CMission : public CSpaceObject
 		virtual ICCItem *GetProperty (CCodeChainCtx &Ctx, const CString &sName) override;
 		virtual CDesignType *GetType (void) const override { return m_pType; }
 		virtual bool HasAttribute (const CString &sAttribute) const override { return m_pType->HasLiteralAttribute(sAttribute); }
+		virtual bool HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const override { return m_pType->HasLiteralAttributes(Required, Excluded); }
 		virtual bool HasSpecialAttribute (const CString &sAttrib) const override;
 		virtual bool IsMission (void) override { return true; }
 		virtual bool IsNonSystemObj (void) override { return true; }
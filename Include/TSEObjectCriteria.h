@@ -128,6 +128,9 @@ class CSpaceObjectCriteria
 
 		TArray<CString> m_AttribsRequired;			//	Required attributes
 		TArray<CString> m_AttribsNotAllowed;		//	Exclude objects with these attributes
+		CAttributeSet m_AttribsRequiredAtoms;		//	m_AttribsRequired as atoms
+		CAttributeSet m_AttribsNotAllowedAtoms;		//	m_AttribsNotAllowed as atoms
+		bool m_bAttribAtoms = false;				//	TRUE if the atoms are valid (all attributes are atoms)
 		TArray<CString> m_SpecialRequired;			//	Special required attributes
 		TArray<CString> m_SpecialNotAllowed;		//	Special excluding attributes
 
@@ -143,3 +146,18 @@ class CSpaceObjectCriteria
 		ESortOptions m_iSortOrder = AscendingSort;
 	};
 
+//	CSpaceObjectCriteriaCache remembers parsed criteria by criteria string so
+//	that scripts that search with the same string every tick don't reparse it.
+//	Cached criteria have no source; callers copy the result and call 
+//	SetSource.
+
+class CSpaceObjectCriteriaCache
+	{
+	public:
+		inline void DeleteAll (void) { m_Cache.DeleteAll(); }
+		const CSpaceObjectCriteria &Get (const CString &sCriteria);
+
+	private:
+		TSortMap<CString, CSpaceObjectCriteria> m_Cache;
+	};
+
@@ -82,6 +82,7 @@ struct SViewportPaintCtx
 		bool bShowUnexploredAnnotation = false;
 		bool bShowBounds = false;
 		bool bShowFacingsAngle = false;
+		bool bShowAILOD = false;
 
 		CSpaceObject *pObj = NULL;				//	Current object being painted
 		RECT rcObjBounds;						//	Object bounds in screen coordinates.
@@ -26,10 +26,13 @@ class CPhysicsContact
 
 		inline const CVector &GetMove1 (void) const { return m_vMove1; }
 		inline const CVector &GetMove2 (void) const { return m_vMove2; }
+		inline Metric GetInvMass1 (void) const { return m_rInvMass1; }
+		inline Metric GetInvMass2 (void) const { return m_rInvMass2; }
 		inline CSpaceObject *GetObj1 (void) const { return m_pObj; }
 		inline CSpaceObject *GetObj2 (void) const { return m_pContactObj; }
 		inline Metric GetPenetration (void) const { return m_rPenetration; }
 		Metric GetSeparatingVel (void) const;
+		inline ETypes GetType (void) const { return m_iType; }
 		void Init (ETypes iType, CSpaceObject *pObj, CSpaceObject *pContactObj, const CVector &vNormal, Metric rPenetration, Metric rRestitution);
 		void InitCollision (CSpaceObject *pObj, CSpaceObject *pContactObj);
 		void OnUpdateDone (void);
@@ -67,17 +70,126 @@ class CPhysicsContact
 		CVector m_vMove2;
 	};
 
+//	CPhysicsContactResolver resolves contacts in order of how fast they are
+//	colliding. Contacts are grouped into islands (contacts connected through
+//	objects that can move); islands do not affect each other, so each one is
+//	solved on its own (in parallel, if there are enough contacts). Inside an
+//	island we keep an indexed priority queue and, after resolving a contact, 
+//	only recalc the contacts that share an object with it.
+
 class CPhysicsContactResolver
 	{
 	public:
 		void AddCollision (CSpaceObject *pObj, CSpaceObject *pContactObj);
 		void AddRod (CPhysicsContact::ETypes iType, CSpaceObject *pObj1, CSpaceObject *pObj2, Metric rLength);
 		void BeginUpdate (void);
-		void Update (void);
+		void Update (CThreadPool *pThreadPool = NULL);
 
 	private:
-		CPhysicsContact *FindContactToResolve (void) const;
-		void RecalcContacts (CPhysicsContact *pChanged);
+		class CSolveIslandsTask;
+
+		//	Indexed binary heap of contacts (by index inside an island) keyed on
+		//	separating velocity.
+
+		class CQueue
+			{
+			public:
+				void Init (int iCount);
+				inline bool IsEmpty (void) const { return (m_Heap.GetCount() == 0); }
+				inline int GetTop (void) const { return m_Heap[0]; }
+				void Remove (int iItem);
+				void Set (int iItem, Metric rKey);
+
+			private:
+				inline bool IsBefore (int iItem1, int iItem2) const { return (m_Key[iItem1] < m_Key[iItem2] || (m_Key[iItem1] == m_Key[iItem2] && iItem1 < iItem2)); }
+				void MoveDown (int iPos);
+				void MoveUp (int iPos);
+				void SetAt (int iPos, int iItem);
+
+				TArray<int> m_Heap;			//	Items in heap order
+				TArray<int> m_Pos;			//	Position of each item in m_Heap (-1 = not in queue)
+				TArray<Metric> m_Key;		//	Key for each item
+			};
+
+		struct SContactNodes
+			{
+			int iNode1;						//	Node of GetObj1()
+			int iNode2;						//	Node of GetObj2()
+			int iLocal;						//	Index of contact inside its island
+			};
+
+		struct SIsland
+			{
+			int iFirst;						//	Index into m_IslandContacts
+			int iCount;						//	Number of contacts
+			};
+
+		void CalcIslands (void);
+		int GetNode (CSpaceObject *pObj, TSortMap<DWORD, int> &NodeMap);
+		void RecalcContacts (int iChanged, CQueue &Queue);
+		void SolveIsland (const SIsland &Island, CQueue &Queue);
+		void UpdateQueue (int iContact, CQueue &Queue) const;
 
 		TArray<CPhysicsContact> m_Contacts;
-	};
\ No newline at end of file
+
+		//	Computed by CalcIslands
+
+		TArray<SContactNodes> m_ContactNodes;	//	Parallel to m_Contacts
+		TArray<bool> m_NodeDynamic;			//	TRUE if node can be moved by contacts
+		TArray<int> m_NodeContactStart;		//	Index into m_NodeContacts, by node (plus one at the end)
+		TArray<int> m_NodeContacts;			//	Contacts of each dynamic node
+		TArray<SIsland> m_Islands;
+		TArray<int> m_IslandContacts;		//	Contacts, grouped by island
+	};
+
+//	CPhysicsBroadphase finds candidate pairs for collision testing using a
+//	sort-and-sweep along the x-axis. Testers are objects that moved and need
+//	to be checked; barriers are objects that can block them. Each tester gets
+//	the list of barriers whose bounds overlap its test box.
+
+class CPhysicsBroadphase
+	{
+	public:
+		struct SEntry
+			{
+			CSpaceObject *pObj;
+			int iTester;					//	Index of tester (-1 = barrier)
+			Metric xMin;
+			Metric xMax;
+			Metric yMin;
+			Metric yMax;
+			};
+
+		void AddBarrier (CSpaceObject *pObj, const CVector &vUR, const CVector &vLL);
+		void AddTester (CSpaceObject *pObj, const CVector &vUR, const CVector &vLL);
+		void CalcPairs (void);
+		void DeleteAll (void);
+		inline CSpaceObject *GetCandidate (int iTester, int iIndex) const { return m_Candidates[m_CandidateStart[iTester] + iIndex]; }
+		inline int GetCandidateCount (int iTester) const { return m_CandidateStart[iTester + 1] - m_CandidateStart[iTester]; }
+		inline CSpaceObject *GetTester (int iTester) const { return m_Testers[iTester]; }
+		inline int GetTesterCount (void) const { return m_Testers.GetCount(); }
+
+	private:
+		struct SPair
+			{
+			int iTester;
+			CSpaceObject *pBarrier;
+			};
+
+		void AddEntry (CSpaceObject *pObj, int iTester, const CVector &vUR, const CVector &vLL);
+		static void PruneActive (const TArray<SEntry> &Entries, TArray<int> &Active, Metric xMin);
+
+		TArray<SEntry> m_Entries;
+		TArray<CSpaceObject *> m_Testers;
+		TArray<int> m_CandidateStart;		//	Index into m_Candidates, by tester (plus one at the end)
+		TArray<CSpaceObject *> m_Candidates;
+
+		//	Temporaries used by CalcPairs
+
+		TArray<SPair> m_Pairs;
+		TArray<int> m_ActiveTesters;
+		TArray<int> m_ActiveBarriers;
+		TArray<int> m_NextCandidate;		//	Next free slot in m_Candidates, by tester
+	};
+
+int KeyCompare (const CPhysicsBroadphase::SEntry &Key1, const CPhysicsBroadphase::SEntry &Key2);
\ No newline at end of file
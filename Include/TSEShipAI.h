@@ -130,6 +130,82 @@ class CAISettings
 		DWORD m_dwSpare:16;
 	};
 
+//  CAIShipInvariants ----------------------------------------------------------
+//
+//	Properties of a ship that the AI computes from its class and loadout (and
+//	not from destiny or per-ship AI settings). Ships of the same class with the
+//	same loadout share a single, reference-counted copy, which the ship class
+//	keeps in a CAIShipInvariantsCache.
+
+class CAIShipInvariantsCache;
+
+class CAIShipInvariants
+	{
+	public:
+		inline CAIShipInvariants *AddRef (void) { m_dwRefCount++; return this; }
+		void Delete (void);
+		inline int GetBestNonLauncherWeaponLevel (void) const { return m_iBestNonLauncherWeaponLevel; }
+		inline int GetFullRotationTime (void) const { return m_iFullRotationTime; }
+		inline Metric GetMinFlankDist (void) const { return m_rMinFlankDist; }
+		inline Metric GetPrimaryRange (void) const { return m_rPrimaryRange; }
+		CInstalledDevice *GetShields (CShip *pShip) const;
+		inline bool HasMultiplePrimaries (void) const { return m_bHasMultiplePrimaries; }
+		inline bool HasSecondaryWeapons (void) const { return m_bHasSecondaryWeapons; }
+		inline bool HasSuperconductingShields (void) const { return m_bSuperconductingShields; }
+		inline bool IsImmobile (void) const { return m_bImmobile; }
+
+	private:
+		enum EKeySizes
+			{
+			KEY_HEADER_SIZE =				5,	//	DWORDs of key for the ship as a whole
+			KEY_DEVICE_SIZE =				5,	//	DWORDs of key for each device slot
+
+			KEY_MAX_SIZE =					5,	//	Larger of the two
+			};
+
+		CAIShipInvariants (CShip *pShip, CAIShipInvariantsCache *pCache, DWORD dwHash);
+
+		static bool CalcHash (CShip *pShip, DWORD *retdwHash);
+		static void GetDeviceKey (CShip *pShip, CInstalledDevice *pDevice, DWORD *retKey);
+		static void GetHeaderKey (CShip *pShip, DWORD *retKey);
+		bool Matches (CShip *pShip) const;
+
+		CAIShipInvariantsCache *m_pCache;		//	Cache that we belong to (NULL if not shared)
+		CAIShipInvariants *m_pNext;				//	Next entry in cache with the same hash
+		DWORD m_dwHash;							//	Hash of m_Key
+		TArray<DWORD> m_Key;					//	Loadout that we were computed for
+
+		Metric m_rPrimaryRange;					//	Range of primary weapon
+		Metric m_rMinFlankDist;					//	Flank distance based on maneuverability
+		int m_iFullRotationTime;				//	Ticks to turn a full circle
+		int m_iBestNonLauncherWeaponLevel;		//	Level of best non-launcher weapon
+		int m_iShields;							//	Device index of shields (-1 if none)
+		bool m_bImmobile;						//	TRUE if ship does not move
+		bool m_bHasMultiplePrimaries;			//	TRUE if ship has multiple primary weapons (non-launchers)
+		bool m_bHasSecondaryWeapons;			//	TRUE if ship has secondary weapons
+		bool m_bSuperconductingShields;			//	TRUE if ship has superconducting shields
+
+		DWORD m_dwRefCount;
+
+	friend class CAIShipInvariantsCache;
+	};
+
+class CAIShipInvariantsCache
+	{
+	public:
+		~CAIShipInvariantsCache (void) { CleanUp(); }
+
+		void CleanUp (void);
+		CAIShipInvariants *Get (CShip *pShip);
+
+	private:
+		void Remove (CAIShipInvariants *pEntry);
+
+		TSortMap<DWORD, CAIShipInvariants *> m_Entries;	//	First entry for each hash
+
+	friend class CAIShipInvariants;
+	};
+
 //	IShipController ------------------------------------------------------------
 //
 //	This abstract class is the root of all ship AI classes.
@@ -280,6 +356,8 @@ class IShipController
 		virtual void Behavior (SUpdateCtx &Ctx) { }
 		virtual void CancelDocking (void) { }
 		virtual bool CanObjRequestDock (void) const { return true; }
+		virtual bool CanReduceBehaviorRate (void) { return false; }
+		virtual void CoastBehavior (SUpdateCtx &Ctx) { }
 		virtual CString DebugCrashInfo (void) { return NULL_STR; }
 		virtual void DebugPaintInfo (CG32bitImage &Dest, int x, int y, SViewportPaintCtx &Ctx) { }
         virtual ICCItem *FindProperty (const CString &sProperty) { return NULL; }
@@ -304,10 +382,12 @@ class IShipController
 		virtual CSpaceObject *GetTarget (CItemCtx &ItemCtx, bool bNoAutoTarget = false) const { return NULL; }
 		virtual bool GetThrust (void) = 0;
 		virtual void GetWeaponTarget (STargetingCtx &TargetingCtx, CItemCtx &ItemCtx, CSpaceObject **retpTarget, int *retiFireSolution) { }
+		virtual bool HasParallelBehavior (void) { return false; }
 		virtual bool IsAngryAt (CSpaceObject *pObj) const { return false; }
 		virtual bool IsPlayer (void) const { return false; }
 		virtual bool IsPlayerBlacklisted (void) const { return false; }
 		virtual bool IsPlayerWingman (void) const { return false; }
+		virtual void ParallelBehavior (void) { }
 		virtual void ReadFromStream (SLoadCtx &Ctx, CShip *pShip) { ASSERT(false); }
 		virtual int SetAISettingInteger (const CString &sSetting, int iValue) { return 0; }
 		virtual CString SetAISettingString (const CString &sSetting, const CString &sValue) { return NULL_STR; }
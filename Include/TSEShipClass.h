@@ -325,6 +325,7 @@ class CShipClass : public CDesignType
 		void GenerateDevices (int iLevel, CDeviceDescList &Devices, DWORD dwFlags = 0);
 
 		CString GenerateShipName (DWORD *retdwFlags) const;
+		inline CAIShipInvariants *GetAIInvariants (CShip *pShip) { return m_AIInvariants.Get(pShip); }
 		inline const CAISettings &GetAISettings (void) { return m_AISettings; }
         inline const CShipArmorDesc &GetArmorDesc (void) const { return m_Armor; }
 		DWORD GetCategoryFlags (void) const;
@@ -550,6 +551,7 @@ class CShipClass : public CDesignType
         //  AI & Player Settings
 
 		CAISettings m_AISettings;				//	AI controller data
+		CAIShipInvariantsCache m_AIInvariants;	//	AI invariants shared by ships of this class
 		mutable CPlayerSettings *m_pPlayerSettings;		//	Player settings data
 		IItemGenerator *m_pItems;				//	Random items
         CAttributeDataBlock m_InitialData;      //  Initial data for ship object
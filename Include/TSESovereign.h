@@ -67,6 +67,7 @@ class CSovereign : public CDesignType
 		CSovereign (void);
 		~CSovereign (void);
 
+		void AddEnemyObject (CSystem *pSystem, CSpaceObject *pObj, CSovereign *pObjSovereign);
 #ifdef DEBUG_ENEMY_CACHE_BUG
 		void DebugObjDeleted (CSpaceObject *pObj) const;
 #endif
@@ -80,11 +81,12 @@ class CSovereign : public CDesignType
 		bool GetPropertyItemList (const CString &sProperty, CItemList *retItemList);
 		bool GetPropertyString (const CString &sProperty, CString *retsValue);
 		CString GetText (MessageTypes iMsg);
-		inline bool IsEnemy (CSovereign *pSovereign) { return (m_bSelfRel || (pSovereign != this)) && (GetDispositionTowards(pSovereign) == dispEnemy); }
-		inline bool IsFriend (CSovereign *pSovereign) { return (!m_bSelfRel && (pSovereign == this)) || (GetDispositionTowards(pSovereign) == dispFriend); }
+		bool IsEnemy (CSovereign *pSovereign);
+		bool IsFriend (CSovereign *pSovereign);
 		void MessageFromObj (CSpaceObject *pSender, const CString &sText);
 		void OnObjDestroyedByPlayer (CSpaceObject *pObj);
 		static Alignments ParseAlignment (const CString &sAlign);
+		void RemoveEnemyObject (CSystem *pSystem, CSpaceObject *pObj, CSovereign *pObjSovereign);
 		void SetDispositionTowards (CSovereign *pSovereign, Disposition iDisp, bool bMutual = false);
 		void SetDispositionTowards (Alignments iAlignment, Disposition iDisp, bool bMutual = false);
 		void SetDispositionTowardsFlag (DWORD dwAlignmentFlag, Disposition iDisp, bool bMutual = false);
@@ -129,6 +131,7 @@ class CSovereign : public CDesignType
 		inline Alignments GetAlignment (void) { return m_iAlignment; }
 		void InitEnemyObjectList (CSystem *pSystem);
 		void InitRelationships (void);
+		bool IsEnemyObjectListValid (CSystem *pSystem) const;
 
 		CString m_sName;						//	":the United States of America"
 		CString m_sShortName;					//	":the USA"
@@ -147,5 +150,51 @@ class CSovereign : public CDesignType
 		bool m_bSelfRel;						//	TRUE if relationship with itself is not friendly
 		CSystem *m_pEnemyObjectsSystem;			//	System that we've cached enemy objects
 		CSpaceObjectList m_EnemyObjects;		//	List of enemy objects that can attack
+		DWORD m_dwEnemyObjectsVersion;			//	Disposition matrix version when we built m_EnemyObjects
+
+		int m_iOrdinal;							//	Index in disposition matrix (-1 if not yet indexed)
+
+	friend class CSovereignDispositionMatrix;
+	};
+
+//	CSovereignDispositionMatrix ------------------------------------------------
+//
+//	Dense table of the disposition of every sovereign towards every other
+//	sovereign, indexed by sovereign ordinal. The table is computed lazily from
+//	the relationship lists; any change to a relationship invalidates it and
+//	bumps the version, so callers can tell when cached enemy data is stale.
+
+class CSovereignDispositionMatrix
+	{
+	public:
+		CSovereignDispositionMatrix (void) :
+				m_iCount(0),
+				m_dwVersion(1),
+				m_bValid(false)
+			{ }
+
+		inline CSovereign::Disposition GetDisposition (CSovereign *pFrom, CSovereign *pTo)
+			{
+			if (!m_bValid)
+				Init();
+
+			if (pTo == NULL || !IsIndexed(pFrom) || !IsIndexed(pTo))
+				return pFrom->GetDispositionTowards(pTo);
+
+			return (CSovereign::Disposition)m_Disp[pFrom->m_iOrdinal * m_iCount + pTo->m_iOrdinal];
+			}
+
+		inline DWORD GetVersion (void) const { return m_dwVersion; }
+		inline void Invalidate (void) { m_bValid = false; m_dwVersion++; }
+
+	private:
+		void Init (void);
+		inline bool IsIndexed (CSovereign *pSovereign) const { return (pSovereign->m_iOrdinal >= 0 && pSovereign->m_iOrdinal < m_iCount && m_Sovereigns[pSovereign->m_iOrdinal] == pSovereign); }
+
+		int m_iCount;							//	Number of sovereigns in the table
+		TArray<CSovereign *> m_Sovereigns;		//	Sovereign at each ordinal
+		TArray<BYTE> m_Disp;					//	m_iCount x m_iCount dispositions (row = from)
+		DWORD m_dwVersion;						//	Incremented on every invalidation
+		bool m_bValid;							//	FALSE if we need to recompute
 	};
 
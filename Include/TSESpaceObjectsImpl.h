@@ -516,6 +516,7 @@ class CMissile : public CSpaceObject
 		virtual CDesignType *GetType (void) const override { return m_pDesc->GetWeaponType(); }
 		virtual CWeaponFireDesc *GetWeaponFireDesc (void) override { return m_pDesc; }
 		virtual bool HasAttribute (const CString &sAttribute) const override;
+		virtual bool HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const override;
 		virtual bool IsAngryAt (CSpaceObject *pObj) const override;
 		virtual bool IsInactive (void) const override { return (m_fDestroyOnAnimationDone ? true : false); }
 		virtual bool IsIntangible (void) const { return ((m_fDestroyOnAnimationDone || IsDestroyed()) ? true : false); }
@@ -1104,6 +1105,7 @@ class CShip : public CSpaceObject
 		virtual DamageTypes GetDamageType (void) override;
 		virtual DWORD GetDefaultBkgnd (void) override { return m_pClass->GetDefaultBkgnd(); }
 		virtual CSpaceObject *GetDestination (void) const override { return m_pController->GetDestination(); }
+		virtual int GetDestinyTimeSpan (void) const override { return m_iDestinyTimeSpan; }
 		virtual CSpaceObject *GetDockedObj (void) const override { return (m_fShipCompartment ? NULL : m_pDocked); }
 		virtual CDockingPorts *GetDockingPorts (void) override { return &m_DockingPorts; }
 		virtual CInstalledDevice *GetDevice (int iDev) override { return &m_Devices.GetDevice(iDev); }
@@ -1148,6 +1150,9 @@ class CShip : public CSpaceObject
 		virtual int GetVisibleDamage (void) override;
 		virtual void GetVisibleDamageDesc (SVisibleDamage &Damage) override;
 		virtual bool HasAttribute (const CString &sAttribute) const override;
+		virtual bool HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const override;
+		virtual bool HasOnMove (void) override { return (WasPainted() || m_DockingPorts.GetPortsInUseCount(this) > 0); }
+		virtual bool HasParallelBehavior (void) override { return (!IsInactive() && !m_fControllerDisabled && m_pController->HasParallelBehavior()); }
 		virtual bool ImageInObject (const CVector &vObjPos, const CObjectImageArray &Image, int iTick, int iRotation, const CVector &vImagePos) override;
 		virtual void IncCounterValue(int iCounterValue) override { m_iCounterValue += iCounterValue; }
 		virtual bool IsAnchored (void) const override { return (GetDockedObj() != NULL) || IsManuallyAnchored(); }
@@ -1190,6 +1195,7 @@ class CShip : public CSpaceObject
 		virtual void OnSystemLoaded (void) override;
 		virtual void PaintLRSBackground (CG32bitImage &Dest, int x, int y, const ViewportTransform &Trans) override;
 		virtual void PaintLRSForeground (CG32bitImage &Dest, int x, int y, const ViewportTransform &Trans) override;
+		virtual void ParallelBehavior (void) override { m_pController->ParallelBehavior(); }
 		virtual bool PointInObject (const CVector &vObjPos, const CVector &vPointPos) const override;
 		virtual bool PointInObject (SPointInObjectCtx &Ctx, const CVector &vObjPos, const CVector &vPointPos) const override;
 		virtual void PointInObjectInit (SPointInObjectCtx &Ctx) const override;
@@ -1323,6 +1329,8 @@ class CShip : public CSpaceObject
 												//	(-1 = permanent)
 		int m_iLastFireTime;					//	Tick when we last fired a weapon
 		int m_iLastHitTime;						//	Tick when we last got hit by something
+		int m_iLastBehaviorTime;				//	Tick when controller last ran Behavior (0 = unknown)
+		int m_iDestinyTimeSpan;					//	Ticks covered by the behavior update in progress (1 otherwise)
 
 		mutable Metric m_rItemMass;				//	Total mass of all items (including installed)
 		mutable Metric m_rCargoMass;			//	Mass of cargo items (not including installed)
@@ -1502,7 +1510,9 @@ class CStation : public CSpaceObject
 		virtual void GetVisibleDamageDesc (SVisibleDamage &Damage) override { return m_Hull.GetVisibleDamageDesc(Damage); }
 		virtual CDesignType *GetWreckType (void) const override;
 		virtual bool HasAttribute (const CString &sAttribute) const override;
+		virtual bool HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const override;
 		virtual bool HasMapLabel (void) override;
+		virtual bool HasOnMove (void) override { return (m_DockingPorts.GetPortsInUseCount(this) > 0); }
 		virtual bool HasVolumetricShadow (void) const override { return (GetScale() == scaleWorld && !IsOutOfPlaneObj()); }
 		virtual bool ImageInObject (const CVector &vObjPos, const CObjectImageArray &Image, int iTick, int iRotation, const CVector &vImagePos) override;
 		virtual bool IsAbandoned (void) const override { return m_Hull.IsAbandoned(); }
@@ -13,6 +13,253 @@
 
 const int MIN_PLANET_SIZE = 1000;			//	Size at which a world is considered planetary size
 
+//	CAILODScheduler
+//
+//	Decides how often each AI ship thinks. Ships near the POV, and ships that
+//	are fighting, run their behavior every tick. Distant, idle ships run it
+//	every few ticks and coast on their last decision in between.
+
+class CAILODScheduler
+	{
+	public:
+		enum ELevels
+			{
+			lodFull =					0,	//	Behavior every tick
+			lodReduced =				1,	//	Behavior every few ticks
+			lodMinimal =				2,	//	Behavior rarely
+
+			lodCount =					3,
+			};
+
+		struct SStats
+			{
+			int iShips[lodCount] = { 0 };	//	Ships at each level
+			int iCoasting = 0;				//	Ships that skipped behavior this tick
+			};
+
+		CAILODScheduler (void);
+
+		void BeginUpdate (CSystem &System);
+		ELevels CalcLevel (CShip *pShip) const;
+		static int GetCadence (ELevels iLevel);
+		inline const SStats &GetStats (void) const { return m_LastStats; }
+		void PaintStats (CG32bitImage &Dest, SViewportPaintCtx &Ctx) const;
+		bool UpdateShip (CShip *pShip);
+
+	private:
+		CVector m_vCenter;					//	Position of POV
+		bool m_bHasCenter;					//	FALSE if POV is not in this system
+
+		SStats m_Stats;						//	Stats for the current tick
+		SStats m_LastStats;					//	Stats for the last complete tick
+	};
+
+//	CAvoidPotentialField
+//
+//	Samples the avoid potential (see CAIBehaviorCtx::CalcAvoidPotential) from
+//	a system's static hazards (gravity wells and barriers that don't move) on
+//	a sparse grid. Ships interpolate the potential here instead of scanning
+//	the area around them for hazards. Hazards that can move are not sampled;
+//	we just keep a list of them.
+
+class CAvoidPotentialField
+	{
+	public:
+		CAvoidPotentialField (void) :
+				m_iLastCheck(-1),
+				m_bValid(false)
+			{ }
+
+		inline const TArray<CSpaceObject *> &GetDynamicSources (void) const { return m_DynamicSources; }
+		bool GetPotential (const CVector &vPos, CVector &iovPotential) const;
+		inline bool IsSource (CSpaceObject *pObj) const { return (pObj && m_Sources.GetAt(pObj) != NULL); }
+		inline bool IsValid (void) const { return m_bValid; }
+		void OnObjAdded (CSpaceObject *pObj);
+		void OnObjRemoved (CSpaceObject *pObj);
+		void Update (CSystem &System);
+
+		static bool IsHazard (CSpaceObject *pObj);
+
+	private:
+		enum Constants
+			{
+			CHUNK_SIZE =				16,		//	Samples per chunk side
+			};
+
+		struct SChunk
+			{
+			CVector Samples[CHUNK_SIZE * CHUNK_SIZE];
+			};
+
+		const CVector *GetSample (int x, int y) const;
+		void Init (const TArray<CSpaceObject *> &Sources);
+		static DWORD MakeChunkKey (int xChunk, int yChunk) { return (((DWORD)(xChunk & 0xffff)) << 16) | (DWORD)(yChunk & 0xffff); }
+		CVector *SetSample (int x, int y);
+
+		TArray<SChunk> m_Chunks;
+		TSortMap<DWORD, int> m_ChunkIndex;			//	Chunk key to index in m_Chunks
+		TSortMap<CSpaceObject *, CVector> m_Sources;	//	Sampled hazards (and their position)
+		TArray<CSpaceObject *> m_DynamicSources;	//	Hazards that can move
+
+		int m_iLastCheck;							//	Tick on which we last checked for changes
+		bool m_bValid;								//	FALSE if we need to rebuild
+	};
+
+//	CSovereignInfluenceMap
+//
+//	Coarse grid of the combat power of armed ships in a system, by sovereign.
+//	Any sovereign can ask how much enemy and friendly power is near a position
+//	without looking at individual ships. Objects are added and removed as they
+//	enter and leave the system; positions and power are refreshed a few times
+//	a second. Each cell also lists its ships, so AI can look for enemies
+//	without walking every enemy in the system.
+
+class CSovereignInfluenceMap
+	{
+	public:
+		CSovereignInfluenceMap (void) :
+				m_iLastUpdate(-1)
+			{ }
+
+		void Add (CSpaceObject *pObj);
+		bool GetEnemyShips (CSovereign *pSovereign, const CVector &vPos, Metric rRadius, TArray<CSpaceObject *> &retList);
+		void GetInfluence (CSovereign *pSovereign, const CVector &vPos, Metric rRadius, int *retiEnemy, int *retiFriend = NULL);
+		bool HasEnemyPower (CSovereign *pSovereign, const CVector &vPos, Metric rRadius);
+		void Remove (CSpaceObject *pObj);
+		void Update (CSystem &System);
+
+		static bool IsCandidate (CSpaceObject *pObj);
+
+	private:
+		struct SEntry
+			{
+			CSovereign *pSovereign;
+			DWORD dwCell;
+			int iPower;
+			};
+
+		struct SSovereignPower
+			{
+			CSovereign *pSovereign;
+			int iPower;
+			TArray<CSpaceObject *> Ships;			//	Ships of this sovereign in the cell
+			};
+
+		struct SCell
+			{
+			TArray<SSovereignPower> Power;			//	Power of each sovereign in the cell
+			};
+
+		struct SInfluence
+			{
+			SInfluence (void) :
+					iEnemy(0),
+					iFriend(0)
+				{ }
+
+			int iEnemy;
+			int iFriend;
+			};
+
+		struct SView
+			{
+			SView (void) :
+					dwVersion(0)
+				{ }
+
+			DWORD dwVersion;						//	Disposition version the view was built with
+			TSortMap<DWORD, SInfluence> Cells;		//	Enemy and friendly power in each cell
+			};
+
+		void AddPower (CSpaceObject *pObj, CSovereign *pSovereign, DWORD dwCell, int iPower);
+		static DWORD CalcCellKey (const CVector &vPos);
+		void CalcInfluence (SView &View, const CVector &vPos, Metric rRadius, int *retiEnemy, int *retiFriend) const;
+		Metric CalcMargin (void) const;
+		SView &GetView (CSovereign *pSovereign);
+		void InitView (CSovereign *pSovereign, SView &View) const;
+		static DWORD MakeCellKey (int x, int y) { return (((DWORD)(x & 0xffff)) << 16) | (DWORD)(y & 0xffff); }
+		void SetEntry (CSpaceObject *pObj, CSovereign *pSovereign, DWORD dwCell, int iPower);
+
+		TSortMap<CSpaceObject *, SEntry> m_Objects;	//	Contribution of each object
+		TSortMap<DWORD, SCell> m_Cells;				//	Power of each sovereign by cell
+		TSortMap<CSovereign *, SView> m_Views;		//	Influence as seen by each sovereign that asked
+
+		int m_iLastUpdate;							//	Tick on which we last refreshed positions
+	};
+
+//	CFlockIndex
+//
+//	Snapshot of the armed ships in a system, by sovereign and by area. We take
+//	it the first time a ship asks about its flock on a given tick, so all
+//	members of a swarm share it. Each cell keeps running totals of its members
+//	(sorted by destiny) so that a ship can add up whole cells of its flock
+//	without looking at each member.
+
+class CFlockIndex
+	{
+	public:
+		struct STotals
+			{
+			STotals (void) :
+					rFlockCount(0.0),
+					rAvoidCount(0.0)
+				{ }
+
+			CVector vFlockPos;						//	Sum of positions (relative to ship) of ships we follow
+			CVector vFlockVel;						//	Sum of velocities (relative to ship) of ships we follow
+			CVector vFlockHeading;					//	Sum of headings (unit vectors) of ships we follow
+			Metric rFlockCount;						//	Number of ships we follow
+
+			CVector vAvoid;							//	Sum of positions (relative to ship) of ships too close
+			Metric rAvoidCount;						//	Number of ships too close
+			};
+
+		CFlockIndex (void) :
+				m_bValid(false)
+			{ }
+
+		void CalcTotals (CSpaceObject *pShip, CSpaceObject *pLeader, Metric rFOVRange, Metric rSeparationRange, STotals &retTotals) const;
+		void Init (CSystem &System);
+		inline void Invalidate (void) { m_bValid = false; }
+		inline bool IsValid (void) const { return m_bValid; }
+		void OnObjRemoved (CSpaceObject *pObj);
+
+		static bool IsCandidate (CSpaceObject *pObj);
+
+	private:
+		struct SMember
+			{
+			CSpaceObject *pObj;
+			CVector vPos;
+			CVector vVel;
+			CVector vHeading;
+			int iDestiny;
+
+			CVector vPosTotal;						//	Totals of this member and all members before it
+			CVector vVelTotal;
+			CVector vHeadingTotal;
+			};
+
+		struct SCell
+			{
+			TArray<SMember> Members;				//	Sorted by descending destiny
+			};
+
+		struct SFlock
+			{
+			TSortMap<DWORD, SCell> Cells;
+			};
+
+		void AddCell (DWORD dwKey, const SCell &Cell, CSpaceObject *pShip, CSpaceObject *pLeader, const DWORD *pLeaderCell, Metric rFOVRange2, Metric rSeparationRange2, STotals &Totals) const;
+		void AddMember (const SMember &Member, CSpaceObject *pShip, CSpaceObject *pLeader, Metric rFOVRange2, Metric rSeparationRange2, STotals &Totals) const;
+		static DWORD CalcCellKey (const CVector &vPos);
+		static DWORD MakeCellKey (int x, int y) { return (((DWORD)(x & 0xffff)) << 16) | (DWORD)(y & 0xffff); }
+
+		TSortMap<CSovereign *, SFlock> m_Flocks;	//	Ships by sovereign and cell
+		TSortMap<CSpaceObject *, DWORD> m_Members;	//	Cell of each ship in the snapshot
+		bool m_bValid;								//	FALSE if we need to take a new snapshot
+	};
+
 //	CNavigationPath
 
 class CNavigationPath : public TSEListNode<CNavigationPath>
@@ -23,19 +270,29 @@ class CNavigationPath : public TSEListNode<CNavigationPath>
 
 		static void Create (CSystem *pSystem, CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd, CNavigationPath **retpPath);
 		static void Create (CSystem *pSystem, CSovereign *pSovereign, const CVector &vStart, const CVector &vEnd, CNavigationPath **retpPath);
+		static void CreatePending (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd, CNavigationPath **retpPath);
 
+		static void AddObstacles (CSystem *pSystem, CSovereign *pSovereign, const CVector &vFrom, const CVector &vTo, CAStarPathFinder &AStar);
 		Metric ComputePathLength (CSystem *pSystem) const;
 		CVector ComputePointOnPath (CSystem *pSystem, Metric rDist) const;
 		static CString DebugDescribe (CSpaceObject *pObj, CNavigationPath *pNavPath);
 		void DebugPaintInfo (CG32bitImage &Dest, int x, int y, ViewportTransform &Xform);
 		void DebugPaintInfo (CG32bitImage &Dest, int x, int y, const CMapViewportCtx &Ctx);
+		static int FindPath (CAStarPathFinder &AStar, const CVector &vFrom, const CVector &vTo, CVector **retpPoints);
+		inline DWORD GetEndID (void) const { return m_iEndIndex; }
 		inline DWORD GetID (void) const { return m_dwID; }
 		inline int GetNavPointCount (void) const { return m_iWaypointCount; }
 		CVector GetNavPoint (int iIndex) const;
 		inline CVector GetPathEnd (void) const { return GetNavPoint(GetNavPointCount() - 1); }
+		inline CVector GetPathStart (void) const { return m_vStart; }
+		inline DWORD GetRevision (void) const { return m_dwRevision; }
+		inline CSovereign *GetSovereign (void) const { return m_pSovereign; }
+		inline DWORD GetStartID (void) const { return m_iStartIndex; }
+		inline bool IsPending (void) const { return m_bPending; }
 		bool Matches (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd);
 		void OnReadFromStream (SLoadCtx &Ctx);
 		void OnWriteToStream (CSystem *pSystem, IWriteStream *pStream) const;
+		void SetWaypoints (int iCount, CVector *pWaypoints);
 
 	private:
 		static int ComputePath (CSystem *pSystem, CSovereign *pSovereign, const CVector &vFrom, const CVector &vTo, CVector **retpPoints);
@@ -53,10 +310,80 @@ class CNavigationPath : public TSEListNode<CNavigationPath>
 		CVector m_vStart;						//	Start position
 		int m_iWaypointCount;					//	Number of waypoints (excludes start)
 		CVector *m_Waypoints;					//	Array of waypoints
+		DWORD m_dwRevision;						//	Incremented when waypoints change (not saved)
+
+		bool m_bPending;						//	Waypoints are a straight line until the path service gets to us
 	};
 
 typedef TSEListNode<CNavigationPath> CNavigationPathNode;
 
+//	CNavObstacleIndex
+//
+//	The objects in a system that could be obstacles for nav paths (stations,
+//	worlds, stars and ships). Most objects in a busy system are missiles,
+//	beams and effects, so this saves nav path searches from scanning them.
+//	The list is built on first use and kept up to date as objects are added
+//	to and removed from the system.
+
+class CNavObstacleIndex
+	{
+	public:
+		CNavObstacleIndex (void) :
+				m_bValid(false)
+			{ }
+
+		void Add (CSpaceObject *pObj);
+		inline void DeleteAll (void) { m_Objs.DeleteAll(); m_bValid = false; }
+		const TArray<CSpaceObject *> &GetObjects (CSystem &System);
+		void Remove (CSpaceObject *pObj);
+
+	private:
+		static bool IsCandidate (CSpaceObject *pObj);
+
+		TArray<CSpaceObject *> m_Objs;			//	Unordered
+		bool m_bValid;							//	FALSE if we need to build the list
+	};
+
+//	CNavigationPathCache
+//
+//	Indexes the system's shared nav paths by endpoints and by ID. The cache
+//	does not own the paths (CSystem::m_NavPaths does).
+
+class CNavigationPathCache
+	{
+	public:
+		void Add (CNavigationPath *pPath);
+		void DeleteAll (void);
+		CNavigationPath *Find (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd) const;
+		CNavigationPath *FindByID (DWORD dwID) const;
+
+	private:
+		static DWORDLONG MakeKey (DWORD dwStartID, DWORD dwEndID) { return (((DWORDLONG)dwStartID) << 32) | (DWORDLONG)dwEndID; }
+
+		TSortMap<DWORDLONG, TArray<CNavigationPath *>> m_ByEndpoints;	//	Newest path first
+		TSortMap<DWORD, CNavigationPath *> m_ByID;
+	};
+
+//	CNavigationPathService
+//
+//	Computes pending nav paths outside of ship behavior. Each system update
+//	completes a limited number of requests, running the searches in parallel
+//	when we have more than one.
+
+class CNavigationPathService
+	{
+	public:
+		void Cancel (CNavigationPath *pPath);
+		void Complete (CSystem &System, CNavigationPath *pPath);
+		inline void DeleteAll (void) { m_Queue.DeleteAll(); }
+		inline int GetCount (void) const { return m_Queue.GetCount(); }
+		inline void Request (CNavigationPath *pPath) { m_Queue.Insert(pPath); }
+		void Update (CSystem &System, CThreadPool *pThreadPool, int iMaxPaths);
+
+	private:
+		TArray<CNavigationPath *> m_Queue;
+	};
+
 //	CSystemEventHandler
 
 class CSystemEventHandler : public TSEListNode<CSystemEventHandler>
@@ -289,13 +616,66 @@ struct SSystemUpdateCtx
 	SSystemUpdateCtx (void) : rSecondsPerTick(g_SecondsPerUpdate),
 			bForceEventFiring(false),
 			bForcePainted(false),
-			bTrackPlayerObjs(false)
+			bTrackPlayerObjs(false),
+			bParallelBehavior(false)
 		{ }
 
 	Metric rSecondsPerTick;
 	bool bForceEventFiring;					//	If TRUE, fire events even if no player ship
 	bool bForcePainted;						//	If TRUE, mark objects as painted 
 	bool bTrackPlayerObjs;					//	If TRUE, make a list of player objects
+	bool bParallelBehavior;					//	If TRUE, run parallel part of behavior on worker threads
+	};
+
+//	CKinematicsStore holds a packed copy (one array per component) of the 
+//	position and velocity of every object that moves on a straight line and
+//	has no OnMove logic. CSystem::Update fills it at the start of the move 
+//	pass, integrates all entries in one batch, and then hands the new 
+//	positions back to each object (in object order) through MoveBatched.
+
+class CKinematicsStore
+	{
+	public:
+		int Add (CSpaceObject *pObj);
+		void DeleteAll (void);
+		inline int GetCount (void) const { return m_PosX.GetCount(); }
+		inline CVector GetPos (int iIndex) const { return CVector(m_PosX[iIndex], m_PosY[iIndex]); }
+		void Integrate (CThreadPool *pThreadPool, Metric rSeconds);
+
+		static void IntegrateRange (Metric *pPosX, Metric *pPosY, const Metric *pVelX, const Metric *pVelY, int iCount, Metric rSeconds);
+
+	private:
+		TArray<Metric> m_PosX;
+		TArray<Metric> m_PosY;
+		TArray<Metric> m_VelX;
+		TArray<Metric> m_VelY;
+	};
+
+//	CSpaceObjectPosIndex buckets the index of every object in the system by
+//	position so that criteria searches with a distance bound (e.g., 
+//	sysFindObject with "N") only look at nearby objects. Unlike 
+//	CSpaceObjectGrid, it includes objects that cannot be hit. CSystem rebuilds
+//	it on demand after objects are added, placed, or moved.
+
+class CSpaceObjectPosIndex
+	{
+	public:
+		CSpaceObjectPosIndex (void) : m_iGridSize(0), m_rCellSize(0.0) { }
+
+		void DeleteAll (void);
+		Metric GetMaxRadius (const CVector &vCenter) const;
+		void GetObjectsInCircle (const CVector &vCenter, Metric rRadius, TArray<int> &Result) const;
+		void Init (CSystem &System);
+		inline bool IsEmpty (void) const { return (m_Objects.GetCount() == 0); }
+
+	private:
+		int m_iGridSize;
+		Metric m_rCellSize;
+		CVector m_vLL;
+		CVector m_vUR;
+
+		TArray<int> m_CellStart;			//	Offset into m_Objects for each cell (plus one at the end)
+		TArray<int> m_Objects;				//	Object indices, grouped by cell
 	};
 
 //	CMoveCtx is currently unused; it was part of an experiment to see
@@ -733,6 +1113,7 @@ class CSystem
 		bool AddJoint (CObjectJoint::ETypes iType, CSpaceObject *pFrom, CSpaceObject *pTo, ICCItem *pOptions, DWORD *retdwID = NULL);
 		ALERROR AddTimedEvent (CSystemEvent *pEvent);
 		void AddToDeleteList (CSpaceObject *pObj);
+		void AddToEnemyObjectCache (CSpaceObject *pObj, CSovereign *pObjSovereign);
 		ALERROR AddToSystem (CSpaceObject *pObj, int *retiIndex);
 		bool AscendObject (CSpaceObject *pObj, CString *retsError = NULL);
 		int CalculateLightIntensity (const CVector &vPos, CSpaceObject **retpStar = NULL, const CG8bitSparseImage **retpVolumetricMask = NULL);
@@ -742,20 +1123,22 @@ class CSystem
 		void CancelTimedEvent (CDesignType *pSource, const CString &sEvent, bool bInDoEvent = false);
 		bool DescendObject (DWORD dwObjID, const CVector &vPos, CSpaceObject **retpObj = NULL, CString *retsError = NULL);
 		inline bool EnemiesInLRS (void) const { return m_fEnemiesInLRS; }
-		inline void EnumObjectsInBoxStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags = 0) const { m_ObjGrid.EnumStart(i, vUR, vLL, dwFlags); }
-		inline void EnumObjectsInBoxStart (SSpaceObjectGridEnumerator &i, const CVector &vPos, Metric rRange, DWORD dwFlags = 0) const
+		inline void EnumObjectsInBoxStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags = 0, DWORD dwCategories = 0) const { m_ObjGrid.EnumStart(i, vUR, vLL, dwFlags, dwCategories); }
+		inline void EnumObjectsInBoxStart (SSpaceObjectGridEnumerator &i, const CVector &vPos, Metric rRange, DWORD dwFlags = 0, DWORD dwCategories = 0) const
 			{
 			CVector vRange = CVector(rRange, rRange);
 			CVector vUR = vPos + vRange;
 			CVector vLL = vPos - vRange;
-			m_ObjGrid.EnumStart(i, vUR, vLL, dwFlags);
+			m_ObjGrid.EnumStart(i, vUR, vLL, dwFlags, dwCategories);
 			}
+		inline void EnumObjectsInCircleStart (SSpaceObjectGridEnumerator &i, const CVector &vCenter, Metric rRadius, DWORD dwFlags = 0, DWORD dwCategories = 0) const { m_ObjGrid.EnumStartCircle(i, vCenter, rRadius, dwFlags, dwCategories); }
 		inline bool EnumObjectsInBoxHasMore (SSpaceObjectGridEnumerator &i) const { return i.bMore; }
 		inline CSpaceObject *EnumObjectsInBoxGetNext (SSpaceObjectGridEnumerator &i) const { return m_ObjGrid.EnumGetNext(i); }
 		inline CSpaceObject *EnumObjectsInBoxGetNextFast (SSpaceObjectGridEnumerator &i) const { return m_ObjGrid.EnumGetNextFast(i); }
 		inline CSpaceObject *EnumObjectsInBoxPointGetNext (SSpaceObjectGridEnumerator &i) const { return m_ObjGrid.EnumGetNextInBoxPoint(i); }
 		CSpaceObject *FindObject (DWORD dwID);
 		CSpaceObject *FindObjectInRange (const CVector &vCenter, Metric rRange, const CSpaceObjectCriteria &Criteria = CSpaceObjectCriteria()) const;
+		void FindObjectsMatching (const CSpaceObjectCriteria &Criteria, CSpaceObjectCriteria::SCtx &Ctx, TArray<CSpaceObject *> *retList = NULL);
         CSpaceObject *FindObjectWithOrbit (const COrbit &Orbit) const;
 		bool FindObjectName (CSpaceObject *pObj, CString *retsName = NULL);
 		void FireOnSystemExplosion (CSpaceObject *pExplosion, CWeaponFireDesc *pDesc, const CDamageSource &Source);
@@ -764,15 +1147,20 @@ class CSystem
 		void FireOnSystemWeaponFire (CSpaceObject *pShot, CWeaponFireDesc *pDesc, const CDamageSource &Source, int iRepeatingCount);
 		void FireSystemWeaponEvents (CSpaceObject *pShot, CWeaponFireDesc *pDesc, const CDamageSource &Source, int iRepeatingCount, DWORD dwFlags);
 		void FlushEnemyObjectCache (void);
+		inline CAILODScheduler &GetAILODScheduler (void) { return m_AILOD; }
 		CString GetAttribsAtPos (const CVector &vPos);
+		inline const CAvoidPotentialField &GetAvoidPotentialField (void) const { return m_AvoidField; }
 		void GetDebugInfo (SDebugInfo &Info) const;
 		inline CEnvironmentGrid *GetEnvironmentGrid (void) { InitSpaceEnvironment(); return m_pEnvironment; }
+		inline const CFlockIndex &GetFlockIndex (void) { if (!m_FlockIndex.IsValid()) m_FlockIndex.Init(*this); return m_FlockIndex; }
 		inline DWORD GetID (void) { return m_dwID; }
+		inline CSovereignInfluenceMap &GetInfluenceMap (void) { return m_InfluenceMap; }
 		inline int GetLastUpdated (void) { return m_iLastUpdated; }
 		int GetLevel (void);
 		inline const CLocationList &GetLocations (void) const { return m_Locations; }
 		CSpaceObject *GetNamedObject (const CString &sName);
 		inline const CString &GetName (void) const { return m_sName; }
+		inline const TArray<CSpaceObject *> &GetNavObstacles (void) { return m_NavObstacles.GetObjects(*this); }
 		CNavigationPath *GetNavPath (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd);
 		CNavigationPath *GetNavPathByID (DWORD dwID);
 		inline CSpaceObject *GetObject (int iIndex) const { return m_AllObjects[iIndex]; }
@@ -801,6 +1189,7 @@ class CSystem
 		bool HasAttribute (const CVector &vPos, const CString &sAttrib);
 		CSpaceObject *HitScan (CSpaceObject *pExclude, const CVector &vStart, const CVector &vEnd, bool bExcludeWorlds, CVector *retvHitPos = NULL);
 		CSpaceObject *HitTest (CSpaceObject *pExclude, const CVector &vPos, bool bExcludeWorlds);
+		inline void InvalidatePosIndex (void) { m_fPosIndexValid = false; }
 		inline bool IsCreationInProgress (void) const { return (m_fInCreate ? true : false); }
 		inline bool IsPlayerUnderAttack (void) const { return m_fPlayerUnderAttack; }
 		bool IsStarAtPos (const CVector &vPos);
@@ -808,6 +1197,8 @@ class CSystem
 		inline bool IsTimeStopped (void) { return (m_iTimeStopped != 0); }
 		void MarkImages (void);
 		void NameObject (const CString &sName, CSpaceObject *pObj);
+		inline CSpaceObjectGridRange ObjectsInBox (const CVector &vPos, Metric rRange, DWORD dwFlags = 0, DWORD dwCategories = 0) const { CVector vRange(rRange, rRange); return m_ObjGrid.ObjectsInBox(vPos + vRange, vPos - vRange, dwFlags, dwCategories); }
+		inline CSpaceObjectGridRange ObjectsInCircle (const CVector &vCenter, Metric rRadius, DWORD dwFlags = 0, DWORD dwCategories = 0) const { return m_ObjGrid.ObjectsInCircle(vCenter, rRadius, dwFlags, dwCategories); }
 		CVector OnJumpPosAdj (CSpaceObject *pObj, const CVector &vPos);
 		void OnStationDestroyed (SDestroyCtx &Ctx);
 		void PaintViewport (CG32bitImage &Dest, const RECT &rcView, CSpaceObject *pCenter, DWORD dwFlags, SViewportAnnotations *pAnnotations = NULL);
@@ -821,7 +1212,9 @@ class CSystem
 		void RegisterEventHandler (CSpaceObject *pObj, Metric rRange);
 		inline void RegisterForOnSystemCreated (CSpaceObject *pObj) { m_DeferredOnCreate.Insert(SDeferredOnCreateCtx(pObj)); }
 		void RegisterForOnSystemCreated (CSpaceObject *pObj, CStationType *pEncounter, const COrbit &Orbit);
+		void RemoveFromEnemyObjectCache (CSpaceObject *pObj, CSovereign *pObjSovereign);
 		void RemoveObject (SDestroyCtx &Ctx);
+		CNavigationPath *RequestNavPath (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd);
 		void RestartTime (void);
 		ALERROR SaveToStream (IWriteStream *pStream);
 		inline void SetID (DWORD dwID) { m_dwID = dwID; }
@@ -902,8 +1295,10 @@ class CSystem
 								  CSpaceObject **retpStation,
 								  CString *retsError = NULL);
 		void FlushDeletedObjects (void);
+		CThreadPool *GetThreadPool (void);
 		inline int GetTimedEventCount (void) { return m_TimedEvents.GetCount(); }
 		inline CSystemEvent *GetTimedEvent (int iIndex) { return m_TimedEvents.GetEvent(iIndex); }
+		void InitNavPathCache (void);
 		void InitSpaceEnvironment (void) const;
 		void InitVolumetricMask (void);
 		void PaintDestinationMarker (SViewportPaintCtx &Ctx, CG32bitImage &Dest, int x, int y, CSpaceObject *pObj);
@@ -912,8 +1307,13 @@ class CSystem
 		void SetPainted (void);
 		void UpdateCollisionTesting (SUpdateCtx &Ctx);
 		void UpdateGravity (SUpdateCtx &Ctx, CSpaceObject *pGravityObj);
+		void UpdateParallelBehavior (void);
 		void UpdateRandomEncounters (void);
 
+		static bool HitsCollisionObj (CSpaceObject *pObj, const CVector &vPos, CSpaceObject *pContactObj);
+		static bool HitsCollisionObjSwept (CSpaceObject *pObj, CSpaceObject *pContactObj, CVector *retvHitPos);
+		static bool IsFastMover (CSpaceObject *pObj);
+
 		//	Game instance data
 
 		DWORD m_dwID;							//	System ID
@@ -928,6 +1328,13 @@ class CSystem
 		CEnvironmentGrid mutable *m_pEnvironment;		//	Nebulas, etc.
 		CSystemEventHandlerNode m_EventHandlers;	//	List of system event handler
 		CNavigationPathNode m_NavPaths;			//	List of navigation paths
+		CNavigationPathCache m_NavPathCache;	//	Index of m_NavPaths
+		CNavigationPathService m_NavPathService;	//	Pending nav paths
+		CNavObstacleIndex m_NavObstacles;		//	Objects that nav paths might need to avoid
+		CAILODScheduler m_AILOD;				//	How often each AI ship thinks
+		CAvoidPotentialField m_AvoidField;		//	Avoid potential from static hazards
+		CSovereignInfluenceMap m_InfluenceMap;	//	Combat power of each sovereign by area
+		CFlockIndex m_FlockIndex;				//	Armed ships by sovereign and area (for flocking)
 		CLocationList m_Locations;				//	List of point locations
 		CTerritoryList m_Territories;			//	List of defined territories
 		CObjectJointList m_Joints;				//	List of object joints
@@ -947,15 +1354,20 @@ class CSystem
 		DWORD m_fEnemiesInSRS:1;				//	TRUE if we found enemies in last SRS update
 		DWORD m_fPlayerUnderAttack:1;			//	TRUE if at least one object has player as target
 		DWORD m_fLocationsBlocked:1;			//	TRUE if we're already computed overlapping locations
+		DWORD m_fPosIndexValid:1;				//	TRUE if m_PosIndex is up to date
 
-		DWORD m_fSpare:24;
+		DWORD m_fSpare:23;
 
 		//	Support structures
 
-		CThreadPool *m_pThreadPool;				//	Thread pool for painting
+		CThreadPool *m_pThreadPool;				//	Thread pool for painting and parallel behavior
+		TArray<CSpaceObject *> m_ParallelBehaviorObjs;	//	Objects with parallel behavior this tick
 		CSpaceObjectList m_EncounterObjs;		//	List of objects that generate encounters
 		TArray<SStarDesc> m_Stars;				//	List of stars in the system
 		CSpaceObjectGrid m_ObjGrid;				//	Grid to help us hit test
+		CSpaceObjectPosIndex m_PosIndex;		//	Object indices by position (for criteria searches)
+		CKinematicsStore m_Kinematics;			//	Packed positions for batched moves
+		TArray<int> m_KinematicsIndex;			//	Index into m_Kinematics by object (-1 = not batched)
 		CSpaceObjectList m_DeletedObjects;		//	List of objects deleted in the current update
 		CSpaceObjectList m_LayerObjs[layerCount];	//	List of objects by layer
 		CSpaceObjectList m_EnhancedDisplayObjs;	//	List of objects to show in viewport periphery
@@ -964,6 +1376,7 @@ class CSystem
 		TArray<SDeferredOnCreateCtx> m_DeferredOnCreate;	//	Ordered list of objects that need an OnSystemCreated call
 		CSystemSpacePainter m_SpacePainter;		//	Paints space background
 		CMapGridPainter m_GridPainter;			//	Structure to paint a grid
+		CPhysicsBroadphase m_Broadphase;		//	Finds candidate pairs for collision testing
 		CPhysicsContactResolver m_ContactResolver;	//	Resolves physics contacts
 
 		static const Metric g_MetersPerKlick;
@@ -35,6 +35,10 @@ class CTopologyNode
 			TArray<CString> AttribsNotAllowed;			//	Does not match if any of these attribs are present
 			TArray<CString> SpecialRequired;			//	Special attributes
 			TArray<CString> SpecialNotAllowed;			//	Special attributes
+
+			CAttributeSet RequiredAtoms;				//	AttribsRequired as atoms
+			CAttributeSet NotAllowedAtoms;				//	AttribsNotAllowed as atoms
+			bool bAtoms = false;						//	TRUE if atoms are valid
 			};
 
 		struct SDistanceTo
@@ -228,6 +232,7 @@ class CTopologyNode
 		TSortMap<CString, SStargateEntry> m_NamedGates;	//	Name to StarGateDesc
 
 		CString m_sAttributes;					//	Attributes
+		CAttributeSet m_Attributes;				//	m_sAttributes as atoms
 		TArray<CString> m_VariantLabels;		//	Variant labels
 		CString m_sEpitaph;						//	Epitaph if this is endgame node
 		CString m_sEndGameReason;				//	End game reason if this is endgame node
@@ -61,6 +61,7 @@ class CCodeChainCtx
 		inline SSystemCreateCtx *GetSystemCreateCtx (void) const { return m_pSysCreateCtx; }
 		inline CUniverse &GetUniverse (void) { return *g_pUniverse; }
 		ICCItemPtr LinkCode (const CString &sString, CCodeChain::SLinkOptions &Options = CCodeChain::SLinkOptions());
+		ICCItemPtr LinkCode (SDesignLoadCtx &LoadCtx, const CString &sString, CCodeChain::SLinkOptions &Options = CCodeChain::SLinkOptions());
 		void RestoreVars (void);
 		ICCItem *Run (ICCItem *pCode);
 		ICCItem *Run (const SEventHandlerDesc &Event);
@@ -131,6 +132,60 @@ class CCodeChainCtx
 		static TArray<SInvokeFrame> g_Invocations;
 	};
 
+class CCodeChainProfiler
+	{
+	public:
+		static void BeginCall (void);
+		static void DeleteAll (void);
+		static void EndCall (const SEventHandlerDesc &Event);
+		static ICCItem *GetResults (CCodeChain &CC);
+		inline static bool IsEnabled (void) { return m_bEnabled; }
+		static void SetEnabled (bool bEnabled = true);
+		static ALERROR WriteCSV (const CString &sFilespec, CString *retsError = NULL);
+		static ALERROR WriteTrace (const CString &sFilespec, CString *retsError = NULL);
+
+		struct SKey
+			{
+			DWORD dwExtension;
+			DWORD dwType;
+			int iEvent;
+			};
+
+	private:
+		struct SStats
+			{
+			int iCalls = 0;
+			LONGLONG TotalTime = 0;			//	Including nested handlers (in counter ticks)
+			LONGLONG SelfTime = 0;			//	Excluding nested handlers
+			LONGLONG MaxTime = 0;			//	Longest single call
+			};
+
+		struct SFrame
+			{
+			LONGLONG StartTime;
+			LONGLONG ChildTime;
+			};
+
+		struct STraceEntry
+			{
+			SKey Key;
+			LONGLONG StartTime;
+			LONGLONG Duration;
+			};
+
+		static CString GetEventName (const SKey &Key);
+		static LONGLONG GetTime (void);
+		static int GetMicroseconds (LONGLONG Ticks);
+
+		static bool m_bEnabled;
+		static LONGLONG m_StartTime;
+		static TSortMap<SKey, SStats> m_Stats;
+		static TArray<SFrame> m_Stack;
+		static TArray<STraceEntry> m_Trace;
+	};
+
+int KeyCompare (const CCodeChainProfiler::SKey &Key1, const CCodeChainProfiler::SKey &Key2);
+
 class CFunctionContextWrapper : public ICCAtom
 	{
 	public:
@@ -88,7 +88,9 @@ class CDebugOptions
 	{
 	public:
 		ICCItemPtr GetProperty (const CString &sProperty) const;
+		inline bool IsParallelBehaviorEnabled (void) const { return m_bParallelBehavior; }
 		inline bool IsShowAIDebugEnbled (void) const { return m_bShowAIDebug; }
+		inline bool IsShowAILODEnabled (void) const { return m_bShowAILOD; }
 		inline bool IsShowBoundsEnabled (void) const { return m_bShowBounds; }
 		inline bool IsShowFacingsAngleEnabled (void) const { return m_bShowFacingsAngle; }
 		inline bool IsShowLineOfFireEnabled (void) const { return m_bShowLineOfFire; }
@@ -97,9 +99,12 @@ class CDebugOptions
 		bool SetProperty (const CString &sProperty, ICCItem *pValue, CString *retsError = NULL);
 		
 	private:
+		ICCItemPtr GetAILODStats (void) const;
 		ICCItemPtr GetMemoryUse (void) const;
 
+		bool m_bParallelBehavior = false;
 		bool m_bShowAIDebug = false;
+		bool m_bShowAILOD = false;
 		bool m_bShowBounds = false;
 		bool m_bShowLineOfFire = false;
 		bool m_bShowNavPaths = false;
@@ -426,6 +431,7 @@ class CUniverse
 		inline int GetMusicResourceCount (void) const { return m_Design.GetCount(designMusic); }
 		inline CSovereign *GetSovereign (int iIndex) const { return (CSovereign *)m_Design.GetEntry(designSovereign, iIndex); }
 		inline int GetSovereignCount (void) { return m_Design.GetCount(designSovereign); }
+		inline CSovereignDispositionMatrix &GetSovereignDispositions (void) { return m_SovereignDispositions; }
 		inline CStationType *GetStationType (int iIndex) { return (CStationType *)m_Design.GetEntry(designStationType, iIndex); }
 		inline int GetStationTypeCount (void) { return m_Design.GetCount(designStationType); }
 		inline CTopology &GetTopology (void) { return m_Topology; }
@@ -482,6 +488,7 @@ class CUniverse
 
 		CExtensionCollection m_Extensions;		//	Loaded extensions
 		CDesignCollection m_Design;				//	Design collection
+		CSovereignDispositionMatrix m_SovereignDispositions;	//	Cached sovereign relationships
 		CDeviceStorage m_DeviceStorage;			//	Local cross-game storage
 
 		CString m_sResourceDb;					//	Resource database
@@ -20,6 +20,7 @@ struct SDamageCtx;
 struct SDestroyCtx;
 struct SSystemCreateCtx;
 struct SSpaceObjectGridEnumerator;
+class CSpaceObjectGridRange;
 
 //	Utility inlines
 
@@ -376,6 +377,67 @@ class CIDCounter
 		DWORD m_dwNextID;
 	};
 
+//	CPropertyIDTable
+//
+//	Maps property names (case-insensitive) to integer IDs. A class defines a
+//	static table of its property names and calls Find once at the top of
+//	GetProperty/SetProperty; after that it compares IDs instead of strings.
+//	Find returns -1 if the class does not handle the property (in which case
+//	it falls back to its base class).
+
+class CPropertyIDTable
+	{
+	public:
+		struct SEntry
+			{
+			int iID;
+			CString sName;
+			};
+
+		CPropertyIDTable (const SEntry *pTable, int iCount) :
+				m_pTable(pTable),
+				m_iCount(iCount)
+			{ }
+
+		int Find (const CString &sName) const;
+
+	private:
+		static int Compare (const CString &sKey1, const CString &sKey2);
+		void Init (void) const;
+
+		const SEntry *m_pTable;
+		int m_iCount;
+		mutable TArray<int> m_Sorted;				//	Indices into m_pTable, sorted by name
+	};
+
+//	CAttributeSet
+//
+//	A set of attributes stored as a sorted array of atoms. Each distinct
+//	attribute name (ignoring case) is interned into a global table the first
+//	time we see it, so checking a criteria against a set is a merge of two
+//	short integer arrays instead of a string scan per attribute.
+
+class CAttributeSet
+	{
+	public:
+		inline void DeleteAll (void) { m_Atoms.DeleteAll(); }
+		bool Has (DWORD dwAtom) const;
+		bool HasAll (const CAttributeSet &Attribs) const;
+		bool HasAny (const CAttributeSet &Attribs) const;
+		bool InitFromArray (const TArray<CString> &Attribs);
+		void InitFromList (const CString &sAttributes);
+		inline bool IsEmpty (void) const { return (m_Atoms.GetCount() == 0); }
+
+		static DWORD Atomize (const CString &sAttrib);
+		static bool FindAtom (const CString &sAttrib, DWORD *retdwAtom = NULL);
+		static bool IsAtom (const CString &sAttrib);
+
+	private:
+		void Insert (DWORD dwAtom);
+
+		TArray<DWORD> m_Atoms;						//	Sorted, no duplicates
+	};
+
 class CAttributeCriteria
 	{
 	public:
@@ -505,11 +567,16 @@ struct SEventHandlerDesc
 	{
     SEventHandlerDesc (void) :
             pExtension(NULL),
-            pCode(NULL)
+            pCode(NULL),
+            dwType(0),
+            iEvent(0)
         { }
 
 	CExtension *pExtension;
 	ICCItem *pCode;
+
+	DWORD dwType;						//	Type that fired the event (for profiling)
+	int iEvent;							//	Event ID (0 = unknown) (see CDesignType::GetEventName)
 	};
 
 class CEventHandler
@@ -1033,6 +1100,15 @@ enum SpaceObjectGridFlags
 	gridNoBoxCheck			= 0x00000001,	//	Do not check for objects in the box
 	};
 
+class ISpaceObjectGridVisitor
+	{
+	public:
+		virtual ~ISpaceObjectGridVisitor (void) { }
+
+		//	Return FALSE to stop the enumeration
+		virtual bool OnObj (CSpaceObject *pObj) = 0;
+	};
+
 class CSpaceObjectPool
 	{
 	public:
@@ -1042,6 +1118,8 @@ class CSpaceObjectPool
 
 			CSpaceObject *pObj;
 			SNode *pNext;
+			SNode *pPrev;					//	Previous node in list (or next free node, if freed)
+			int iCell;						//	Index of the list we're on
 			};
 
 		CSpaceObjectPool (void) { }
@@ -1049,15 +1127,14 @@ class CSpaceObjectPool
 		CSpaceObjectPool (const CSpaceObjectPool &Src) = delete;
 		CSpaceObjectPool &operator= (const CSpaceObjectPool &Src) = delete;
 
-		SNode *AllocObj (SNode *pList, CSpaceObject *pObj);
+		SNode *AllocNode (CSpaceObject *pObj);
 		void DeleteAll (void);
-		SNode *DeleteObj (SNode *pList, CSpaceObject *pObj, bool *retbDeleted = false);
-		bool FindObj (SNode *pList, CSpaceObject *pObj) const;
-		void Init (int iSize);
+		bool FindObj (const SNode *pList, CSpaceObject *pObj) const;
+		void FreeNode (SNode *pNode);
 
 	private:
-		SNode *m_Pool = NULL;
-		int m_iSize = 0;
+		TArray<SNode *> m_Blocks;
+		SNode *m_pFree = NULL;
 		int m_iNextNode = 0;
 	};
 
@@ -1069,14 +1146,18 @@ class CSpaceObjectGrid
 
 		void DebugObjDeleted (CSpaceObject *pObj) const;
 		void Delete (CSpaceObject *pObj);
-		void DeleteAll (void);
-		void EnumStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags) const;
+		void EnumStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags, DWORD dwCategories = 0) const;
+		void EnumStartCircle (SSpaceObjectGridEnumerator &i, const CVector &vCenter, Metric rRadius, DWORD dwFlags, DWORD dwCategories = 0) const;
 		inline bool EnumHasMore (SSpaceObjectGridEnumerator &i) const;
 		CSpaceObject *EnumGetNext (SSpaceObjectGridEnumerator &i) const;
 		CSpaceObject *EnumGetNextFast (SSpaceObjectGridEnumerator &i) const;
 		CSpaceObject *EnumGetNextInBoxPoint (SSpaceObjectGridEnumerator &i) const;
 		void GetObjectsInBox (const CVector &vUR, const CVector &vLL, CSpaceObjectList &Result);
-		void Init (CSystem *pSystem, SUpdateCtx &Ctx);
+		CSpaceObjectGridRange ObjectsInBox (const CVector &vUR, const CVector &vLL, DWORD dwFlags = 0, DWORD dwCategories = 0) const;
+		CSpaceObjectGridRange ObjectsInCircle (const CVector &vCenter, Metric rRadius, DWORD dwFlags = 0, DWORD dwCategories = 0) const;
+		void Update (CSystem *pSystem, SUpdateCtx &Ctx);
+		void VisitInBox (ISpaceObjectGridVisitor &Visitor, const CVector &vUR, const CVector &vLL, DWORD dwFlags = 0, DWORD dwCategories = 0) const;
+		void VisitInCircle (ISpaceObjectGridVisitor &Visitor, const CVector &vCenter, Metric rRadius, DWORD dwFlags = 0, DWORD dwCategories = 0) const;
 
 	private:
 		struct SList
@@ -1084,19 +1165,25 @@ class CSpaceObjectGrid
 			CSpaceObjectPool::SNode *pList;
 			};
 
-		void AddObject (CSpaceObject *pObj);
+		void AddObject (CSpaceObject *pObj, int iCell);
 		bool EnumGetNextList (SSpaceObjectGridEnumerator &i) const;
+		void EnumInitCells (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL) const;
+		bool EnumMatches (const SSpaceObjectGridEnumerator &i, CSpaceObject *pObj) const;
+		const SList *EnumNextCell (SSpaceObjectGridEnumerator &i) const;
+		int GetCell (const CVector &vPos) const;
 		bool GetGridCoord (const CVector &vPos, int *retx, int *rety) const;
-		const SList &GetList (const CVector &vPos) const;
-		SList &GetList (const CVector &vPos);
 		inline const SList &GetList (int x, int y) const { ASSERT(y * m_iGridSize + x < m_iGridSize * m_iGridSize); return m_pGrid[y * m_iGridSize + x]; }
 		inline SList &GetList (int x, int y) { ASSERT(y * m_iGridSize + x < m_iGridSize * m_iGridSize); return m_pGrid[y * m_iGridSize + x]; }
+		inline SList &GetListByCell (int iCell) { return (iCell == m_iOuterCell ? m_Outer : m_pGrid[iCell]); }
+		void LinkNode (CSpaceObjectPool::SNode *pNode, int iCell);
+		void UnlinkNode (CSpaceObjectPool::SNode *pNode);
 
 		CSpaceObjectPool m_Pool;
 		SList *m_pGrid;
 		SList m_Outer;
 
 		int m_iGridSize;
+		int m_iOuterCell;					//	Cell index that stands for m_Outer
 		CVector m_vGridSize;
 		Metric m_rCellSize;
 		Metric m_rCellBorder;
@@ -1106,23 +1193,74 @@ class CSpaceObjectGrid
 		friend struct SSpaceObjectGridEnumerator;
 	};
 
+//	SSpaceObjectGridEnumerator holds the state of a grid query. It does not 
+//	allocate: cells are generated on the fly from the cell range (center cell 
+//	first, then the rest in row order).
+
 struct SSpaceObjectGridEnumerator
 	{
-	SSpaceObjectGridEnumerator (void) : pGridIndexList(NULL) { }
-	~SSpaceObjectGridEnumerator (void) { if (pGridIndexList) delete [] pGridIndexList; }
+	CSpaceObject *pObj = NULL;				//	Current object
+	const CSpaceObjectGrid::SList *pList = NULL;				//	Current list
+	const CSpaceObjectPool::SNode *pNode = NULL;				//	Current node
+	bool bMore = false;						//	TRUE if there is more
+
+	int xStart = 0;							//	Range of cells to traverse
+	int yStart = 0;
+	int xEnd = -1;
+	int yEnd = -1;
+	int xCenter = 0;						//	Center cell (traversed first)
+	int yCenter = 0;
+	int xNext = 0;							//	Next cell to traverse
+	int yNext = 0;
+	bool bCenterDone = false;				//	TRUE if we've already returned the center cell
+	bool bOuterDone = false;				//	TRUE if we've already returned the outer list
+
+	bool bCheckBox = false;					//	If TRUE, only return objects in box
+	CVector vLL;							//	Box to check
+	CVector vUR;
 
-	CSpaceObject *pObj;						//	Current object
-	int iGridIndex;							//	Current grid cell to search
-	const CSpaceObjectGrid::SList *pList;						//	Current list
-	const CSpaceObjectPool::SNode *pNode;						//	Current node
-	bool bMore;								//	TRUE if there is more
+	bool bCheckCircle = false;				//	If TRUE, only return objects whose center is in circle
+	CVector vCenter;						//	Circle to check
+	Metric rRadius2 = 0.0;
 
-	int iGridIndexCount;					//	Number of grid indices to traverse
-	const CSpaceObjectGrid::SList **pGridIndexList;			//	Array of grid indices to traverse
+	DWORD dwCategories = 0;					//	If non-zero, only return objects of these categories
+	};
 
-	bool bCheckBox;							//	If TRUE, only return objects in box
-	CVector vLL;							//	Box to check
-	CVector vUR;
+//	CSpaceObjectGridRange wraps a query so that it can be used in a range-based
+//	for loop:
+//
+//		for (CSpaceObject *pObj : pSystem->ObjectsInCircle(vPos, rRadius))
+//			...
+//
+//	Filters are applied the same way as EnumGetNext (destroyed objects are 
+//	skipped).
+
+class CSpaceObjectGridRange
+	{
+	public:
+		class iterator
+			{
+			public:
+				iterator (const CSpaceObjectGrid *pGrid, SSpaceObjectGridEnumerator *pEnum) : m_pGrid(pGrid), m_pEnum(pEnum) { }
+
+				inline CSpaceObject *operator* (void) const { return m_pEnum->pObj; }
+				inline iterator &operator++ (void) { m_pGrid->EnumGetNext(*m_pEnum); return *this; }
+				inline bool operator!= (const iterator &Src) const { return (m_pEnum && m_pEnum->bMore) != (Src.m_pEnum && Src.m_pEnum->bMore); }
+
+			private:
+				const CSpaceObjectGrid *m_pGrid;
+				SSpaceObjectGridEnumerator *m_pEnum;
+			};
+
+		CSpaceObjectGridRange (const CSpaceObjectGrid &Grid) : m_pGrid(&Grid) { }
+
+		inline iterator begin (void) { return iterator(m_pGrid, &m_Enum); }
+		inline iterator end (void) { return iterator(m_pGrid, NULL); }
+		inline SSpaceObjectGridEnumerator &GetEnumerator (void) { return m_Enum; }
+
+	private:
+		const CSpaceObjectGrid *m_pGrid;
+		SSpaceObjectGridEnumerator m_Enum;
 	};
 
 class CGameTimeKeeper
@@ -141,61 +141,20 @@ bool CAIBehaviorCtx::CalcFlockingFormationCloud (CShip *pShip, CSpaceObject *pLe
 //	if the current ship is a leader in the flock.
 
 	{
-	int i;
-	CVector vFlockPos;
-	CVector vFlockVel;
-	CVector vFlockHeading;
-	CVector vAvoid;
-	Metric rFOVRange2 = rFOVRange * rFOVRange;
 	Metric rSeparationRange2 = rSeparationRange * rSeparationRange;
-	Metric rFlockCount = 0.0;
-	Metric rAvoidCount = 0.0;
-
-	for (i = 0; i < pShip->GetSystem()->GetObjectCount(); i++)
-		{
-		CSpaceObject *pObj = pShip->GetSystem()->GetObject(i);
-
-		if (pObj 
-				&& pObj->GetSovereign() == pShip->GetSovereign()
-				&& pObj->GetCategory() == CSpaceObject::catShip
-				&& pObj->CanAttack()	//	Excludes attached ship sections
-				&& pObj != pShip
-				&& pObj != pLeader)
-			{
-			CVector vTarget = pObj->GetPos() - pShip->GetPos();
-			Metric rTargetDist2 = vTarget.Dot(vTarget);
-
-			//	Only consider ships within a certain range
 
-			if (rTargetDist2 < rFOVRange2)
-				{
-				CVector vTargetRot = vTarget.Rotate(360 - pShip->GetRotation());
-
-				//	Only consider ships in front of us
-
-				if (vTargetRot.GetX() > 0.0)
-					{
-					//	Only ships of a certain destiny
-
-					if (pObj->GetDestiny() > pShip->GetDestiny())
-						{
-						vFlockPos = vFlockPos + vTarget;
-						vFlockVel = vFlockVel + (pObj->GetVel() - pShip->GetVel());
-						vFlockHeading = vFlockHeading + PolarToVector(pObj->GetRotation(), 1.0);
-						rFlockCount = rFlockCount + 1.0;
-						}
+	//	Add up the flock. All ships share a per-tick snapshot of the system, so
+	//	we only look at nearby cells (and most of those as a whole).
 
-					//	Avoid ships that are too close
+	CFlockIndex::STotals Totals;
+	pShip->GetSystem()->GetFlockIndex().CalcTotals(pShip, pLeader, rFOVRange, rSeparationRange, Totals);
 
-					if (rTargetDist2 < rSeparationRange2)
-						{
-						vAvoid = vAvoid + vTarget;
-						rAvoidCount = rAvoidCount + 1.0;
-						}
-					}
-				}
-			}
-		}
+	CVector vFlockPos = Totals.vFlockPos;
+	CVector vFlockVel = Totals.vFlockVel;
+	CVector vFlockHeading = Totals.vFlockHeading;
+	CVector vAvoid = Totals.vAvoid;
+	Metric rFlockCount = Totals.rFlockCount;
+	Metric rAvoidCount = Totals.rAvoidCount;
 
 	//	If we've got a leader, add separately
 
@@ -1561,6 +1520,15 @@ void CAIBehaviorCtx::ImplementFollowNavPath (CShip *pShip, bool *retbAtDestinati
 	{
 	DEBUG_TRY
 
+	//	If the path service has filled in the waypoints since we started on
+	//	this path, then our position in it is meaningless.
+
+	if (m_pNavPath->GetRevision() != m_dwNavPathRevision)
+		{
+		m_iNavPathPos = CalcNavPathPos(pShip, m_pNavPath);
+		m_dwNavPathRevision = m_pNavPath->GetRevision();
+		}
+
 	//	Figure out our next point along the path
 
 	CVector vTarget = m_pNavPath->GetNavPoint(m_iNavPathPos) - pShip->GetPos();
@@ -1826,12 +1794,19 @@ void CAIBehaviorCtx::ImplementManeuver (CShip *pShip, int iDir, bool bThrust, bo
 //	m_iThrustDir
 //	m_iLastTurn
 //	m_iLastTurnCount
+//	m_iManeuverDir
 
 	{
 #ifdef DEBUG_SHIP
 	bool bDebug = pShip->IsSelected();
 #endif
 
+	//	Remember what we wanted in case we skip the next few behavior updates
+	//	(see CoastManeuver).
+
+	m_iManeuverDir = iDir;
+	m_fManeuverThrust = bThrust;
+
 	if (iDir != -1)
 		{
 		int iCurrentDir = pShip->GetRotation();
@@ -1993,5 +1968,7 @@ void CAIBehaviorCtx::ImplementTurnTo (CShip *pShip, int iRotation)
 
 	{
 	SetManeuver(pShip->GetManeuverToFace(iRotation));
+	m_iManeuverDir = iRotation;
+	m_fManeuverThrust = false;
 	}
 
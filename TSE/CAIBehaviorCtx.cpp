@@ -23,12 +23,6 @@ const Metric MAX_NAV_START_DIST2 =		(MAX_NAV_START_DIST * MAX_NAV_START_DIST);
 
 const DWORD NAV_PATH_ID_OWNED =			0xffffffff;
 
-//	For purposes of computing flanking distance, we assume that our target 
-//	won't move faster than this. In practice, it's OK if they do, it just means
-//	that there is a chance we'll be too close to turn properly.
-
-const Metric MAX_TARGET_SPEED =			(0.25 * LIGHT_SPEED);
-
 CAIBehaviorCtx::CAIBehaviorCtx (void) :
 		m_iLastTurn(NoRotation),
 		m_iLastTurnCount(0),
@@ -37,20 +31,28 @@ CAIBehaviorCtx::CAIBehaviorCtx (void) :
 		m_pNavPath(NULL),
 		m_iNavPathPos(-1),
 		m_iBarrierClock(-1),
+		m_dwNavPathRevision(0),
+		m_iManeuverDir(-1),
 		m_pUpdateCtx(NULL),
-		m_pShields(NULL),
+		m_pInvariants(NULL),
 		m_iBestWeapon(devNone),
 		m_fDockingRequested(false),
-		m_fImmobile(false),
 		m_fWaitForShieldsToRegen(false),
-		m_fSuperconductingShields(false),
+		m_fManeuverThrust(false),
 		m_fHasMultipleWeapons(false),
 		m_fHasSecondaryWeapons(false),
-		m_fHasMultiplePrimaries(false),
 		m_fRecalcBestWeapon(true),
 		m_fHasEscorts(false),
 		m_fFreeNavPath(false),
-		m_fHasAvoidPotential(false)
+		m_fHasAvoidPotential(false),
+		m_iAvoidCandidatesTick(-1),
+		m_rAvoidCandidatesSeparation(0.0),
+		m_bAvoidCandidatesUseField(false),
+		m_dwWeaponScoresTarget(OBJID_NULL),
+		m_fWeaponScoresValid(false),
+		m_fWeaponScoresShieldsUp(false),
+		m_fWeaponScoresTargetThrusts(false),
+		m_fCalcingBestWeapon(false)
 
 //	CAIBehaviorCtx constructor
 
@@ -63,6 +65,174 @@ CAIBehaviorCtx::~CAIBehaviorCtx (void)
 
 	{
 	ClearNavPath();
+
+	if (m_pInvariants)
+		m_pInvariants->Delete();
+	}
+
+bool CAIBehaviorCtx::AddAvoidPotential (CShip *pShip, CSpaceObject *pObj, Metric rMinSeparation2, Metric rSeparationForce, CVector &iovPotential) const
+
+//	AddAvoidPotential
+//
+//	Adds the potential away from pObj to iovPotential. Returns TRUE if pObj 
+//	contributed any potential.
+//
+//	NOTE: This may be called from a worker thread (via 
+//	CalcAvoidPotentialParallel), in which case m_iBarrierClock is always -1.
+
+	{
+	Metric rDist;
+	bool bContributes = false;
+
+	if (pObj->HasGravity())
+		bContributes = CalcHazardPotential(pObj, pShip->GetPos(), iovPotential);
+
+	else if (pObj->Blocks(pShip))
+		{
+		//	If we've hit a wall, then we need more precise computations because 
+		//	moving aways from the center of the wall might not help.
+
+		if (m_iBarrierClock != -1)
+			{
+			CVector vTarget = pObj->GetPos() - pShip->GetPos();
+			Metric rTargetDist2 = vTarget.Dot(vTarget);
+
+			if (rTargetDist2 < WALL_RANGE2)
+				{
+				int iRange;
+				int iAngle;
+				for (iRange = 1; iRange < 8; iRange++)
+					{
+					Metric rRange = g_KlicksPerPixel * iRange * 10.0;
+					Metric rStrength = g_KlicksPerPixel * (8 - iRange) * 10.0;
+
+					for (iAngle = 0; iAngle < 360; iAngle += 30)
+						{
+						CVector vTest = PolarToVector(iAngle, 1.0);
+						if (pObj->PointInObject(pObj->GetPos(), pShip->GetPos() + (rRange * vTest)))
+							{
+							iovPotential = iovPotential - (rStrength * vTest);
+							bContributes = true;
+							}
+						}
+					}
+				}
+			}
+
+		//	Otherwise, move away from the center of the wall
+
+		else
+			bContributes = CalcHazardPotential(pObj, pShip->GetPos(), iovPotential);
+		}
+	else if (pObj->GetCategory() == CSpaceObject::catShip)
+		{
+		CVector vTarget = pObj->GetPos() - pShip->GetPos();
+		Metric rTargetDist2 = vTarget.Dot(vTarget);
+
+		//	If we get too close to this ship, then move away
+
+		if (rTargetDist2 < rMinSeparation2)
+			{
+			CVector vTargetN = vTarget.Normal(&rDist);
+			if (rDist > 0.0)
+				{
+				Metric rCloseness = GetMinCombatSeparation() - rDist;
+				iovPotential = iovPotential - (vTargetN * rSeparationForce * rCloseness);
+				bContributes = true;
+				}
+			}
+		}
+
+	return bContributes;
+	}
+
+bool CAIBehaviorCtx::AddHazardFieldPotential (CShip *pShip, CSpaceObject *pTarget, const CAvoidPotentialField &Field, CVector &iovPotential) const
+
+//	AddHazardFieldPotential
+//
+//	Adds the potential from all hazards (gravity wells and barriers) using the
+//	system's precomputed field for static hazards. Returns TRUE if any hazard
+//	contributed.
+
+	{
+	int i;
+	bool bContributes = Field.GetPotential(pShip->GetPos(), iovPotential);
+
+	//	Hazards that can move are not in the field.
+
+	const TArray<CSpaceObject *> &Dynamic = Field.GetDynamicSources();
+	for (i = 0; i < Dynamic.GetCount(); i++)
+		{
+		CSpaceObject *pObj = Dynamic[i];
+		if (pObj == pShip || pObj == pTarget || pObj->IsDestroyed())
+			continue;
+
+		if (CalcHazardPotential(pObj, pShip->GetPos(), iovPotential))
+			bContributes = true;
+		}
+
+	return bContributes;
+	}
+
+bool CAIBehaviorCtx::ApplyAvoidPotentialParallel (CShip *pShip, CSpaceObject *pTarget)
+
+//	ApplyAvoidPotentialParallel
+//
+//	If CalcAvoidPotentialParallel computed candidates for this tick, and if
+//	nothing they depend on has changed since, we compute m_vPotential from them
+//	and return TRUE. Otherwise we return FALSE and the caller must compute it.
+//
+//	The grid does not change during the behavior loop, so the candidates are
+//	exactly the objects that a serial enumeration would return, in the same
+//	order. We only need to check that none of them moved.
+
+	{
+	int i;
+
+	if (m_iAvoidCandidatesTick != g_pUniverse->GetTicks()
+			|| m_iBarrierClock != -1
+			|| m_rAvoidCandidatesSeparation != GetMinCombatSeparation()
+			|| m_vAvoidCandidatesPos.GetX() != pShip->GetPos().GetX()
+			|| m_vAvoidCandidatesPos.GetY() != pShip->GetPos().GetY())
+		return false;
+
+	//	The candidates only work if CalcAvoidPotential would make the same
+	//	choice about using the hazard field.
+
+	const CAvoidPotentialField &Field = pShip->GetSystem()->GetAvoidPotentialField();
+	bool bUseField = (Field.IsValid() && !Field.IsSource(pTarget));
+	if (bUseField != m_bAvoidCandidatesUseField)
+		return false;
+
+	for (i = 0; i < m_AvoidCandidates.GetCount(); i++)
+		{
+		const SAvoidCandidate &Candidate = m_AvoidCandidates[i];
+		if (Candidate.vPos.GetX() != Candidate.pObj->GetPos().GetX()
+				|| Candidate.vPos.GetY() != Candidate.pObj->GetPos().GetY())
+			return false;
+		}
+
+	//	Add up the potential in the same order as the serial loop.
+
+	m_vPotential = CVector();
+	m_fHasAvoidPotential = false;
+
+	if (bUseField && AddHazardFieldPotential(pShip, pTarget, Field, m_vPotential))
+		m_fHasAvoidPotential = true;
+
+	for (i = 0; i < m_AvoidCandidates.GetCount(); i++)
+		{
+		const SAvoidCandidate &Candidate = m_AvoidCandidates[i];
+		if (!Candidate.bContributes 
+				|| Candidate.pObj == pTarget 
+				|| Candidate.pObj->IsDestroyed())
+			continue;
+
+		m_vPotential = m_vPotential + Candidate.vPotential;
+		m_fHasAvoidPotential = true;
+		}
+
+	return true;
 	}
 
 void CAIBehaviorCtx::CalcAvoidPotential (CShip *pShip, CSpaceObject *pTarget)
@@ -77,6 +247,16 @@ void CAIBehaviorCtx::CalcAvoidPotential (CShip *pShip, CSpaceObject *pTarget)
 	{
 	if (pShip->IsDestinyTime(11))
 		{
+		//	If we've already done the work on a worker thread, then we're done.
+
+		if (ApplyAvoidPotentialParallel(pShip, pTarget))
+			{
+#ifdef DEBUG_AVOID_POTENTIAL
+			pShip->SetDebugVector(m_vPotential);
+#endif
+			return;
+			}
+
 		//	Start with no potential
 
 		m_vPotential = CVector();
@@ -84,13 +264,24 @@ void CAIBehaviorCtx::CalcAvoidPotential (CShip *pShip, CSpaceObject *pTarget)
 
 		//	Set up
 
-		Metric rDist;
 		Metric rMinSeparation2 = GetMinCombatSeparation() * GetMinCombatSeparation();
 		Metric rSeparationForce = g_KlicksPerPixel * 40.0 / GetMinCombatSeparation();
 
 		CSystem *pSystem = pShip->GetSystem();
+
+		//	Usually we get gravity wells and barriers from the system's hazard
+		//	field, so we only need to look for nearby ships. But if we've hit a
+		//	barrier or if we're targeting a hazard, we look at each object.
+
+		const CAvoidPotentialField &Field = pSystem->GetAvoidPotentialField();
+		bool bUseField = (m_iBarrierClock == -1 && Field.IsValid() && !Field.IsSource(pTarget));
+		if (bUseField && AddHazardFieldPotential(pShip, pTarget, Field, m_vPotential))
+			m_fHasAvoidPotential = true;
+
+		Metric rRange = (bUseField ? GetMinCombatSeparation() : Max(GRAVITY_WELL_RANGE, WALL_RANGE));
+
 		SSpaceObjectGridEnumerator i;
-		pSystem->EnumObjectsInBoxStart(i, pShip->GetPos(), Max(GRAVITY_WELL_RANGE, WALL_RANGE), gridNoBoxCheck);
+		pSystem->EnumObjectsInBoxStart(i, pShip->GetPos(), rRange, gridNoBoxCheck);
 
 		while (pSystem->EnumObjectsInBoxHasMore(i))
 			{
@@ -98,93 +289,69 @@ void CAIBehaviorCtx::CalcAvoidPotential (CShip *pShip, CSpaceObject *pTarget)
 
 			if (pObj == NULL || pObj == pShip || pObj == pTarget || pObj->IsDestroyed())
 				NULL;
-			else if (pObj->HasGravity())
-				{
-				CVector vTarget = pObj->GetPos() - pShip->GetPos();
-				Metric rTargetDist2 = vTarget.Dot(vTarget);
+			else if (bUseField && CAvoidPotentialField::IsHazard(pObj))
+				NULL;
+			else if (AddAvoidPotential(pShip, pObj, rMinSeparation2, rSeparationForce, m_vPotential))
+				m_fHasAvoidPotential = true;
+			}
 
-				//	There is a sharp potential away from gravity wells
+#ifdef DEBUG_AVOID_POTENTIAL
+		pShip->SetDebugVector(m_vPotential);
+#endif
+		}
+	}
 
-				if (rTargetDist2 < GRAVITY_WELL_RANGE2)
-					{
-					CVector vTargetN = vTarget.Normal(&rDist);
-					if (rDist > 0.0)
-						{
-						m_vPotential = m_vPotential - (vTargetN * 500.0 * g_KlicksPerPixel * (GRAVITY_WELL_RANGE / rDist));
-						m_fHasAvoidPotential = true;
-						}
-					}
-				}
-			else if (pObj->Blocks(pShip))
-				{
-				CVector vTarget = pObj->GetPos() - pShip->GetPos();
-				Metric rTargetDist2 = vTarget.Dot(vTarget);
+void CAIBehaviorCtx::CalcAvoidPotentialParallel (CShip *pShip)
 
-				//	There is a sharp potential away from walls
+//	CalcAvoidPotentialParallel
+//
+//	Called on a worker thread before the behavior loop. We enumerate the grid
+//	and compute each object's contribution to the avoid potential, but we do
+//	not modify anything other than m_AvoidCandidates. CalcAvoidPotential will
+//	use the result if it is still valid.
 
-				if (rTargetDist2 < WALL_RANGE2)
-					{
-					//	If we've hit a wall, then we need more precise computations because 
-					//	moving aways from the center of the wall might not help.
+	{
+	m_AvoidCandidates.DeleteAll();
+	m_iAvoidCandidatesTick = -1;
 
-					if (m_iBarrierClock != -1)
-						{
-						int iRange;
-						int iAngle;
-						for (iRange = 1; iRange < 8; iRange++)
-							{
-							Metric rRange = g_KlicksPerPixel * iRange * 10.0;
-							Metric rStrength = g_KlicksPerPixel * (8 - iRange) * 10.0;
+	Metric rMinSeparation2 = GetMinCombatSeparation() * GetMinCombatSeparation();
+	Metric rSeparationForce = g_KlicksPerPixel * 40.0 / GetMinCombatSeparation();
 
-							for (iAngle = 0; iAngle < 360; iAngle += 30)
-								{
-								CVector vTest = PolarToVector(iAngle, 1.0);
-								if (pObj->PointInObject(pObj->GetPos(), pShip->GetPos() + (rRange * vTest)))
-									{
-									m_vPotential = m_vPotential - (rStrength * vTest);
-									m_fHasAvoidPotential = true;
-									}
-								}
-							}
-						}
+	CSystem *pSystem = pShip->GetSystem();
 
-					//	Otherwise, move away from the center of the wall
+	//	If the system has a hazard field, we assume that we'll use it (we don't
+	//	know our target yet; ApplyAvoidPotentialParallel checks).
 
-					else
-						{
-						CVector vTargetN = vTarget.Normal(&rDist);
-						if (rDist > 0.0)
-							{
-							m_vPotential = m_vPotential - (vTargetN * 50.0 * g_KlicksPerPixel * (WALL_RANGE / rDist));
-							m_fHasAvoidPotential = true;
-							}
-						}
-					}
-				}
-			else if (pObj->GetCategory() == CSpaceObject::catShip)
-				{
-				CVector vTarget = pObj->GetPos() - pShip->GetPos();
-				Metric rTargetDist2 = vTarget.Dot(vTarget);
+	m_bAvoidCandidatesUseField = pSystem->GetAvoidPotentialField().IsValid();
+	Metric rRange = (m_bAvoidCandidatesUseField ? GetMinCombatSeparation() : Max(GRAVITY_WELL_RANGE, WALL_RANGE));
 
-				//	If we get too close to this ship, then move away
+	SSpaceObjectGridEnumerator i;
+	pSystem->EnumObjectsInBoxStart(i, pShip->GetPos(), rRange, gridNoBoxCheck);
 
-				if (rTargetDist2 < rMinSeparation2)
-					{
-					CVector vTargetN = vTarget.Normal(&rDist);
-					if (rDist > 0.0)
-						{
-						Metric rCloseness = GetMinCombatSeparation() - rDist;
-						m_vPotential = m_vPotential - (vTargetN * rSeparationForce * rCloseness);
-						m_fHasAvoidPotential = true;
-						}
-					}
-				}
-			}
+	while (pSystem->EnumObjectsInBoxHasMore(i))
+		{
+		CSpaceObject *pObj = pSystem->EnumObjectsInBoxGetNextFast(i);
 
-#ifdef DEBUG_AVOID_POTENTIAL
-		pShip->SetDebugVector(m_vPotential);
-#endif
+		//	NOTE: We include destroyed objects and our (future) target because 
+		//	we only know about those later; ApplyAvoidPotentialParallel skips
+		//	them.
+
+		if (pObj == NULL || pObj == pShip)
+			continue;
+
+		if (m_bAvoidCandidatesUseField && CAvoidPotentialField::IsHazard(pObj))
+			continue;
+
+		SAvoidCandidate *pCandidate = m_AvoidCandidates.Insert();
+		pCandidate->pObj = pObj;
+		pCandidate->vPos = pObj->GetPos();
+		pCandidate->vPotential = CVector();
+		pCandidate->bContributes = AddAvoidPotential(pShip, pObj, rMinSeparation2, rSeparationForce, pCandidate->vPotential);
 		}
+
+	m_vAvoidCandidatesPos = pShip->GetPos();
+	m_rAvoidCandidatesSeparation = GetMinCombatSeparation();
+	m_iAvoidCandidatesTick = g_pUniverse->GetTicks();
 	}
 
 void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric rTargetDist2)
@@ -196,6 +363,11 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 //	m_iBestWeapon
 //	m_pBestWeapon
 //	m_rBestWeaponRange
+//
+//	Scores depend on ranges, levels, and damage adjustments that only change
+//	when our loadout or the target changes, so we remember those (see
+//	GetWeaponScore) and only recompute the parts that depend on the moment
+//	(readiness, alignment, distance).
 
 	{
 	int i;
@@ -206,6 +378,24 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 
 		m_rMaxWeaponRange = 0.0;
 
+		//	If the target changed (or its shields went up or down), then our
+		//	remembered scores no longer apply.
+
+		DWORD dwTargetID = (pTarget ? pTarget->GetID() : OBJID_NULL);
+		bool bShieldsUp = (pTarget && pTarget->GetShieldLevel() > 0);
+		bool bTargetThrusts = (pTarget && pTarget->CanThrust());
+		if (!m_fWeaponScoresValid
+				|| dwTargetID != m_dwWeaponScoresTarget
+				|| bShieldsUp != (m_fWeaponScoresShieldsUp ? true : false)
+				|| bTargetThrusts != (m_fWeaponScoresTargetThrusts ? true : false))
+			{
+			m_WeaponScores.DeleteAll();
+			m_dwWeaponScoresTarget = dwTargetID;
+			m_fWeaponScoresShieldsUp = bShieldsUp;
+			m_fWeaponScoresTargetThrusts = bTargetThrusts;
+			m_fWeaponScoresValid = true;
+			}
+
 		Metric rBestRange = g_InfiniteDistance;
 		int iBestWeapon = -1;
 		int iBestWeaponVariant = 0;
@@ -234,7 +424,7 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 				//	Remember the range in case we end up with no good weapons and we need to set 
 				//	a course towards the target.
 
-				Metric rRange = pWeapon->GetClass()->GetMaxEffectiveRange(pShip, pWeapon, pTarget);
+				Metric rRange = GetWeaponScore(pShip, pTarget, i, 0).rTargetRange;
 				if (rRange < rBestRange)
 					rBestRange = rRange;
 
@@ -257,7 +447,7 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 					{
 					case itemcatWeapon:
 						{
-						int iScore = CalcWeaponScore(pShip, pTarget, pWeapon, rTargetDist2);
+						int iScore = CalcWeaponScore(pShip, pTarget, i, 0, rTargetDist2);
 						if (iScore > iBestScore)
 							{
 							iBestWeapon = i;
@@ -265,7 +455,7 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 							iBestScore = iScore;
 							}
 
-						Metric rMaxRange = pWeapon->GetMaxEffectiveRange(pShip);
+						Metric rMaxRange = GetWeaponScore(pShip, pTarget, i, 0).rMaxRange;
 						if (rMaxRange > m_rMaxWeaponRange)
 							m_rMaxWeaponRange = rMaxRange;
 
@@ -287,7 +477,7 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 
 							for (int j = 0; j < iCount; j++)
 								{
-								int iScore = CalcWeaponScore(pShip, pTarget, pWeapon, rTargetDist2);
+								int iScore = CalcWeaponScore(pShip, pTarget, i, j, rTargetDist2);
 
 								//	If we only score 1 and we've got secondary weapons, then don't
 								//	bother with this missile (we don't want to waste it)
@@ -299,7 +489,7 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 									//	Remember the range in case we end up with no good weapons and we need to set 
 									//	a course towards the target.
 
-									Metric rRange = pWeapon->GetClass()->GetMaxEffectiveRange(pShip, pWeapon, pTarget);
+									Metric rRange = GetWeaponScore(pShip, pTarget, i, j).rTargetRange;
 									if (rRange < rBestRange)
 										rBestRange = rRange;
 
@@ -329,7 +519,12 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 
 		if (iBestWeapon != -1)
 			{
+			//	Selecting the weapon tells our controller that the weapon
+			//	status changed, but that does not affect our scores.
+
+			m_fCalcingBestWeapon = true;
 			m_iBestWeapon = pShip->SelectWeapon(iBestWeapon, iBestWeaponVariant);
+			m_fCalcingBestWeapon = false;
 			m_pBestWeapon = pShip->GetNamedDevice(m_iBestWeapon);
 			m_rBestWeaponRange = m_pBestWeapon->GetClass()->GetMaxEffectiveRange(pShip, m_pBestWeapon, pTarget);
 
@@ -368,6 +563,51 @@ void CAIBehaviorCtx::CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric
 		}
 	}
 
+bool CAIBehaviorCtx::CalcHazardPotential (CSpaceObject *pObj, const CVector &vPos, CVector &iovPotential)
+
+//	CalcHazardPotential
+//
+//	Adds the potential at vPos away from the given gravity well or barrier.
+//	Returns TRUE if the hazard contributed. This is also used to build the
+//	system's hazard field (CAvoidPotentialField), so it must not depend on the
+//	ship.
+
+	{
+	Metric rDist;
+	CVector vTarget = pObj->GetPos() - vPos;
+	Metric rTargetDist2 = vTarget.Dot(vTarget);
+
+	//	There is a sharp potential away from gravity wells
+
+	if (pObj->HasGravity())
+		{
+		if (rTargetDist2 >= GRAVITY_WELL_RANGE2)
+			return false;
+
+		CVector vTargetN = vTarget.Normal(&rDist);
+		if (rDist <= 0.0)
+			return false;
+
+		iovPotential = iovPotential - (vTargetN * 500.0 * g_KlicksPerPixel * (GRAVITY_WELL_RANGE / rDist));
+		return true;
+		}
+
+	//	There is a sharp potential away from walls
+
+	else
+		{
+		if (rTargetDist2 >= WALL_RANGE2)
+			return false;
+
+		CVector vTargetN = vTarget.Normal(&rDist);
+		if (rDist <= 0.0)
+			return false;
+
+		iovPotential = iovPotential - (vTargetN * 50.0 * g_KlicksPerPixel * (WALL_RANGE / rDist));
+		return true;
+		}
+	}
+
 void CAIBehaviorCtx::CalcInvariants (CShip *pShip)
 
 //	CalcInvariants
@@ -375,32 +615,25 @@ void CAIBehaviorCtx::CalcInvariants (CShip *pShip)
 //	Calculates some invariant properties of the ship
 
 	{
-	int i;
+	//	Properties that depend only on our class and loadout are shared with
+	//	other ships of the same class and loadout.
 
-	//	Basic properties
-
-	m_fImmobile = (pShip->GetMaxSpeed() == 0.0);
+	CAIShipInvariants *pInvariants = pShip->GetClass()->GetAIInvariants(pShip);
+	if (m_pInvariants)
+		m_pInvariants->Delete();
+	m_pInvariants = pInvariants;
 
 	//	Primary aim range
 
-	Metric rPrimaryRange = pShip->GetWeaponRange(devPrimaryWeapon);
-	Metric rAimRange = (GetFireRangeAdj() * rPrimaryRange) / (100.0 + ((pShip->GetDestiny() % 8) + 4));
+	Metric rAimRange = (GetFireRangeAdj() * m_pInvariants->GetPrimaryRange()) / (100.0 + ((pShip->GetDestiny() % 8) + 4));
 	if (rAimRange < 1.5 * MIN_TARGET_DIST)
 		rAimRange = 1.5 * MIN_TARGET_DIST;
 	m_rPrimaryAimRange2 = rAimRange * rAimRange;
 
-	//	Compute the minimum flanking distance. If we're very maneuverable,
-	//	can get in closer because we can turn faster to adjust for the target's
-	//	motion.
-
-	Metric rDegreesPerTick = Max(1.0, Min(pShip->GetRotationDesc().GetMaxRotationSpeedDegrees(), 60.0));
-	Metric rTanRot = tan(PI * rDegreesPerTick / 180.0);
-	Metric rMinFlankDist = Max(MIN_TARGET_DIST, MAX_TARGET_SPEED / rTanRot);
+	//	Adjust the minimum flanking distance a little based on destiny so we 
+	//	get some variation, even between ships of the same class.
 
-	//	Adjust a little based on destiny so we get some variation, even between
-	//	ships of the same class.
-
-	rMinFlankDist *= 1.0 + (0.5 * (pShip->GetDestiny() / 360.0));
+	Metric rMinFlankDist = m_pInvariants->GetMinFlankDist() * (1.0 + (0.5 * (pShip->GetDestiny() / 360.0)));
 
 	//	And, of course, we can't ever flank outside our weapon range
 
@@ -408,71 +641,28 @@ void CAIBehaviorCtx::CalcInvariants (CShip *pShip)
 
 	//	Max turn count
 
-	int iFullRotationTime = Max(1, pShip->GetRotationDesc().GetMaxRotationTimeTicks());
+	int iFullRotationTime = m_pInvariants->GetFullRotationTime();
 	m_iMaxTurnCount = iFullRotationTime * (1 + (pShip->GetDestiny() % 6));
 
 	//	Chance of premature fire based on turn rate
 
 	m_iPrematureFireChance = (6 * (100 - m_AISettings.GetFireAccuracy())) / iFullRotationTime;
 
-	//	Compute some properties of installed devices
-
-	m_pShields = NULL;
-	m_fSuperconductingShields = false;
-	m_iBestNonLauncherWeaponLevel = 0;
-	m_fHasSecondaryWeapons = false;
-
-	int iPrimaryCount = 0;
-
-	for (i = 0; i < pShip->GetDeviceCount(); i++)
-		{
-		CInstalledDevice *pDevice = pShip->GetDevice(i);
-
-		if (pDevice->IsEmpty() || !pDevice->IsWorking())
-			continue;
-
-		switch (pDevice->GetCategory())
-			{
-			case itemcatWeapon:
-			case itemcatLauncher:
-				{
-				//	Figure out the best non-launcher level
-
-                int iWeaponLevel = pDevice->GetLevel();
-				if (pDevice->GetCategory() != itemcatLauncher
-						&& !pDevice->GetClass()->IsAmmoWeapon()
-						&& iWeaponLevel > m_iBestNonLauncherWeaponLevel)
-					{
-					m_iBestNonLauncherWeaponLevel = iWeaponLevel;
-					}
-
-				//	Secondary
-
-				if (pDevice->IsSecondaryWeapon())
-					m_fHasSecondaryWeapons = true;
-				else if (pDevice->GetCategory() == itemcatWeapon)
-					iPrimaryCount++;
-
-				break;
-				}
+	//	CalcBestWeapon refines these as ammo comes and goes, but it needs a
+	//	starting point.
 
-			case itemcatShields:
-				m_pShields = pDevice;
-				if (pDevice->GetClass()->GetUNID() == g_SuperconductingShieldsUNID)
-					m_fSuperconductingShields = true;
-				break;
-			}
-		}
+	m_iBestNonLauncherWeaponLevel = m_pInvariants->GetBestNonLauncherWeaponLevel();
+	m_fHasSecondaryWeapons = m_pInvariants->HasSecondaryWeapons();
 
 	//	Flags
 
-	m_fHasMultiplePrimaries = (iPrimaryCount > 1);
 	m_fThrustThroughTurn = ((pShip->GetDestiny() % 100) < 50);
 	m_fAvoidExplodingStations = (rAimRange > MIN_STATION_TARGET_DIST);
 
 	//	Weapon
 
 	m_fRecalcBestWeapon = true;
+	m_fWeaponScoresValid = false;
 	CalcBestWeapon(pShip, NULL, 0.0);
 	}
 
@@ -603,10 +793,11 @@ bool CAIBehaviorCtx::CalcNavPath (CShip *pShip, CSpaceObject *pTo)
 	if (pBestObj == NULL)
 		return CalcNavPath(pShip, pTo->GetPos());
 
-	//	Get the appropriate nav path from the system
+	//	Get the appropriate nav path from the system. If it has not been computed
+	//	yet, we fly straight at the destination until the path is ready.
 
 	CSpaceObject *pFrom = pBestObj;
-	CNavigationPath *pPath = pSystem->GetNavPath(pShip->GetSovereign(), pFrom, pTo);
+	CNavigationPath *pPath = pSystem->RequestNavPath(pShip->GetSovereign(), pFrom, pTo);
 
 	//	Done
 
@@ -625,10 +816,11 @@ void CAIBehaviorCtx::CalcNavPath (CShip *pShip, CSpaceObject *pFrom, CSpaceObjec
 	ASSERT(pFrom);
 	ASSERT(pTo);
 
-	//	Get the appropriate nav path from the system
+	//	Get the appropriate nav path from the system (this may be pending; see
+	//	CSystem::RequestNavPath).
 
 	CSystem *pSystem = pShip->GetSystem();
-	CNavigationPath *pPath = pSystem->GetNavPath(pShip->GetSovereign(), pFrom, pTo);
+	CNavigationPath *pPath = pSystem->RequestNavPath(pShip->GetSovereign(), pFrom, pTo);
 
 	//	Done
 
@@ -642,9 +834,19 @@ void CAIBehaviorCtx::CalcNavPath (CShip *pShip, CNavigationPath *pPath, bool bOw
 //	Initializes ship state to follow the given path
 
 	{
-	int i;
-
 	ASSERT(pPath);
+	SetNavPath(pPath, CalcNavPathPos(pShip, pPath), bOwned);
+	}
+
+int CAIBehaviorCtx::CalcNavPathPos (CShip *pShip, CNavigationPath *pPath)
+
+//	CalcNavPathPos
+//
+//	Returns the nav point on the path that we should head for (the one closest
+//	to us).
+
+	{
+	int i;
 
 	//	Figure out which nav position we are closest to
 
@@ -674,7 +876,7 @@ void CAIBehaviorCtx::CalcNavPath (CShip *pShip, CNavigationPath *pPath, bool bOw
 	if (iBestPoint == -1)
 		iBestPoint = 0;
 
-	SetNavPath(pPath, iBestPoint, bOwned);
+	return iBestPoint;
 	}
 
 void CAIBehaviorCtx::CalcShieldState (CShip *pShip)
@@ -684,13 +886,14 @@ void CAIBehaviorCtx::CalcShieldState (CShip *pShip)
 //	Updates m_fWaitForShieldsToRegen
 
 	{
-	if (m_pShields
+	CInstalledDevice *pShields = (m_pInvariants ? m_pInvariants->GetShields(pShip) : NULL);
+	if (pShields
 			&& !NoShieldRetreat()
 			&& pShip->IsDestinyTime(17) 
-			&& !m_fSuperconductingShields)
+			&& !HasSuperconductingShields())
 		{
 		int iHPLeft, iMaxHP;
-		m_pShields->GetStatus(pShip, &iHPLeft, &iMaxHP);
+		pShields->GetStatus(pShip, &iHPLeft, &iMaxHP);
 
 		//	If iMaxHP is 0 then we treat the shields as up. This can happen
 		//	if a ship with (e.g.) hull-plate ionizer gets its armor destroyed
@@ -717,13 +920,14 @@ void CAIBehaviorCtx::CalcShieldState (CShip *pShip)
 		}
 	}
 
-int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInstalledDevice *pWeapon, Metric rTargetDist2)
+int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, int iDevice, int iVariant, Metric rTargetDist2)
 
 //	CalcWeaponScore
 //
-//	Calculates a score for this weapon
+//	Calculates a score for this weapon (with the given variant selected).
 
 	{
+	CInstalledDevice *pWeapon = pShip->GetDevice(iDevice);
 	int iScore = 0;
 
 	//	If this is an EMP weapon adjust the score based on the state of
@@ -733,16 +937,16 @@ int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInsta
 	if (iEffectiveness < 0)
 		return 0;
 
-	//	Get the range of this weapon
+	//	Get the parts of the score that only change when our loadout or the
+	//	target changes.
 
-	Metric rRange2 = pWeapon->GetClass()->GetMaxEffectiveRange(pShip, pWeapon, pTarget);
-	rRange2 *= rRange2;
+	const SWeaponScore &Score = GetWeaponScore(pShip, pTarget, iDevice, iVariant);
 
 	//	If the weapon is out of range of the target then we score 1
 	//	(meaning that it is better than nothing (0) but we would rather any
 	//	other weapon)
 
-	if (rRange2 < rTargetDist2)
+	if (Score.rTargetRange * Score.rTargetRange < rTargetDist2)
 		return 1;
 
 	//	If this weapon will take a while to get ready, then 
@@ -751,25 +955,13 @@ int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInsta
 	if (pWeapon->GetTimeUntilReady() >= 15)
 		return 1;
 
-	//	Get the item for the selected variant (either the weapon
-	//	or the ammo)
-
-	CItemType *pType;
-	pWeapon->GetClass()->GetSelectedVariantInfo(pShip,
-			pWeapon,
-			NULL,
-			NULL,
-			&pType);
-
 	//	Base score is based on the level of the variant
 
-    int iLevel = (pType->IsDevice() ? pWeapon->GetLevel() : pType->GetLevel());
-	iScore += iLevel * 10;
+	iScore += Score.iLevel * 10;
 
 	//	Missiles/ammo count for more
 
-	if (pWeapon->GetCategory() == itemcatLauncher
-			|| pWeapon->GetClass()->IsAmmoWeapon())
+	if (Score.bAmmo)
 		{
 		//	Don't waste missiles on "lesser" targets
 
@@ -777,7 +969,7 @@ int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInsta
 				&& pTarget->GetCategory() == CSpaceObject::catShip
 				&& !pTarget->IsMultiHull()
 				&& pTarget->GetLevel() <= (m_iBestNonLauncherWeaponLevel - 2)
-				&& pTarget->GetLevel() <= (iLevel - 2)
+				&& pTarget->GetLevel() <= (Score.iLevel - 2)
 				&& !pTarget->IsPlayer())
 			return 1;
 
@@ -794,13 +986,12 @@ int CAIBehaviorCtx::CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInsta
 	//	If we have multiple primaries, then include damage type effectiveness against
 	//	the target.
 
-	if (pTarget && m_fHasMultiplePrimaries)
+	if (pTarget && m_pInvariants && m_pInvariants->HasMultiplePrimaries())
 		{
-		int iDamageEffect = pTarget->GetDamageEffectiveness(pShip, pWeapon);
-		if (iDamageEffect < 0)
+		if (Score.iDamageEffect < 0)
 			return 0;
 		else
-			iScore += (iDamageEffect / 10);
+			iScore += (Score.iDamageEffect / 10);
 		}
 
 	//	If this weapon aligned, then prefer this weapon
@@ -895,6 +1086,33 @@ void CAIBehaviorCtx::ClearNavPath (void)
 		}
 	}
 
+void CAIBehaviorCtx::CoastManeuver (CShip *pShip)
+
+//	CoastManeuver
+//
+//	Called on ticks when the ship skips its behavior (see CAILODScheduler). We
+//	keep the controls set by the last behavior, except that we stop turning
+//	once we face the direction that ImplementManeuver picked (and start
+//	thrusting, if it wanted us to).
+
+	{
+	if (GetManeuver() == NoRotation)
+		return;
+
+	//	If we don't know where we were turning to, stop turning rather than
+	//	spin until the next behavior update.
+
+	if (m_iManeuverDir == -1)
+		SetManeuver(NoRotation);
+
+	else if (pShip->GetManeuverToFace(m_iManeuverDir) == NoRotation)
+		{
+		SetManeuver(NoRotation);
+		if (m_fManeuverThrust)
+			SetThrustDir(pShip->GetRotation());
+		}
+	}
+
 void CAIBehaviorCtx::CommunicateWithEscorts (CShip *pShip, MessageTypes iMessage, CSpaceObject *pParam1, DWORD dwParam2)
 
 //	CommunicateWithEscorts
@@ -942,6 +1160,55 @@ void CAIBehaviorCtx::DebugPaintInfo (CG32bitImage &Dest, int x, int y, SViewport
 		m_pNavPath->DebugPaintInfo(Dest, x, y, Ctx.XForm);
 	}
 
+Metric CAIBehaviorCtx::GetHazardRange (CSpaceObject *pObj)
+
+//	GetHazardRange
+//
+//	Returns the distance at which the given gravity well or barrier stops 
+//	contributing to the avoid potential.
+
+	{
+	return (pObj->HasGravity() ? GRAVITY_WELL_RANGE : WALL_RANGE);
+	}
+
+const CAIBehaviorCtx::SWeaponScore &CAIBehaviorCtx::GetWeaponScore (CShip *pShip, CSpaceObject *pTarget, int iDevice, int iVariant)
+
+//	GetWeaponScore
+//
+//	Returns the parts of the weapon score for the given weapon (and selected
+//	variant) that only depend on our loadout and on the target. CalcBestWeapon
+//	clears these when the target changes; our controller clears them when our
+//	weapons change.
+
+	{
+	CInstalledDevice *pWeapon = pShip->GetDevice(iDevice);
+
+	//	Get the item for the selected variant (either the weapon or the ammo).
+	//	If the variant at this position changed (e.g., we ran out of a missile)
+	//	then we need to recompute.
+
+	CItemType *pType;
+	pWeapon->GetClass()->GetSelectedVariantInfo(pShip,
+			pWeapon,
+			NULL,
+			NULL,
+			&pType);
+
+	bool bNew;
+	SWeaponScore *pScore = m_WeaponScores.SetAt(((DWORD)iDevice << 16) | (DWORD)(iVariant & 0xffff), &bNew);
+	if (!bNew && pScore->pVariantType == pType)
+		return *pScore;
+
+	pScore->pVariantType = pType;
+	pScore->iLevel = ((pType == NULL || pType->IsDevice()) ? pWeapon->GetLevel() : pType->GetLevel());
+	pScore->bAmmo = (pWeapon->GetCategory() == itemcatLauncher || pWeapon->GetClass()->IsAmmoWeapon());
+	pScore->rMaxRange = pWeapon->GetMaxEffectiveRange(pShip);
+	pScore->rTargetRange = pWeapon->GetClass()->GetMaxEffectiveRange(pShip, pWeapon, pTarget);
+	pScore->iDamageEffect = (pTarget ? pTarget->GetDamageEffectiveness(pShip, pWeapon) : 100);
+
+	return *pScore;
+	}
+
 bool CAIBehaviorCtx::IsBeingAttacked (int iThreshold) const 
 
 //	IsBeingAttacked
@@ -965,6 +1232,19 @@ bool CAIBehaviorCtx::IsSecondAttack (void) const
 	return (iInterval > MULTI_HIT_WINDOW && iInterval < 3 * ATTACK_TIME_THRESHOLD);
 	}
 
+bool CAIBehaviorCtx::NeedsAvoidPotentialParallel (CShip *pShip)
+
+//	NeedsAvoidPotentialParallel
+//
+//	Returns TRUE if CalcAvoidPotential may need to compute the potential this
+//	tick and we can do the work ahead of time on a worker thread.
+
+	{
+	return (!IsImmobile()
+			&& m_iBarrierClock == -1
+			&& pShip->IsDestinyTime(11));
+	}
+
 void CAIBehaviorCtx::ReadFromStream (SLoadCtx &Ctx)
 
 //	ReadFromStream
@@ -1045,6 +1325,14 @@ void CAIBehaviorCtx::ReadFromStream (SLoadCtx &Ctx)
 	m_fDockingRequested =		((dwLoad & 0x00000001) ? true : false);
 	m_fWaitForShieldsToRegen =	((dwLoad & 0x00000002) ? true : false);
 	m_fHasEscorts =				((dwLoad & 0x00000004) ? true : false);
+	bool bNavPathPending =		((dwLoad & 0x00000008) ? true : false);
+
+	//	If our nav path was pending when we saved, then it was saved with its
+	//	real waypoints, so we need to find our place in it (just as if the path
+	//	service had finished it).
+
+	if (m_pNavPath)
+		m_dwNavPathRevision = m_pNavPath->GetRevision() - (bNavPathPending ? 1 : 0);
 
 	//	These flags do not need to be saved
 
@@ -1116,6 +1404,9 @@ void CAIBehaviorCtx::Update (void)
 
 	if (m_iBarrierClock != -1)
 		m_iBarrierClock--;
+
+	m_iManeuverDir = -1;
+	m_fManeuverThrust = false;
 	}
 
 void CAIBehaviorCtx::WriteToStream (CSystem *pSystem, IWriteStream *pStream)
@@ -1195,5 +1486,6 @@ void CAIBehaviorCtx::WriteToStream (CSystem *pSystem, IWriteStream *pStream)
 	dwSave |= (m_fDockingRequested ?		0x00000001 : 0);
 	dwSave |= (m_fWaitForShieldsToRegen ?	0x00000002 : 0);
 	dwSave |= (m_fHasEscorts ?				0x00000004 : 0);
+	dwSave |= (m_pNavPath && m_pNavPath->IsPending() ?	0x00000008 : 0);
 	pStream->Write((char *)&dwSave, sizeof(DWORD));
 	}
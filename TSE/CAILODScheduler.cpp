@@ -0,0 +1,132 @@
+//	CAILODScheduler.cpp
+//
+//	CAILODScheduler class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const Metric FULL_RATE_DIST =				(1.5 * g_LRSRange);
+const Metric FULL_RATE_DIST2 =				(FULL_RATE_DIST * FULL_RATE_DIST);
+const Metric REDUCED_RATE_DIST =			(600.0 * LIGHT_SECOND);
+const Metric REDUCED_RATE_DIST2 =			(REDUCED_RATE_DIST * REDUCED_RATE_DIST);
+
+const int REDUCED_RATE_CADENCE =			3;
+const int MINIMAL_RATE_CADENCE =			10;
+
+const CG32bitPixel RGB_STATS_TEXT =			CG32bitPixel(255, 255, 0);
+const int STATS_MARGIN =					8;
+
+CAILODScheduler::CAILODScheduler (void) :
+		m_bHasCenter(false)
+
+//	CAILODScheduler constructor
+
+	{
+	}
+
+void CAILODScheduler::BeginUpdate (CSystem &System)
+
+//	BeginUpdate
+//
+//	Called once per system update, before any ship runs its behavior.
+
+	{
+	m_LastStats = m_Stats;
+	m_Stats = SStats();
+
+	//	Distances are measured from the POV, since that is what the player can
+	//	see. If the POV is somewhere else, everyone runs at full rate.
+
+	CSpaceObject *pPOV = g_pUniverse->GetPOV();
+	m_bHasCenter = (pPOV && pPOV->GetSystem() == &System);
+	if (m_bHasCenter)
+		m_vCenter = pPOV->GetPos();
+	}
+
+CAILODScheduler::ELevels CAILODScheduler::CalcLevel (CShip *pShip) const
+
+//	CalcLevel
+//
+//	Returns the level of detail for the given ship.
+
+	{
+	if (!m_bHasCenter)
+		return lodFull;
+
+	//	The controller decides whether it is safe to think less often (e.g., it
+	//	is not fighting or docking).
+
+	if (!pShip->GetController()->CanReduceBehaviorRate())
+		return lodFull;
+
+	Metric rDist2 = (pShip->GetPos() - m_vCenter).Length2();
+	if (rDist2 < FULL_RATE_DIST2)
+		return lodFull;
+	else if (rDist2 < REDUCED_RATE_DIST2)
+		return lodReduced;
+	else
+		return lodMinimal;
+	}
+
+int CAILODScheduler::GetCadence (ELevels iLevel)
+
+//	GetCadence
+//
+//	Returns the number of ticks between behavior updates at the given level.
+
+	{
+	switch (iLevel)
+		{
+		case lodReduced:
+			return REDUCED_RATE_CADENCE;
+
+		case lodMinimal:
+			return MINIMAL_RATE_CADENCE;
+
+		default:
+			return 1;
+		}
+	}
+
+void CAILODScheduler::PaintStats (CG32bitImage &Dest, SViewportPaintCtx &Ctx) const
+
+//	PaintStats
+//
+//	Paints the number of ships at each level (debug overlay).
+
+	{
+	const CG16bitFont &MessageFont = g_pUniverse->GetNamedFont(CUniverse::fontSRSMessage);
+	CString sText = strPatternSubst(CONSTLIT("AI LOD: %d full, %d reduced, %d minimal (%d coasting)"),
+			m_LastStats.iShips[lodFull],
+			m_LastStats.iShips[lodReduced],
+			m_LastStats.iShips[lodMinimal],
+			m_LastStats.iCoasting);
+
+	MessageFont.DrawText(Dest,
+			Ctx.rcView.left + STATS_MARGIN,
+			Ctx.rcView.top + STATS_MARGIN,
+			RGB_STATS_TEXT,
+			sText);
+	}
+
+bool CAILODScheduler::UpdateShip (CShip *pShip)
+
+//	UpdateShip
+//
+//	Returns TRUE if the ship should run its behavior this tick. Otherwise, the
+//	ship should coast. We stagger ships at the same level by their destiny so
+//	that they don't all think on the same tick.
+
+	{
+	ELevels iLevel = CalcLevel(pShip);
+	m_Stats.iShips[iLevel]++;
+
+	int iCadence = GetCadence(iLevel);
+	if (iCadence > 1 && !pShip->IsDestinyTime(iCadence))
+		{
+		m_Stats.iCoasting++;
+		return false;
+		}
+
+	return true;
+	}
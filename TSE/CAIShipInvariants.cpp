@@ -0,0 +1,246 @@
+//	CAIShipInvariants.cpp
+//
+//	CAIShipInvariants class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const Metric MIN_TARGET_DIST =			(5.0 * LIGHT_SECOND);
+
+//	For purposes of computing flanking distance, we assume that our target
+//	won't move faster than this. In practice, it's OK if they do, it just means
+//	that there is a chance we'll be too close to turn properly.
+
+const Metric MAX_TARGET_SPEED =			(0.25 * LIGHT_SPEED);
+
+const DWORD HASH_INIT =					2166136261;
+const DWORD HASH_PRIME =				16777619;
+
+const DWORD KEY_FLAG_WORKING =			0x00000001;
+const DWORD KEY_FLAG_SECONDARY =		0x00000002;
+
+CAIShipInvariants::CAIShipInvariants (CShip *pShip, CAIShipInvariantsCache *pCache, DWORD dwHash) :
+		m_pCache(pCache),
+		m_pNext(NULL),
+		m_dwHash(dwHash),
+		m_iBestNonLauncherWeaponLevel(0),
+		m_iShields(-1),
+		m_bHasMultiplePrimaries(false),
+		m_bHasSecondaryWeapons(false),
+		m_bSuperconductingShields(false),
+		m_dwRefCount(1)
+
+//	CAIShipInvariants constructor
+//
+//	Computes the invariants for the given ship. If pCache is not NULL, we also
+//	remember the key so that other ships can find us.
+
+	{
+	int i;
+
+	if (m_pCache)
+		{
+		m_Key.InsertEmpty(KEY_HEADER_SIZE + pShip->GetDeviceCount() * KEY_DEVICE_SIZE);
+		GetHeaderKey(pShip, &m_Key[0]);
+		for (i = 0; i < pShip->GetDeviceCount(); i++)
+			GetDeviceKey(pShip, pShip->GetDevice(i), &m_Key[KEY_HEADER_SIZE + i * KEY_DEVICE_SIZE]);
+		}
+
+	//	Basic properties
+
+	m_bImmobile = (pShip->GetMaxSpeed() == 0.0);
+	m_rPrimaryRange = pShip->GetWeaponRange(devPrimaryWeapon);
+
+	//	Compute the minimum flanking distance. If we're very maneuverable,
+	//	can get in closer because we can turn faster to adjust for the target's
+	//	motion.
+
+	Metric rDegreesPerTick = Max(1.0, Min(pShip->GetRotationDesc().GetMaxRotationSpeedDegrees(), 60.0));
+	Metric rTanRot = tan(PI * rDegreesPerTick / 180.0);
+	m_rMinFlankDist = Max(MIN_TARGET_DIST, MAX_TARGET_SPEED / rTanRot);
+
+	m_iFullRotationTime = Max(1, pShip->GetRotationDesc().GetMaxRotationTimeTicks());
+
+	//	Compute some properties of installed devices
+
+	int iPrimaryCount = 0;
+
+	for (i = 0; i < pShip->GetDeviceCount(); i++)
+		{
+		CInstalledDevice *pDevice = pShip->GetDevice(i);
+
+		if (pDevice->IsEmpty() || !pDevice->IsWorking())
+			continue;
+
+		switch (pDevice->GetCategory())
+			{
+			case itemcatWeapon:
+			case itemcatLauncher:
+				{
+				//	Figure out the best non-launcher level
+
+				int iWeaponLevel = pDevice->GetLevel();
+				if (pDevice->GetCategory() != itemcatLauncher
+						&& !pDevice->GetClass()->IsAmmoWeapon()
+						&& iWeaponLevel > m_iBestNonLauncherWeaponLevel)
+					{
+					m_iBestNonLauncherWeaponLevel = iWeaponLevel;
+					}
+
+				//	Secondary
+
+				if (pDevice->IsSecondaryWeapon())
+					m_bHasSecondaryWeapons = true;
+				else if (pDevice->GetCategory() == itemcatWeapon)
+					iPrimaryCount++;
+
+				break;
+				}
+
+			case itemcatShields:
+				m_iShields = i;
+				if (pDevice->GetClass()->GetUNID() == g_SuperconductingShieldsUNID)
+					m_bSuperconductingShields = true;
+				break;
+			}
+		}
+
+	m_bHasMultiplePrimaries = (iPrimaryCount > 1);
+	}
+
+bool CAIShipInvariants::CalcHash (CShip *pShip, DWORD *retdwHash)
+
+//	CalcHash
+//
+//	Hashes the key for the ship without storing it. Returns FALSE if the ship
+//	cannot share invariants with other ships.
+
+	{
+	int i, j;
+	DWORD Key[KEY_MAX_SIZE];
+
+	DWORD dwHash = HASH_INIT;
+
+	GetHeaderKey(pShip, Key);
+	for (j = 0; j < KEY_HEADER_SIZE; j++)
+		dwHash = (dwHash ^ Key[j]) * HASH_PRIME;
+
+	for (i = 0; i < pShip->GetDeviceCount(); i++)
+		{
+		CInstalledDevice *pDevice = pShip->GetDevice(i);
+
+		//	Enhancements (from mods, other devices, overlays, or the system)
+		//	can change weapon range, and they are not part of the key. Ships
+		//	with enhanced devices get their own copy.
+
+		const CItemEnhancementStack *pEnhancements = pDevice->GetEnhancementStack();
+		if (pEnhancements && !pEnhancements->IsEmpty())
+			return false;
+
+		GetDeviceKey(pShip, pDevice, Key);
+		for (j = 0; j < KEY_DEVICE_SIZE; j++)
+			dwHash = (dwHash ^ Key[j]) * HASH_PRIME;
+		}
+
+	*retdwHash = dwHash;
+	return true;
+	}
+
+void CAIShipInvariants::Delete (void)
+
+//	Delete
+//
+//	Releases a reference. When the last ship lets go, we leave the cache.
+
+	{
+	if (--m_dwRefCount > 0)
+		return;
+
+	if (m_pCache)
+		m_pCache->Remove(this);
+
+	delete this;
+	}
+
+void CAIShipInvariants::GetDeviceKey (CShip *pShip, CInstalledDevice *pDevice, DWORD *retKey)
+
+//	GetDeviceKey
+//
+//	Returns the part of the key for one device slot (KEY_DEVICE_SIZE DWORDs).
+//	The weapon range depends on the item level, charges and selected variant;
+//	everything else that we compute depends only on the device class and its
+//	flags.
+
+	{
+	if (pDevice->IsEmpty())
+		{
+		utlMemSet(retKey, KEY_DEVICE_SIZE * sizeof(DWORD), 0);
+		return;
+		}
+
+	retKey[0] = pDevice->GetUNID();
+	retKey[1] = (DWORD)pDevice->GetLevel();
+	retKey[2] = (DWORD)pDevice->GetCharges(pShip);
+	retKey[3] = pDevice->GetData();
+	retKey[4] = (pDevice->IsWorking() ? KEY_FLAG_WORKING : 0)
+			| (pDevice->IsSecondaryWeapon() ? KEY_FLAG_SECONDARY : 0);
+	}
+
+void CAIShipInvariants::GetHeaderKey (CShip *pShip, DWORD *retKey)
+
+//	GetHeaderKey
+//
+//	Returns the part of the key for the ship as a whole (KEY_HEADER_SIZE
+//	DWORDs). We take speed and rotation from the ship's performance, which
+//	already accounts for armor, devices, mass and damage.
+
+	{
+	const CIntegralRotationDesc &Rotation = pShip->GetRotationDesc();
+
+	retKey[0] = (pShip->GetMaxSpeed() == 0.0 ? 1 : 0);
+	retKey[1] = (DWORD)Rotation.GetMaxRotationSpeed();
+	retKey[2] = (DWORD)Rotation.GetFrameCount();
+	retKey[3] = (DWORD)pShip->GetDeviceSystem()->GetNamedIndex(devPrimaryWeapon);
+	retKey[4] = (DWORD)pShip->GetDeviceCount();
+	}
+
+CInstalledDevice *CAIShipInvariants::GetShields (CShip *pShip) const
+
+//	GetShields
+//
+//	Returns the ship's shields (or NULL).
+
+	{
+	return (m_iShields != -1 ? pShip->GetDevice(m_iShields) : NULL);
+	}
+
+bool CAIShipInvariants::Matches (CShip *pShip) const
+
+//	Matches
+//
+//	Returns TRUE if we were computed for a ship with the same key.
+
+	{
+	int i, j;
+	DWORD Key[KEY_MAX_SIZE];
+
+	if (m_Key.GetCount() != KEY_HEADER_SIZE + pShip->GetDeviceCount() * KEY_DEVICE_SIZE)
+		return false;
+
+	GetHeaderKey(pShip, Key);
+	for (j = 0; j < KEY_HEADER_SIZE; j++)
+		if (Key[j] != m_Key[j])
+			return false;
+
+	for (i = 0; i < pShip->GetDeviceCount(); i++)
+		{
+		GetDeviceKey(pShip, pShip->GetDevice(i), Key);
+
+		int iStart = KEY_HEADER_SIZE + i * KEY_DEVICE_SIZE;
+		for (j = 0; j < KEY_DEVICE_SIZE; j++)
+			if (Key[j] != m_Key[iStart + j])
+				return false;
+		}
+
+	return true;
+	}
@@ -0,0 +1,94 @@
+//	CAIShipInvariantsCache.cpp
+//
+//	CAIShipInvariantsCache class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+void CAIShipInvariantsCache::CleanUp (void)
+
+//	CleanUp
+//
+//	Forgets all entries. Entries still held by ships stay valid; they are freed
+//	when the last ship releases them.
+
+	{
+	int i;
+
+	for (i = 0; i < m_Entries.GetCount(); i++)
+		{
+		CAIShipInvariants *pEntry = m_Entries.GetValue(i);
+		while (pEntry)
+			{
+			CAIShipInvariants *pNext = pEntry->m_pNext;
+			pEntry->m_pCache = NULL;
+			pEntry->m_pNext = NULL;
+			pEntry = pNext;
+			}
+		}
+
+	m_Entries.DeleteAll();
+	}
+
+CAIShipInvariants *CAIShipInvariantsCache::Get (CShip *pShip)
+
+//	Get
+//
+//	Returns invariants for the given ship (which must be of our class). The
+//	caller must call Delete on the result.
+
+	{
+	DWORD dwHash;
+	if (!CAIShipInvariants::CalcHash(pShip, &dwHash))
+		return new CAIShipInvariants(pShip, NULL, 0);
+
+	//	Look for a ship with the same loadout
+
+	CAIShipInvariants **ppFirst = m_Entries.GetAt(dwHash);
+	if (ppFirst)
+		{
+		for (CAIShipInvariants *pEntry = *ppFirst; pEntry; pEntry = pEntry->m_pNext)
+			if (pEntry->Matches(pShip))
+				return pEntry->AddRef();
+		}
+
+	//	Otherwise, add a new entry
+
+	CAIShipInvariants *pEntry = new CAIShipInvariants(pShip, this, dwHash);
+	pEntry->m_pNext = (ppFirst ? *ppFirst : NULL);
+	m_Entries.SetAt(dwHash, pEntry);
+
+	return pEntry;
+	}
+
+void CAIShipInvariantsCache::Remove (CAIShipInvariants *pEntry)
+
+//	Remove
+//
+//	Removes the entry from the cache.
+
+	{
+	CAIShipInvariants **ppFirst = m_Entries.GetAt(pEntry->m_dwHash);
+	if (ppFirst == NULL)
+		return;
+
+	if (*ppFirst == pEntry)
+		{
+		if (pEntry->m_pNext)
+			*ppFirst = pEntry->m_pNext;
+		else
+			m_Entries.DeleteAt(pEntry->m_dwHash);
+		}
+	else
+		{
+		CAIShipInvariants *pPrev = *ppFirst;
+		while (pPrev->m_pNext && pPrev->m_pNext != pEntry)
+			pPrev = pPrev->m_pNext;
+
+		if (pPrev->m_pNext == pEntry)
+			pPrev->m_pNext = pEntry->m_pNext;
+		}
+
+	pEntry->m_pCache = NULL;
+	pEntry->m_pNext = NULL;
+	}
@@ -9,12 +9,15 @@ const int ADJACENT_NODE_AXIS_COST =						8;
 const int ADJACENT_NODE_DIAG_COST =						(int)((1.4142 * ADJACENT_NODE_AXIS_COST) + 0.5);
 const Metric ADJACENT_NODE_DIST =						(ADJACENT_NODE_AXIS_COST * LIGHT_SECOND);
 
-const int MAP_SIZE =									30;
-const int MAP_SCALE =									2;
-const int MAP_OFFSET_X =								450;
-const int MAP_OFFSET_Y =								450;
+const DWORD NODE_OPEN_FLAG =							0x01;
+const DWORD NODE_CLOSED_FLAG =							0x02;
+const DWORD NODE_BLOCKED_FLAG =							0x04;
 
-const DWORD MAP_NODE_CLOSED_FLAG =						0x01;
+const int NODES_PER_BLOCK =								1024;
+const int INITIAL_INDEX_SIZE =							1024;
+
+const int MAX_OBSTACLE_GRID_SIZE =						64;
+const Metric MIN_OBSTACLE_CELL_SIZE =					(32.0 * LIGHT_SECOND);
 
 //	5000 loops is too small for some scenarios (including Arena)
 //	So we set the limit to 10000.
@@ -24,10 +27,23 @@ const int ADJACENT_NODE_COUNT =							8;
 static int ADJACENT_NODE_DIR_X[] = { -1,  0, +1, -1, +1, -1,  0, +1 };
 static int ADJACENT_NODE_DIR_Y[] = { -1, -1, -1,  0,  0, +1, +1, +1 };
 
+inline DWORD PackNodeKey (int x, int y) { return ((((DWORD)x) & 0xffff) << 16) | (((DWORD)y) & 0xffff); }
+inline DWORD HashNodeKey (DWORD dwKey) { return (dwKey * 2654435761u) >> 8; }
+
 CAStarPathFinder::CAStarPathFinder (void) :
-		m_pOpenList(NULL),
-		m_pClosedList(NULL),
-		m_pClosedMap(NULL)
+		m_bObstacleIndexValid(false),
+		m_xMin(0.0),
+		m_yMin(0.0),
+		m_xMax(0.0),
+		m_yMax(0.0),
+		m_rCellSize(MIN_OBSTACLE_CELL_SIZE),
+		m_cxCells(0),
+		m_cyCells(0),
+		m_dwMark(0),
+		m_iIndexCount(0),
+		m_iNextBlock(0),
+		m_iNextNode(0),
+		m_dwNextSeq(0)
 
 //	CAStarPathFinder constructor
 
@@ -44,11 +60,8 @@ CAStarPathFinder::~CAStarPathFinder (void)
 //	CAStarPathFinder destructor
 
 	{
-	DeleteList(m_pOpenList);
-	DeleteList(m_pClosedList);
-
-	if (m_pClosedMap)
-		delete m_pClosedMap;
+	for (int i = 0; i < m_NodeBlocks.GetCount(); i++)
+		delete [] m_NodeBlocks[i];
 	}
 
 void CAStarPathFinder::AddObstacle (const CVector &vUR, const CVector &vLL)
@@ -61,6 +74,8 @@ void CAStarPathFinder::AddObstacle (const CVector &vUR, const CVector &vLL)
 	SObstacle *pObstacle = m_Obstacles.Insert();
 	pObstacle->vLL = vLL;
 	pObstacle->vUR = vUR;
+
+	m_bObstacleIndexValid = false;
 	}
 
 void CAStarPathFinder::AddToClosedList (SNode *pNew)
@@ -70,64 +85,62 @@ void CAStarPathFinder::AddToClosedList (SNode *pNew)
 //	Add a node to the closed list
 
 	{
-	AddToList(m_pClosedList, pNew);
-
-	int x = pNew->x + MAP_OFFSET_X;
-	int y = pNew->y + MAP_OFFSET_Y;
-	DWORD dwFlags = m_pClosedMap->GetTile(x, y);
-	m_pClosedMap->SetTile(x, y, dwFlags | MAP_NODE_CLOSED_FLAG);
+	SetNodeFlags(pNew->x, pNew->y, NODE_CLOSED_FLAG);
 
 #ifdef DEBUG_ASTAR_PERF
 	m_iClosedListCount++;
 #endif
 	}
 
-void CAStarPathFinder::AddToList (SNodeRoot &pRoot, SNode *pNew, SNode *pAddAfter)
+void CAStarPathFinder::AddToOpenList (SNode *pNew)
 
-//	AddToList
+//	AddToOpenList
 //
-//	Adds to a list
+//	Adds a new node to the open list. Nodes with the same total cost come out
+//	in the order in which they were added.
 
 	{
-	if (pAddAfter == NULL)
-		{
-		pNew->pNext = pRoot;
-		pNew->pPrev = NULL;
-		pRoot = pNew;
-		}
-	else
+	pNew->dwSeq = m_dwNextSeq++;
+	SetNodeFlags(pNew->x, pNew->y, NODE_OPEN_FLAG);
+
+	//	Sift up
+
+	int iPos = m_OpenList.GetCount();
+	m_OpenList.Insert(pNew);
+	while (iPos > 0)
 		{
-		pNew->pNext = pAddAfter->pNext;
-		pNew->pPrev = pAddAfter;
-		pAddAfter->pNext = pNew;
+		int iParent = (iPos - 1) / 2;
+		if (!IsBefore(pNew, m_OpenList[iParent]))
+			break;
+
+		m_OpenList[iPos] = m_OpenList[iParent];
+		iPos = iParent;
 		}
+
+	m_OpenList[iPos] = pNew;
+
+#ifdef DEBUG_ASTAR_PERF
+	m_iOpenListCount++;
+#endif
 	}
 
-void CAStarPathFinder::AddToOpenList (SNode *pNew)
+CAStarPathFinder::SNode *CAStarPathFinder::AllocNode (void)
 
-//	AddToOpenList
+//	AllocNode
 //
-//	Adds a new node to the open list
+//	Allocates a node from our arena. Nodes stay valid until the next Reset.
 
 	{
-	//	Figure out where to insert the new node (so that
-	//	the list is in total cost order)
-
-	SNode *pNext = m_pOpenList;
-	SNode *pPrev = NULL;
-	while (pNext && pNext->iTotalCost <= pNew->iTotalCost)
+	if (m_iNextNode == NODES_PER_BLOCK)
 		{
-		pPrev = pNext;
-		pNext = pNext->pNext;
+		m_iNextBlock++;
+		m_iNextNode = 0;
 		}
 
-	//	Insert
-
-	AddToList(m_pOpenList, pNew, pPrev);
+	if (m_iNextBlock == m_NodeBlocks.GetCount())
+		m_NodeBlocks.Insert(new SNode [NODES_PER_BLOCK]);
 
-#ifdef DEBUG_ASTAR_PERF
-	m_iOpenListCount++;
-#endif
+	return &m_NodeBlocks[m_iNextBlock][m_iNextNode++];
 	}
 
 int CAStarPathFinder::CalcHeuristic (const CVector &vPos, const CVector &vDest)
@@ -177,34 +190,28 @@ void CAStarPathFinder::CreateInOpenList (const CVector &vEnd, SNode *pCurrent, i
 	int x = pCurrent->x + xDir;
 	int y = pCurrent->y + yDir;
 
-	//	If this node is in the closed list, then bail
+	//	If this node is in the open or closed list, or if we already know that
+	//	it is blocked, then bail.
 
-	if (IsInClosedList(x, y))
+	if (GetNodeFlags(x, y))
 		return;
 
-	//	If this node is in the open list, then bail
-
-	SNode *pNext = m_pOpenList;
-	while (pNext)
-		{
-		if (pNext->x == x && pNext->y == y)
-			return;
-
-		pNext = pNext->pNext;
-		}
-
 	//	Compute the position of the new node
 
 	CVector vPos = pCurrent->vPos + CVector(xDir * ADJACENT_NODE_DIST, yDir * ADJACENT_NODE_DIST);
 
-	//	See if the node is blocked
+	//	See if the node is blocked. Obstacles don't change during a search, so
+	//	we remember the answer.
 
 	if (!IsPointClear(vPos))
+		{
+		SetNodeFlags(x, y, NODE_BLOCKED_FLAG);
 		return;
+		}
 
 	//	Create a new node
 
-	SNode *pNew = new SNode;
+	SNode *pNew = AllocNode();
 	pNew->x = x;
 	pNew->y = y;
 	pNew->vPos = vPos;
@@ -218,48 +225,6 @@ void CAStarPathFinder::CreateInOpenList (const CVector &vEnd, SNode *pCurrent, i
 	AddToOpenList(pNew);
 	}
 
-void CAStarPathFinder::DeleteFromList (SNodeRoot &pRoot, SNode *pDelete)
-
-//	DeleteFromList
-//
-//	Delete from a list (note: we do not free the node)
-
-	{
-	if (pDelete->pPrev == NULL)
-		{
-		pRoot = pDelete->pNext;
-		if (pRoot)
-			pRoot->pPrev = NULL;
-		}
-	else
-		{
-		pDelete->pPrev->pNext = pDelete->pNext;
-		if (pDelete->pNext)
-			pDelete->pNext->pPrev = pDelete->pPrev;
-		}
-
-	pDelete->pNext = NULL;
-	pDelete->pPrev = NULL;
-	}
-
-void CAStarPathFinder::DeleteList (SNodeRoot &pRoot)
-
-//	DeleteList
-//
-//	Deletes the given list
-
-	{
-	SNode *pNext = pRoot;
-	while (pNext)
-		{
-		SNode *pDelete = pNext;
-		pNext = pNext->pNext;
-		delete pDelete;
-		}
-
-	pRoot = NULL;
-	}
-
 int CAStarPathFinder::FindPath (const CVector &vStart, const CVector &vEnd, CVector **retPathList, bool bTryReverse)
 
 //	FindPath
@@ -276,10 +241,12 @@ int CAStarPathFinder::FindPath (const CVector &vStart, const CVector &vEnd, CVec
 	//	Initialize the open list and closed map
 
 	Reset();
+	if (!m_bObstacleIndexValid)
+		InitObstacleIndex();
 
 	//	Start with a node at the start position
 
-	SNode *pStart = new SNode;
+	SNode *pStart = AllocNode();
 	pStart->x = 0;
 	pStart->y = 0;
 	pStart->vPos = vStart;
@@ -293,9 +260,9 @@ int CAStarPathFinder::FindPath (const CVector &vStart, const CVector &vEnd, CVec
 	//	Loop
 
 	int iLoopCount = 0;
-	while (m_pOpenList)
+	while (m_OpenList.GetCount() > 0)
 		{
-		SNode *pCurrent = m_pOpenList;
+		SNode *pCurrent = m_OpenList[0];
 
 		//	Are we there yet?
 
@@ -350,7 +317,7 @@ int CAStarPathFinder::FindPath (const CVector &vStart, const CVector &vEnd, CVec
 			{
 			//	Move to closed list
 
-			DeleteFromList(m_pOpenList, pCurrent);
+			PopOpenList();
 #ifdef DEBUG_ASTAR_PERF
 			m_iOpenListCount--;
 #endif
@@ -376,15 +343,143 @@ int CAStarPathFinder::FindPath (const CVector &vStart, const CVector &vEnd, CVec
 	return -1;
 	}
 
-bool CAStarPathFinder::IsInClosedList (int x, int y)
+DWORD CAStarPathFinder::GetNodeFlags (int x, int y) const
+
+//	GetNodeFlags
+//
+//	Returns the state of the node at the given coordinates (0 if we've never
+//	seen it).
+
+	{
+	DWORD dwKey = PackNodeKey(x, y);
+	int iMask = m_Index.GetCount() - 1;
+	int iSlot = HashNodeKey(dwKey) & iMask;
+
+	while (m_Index[iSlot].dwFlags)
+		{
+		if (m_Index[iSlot].dwKey == dwKey)
+			return m_Index[iSlot].dwFlags;
+
+		iSlot = (iSlot + 1) & iMask;
+		}
+
+	return 0;
+	}
+
+void CAStarPathFinder::GrowIndex (void)
+
+//	GrowIndex
+//
+//	Doubles the size of the node index and rehashes.
+
+	{
+	int i;
+
+	TArray<SIndexEntry> OldIndex = m_Index;
+
+	m_Index.DeleteAll();
+	m_Index.InsertEmpty(OldIndex.GetCount() * 2);
+	for (i = 0; i < m_Index.GetCount(); i++)
+		m_Index[i].dwFlags = 0;
+
+	int iMask = m_Index.GetCount() - 1;
+	for (i = 0; i < OldIndex.GetCount(); i++)
+		{
+		if (OldIndex[i].dwFlags == 0)
+			continue;
+
+		int iSlot = HashNodeKey(OldIndex[i].dwKey) & iMask;
+		while (m_Index[iSlot].dwFlags)
+			iSlot = (iSlot + 1) & iMask;
+
+		m_Index[iSlot] = OldIndex[i];
+		}
+	}
+
+void CAStarPathFinder::InitObstacleIndex (void)
 
-//	IsInClosedList
+//	InitObstacleIndex
 //
-//	Returns TRUE if these coordinates are in the closed list
+//	Buckets the obstacles into a coarse grid covering their bounding box so
+//	that point and segment tests only look at nearby obstacles.
 
 	{
-	DWORD dwFlags = m_pClosedMap->GetTile(x + MAP_OFFSET_X, y + MAP_OFFSET_Y);
-	return (dwFlags & MAP_NODE_CLOSED_FLAG ? true : false);
+	int i, x, y;
+
+	m_CellStart.DeleteAll();
+	m_CellObstacles.DeleteAll();
+	m_ObstacleMark.DeleteAll();
+	m_cxCells = 0;
+	m_cyCells = 0;
+	m_bObstacleIndexValid = true;
+
+	if (m_Obstacles.GetCount() == 0)
+		return;
+
+	//	Compute the bounds
+
+	m_xMin = m_Obstacles[0].vLL.GetX();
+	m_yMin = m_Obstacles[0].vLL.GetY();
+	m_xMax = m_Obstacles[0].vUR.GetX();
+	m_yMax = m_Obstacles[0].vUR.GetY();
+	for (i = 1; i < m_Obstacles.GetCount(); i++)
+		{
+		m_xMin = Min(m_xMin, m_Obstacles[i].vLL.GetX());
+		m_yMin = Min(m_yMin, m_Obstacles[i].vLL.GetY());
+		m_xMax = Max(m_xMax, m_Obstacles[i].vUR.GetX());
+		m_yMax = Max(m_yMax, m_Obstacles[i].vUR.GetY());
+		}
+
+	m_rCellSize = Max(MIN_OBSTACLE_CELL_SIZE, Max(m_xMax - m_xMin, m_yMax - m_yMin) / MAX_OBSTACLE_GRID_SIZE);
+	m_cxCells = (int)((m_xMax - m_xMin) / m_rCellSize) + 1;
+	m_cyCells = (int)((m_yMax - m_yMin) / m_rCellSize) + 1;
+
+	//	Count the obstacles in each cell (offset by one so that we can turn the
+	//	counts into start indices in place).
+
+	int iCellCount = m_cxCells * m_cyCells;
+	m_CellStart.InsertEmpty(iCellCount + 1);
+	for (i = 0; i < m_CellStart.GetCount(); i++)
+		m_CellStart[i] = 0;
+
+	for (i = 0; i < m_Obstacles.GetCount(); i++)
+		{
+		int x1 = GetCellX(m_Obstacles[i].vLL.GetX());
+		int x2 = GetCellX(m_Obstacles[i].vUR.GetX());
+		int y1 = GetCellY(m_Obstacles[i].vLL.GetY());
+		int y2 = GetCellY(m_Obstacles[i].vUR.GetY());
+
+		for (y = y1; y <= y2; y++)
+			for (x = x1; x <= x2; x++)
+				m_CellStart[y * m_cxCells + x + 1]++;
+		}
+
+	for (i = 1; i < m_CellStart.GetCount(); i++)
+		m_CellStart[i] += m_CellStart[i - 1];
+
+	//	Fill
+
+	TArray<int> Next;
+	Next.InsertEmpty(iCellCount);
+	for (i = 0; i < iCellCount; i++)
+		Next[i] = m_CellStart[i];
+
+	m_CellObstacles.InsertEmpty(m_CellStart[iCellCount]);
+	for (i = 0; i < m_Obstacles.GetCount(); i++)
+		{
+		int x1 = GetCellX(m_Obstacles[i].vLL.GetX());
+		int x2 = GetCellX(m_Obstacles[i].vUR.GetX());
+		int y1 = GetCellY(m_Obstacles[i].vLL.GetY());
+		int y2 = GetCellY(m_Obstacles[i].vUR.GetY());
+
+		for (y = y1; y <= y2; y++)
+			for (x = x1; x <= x2; x++)
+				m_CellObstacles[Next[y * m_cxCells + x]++] = i;
+		}
+
+	m_ObstacleMark.InsertEmpty(m_Obstacles.GetCount());
+	for (i = 0; i < m_ObstacleMark.GetCount(); i++)
+		m_ObstacleMark[i] = m_dwMark;
 	}
 
 bool CAStarPathFinder::IsPathClear (const CVector &vStart, const CVector &vEnd)
@@ -394,18 +489,63 @@ bool CAStarPathFinder::IsPathClear (const CVector &vStart, const CVector &vEnd)
 //	Returns TRUE if the straight path from vStart to vEnd is unobstructed
 
 	{
-	int i;
+	int i, j, k;
 
 #ifdef DEBUG_ASTAR_PERF
 	m_iCallsToIsPathClear++;
 #endif
 
-	//	Check to see if the line intersects any of the obstacles
+	//	If the segment misses the obstacle grid entirely, then it is clear.
 
-	for (i = 0; i < m_Obstacles.GetCount(); i++)
+	Metric xLo = Min(vStart.GetX(), vEnd.GetX());
+	Metric xHi = Max(vStart.GetX(), vEnd.GetX());
+	Metric yLo = Min(vStart.GetY(), vEnd.GetY());
+	Metric yHi = Max(vStart.GetY(), vEnd.GetY());
+	if (m_cxCells == 0 || xHi < m_xMin || xLo > m_xMax || yHi < m_yMin || yLo > m_yMax)
+		return true;
+
+	//	Walk the rows of cells that the segment crosses. In each row we only
+	//	visit the cells covered by the part of the segment inside the row (plus
+	//	one cell on each side, so rounding never skips an obstacle). Each
+	//	obstacle is tested at most once.
+
+	m_dwMark++;
+	Metric dx = vEnd.GetX() - vStart.GetX();
+	Metric dy = vEnd.GetY() - vStart.GetY();
+	int yFirst = Max(0, GetCellY(yLo) - 1);
+	int yLast = Min(m_cyCells - 1, GetCellY(yHi) + 1);
+
+	for (i = yFirst; i <= yLast; i++)
 		{
-		if (LineIntersectsRect(vStart, vEnd, m_Obstacles[i].vUR, m_Obstacles[i].vLL))
-			return false;
+		Metric xRowLo = xLo;
+		Metric xRowHi = xHi;
+		if (dy != 0.0)
+			{
+			Metric t1 = Max(0.0, Min(1.0, (m_yMin + i * m_rCellSize - vStart.GetY()) / dy));
+			Metric t2 = Max(0.0, Min(1.0, (m_yMin + (i + 1) * m_rCellSize - vStart.GetY()) / dy));
+			Metric x1 = vStart.GetX() + t1 * dx;
+			Metric x2 = vStart.GetX() + t2 * dx;
+			xRowLo = Min(x1, x2);
+			xRowHi = Max(x1, x2);
+			}
+
+		int xFirst = Max(0, GetCellX(xRowLo) - 1);
+		int xLast = Min(m_cxCells - 1, GetCellX(xRowHi) + 1);
+
+		for (j = xFirst; j <= xLast; j++)
+			{
+			int iCell = i * m_cxCells + j;
+			for (k = m_CellStart[iCell]; k < m_CellStart[iCell + 1]; k++)
+				{
+				int iObstacle = m_CellObstacles[k];
+				if (m_ObstacleMark[iObstacle] == m_dwMark)
+					continue;
+
+				m_ObstacleMark[iObstacle] = m_dwMark;
+				if (LineIntersectsRect(vStart, vEnd, m_Obstacles[iObstacle].vUR, m_Obstacles[iObstacle].vLL))
+					return false;
+				}
+			}
 		}
 
 	return true;
@@ -420,11 +560,18 @@ bool CAStarPathFinder::IsPointClear (const CVector &vPos)
 	{
 	int i;
 
-	//	Check to see if the line intersects any of the obstacles
+	if (m_cxCells == 0
+			|| vPos.GetX() < m_xMin || vPos.GetX() > m_xMax
+			|| vPos.GetY() < m_yMin || vPos.GetY() > m_yMax)
+		return true;
 
-	for (i = 0; i < m_Obstacles.GetCount(); i++)
+	//	Only obstacles that overlap the point's cell can contain it.
+
+	int iCell = GetCellY(vPos.GetY()) * m_cxCells + GetCellX(vPos.GetX());
+	for (i = m_CellStart[iCell]; i < m_CellStart[iCell + 1]; i++)
 		{
-		if (IntersectRect(m_Obstacles[i].vUR, m_Obstacles[i].vLL, vPos))
+		const SObstacle &Obstacle = m_Obstacles[m_CellObstacles[i]];
+		if (IntersectRect(Obstacle.vUR, Obstacle.vLL, vPos))
 			return false;
 		}
 
@@ -509,17 +656,98 @@ int CAStarPathFinder::OptimizePath (const CVector &vEnd, SNode *pFinal, CVector
 	return iCount;
 	}
 
+CAStarPathFinder::SNode *CAStarPathFinder::PopOpenList (void)
+
+//	PopOpenList
+//
+//	Removes and returns the best node in the open list.
+
+	{
+	SNode *pBest = m_OpenList[0];
+	SNode *pLast = m_OpenList[m_OpenList.GetCount() - 1];
+	m_OpenList.Delete(m_OpenList.GetCount() - 1);
+
+	int iCount = m_OpenList.GetCount();
+	if (iCount > 0)
+		{
+		//	Sift the last node down from the root
+
+		int iPos = 0;
+		while (true)
+			{
+			int iChild = 2 * iPos + 1;
+			if (iChild >= iCount)
+				break;
+
+			if (iChild + 1 < iCount && IsBefore(m_OpenList[iChild + 1], m_OpenList[iChild]))
+				iChild++;
+
+			if (!IsBefore(m_OpenList[iChild], pLast))
+				break;
+
+			m_OpenList[iPos] = m_OpenList[iChild];
+			iPos = iChild;
+			}
+
+		m_OpenList[iPos] = pLast;
+		}
+
+	return pBest;
+	}
+
 void CAStarPathFinder::Reset (void)
 
 //	Reset
 //
-//	Resets internal variables
+//	Resets internal variables. We keep our node blocks and index allocation so
+//	that repeated searches don't hit the allocator.
 
 	{
-	DeleteList(m_pOpenList);
-	DeleteList(m_pClosedList);
-	if (m_pClosedMap)
-		delete m_pClosedMap;
+	int i;
+
+	m_OpenList.DeleteAll();
+
+	m_iNextBlock = 0;
+	m_iNextNode = 0;
+	m_dwNextSeq = 0;
+
+	if (m_Index.GetCount() == 0)
+		m_Index.InsertEmpty(INITIAL_INDEX_SIZE);
+
+	for (i = 0; i < m_Index.GetCount(); i++)
+		m_Index[i].dwFlags = 0;
+
+	m_iIndexCount = 0;
+	}
+
+void CAStarPathFinder::SetNodeFlags (int x, int y, DWORD dwFlags)
+
+//	SetNodeFlags
+//
+//	Sets the state of the node at the given coordinates.
+
+	{
+	//	Keep the index at most half full so that probes stay short.
+
+	if (2 * (m_iIndexCount + 1) > m_Index.GetCount())
+		GrowIndex();
+
+	DWORD dwKey = PackNodeKey(x, y);
+	int iMask = m_Index.GetCount() - 1;
+	int iSlot = HashNodeKey(dwKey) & iMask;
+
+	while (m_Index[iSlot].dwFlags)
+		{
+		if (m_Index[iSlot].dwKey == dwKey)
+			{
+			m_Index[iSlot].dwFlags = dwFlags;
+			return;
+			}
+
+		iSlot = (iSlot + 1) & iMask;
+		}
 
-	m_pClosedMap = new CTileMap(MAP_SIZE, MAP_SCALE);
+	m_Index[iSlot].dwKey = dwKey;
+	m_Index[iSlot].dwFlags = dwFlags;
+	m_iIndexCount++;
 	}
@@ -0,0 +1,223 @@
+//	CAttributeSet.cpp
+//
+//	CAttributeSet class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+static TSortMap<CString, DWORD> g_AttributeAtoms;
+
+DWORD CAttributeSet::Atomize (const CString &sAttrib)
+
+//	Atomize
+//
+//	Returns the atom for the given attribute, adding it to the table if
+//	necessary. Atoms start at 1.
+
+	{
+	bool bNew;
+	DWORD *pAtom = g_AttributeAtoms.SetAt(strToLower(sAttrib), &bNew);
+	if (bNew)
+		*pAtom = (DWORD)g_AttributeAtoms.GetCount();
+
+	return *pAtom;
+	}
+
+bool CAttributeSet::FindAtom (const CString &sAttrib, DWORD *retdwAtom)
+
+//	FindAtom
+//
+//	Looks up the atom for the given attribute without adding it to the table.
+//	Returns FALSE if nothing has ever used the attribute (in which case no set
+//	can have it).
+
+	{
+	//	Attributes are almost always lowercase already, so we only allocate a 
+	//	lowercase copy if we need to.
+
+	const DWORD *pAtom = NULL;
+	char *pPos = sAttrib.GetASCIIZPointer();
+	while (*pPos != '\0' && !(*pPos >= 'A' && *pPos <= 'Z'))
+		pPos++;
+
+	if (*pPos == '\0')
+		pAtom = g_AttributeAtoms.GetAt(sAttrib);
+	else
+		pAtom = g_AttributeAtoms.GetAt(strToLower(sAttrib));
+
+	if (pAtom == NULL)
+		return false;
+
+	if (retdwAtom)
+		*retdwAtom = *pAtom;
+
+	return true;
+	}
+
+bool CAttributeSet::Has (DWORD dwAtom) const
+
+//	Has
+//
+//	Returns TRUE if we have the given attribute.
+
+	{
+	int iMin = 0;
+	int iMax = m_Atoms.GetCount();
+
+	while (iMin < iMax)
+		{
+		int iMid = (iMin + iMax) / 2;
+		if (m_Atoms[iMid] < dwAtom)
+			iMin = iMid + 1;
+		else if (m_Atoms[iMid] > dwAtom)
+			iMax = iMid;
+		else
+			return true;
+		}
+
+	return false;
+	}
+
+bool CAttributeSet::HasAll (const CAttributeSet &Attribs) const
+
+//	HasAll
+//
+//	Returns TRUE if we have all of the given attributes.
+
+	{
+	int iPos = 0;
+	int i;
+
+	for (i = 0; i < Attribs.m_Atoms.GetCount(); i++)
+		{
+		DWORD dwAtom = Attribs.m_Atoms[i];
+		while (iPos < m_Atoms.GetCount() && m_Atoms[iPos] < dwAtom)
+			iPos++;
+
+		if (iPos == m_Atoms.GetCount() || m_Atoms[iPos] != dwAtom)
+			return false;
+		}
+
+	return true;
+	}
+
+bool CAttributeSet::HasAny (const CAttributeSet &Attribs) const
+
+//	HasAny
+//
+//	Returns TRUE if we have at least one of the given attributes.
+
+	{
+	int iPos = 0;
+	int i;
+
+	for (i = 0; i < Attribs.m_Atoms.GetCount(); i++)
+		{
+		DWORD dwAtom = Attribs.m_Atoms[i];
+		while (iPos < m_Atoms.GetCount() && m_Atoms[iPos] < dwAtom)
+			iPos++;
+
+		if (iPos == m_Atoms.GetCount())
+			return false;
+		else if (m_Atoms[iPos] == dwAtom)
+			return true;
+		}
+
+	return false;
+	}
+
+bool CAttributeSet::InitFromArray (const TArray<CString> &Attribs)
+
+//	InitFromArray
+//
+//	Initializes from an array of attributes (e.g., the required attributes of a
+//	criteria). Returns FALSE if any of the attributes cannot be an atom (in
+//	which case callers must match with ::HasModifier, as before).
+
+	{
+	int i;
+
+	m_Atoms.DeleteAll();
+
+	for (i = 0; i < Attribs.GetCount(); i++)
+		{
+		if (!IsAtom(Attribs[i]))
+			{
+			m_Atoms.DeleteAll();
+			return false;
+			}
+
+		Insert(Atomize(Attribs[i]));
+		}
+
+	return true;
+	}
+
+void CAttributeSet::InitFromList (const CString &sAttributes)
+
+//	InitFromList
+//
+//	Initializes from a list of attributes separated by semicolons, commas, or
+//	spaces. We split the list exactly like ::HasModifier, so a set matches the
+//	same attributes as the original string.
+
+	{
+	m_Atoms.DeleteAll();
+
+	char *pPos = sAttributes.GetASCIIZPointer();
+	while (*pPos != '\0')
+		{
+		while (*pPos == ' ')
+			pPos++;
+
+		char *pStart = pPos;
+		while (*pPos != '\0' && *pPos != ';' && *pPos != ',' && *pPos != ' ')
+			pPos++;
+
+		if (pPos != pStart)
+			Insert(Atomize(CString(pStart, (int)(pPos - pStart))));
+
+		if (*pPos == ';' || *pPos == ',')
+			pPos++;
+		}
+	}
+
+void CAttributeSet::Insert (DWORD dwAtom)
+
+//	Insert
+//
+//	Adds the atom, keeping the array sorted.
+
+	{
+	int iPos = 0;
+	while (iPos < m_Atoms.GetCount() && m_Atoms[iPos] < dwAtom)
+		iPos++;
+
+	if (iPos < m_Atoms.GetCount() && m_Atoms[iPos] == dwAtom)
+		return;
+
+	m_Atoms.Insert(dwAtom, iPos);
+	}
+
+bool CAttributeSet::IsAtom (const CString &sAttrib)
+
+//	IsAtom
+//
+//	Returns TRUE if the attribute is a single non-blank name (which is the only
+//	kind that ::HasModifier matches as a whole token).
+
+	{
+	if (sAttrib.IsBlank())
+		return false;
+
+	char *pPos = sAttrib.GetASCIIZPointer();
+	while (*pPos != '\0')
+		{
+		if (*pPos == ';' || *pPos == ',' || *pPos == ' ')
+			return false;
+
+		pPos++;
+		}
+
+	return true;
+	}
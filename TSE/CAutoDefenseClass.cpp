@@ -27,6 +27,28 @@
 
 const int DEFAULT_INTERCEPT_RANGE =				10;
 
+enum EAutoDefenseClassProperties
+	{
+	propEnabled,
+	propExternal,
+	propFireArc,
+	propFireDelay,
+	propFireRate,
+	propOmnidirectional,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propEnabled,					PROPERTY_ENABLED	},
+		{	propExternal,					PROPERTY_EXTERNAL	},
+		{	propFireArc,					PROPERTY_FIRE_ARC	},
+		{	propFireDelay,					PROPERTY_FIRE_DELAY	},
+		{	propFireRate,					PROPERTY_FIRE_RATE	},
+		{	propOmnidirectional,			PROPERTY_OMNIDIRECTIONAL	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CAutoDefenseClass::CAutoDefenseClass (void)
 
 //	CAutoDefenseClass constructor
@@ -203,16 +225,17 @@ ICCItem *CAutoDefenseClass::FindItemProperty (CItemCtx &Ctx, const CString &sPro
 //	understand the property.
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	CDeviceClass *pWeapon;
 	CInstalledDevice *pDevice = Ctx.GetDevice();
 
 	//	Get the property
 
-	if (strEquals(sProperty, PROPERTY_FIRE_DELAY))
+	if (iProp == propFireDelay)
 		return CC.CreateInteger(m_iRechargeTicks);
 
-	else if (strEquals(sProperty, PROPERTY_FIRE_RATE))
+	else if (iProp == propFireRate)
 		{
 		Metric rDelay = m_iRechargeTicks;
 		if (rDelay <= 0.0)
@@ -221,16 +244,16 @@ ICCItem *CAutoDefenseClass::FindItemProperty (CItemCtx &Ctx, const CString &sPro
 		return CC.CreateInteger((int)(1000.0 / rDelay));
 		}
 
-	else if (strEquals(sProperty, PROPERTY_ENABLED))
+	else if (iProp == propEnabled)
 		return (pDevice ? CC.CreateBool(pDevice->IsEnabled()) : CC.CreateNil());
 
-	else if (strEquals(sProperty, PROPERTY_EXTERNAL))
+	else if (iProp == propExternal)
 		return CC.CreateBool(pDevice ? pDevice->IsExternal() : IsExternal());
 
-	else if (strEquals(sProperty, PROPERTY_OMNIDIRECTIONAL))
+	else if (iProp == propOmnidirectional)
 		return CC.CreateBool(IsOmniDirectional(pDevice));
 
-	else if (strEquals(sProperty, PROPERTY_FIRE_ARC))
+	else if (iProp == propFireArc)
 		{
 		int iMinFireArc;
 		int iMaxFireArc;
@@ -0,0 +1,234 @@
+//	CAvoidPotentialField.cpp
+//
+//	CAvoidPotentialField class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const Metric SAMPLE_SPACING =				(KLICKS_PER_PIXEL * 50.0);
+const int CHECK_INTERVAL =					30;
+
+bool CAvoidPotentialField::GetPotential (const CVector &vPos, CVector &iovPotential) const
+
+//	GetPotential
+//
+//	Adds the potential at the given position (interpolated from the nearest
+//	samples) to iovPotential. Returns TRUE if any hazard contributed.
+
+	{
+	if (m_Chunks.GetCount() == 0)
+		return false;
+
+	Metric x = vPos.GetX() / SAMPLE_SPACING;
+	Metric y = vPos.GetY() / SAMPLE_SPACING;
+	int x0 = (int)floor(x);
+	int y0 = (int)floor(y);
+	Metric xFrac = x - x0;
+	Metric yFrac = y - y0;
+
+	CVector vPotential = (*GetSample(x0, y0) * ((1.0 - xFrac) * (1.0 - yFrac)))
+			+ (*GetSample(x0 + 1, y0) * (xFrac * (1.0 - yFrac)))
+			+ (*GetSample(x0, y0 + 1) * ((1.0 - xFrac) * yFrac))
+			+ (*GetSample(x0 + 1, y0 + 1) * (xFrac * yFrac));
+
+	if (vPotential.GetX() == 0.0 && vPotential.GetY() == 0.0)
+		return false;
+
+	iovPotential = iovPotential + vPotential;
+	return true;
+	}
+
+const CVector *CAvoidPotentialField::GetSample (int x, int y) const
+
+//	GetSample
+//
+//	Returns the sample at the given grid position (which is zero if no hazard
+//	is in range).
+
+	{
+	static const CVector NullPotential;
+
+	int xChunk = (x >= 0 ? x / CHUNK_SIZE : -((-x - 1) / CHUNK_SIZE) - 1);
+	int yChunk = (y >= 0 ? y / CHUNK_SIZE : -((-y - 1) / CHUNK_SIZE) - 1);
+
+	const int *pIndex = m_ChunkIndex.GetAt(MakeChunkKey(xChunk, yChunk));
+	if (pIndex == NULL)
+		return &NullPotential;
+
+	int xLocal = x - (xChunk * CHUNK_SIZE);
+	int yLocal = y - (yChunk * CHUNK_SIZE);
+	return &m_Chunks[*pIndex].Samples[yLocal * CHUNK_SIZE + xLocal];
+	}
+
+void CAvoidPotentialField::Init (const TArray<CSpaceObject *> &Sources)
+
+//	Init
+//
+//	Samples the potential from the given hazards.
+
+	{
+	int i;
+
+	m_Chunks.DeleteAll();
+	m_ChunkIndex.DeleteAll();
+	m_Sources.DeleteAll();
+
+	for (i = 0; i < Sources.GetCount(); i++)
+		{
+		CSpaceObject *pObj = Sources[i];
+		m_Sources.SetAt(pObj, pObj->GetPos());
+
+		//	Sample every grid point in range of the hazard.
+
+		Metric rRange = CAIBehaviorCtx::GetHazardRange(pObj);
+		int xFrom = (int)floor((pObj->GetPos().GetX() - rRange) / SAMPLE_SPACING);
+		int xTo = (int)ceil((pObj->GetPos().GetX() + rRange) / SAMPLE_SPACING);
+		int yFrom = (int)floor((pObj->GetPos().GetY() - rRange) / SAMPLE_SPACING);
+		int yTo = (int)ceil((pObj->GetPos().GetY() + rRange) / SAMPLE_SPACING);
+
+		int x, y;
+		for (y = yFrom; y <= yTo; y++)
+			for (x = xFrom; x <= xTo; x++)
+				{
+				CVector vSample(x * SAMPLE_SPACING, y * SAMPLE_SPACING);
+				CVector vPotential;
+				if (CAIBehaviorCtx::CalcHazardPotential(pObj, vSample, vPotential))
+					{
+					CVector *pSample = SetSample(x, y);
+					*pSample = *pSample + vPotential;
+					}
+				}
+		}
+
+	m_bValid = true;
+	}
+
+bool CAvoidPotentialField::IsHazard (CSpaceObject *pObj)
+
+//	IsHazard
+//
+//	Returns TRUE if the object contributes to the avoid potential of ships.
+
+	{
+	return (pObj->HasGravity() || pObj->BlocksShips());
+	}
+
+void CAvoidPotentialField::OnObjAdded (CSpaceObject *pObj)
+
+//	OnObjAdded
+//
+//	An object has been added to the system. Ships that use the field do not
+//	look for hazards themselves, so we cannot wait for the next check.
+
+	{
+	if (!IsHazard(pObj))
+		return;
+
+	//	Hazards that can move are computed exactly, so we just add them to the
+	//	list. Otherwise the field is missing a source; we stop using it until
+	//	the next update rebuilds it.
+
+	if (!pObj->IsAnchored())
+		m_DynamicSources.Insert(pObj);
+	else
+		m_bValid = false;
+	}
+
+void CAvoidPotentialField::OnObjRemoved (CSpaceObject *pObj)
+
+//	OnObjRemoved
+//
+//	An object has been removed from the system.
+
+	{
+	int iIndex;
+
+	if (m_DynamicSources.Find(pObj, &iIndex))
+		m_DynamicSources.Delete(iIndex);
+
+	//	If this was one of our sampled hazards, the field is wrong. We stop using
+	//	it until the next update rebuilds it.
+
+	if (IsSource(pObj))
+		m_bValid = false;
+	}
+
+CVector *CAvoidPotentialField::SetSample (int x, int y)
+
+//	SetSample
+//
+//	Returns the sample at the given grid position, allocating a chunk if
+//	necessary.
+
+	{
+	int xChunk = (x >= 0 ? x / CHUNK_SIZE : -((-x - 1) / CHUNK_SIZE) - 1);
+	int yChunk = (y >= 0 ? y / CHUNK_SIZE : -((-y - 1) / CHUNK_SIZE) - 1);
+	DWORD dwKey = MakeChunkKey(xChunk, yChunk);
+
+	int iIndex;
+	int *pIndex = m_ChunkIndex.GetAt(dwKey);
+	if (pIndex)
+		iIndex = *pIndex;
+	else
+		{
+		iIndex = m_Chunks.GetCount();
+		m_Chunks.InsertEmpty(1);
+		m_ChunkIndex.SetAt(dwKey, iIndex);
+		}
+
+	int xLocal = x - (xChunk * CHUNK_SIZE);
+	int yLocal = y - (yChunk * CHUNK_SIZE);
+	return &m_Chunks[iIndex].Samples[yLocal * CHUNK_SIZE + xLocal];
+	}
+
+void CAvoidPotentialField::Update (CSystem &System)
+
+//	Update
+//
+//	Called once per system update, before ship behavior. Every so often we
+//	look for hazards that were added, changed, or moved and rebuild the field
+//	if necessary.
+
+	{
+	int i;
+
+	int iTick = g_pUniverse->GetTicks();
+	if (m_bValid && iTick - m_iLastCheck < CHECK_INTERVAL)
+		return;
+
+	m_iLastCheck = iTick;
+
+	//	All hazards are nav path obstacle candidates, so we don't need to look
+	//	at every object in the system.
+
+	TArray<CSpaceObject *> Sources;
+	m_DynamicSources.DeleteAll();
+
+	const TArray<CSpaceObject *> &Candidates = System.GetNavObstacles();
+	for (i = 0; i < Candidates.GetCount(); i++)
+		{
+		CSpaceObject *pObj = Candidates[i];
+		if (pObj->IsDestroyed() || !IsHazard(pObj))
+			continue;
+
+		if (pObj->IsAnchored())
+			Sources.Insert(pObj);
+		else
+			m_DynamicSources.Insert(pObj);
+		}
+
+	//	If nothing changed, we keep the current samples.
+
+	bool bChanged = (!m_bValid || Sources.GetCount() != m_Sources.GetCount());
+	for (i = 0; i < Sources.GetCount() && !bChanged; i++)
+		{
+		const CVector *pPos = m_Sources.GetAt(Sources[i]);
+		if (pPos == NULL
+				|| pPos->GetX() != Sources[i]->GetPos().GetX()
+				|| pPos->GetY() != Sources[i]->GetPos().GetY())
+			bChanged = true;
+		}
+
+	if (bChanged)
+		Init(Sources);
+	}
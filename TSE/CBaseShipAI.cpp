@@ -19,6 +19,7 @@ const Metric ATTACK_RANGE =				(20.0 * LIGHT_SECOND);
 const Metric CLOSE_RANGE =				(50.0 * LIGHT_SECOND);
 const Metric CLOSE_RANGE2 =				(CLOSE_RANGE * CLOSE_RANGE);
 const Metric MIN_POTENTIAL2 =			(KLICKS_PER_PIXEL * KLICKS_PER_PIXEL * 25.0);
+const int RECENT_COMBAT_TIME =			150;
 
 #define MAX_TARGETS						10
 #define MAX_DOCK_DISTANCE				(15.0 * LIGHT_SECOND)
@@ -250,8 +251,13 @@ CSpaceObject *CBaseShipAI::CalcEnemyShipInRange (CSpaceObject *pCenter, Metric r
 
 //	CalcEnemyShipInRange
 //
-//	Returns the first enemy ship that it finds in range of pCenter. Returns NULL if none
-//	are found.
+//	Returns the enemy ship in range of pCenter that is nearest to pCenter (if
+//	two are at exactly the same distance, the one with the lower object ID).
+//	If the player is an enemy in range, we always return the player. Returns
+//	NULL if none are found.
+//
+//	NOTE: The result does not depend on the order in which the influence map
+//	or the enemy list returns candidates.
 
 	{
 	DEBUG_TRY
@@ -286,13 +292,22 @@ CSpaceObject *CBaseShipAI::CalcEnemyShipInRange (CSpaceObject *pCenter, Metric r
 	if (pSovereign == NULL || m_pShip->GetSystem() == NULL)
 		return NULL;
 
+	//	The influence map knows which enemy ships are near the center, so we
+	//	only need to look at those. If the map has not been updated yet, we
+	//	look at all enemies.
+
+	CSystem *pSystem = m_pShip->GetSystem();
+	bool bNearby = pSystem->GetInfluenceMap().GetEnemyShips(pSovereign, pCenter->GetPos(), rRange, m_EnemyShips);
+	const CSpaceObjectList *pAllEnemies = (bNearby ? NULL : &pSovereign->GetEnemyObjectList(pSystem));
+	int iCount = (bNearby ? m_EnemyShips.GetCount() : pAllEnemies->GetCount());
+
 	//	Loop
 
-	const CSpaceObjectList &ObjList = pSovereign->GetEnemyObjectList(m_pShip->GetSystem());
-	int iCount = ObjList.GetCount();
+	CSpaceObject *pBest = NULL;
+	Metric rBestDist2 = rMaxRange2;
 	for (i = 0; i < iCount; i++)
 		{
-		CSpaceObject *pObj = ObjList.GetObj(i);
+		CSpaceObject *pObj = (bNearby ? m_EnemyShips[i] : pAllEnemies->GetObj(i));
 
 		if (pObj->GetCategory() == CSpaceObject::catShip
 				&& pObj->CanAttack()
@@ -301,15 +316,18 @@ CSpaceObject *CBaseShipAI::CalcEnemyShipInRange (CSpaceObject *pCenter, Metric r
 			CVector vRange = pObj->GetPos() - pCenter->GetPos();
 			Metric rDistance2 = vRange.Dot(vRange);
 
-			if (rDistance2 < rMaxRange2
+			if ((rDistance2 < rBestDist2 || (pBest && rDistance2 == rBestDist2 && pObj->GetID() < pBest->GetID()))
 					&& Perception.CanBeTargeted(pObj, rDistance2)
 					&& pObj != pExcludeObj
 					&& !pObj->IsEscortingFriendOf(m_pShip))
-				return pObj;
+				{
+				pBest = pObj;
+				rBestDist2 = rDistance2;
+				}
 			}
 		}
 
-	return NULL;
+	return pBest;
 
 	DEBUG_CATCH_CONTINUE
 
@@ -462,6 +480,28 @@ bool CBaseShipAI::CanObjRequestDock (void) const
 		}
 	}
 
+bool CBaseShipAI::CanReduceBehaviorRate (void)
+
+//	CanReduceBehaviorRate
+//
+//	Returns TRUE if we can skip behavior updates when we're far from the POV
+//	(see CAILODScheduler). We only allow it if we're not fighting or docking.
+//	Timers that count behavior calls (rather than ticks) would run slow if we
+//	skipped, so we also refuse while any of them is running. Subclasses with
+//	their own timers must check them too.
+
+	{
+	CItemCtx ItemCtx;
+
+	return (!m_AICtx.IsDockingRequested()
+			&& !m_AICtx.IsRecoveringFromBarrier()
+			&& (m_pOrderModule == NULL || m_pOrderModule->CanReduceBehaviorRate())
+			&& !m_fIsPlayerWingman
+			&& !m_AICtx.IsBeingAttacked(RECENT_COMBAT_TIME)
+			&& (g_pUniverse->GetTicks() - m_pShip->GetLastFireTime()) > RECENT_COMBAT_TIME
+			&& GetTarget(ItemCtx, true) == NULL);
+	}
+
 bool CBaseShipAI::CheckForEnemiesInRange (CSpaceObject *pCenter, Metric rRange, int iInterval, CSpaceObject **retpTarget)
 
 //	CheckForEnemiesInRange
@@ -522,6 +562,18 @@ bool CBaseShipAI::CheckOutOfZone (CSpaceObject *pBase, Metric rInnerRadius, Metr
 		return false;
 	}
 
+void CBaseShipAI::CoastBehavior (SUpdateCtx &Ctx)
+
+//	CoastBehavior
+//
+//	Called instead of Behavior on ticks that the LOD scheduler skips. We keep
+//	flying the course picked by our last behavior update.
+
+	{
+	m_pShip->ClearAllTriggered();
+	m_AICtx.CoastManeuver(m_pShip);
+	}
+
 CString CBaseShipAI::DebugCrashInfo (void)
 
 //	DebugCrashInfo
@@ -29,6 +29,7 @@ ICCItem *fnEnvironmentGet (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData)
 #define FN_DEBUG_IS_ACTIVE			6
 #define FN_DEBUG_GET				7
 #define FN_DEBUG_SET				8
+#define FN_DEBUG_PROFILE			9
 
 ICCItem *fnDebug (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData);
 
@@ -396,6 +397,7 @@ ICCItem *fnSystemCreateStation (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dw
 #define FN_SYS_FIND_AT_POS				1
 
 ICCItem *fnSystemFind (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData);
+static CSpaceObjectCriteriaCache g_CriteriaCache;	//	Parsed sysFindObject criteria
 
 ICCItem *fnSystemGetObjectByName (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData);
 ICCItem *fnSystemVectorOffset (CEvalContext *pEvalCtx, ICCItem *pArguments, DWORD dwData);
@@ -482,6 +484,7 @@ ICCItem *fnSystemAddStationTimerEvent (CEvalContext *pEvalCtx, ICCItem *pArgs, D
 #define FN_SYS_GET_POV					36
 #define FN_SYS_ITEM_BUY_PRICE			37
 #define FN_SYS_STARGATE_PROPERTY		38
+#define FN_SYS_INFLUENCE				39
 
 ICCItem *fnSystemGet (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData);
 
@@ -662,6 +665,20 @@ static PRIMITIVEPROCDEF g_Extensions[] =
 			"(dbgOutput [string]*) -> True if in debug mode, else Nil",
 			"*",	PPFLAG_SIDEEFFECTS,	},
 
+		{	"dbgProfile",				fnDebug,		FN_DEBUG_PROFILE,
+			"(dbgProfile command [filespec]) -> result\n\n"
+			
+			"command:\n\n"
+			
+			"   'clear                  Clear all results\n"
+			"   'results                List of handler stats (times in microseconds)\n"
+			"   'saveCSV filespec       Write handler stats to a CSV file\n"
+			"   'saveTrace filespec     Write calls in Chrome trace format\n"
+			"   'start                  Start profiling event handlers\n"
+			"   'stop                   Stop profiling\n",
+
+			"s*",	PPFLAG_SIDEEFFECTS, },
+
 		{	"dbgSet",					fnDebug,		FN_DEBUG_SET,
 			"(dbgSet property value) -> True/Nil\n\n"
 			
@@ -2838,6 +2855,16 @@ static PRIMITIVEPROCDEF g_Extensions[] =
 			"(sysGetEnvironment pos) -> environmentUNID",
 			"v",	0,	},
 
+		{	"sysGetInfluence",				fnSystemGet,	FN_SYS_INFLUENCE,
+			"(sysGetInfluence sovereignID pos|obj [radius]) -> {enemy:power friend:power}\n\n"
+
+			"Returns the total combat power of armed ships near the given position\n"
+			"that the sovereign considers enemies and friends. The map is coarse\n"
+			"(cells are 100 light-seconds) and is refreshed a few times a second.\n"
+			"radius is in light-seconds.",
+
+			"iv*",	0,	},
+
 		{	"sysGetItemBuyPrice",			fnSystemGet,	FN_SYS_ITEM_BUY_PRICE,
 			"(sysGetItemBuyPrice [nodeID] item [typeCriteria]) -> price (or Nil)",
 			"*v",	0,	},
@@ -4118,6 +4145,53 @@ ICCItem *fnDebug (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData)
 		case FN_DEBUG_IS_ACTIVE:
 			return g_pUniverse->InDebugMode() ? pCC->CreateTrue() : pCC->CreateNil();
 
+		case FN_DEBUG_PROFILE:
+			{
+			//	Only in debug mode (since we can write files)
+
+			if (!g_pUniverse->InDebugMode())
+				return pCC->CreateNil();
+
+			CString sCommand = pArgs->GetElement(0)->GetStringValue();
+			if (strEquals(sCommand, CONSTLIT("clear")))
+				CCodeChainProfiler::DeleteAll();
+
+			else if (strEquals(sCommand, CONSTLIT("results")))
+				return CCodeChainProfiler::GetResults(*pCC);
+
+			else if (strEquals(sCommand, CONSTLIT("saveCSV"))
+					|| strEquals(sCommand, CONSTLIT("saveTrace")))
+				{
+				if (pArgs->GetCount() < 2)
+					return pCC->CreateError(CONSTLIT("Filespec expected"));
+
+				CString sFilespec = pArgs->GetElement(1)->GetStringValue();
+				CString sError;
+				ALERROR error;
+				if (strEquals(sCommand, CONSTLIT("saveCSV")))
+					error = CCodeChainProfiler::WriteCSV(sFilespec, &sError);
+				else
+					error = CCodeChainProfiler::WriteTrace(sFilespec, &sError);
+
+				if (error)
+					return pCC->CreateError(sError);
+				}
+
+			else if (strEquals(sCommand, CONSTLIT("start")))
+				{
+				CCodeChainProfiler::DeleteAll();
+				CCodeChainProfiler::SetEnabled(true);
+				}
+
+			else if (strEquals(sCommand, CONSTLIT("stop")))
+				CCodeChainProfiler::SetEnabled(false);
+
+			else
+				return pCC->CreateError(CONSTLIT("Invalid profile command"), pArgs->GetElement(0));
+
+			return pCC->CreateTrue();
+			}
+
 		case FN_DEBUG_SET:
 			{
 			CString sProperty = pArgs->GetElement(0)->GetStringValue();
@@ -12442,8 +12516,9 @@ ICCItem *fnSystemFind (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData)
 
 	//	Second argument is the filter
 
-	CString sFilter = pArgs->GetElement(1)->GetStringValue();
-	CSpaceObjectCriteria Criteria(pSource, sFilter);
+	CSpaceObjectCriteria Criteria = g_CriteriaCache.Get(pArgs->GetElement(1)->GetStringValue());
+	if (pSource)
+		Criteria.SetSource(pSource);
 
 	//	If we're checking for position, we need to do some extra work
 
@@ -12503,24 +12578,15 @@ ICCItem *fnSystemFind (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData)
 
 	bool bGenerateOurOwnList = (pList && (Criteria.GetSort() == CSpaceObjectCriteria::sortNone));
 
-	//	Do the search
+	//	Do the search. If the criteria limits the distance, the system only
+	//	looks at nearby objects.
 
 	CSpaceObjectCriteria::SCtx Ctx(Criteria);
-	for (i = 0; i < pSystem->GetObjectCount(); i++)
-		{
-		CSpaceObject *pObj = pSystem->GetObject(i);
+	TArray<CSpaceObject *> Found;
+	pSystem->FindObjectsMatching(Criteria, Ctx, (bGenerateOurOwnList ? &Found : NULL));
 
-		//	NOTE: Sometimes we want to find virtual objects, so always include 
-		//	them if they match.
-
-		if (pObj 
-				&& pObj->MatchesCriteria(Ctx, Criteria)
-				&& (!pObj->IsIntangible() || pObj->IsVirtual()))
-			{
-			if (bGenerateOurOwnList)
-				pList->AppendInteger(*pCC, (int)pObj);
-			}
-		}
+	for (i = 0; i < Found.GetCount(); i++)
+		pList->AppendInteger(*pCC, (int)Found[i]);
 
 	//	If we only want the nearest/farthest object, then find it now
 
@@ -13013,6 +13079,34 @@ ICCItem *fnSystemGet (CEvalContext *pEvalCtx, ICCItem *pArgs, DWORD dwData)
 			return pCC->CreateInteger((int)((rDistance / rSpeed) + 0.5));
 			}
 
+		case FN_SYS_INFLUENCE:
+			{
+			CSystem *pSystem = g_pUniverse->GetCurrentSystem();
+			if (pSystem == NULL)
+				return StdErrorNoSystem(*pCC);
+
+			CSovereign *pSovereign = g_pUniverse->FindSovereign(pArgs->GetElement(0)->GetIntegerValue());
+			if (pSovereign == NULL)
+				return pCC->CreateError(CONSTLIT("Unknown sovereign"), pArgs->GetElement(0));
+
+			CVector vPos;
+			if (GetPosOrObject(pEvalCtx, pArgs->GetElement(1), &vPos) != NOERROR)
+				return pCC->CreateError(CONSTLIT("Invalid pos"), pArgs->GetElement(1));
+
+			Metric rRadius = 0.0;
+			if (pArgs->GetCount() >= 3)
+				rRadius = Max(0.0, pArgs->GetElement(2)->GetDoubleValue() * LIGHT_SECOND);
+
+			int iEnemy;
+			int iFriend;
+			pSystem->GetInfluenceMap().GetInfluence(pSovereign, vPos, rRadius, &iEnemy, &iFriend);
+
+			ICCItem *pResult = pCC->CreateSymbolTable();
+			pResult->SetIntegerAt(*pCC, CONSTLIT("enemy"), iEnemy);
+			pResult->SetIntegerAt(*pCC, CONSTLIT("friend"), iFriend);
+			return pResult;
+			}
+
 		case FN_SYS_INC_DATA:
 			{
 			int iArg = 0;
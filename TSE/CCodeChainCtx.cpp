@@ -429,6 +429,20 @@ ICCItemPtr CCodeChainCtx::LinkCode (const CString &sString, CCodeChain::SLinkOpt
 	return ICCItemPtr(m_CC.Link(sString, Options));
 	}
 
+ICCItemPtr CCodeChainCtx::LinkCode (SDesignLoadCtx &LoadCtx, const CString &sString, CCodeChain::SLinkOptions &Options)
+
+//	LinkCode
+//
+//	Links a CodeChain expression while loading a design. If the load context
+//	has a code cache, we go through it.
+
+	{
+	if (LoadCtx.pCodeCache)
+		return LoadCtx.pCodeCache->Link(m_CC, sString, Options);
+
+	return LinkCode(sString, Options);
+	}
+
 void CCodeChainCtx::RemoveFrame (void)
 
 //	RemoveFrame
@@ -515,8 +529,15 @@ ICCItem *CCodeChainCtx::Run (const SEventHandlerDesc &Event)
 	CExtension *pOldExtension = m_pExtension;
 	m_pExtension = Event.pExtension;
 
+	bool bProfile = CCodeChainProfiler::IsEnabled();
+	if (bProfile)
+		CCodeChainProfiler::BeginCall();
+
 	ICCItem *pResult = Run(Event.pCode);
 
+	if (bProfile)
+		CCodeChainProfiler::EndCall(Event);
+
 	m_pExtension = pOldExtension;
 	return pResult;
 
@@ -554,8 +575,15 @@ ICCItemPtr CCodeChainCtx::RunCode (const SEventHandlerDesc &Event)
 	CExtension *pOldExtension = m_pExtension;
 	m_pExtension = Event.pExtension;
 
+	bool bProfile = CCodeChainProfiler::IsEnabled();
+	if (bProfile)
+		CCodeChainProfiler::BeginCall();
+
 	ICCItemPtr pResult = RunCode(Event.pCode);
 
+	if (bProfile)
+		CCodeChainProfiler::EndCall(Event);
+
 	m_pExtension = pOldExtension;
 	return pResult;
 
@@ -0,0 +1,301 @@
+//	CCodeChainProfiler.cpp
+//
+//	CCodeChainProfiler class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+#define FIELD_CALLS								CONSTLIT("calls")
+#define FIELD_EVENT								CONSTLIT("event")
+#define FIELD_EXTENSION							CONSTLIT("extension")
+#define FIELD_MAX_TIME							CONSTLIT("maxTime")
+#define FIELD_SELF_TIME							CONSTLIT("selfTime")
+#define FIELD_TOTAL_TIME						CONSTLIT("totalTime")
+#define FIELD_TYPE								CONSTLIT("type")
+
+#define STR_UNKNOWN_EVENT						CONSTLIT("(unknown)")
+
+const int MAX_TRACE_ENTRIES =					200000;
+
+bool CCodeChainProfiler::m_bEnabled = false;
+LONGLONG CCodeChainProfiler::m_StartTime = 0;
+TSortMap<CCodeChainProfiler::SKey, CCodeChainProfiler::SStats> CCodeChainProfiler::m_Stats;
+TArray<CCodeChainProfiler::SFrame> CCodeChainProfiler::m_Stack;
+TArray<CCodeChainProfiler::STraceEntry> CCodeChainProfiler::m_Trace;
+
+int KeyCompare (const CCodeChainProfiler::SKey &Key1, const CCodeChainProfiler::SKey &Key2)
+
+//	KeyCompare
+//
+//	Compares keys
+
+	{
+	if (Key1.dwExtension > Key2.dwExtension)
+		return 1;
+	else if (Key1.dwExtension < Key2.dwExtension)
+		return -1;
+	else if (Key1.dwType > Key2.dwType)
+		return 1;
+	else if (Key1.dwType < Key2.dwType)
+		return -1;
+	else if (Key1.iEvent > Key2.iEvent)
+		return 1;
+	else if (Key1.iEvent < Key2.iEvent)
+		return -1;
+	else
+		return 0;
+	}
+
+void CCodeChainProfiler::BeginCall (void)
+
+//	BeginCall
+//
+//	Called before we run an event handler. Must be balanced with a call to
+//	EndCall.
+
+	{
+	SFrame *pFrame = m_Stack.Insert();
+	pFrame->StartTime = GetTime();
+	pFrame->ChildTime = 0;
+	}
+
+void CCodeChainProfiler::DeleteAll (void)
+
+//	DeleteAll
+//
+//	Clears all results.
+
+	{
+	m_Stats.DeleteAll();
+	m_Stack.DeleteAll();
+	m_Trace.DeleteAll();
+	m_StartTime = GetTime();
+	}
+
+void CCodeChainProfiler::EndCall (const SEventHandlerDesc &Event)
+
+//	EndCall
+//
+//	Called after an event handler has run.
+
+	{
+	//	If we got cleared while inside the handler, then there is nothing to
+	//	record.
+
+	if (m_Stack.GetCount() == 0)
+		return;
+
+	SFrame Frame = m_Stack[m_Stack.GetCount() - 1];
+	m_Stack.Delete(m_Stack.GetCount() - 1);
+
+	LONGLONG Duration = GetTime() - Frame.StartTime;
+
+	//	Our caller's self time excludes us.
+
+	if (m_Stack.GetCount() > 0)
+		m_Stack[m_Stack.GetCount() - 1].ChildTime += Duration;
+
+	//	Accumulate
+
+	SKey Key;
+	Key.dwExtension = (Event.pExtension ? Event.pExtension->GetUNID() : 0);
+	Key.dwType = Event.dwType;
+	Key.iEvent = Event.iEvent;
+
+	SStats *pStats = m_Stats.SetAt(Key);
+	pStats->iCalls++;
+	pStats->TotalTime += Duration;
+	pStats->SelfTime += Duration - Frame.ChildTime;
+	if (Duration > pStats->MaxTime)
+		pStats->MaxTime = Duration;
+
+	//	Keep individual calls for a trace (up to a limit so that we don't run
+	//	out of memory if someone leaves the profiler on).
+
+	if (m_Trace.GetCount() < MAX_TRACE_ENTRIES)
+		{
+		STraceEntry *pEntry = m_Trace.Insert();
+		pEntry->Key = Key;
+		pEntry->StartTime = Frame.StartTime;
+		pEntry->Duration = Duration;
+		}
+	}
+
+CString CCodeChainProfiler::GetEventName (const SKey &Key)
+
+//	GetEventName
+//
+//	Returns the name of the event for the given key.
+
+	{
+	CString sEvent = CDesignType::GetEventName(Key.iEvent);
+	if (sEvent.IsBlank())
+		return STR_UNKNOWN_EVENT;
+
+	return sEvent;
+	}
+
+int CCodeChainProfiler::GetMicroseconds (LONGLONG Ticks)
+
+//	GetMicroseconds
+//
+//	Converts performance counter ticks to microseconds.
+
+	{
+	static LONGLONG Frequency = 0;
+	if (Frequency == 0)
+		{
+		LARGE_INTEGER Value;
+		::QueryPerformanceFrequency(&Value);
+		Frequency = Max((LONGLONG)1, (LONGLONG)Value.QuadPart);
+		}
+
+	return (int)((Ticks * 1000000) / Frequency);
+	}
+
+ICCItem *CCodeChainProfiler::GetResults (CCodeChain &CC)
+
+//	GetResults
+//
+//	Returns a list of structures, one per handler, ordered by descending total
+//	time. Times are in microseconds.
+
+	{
+	int i;
+
+	TSortMap<LONGLONG, int> Sorted(DescendingSort);
+	for (i = 0; i < m_Stats.GetCount(); i++)
+		Sorted.Insert(m_Stats[i].TotalTime, i);
+
+	ICCItem *pResult = CC.CreateLinkedList();
+	for (i = 0; i < Sorted.GetCount(); i++)
+		{
+		const SKey &Key = m_Stats.GetKey(Sorted[i]);
+		const SStats &Stats = m_Stats[Sorted[i]];
+
+		ICCItem *pEntry = CC.CreateSymbolTable();
+		pEntry->SetIntegerAt(CC, FIELD_EXTENSION, Key.dwExtension);
+		pEntry->SetIntegerAt(CC, FIELD_TYPE, Key.dwType);
+		pEntry->SetStringAt(CC, FIELD_EVENT, GetEventName(Key));
+		pEntry->SetIntegerAt(CC, FIELD_CALLS, Stats.iCalls);
+		pEntry->SetIntegerAt(CC, FIELD_TOTAL_TIME, GetMicroseconds(Stats.TotalTime));
+		pEntry->SetIntegerAt(CC, FIELD_SELF_TIME, GetMicroseconds(Stats.SelfTime));
+		pEntry->SetIntegerAt(CC, FIELD_MAX_TIME, GetMicroseconds(Stats.MaxTime));
+
+		pResult->Append(CC, pEntry);
+		pEntry->Discard(&CC);
+		}
+
+	return pResult;
+	}
+
+LONGLONG CCodeChainProfiler::GetTime (void)
+
+//	GetTime
+//
+//	Returns the current performance counter.
+
+	{
+	LARGE_INTEGER Value;
+	::QueryPerformanceCounter(&Value);
+	return Value.QuadPart;
+	}
+
+void CCodeChainProfiler::SetEnabled (bool bEnabled)
+
+//	SetEnabled
+//
+//	Starts or stops profiling. Results accumulate until DeleteAll.
+
+	{
+	if (bEnabled && !m_bEnabled && m_Stats.GetCount() == 0)
+		m_StartTime = GetTime();
+
+	m_bEnabled = bEnabled;
+	}
+
+ALERROR CCodeChainProfiler::WriteCSV (const CString &sFilespec, CString *retsError)
+
+//	WriteCSV
+//
+//	Writes a summary of all handlers to a CSV file. Times are in microseconds.
+
+	{
+	ALERROR error;
+	int i;
+
+	CFileWriteStream File(sFilespec, FALSE);
+	if (error = File.Create())
+		{
+		if (retsError)
+			*retsError = strPatternSubst(CONSTLIT("Unable to create file: %s"), sFilespec);
+		return error;
+		}
+
+	CString sData = CONSTLIT("extension,type,event,calls,totalTime,selfTime,maxTime\r\n");
+	File.Write(sData.GetPointer(), sData.GetLength(), NULL);
+
+	for (i = 0; i < m_Stats.GetCount(); i++)
+		{
+		const SKey &Key = m_Stats.GetKey(i);
+		const SStats &Stats = m_Stats[i];
+
+		sData = strPatternSubst(CONSTLIT("%08x,%08x,%s,%d,%d,%d,%d\r\n"),
+				Key.dwExtension,
+				Key.dwType,
+				GetEventName(Key),
+				Stats.iCalls,
+				GetMicroseconds(Stats.TotalTime),
+				GetMicroseconds(Stats.SelfTime),
+				GetMicroseconds(Stats.MaxTime));
+
+		File.Write(sData.GetPointer(), sData.GetLength(), NULL);
+		}
+
+	File.Close();
+	return NOERROR;
+	}
+
+ALERROR CCodeChainProfiler::WriteTrace (const CString &sFilespec, CString *retsError)
+
+//	WriteTrace
+//
+//	Writes every recorded call in Chrome trace event format (open with
+//	chrome://tracing).
+
+	{
+	ALERROR error;
+	int i;
+
+	CFileWriteStream File(sFilespec, FALSE);
+	if (error = File.Create())
+		{
+		if (retsError)
+			*retsError = strPatternSubst(CONSTLIT("Unable to create file: %s"), sFilespec);
+		return error;
+		}
+
+	CString sData = CONSTLIT("{\"traceEvents\":[\r\n");
+	File.Write(sData.GetPointer(), sData.GetLength(), NULL);
+
+	for (i = 0; i < m_Trace.GetCount(); i++)
+		{
+		const STraceEntry &Entry = m_Trace[i];
+
+		sData = strPatternSubst(CONSTLIT("%s{\"name\":\"%s %08x\",\"cat\":\"%08x\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%d,\"dur\":%d}\r\n"),
+				(i > 0 ? CONSTLIT(",") : NULL_STR),
+				GetEventName(Entry.Key),
+				Entry.Key.dwType,
+				Entry.Key.dwExtension,
+				GetMicroseconds(Entry.StartTime - m_StartTime),
+				GetMicroseconds(Entry.Duration));
+
+		File.Write(sData.GetPointer(), sData.GetLength(), NULL);
+		}
+
+	sData = CONSTLIT("]}\r\n");
+	File.Write(sData.GetPointer(), sData.GetLength(), NULL);
+
+	File.Close();
+	return NOERROR;
+	}
@@ -5,9 +5,12 @@
 
 #include "PreComp.h"
 
+#define PROPERTY_AI_LOD_STATS				CONSTLIT("aiLODStats")
 #define PROPERTY_DEBUG_MODE					CONSTLIT("debugMode")
 #define PROPERTY_MEMORY_USE					CONSTLIT("memoryUse")
+#define PROPERTY_PARALLEL_BEHAVIOR			CONSTLIT("parallelBehavior")
 #define PROPERTY_SHOW_AI_DEBUG				CONSTLIT("showAIDebug")
+#define PROPERTY_SHOW_AI_LOD				CONSTLIT("showAILOD")
 #define PROPERTY_SHOW_BOUNDS				CONSTLIT("showBounds")
 #define PROPERTY_SHOW_FACINGS_ANGLE			CONSTLIT("showFacingsAngle")
 #define PROPERTY_SHOW_LINE_OF_FIRE			CONSTLIT("showLineOfFire")
@@ -16,6 +19,31 @@
 
 #define ERR_MUST_BE_IN_DEBUG_MODE			CONSTLIT("Must be in debug mode to set a debug property.")
 
+ICCItemPtr CDebugOptions::GetAILODStats (void) const
+
+//	GetAILODStats
+//
+//	Returns the number of ships at each AI level of detail in the current
+//	system (as of the last update).
+
+	{
+	CCodeChain &CC = g_pUniverse->GetCC();
+
+	CSystem *pSystem = g_pUniverse->GetCurrentSystem();
+	if (pSystem == NULL)
+		return ICCItemPtr(CC.CreateNil());
+
+	const CAILODScheduler::SStats &Stats = pSystem->GetAILODScheduler().GetStats();
+
+	ICCItemPtr pResult = ICCItemPtr(CC.CreateSymbolTable());
+	pResult->SetIntegerAt(CC, CONSTLIT("full"), Stats.iShips[CAILODScheduler::lodFull]);
+	pResult->SetIntegerAt(CC, CONSTLIT("reduced"), Stats.iShips[CAILODScheduler::lodReduced]);
+	pResult->SetIntegerAt(CC, CONSTLIT("minimal"), Stats.iShips[CAILODScheduler::lodMinimal]);
+	pResult->SetIntegerAt(CC, CONSTLIT("coasting"), Stats.iCoasting);
+
+	return pResult;
+	}
+
 ICCItemPtr CDebugOptions::GetMemoryUse (void) const
 
 //	GetMemoryUse
@@ -48,15 +76,24 @@ ICCItemPtr CDebugOptions::GetProperty (const CString &sProperty) const
 	{
 	CCodeChain &CC = g_pUniverse->GetCC();
 
-	if (strEquals(sProperty, PROPERTY_MEMORY_USE))
+	if (strEquals(sProperty, PROPERTY_AI_LOD_STATS))
+		return GetAILODStats();
+
+	else if (strEquals(sProperty, PROPERTY_MEMORY_USE))
 		return GetMemoryUse();
 
 	else if (strEquals(sProperty, PROPERTY_DEBUG_MODE))
 		return ICCItemPtr(CC.CreateBool(g_pUniverse->InDebugMode()));
 
+	else if (strEquals(sProperty, PROPERTY_PARALLEL_BEHAVIOR))
+		return ICCItemPtr(CC.CreateBool(m_bParallelBehavior));
+
 	else if (strEquals(sProperty, PROPERTY_SHOW_AI_DEBUG))
 		return ICCItemPtr(CC.CreateBool(m_bShowAIDebug));
 
+	else if (strEquals(sProperty, PROPERTY_SHOW_AI_LOD))
+		return ICCItemPtr(CC.CreateBool(m_bShowAILOD));
+
 	else if (strEquals(sProperty, PROPERTY_SHOW_BOUNDS))
 		return ICCItemPtr(CC.CreateBool(m_bShowBounds));
 
@@ -97,9 +134,15 @@ bool CDebugOptions::SetProperty (const CString &sProperty, ICCItem *pValue, CStr
 
 	//	Set a property
 
-	if (strEquals(sProperty, PROPERTY_SHOW_AI_DEBUG))
+	if (strEquals(sProperty, PROPERTY_PARALLEL_BEHAVIOR))
+		m_bParallelBehavior = !pValue->IsNil();
+
+	else if (strEquals(sProperty, PROPERTY_SHOW_AI_DEBUG))
 		m_bShowAIDebug = !pValue->IsNil();
 
+	else if (strEquals(sProperty, PROPERTY_SHOW_AI_LOD))
+		m_bShowAILOD = !pValue->IsNil();
+
 	else if (strEquals(sProperty, PROPERTY_SHOW_BOUNDS))
 		m_bShowBounds = !pValue->IsNil();
 
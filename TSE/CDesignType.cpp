@@ -179,6 +179,36 @@ static char *DESIGN_CLASS_NAME[designCount] =
 		"ImageComposite",
 	};
 
+enum EDesignTypeProperties
+	{
+	propAPIVersion,
+	propAttributes,
+	propClass,
+	propExtension,
+	propMapDescription,
+	propMerged,
+	propNamePattern,
+	propObsoleteVersion,
+	propRequiredVersion,
+	propUNID,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propAPIVersion,					PROPERTY_API_VERSION	},
+		{	propAttributes,					PROPERTY_ATTRIBUTES	},
+		{	propClass,						PROPERTY_CLASS	},
+		{	propExtension,					PROPERTY_EXTENSION	},
+		{	propMapDescription,				PROPERTY_MAP_DESCRIPTION	},
+		{	propMerged,						PROPERTY_MERGED	},
+		{	propNamePattern,				PROPERTY_NAME_PATTERN	},
+		{	propObsoleteVersion,			PROPERTY_OBSOLETE_VERSION	},
+		{	propRequiredVersion,			PROPERTY_REQUIRED_VERSION	},
+		{	propUNID,						PROPERTY_UNID	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 static char *CACHED_EVENTS[CDesignType::evtCount] =
 	{
 		"CanInstallItem",
@@ -193,6 +223,39 @@ static char *CACHED_EVENTS[CDesignType::evtCount] =
 		"OnUpdate",
 	};
 
+static TSortMap<CString, int> g_EventIDs;
+static TArray<CString> g_EventNames;
+
+static int AtomizeEvent (const CString &sEvent)
+
+//	AtomizeEvent
+//
+//	Returns the unique ID for the given event name (allocating one the first
+//	time we see it). IDs start at 1.
+
+	{
+	bool bNew;
+	int *pID = g_EventIDs.SetAt(sEvent, &bNew);
+	if (bNew)
+		{
+		g_EventNames.Insert(sEvent);
+		*pID = g_EventNames.GetCount();
+		}
+
+	return *pID;
+	}
+
+static int FindEventID (const CString &sEvent)
+
+//	FindEventID
+//
+//	Returns the ID for the given event name (or 0 if no type defines it).
+
+	{
+	const int *pID = g_EventIDs.GetAt(sEvent);
+	return (pID ? *pID : 0);
+	}
+
 CDesignType::~CDesignType (void)
 
 //	CDesignType destructor
@@ -225,6 +288,11 @@ ALERROR CDesignType::BindDesign (SDesignLoadCtx &Ctx)
 
 	Ctx.pType = this;
 
+	//	Flatten our event handlers (including inherited ones) so that we don't
+	//	have to walk the hierarchy on every lookup.
+
+	InitEventTable();
+
 	//	Now that we've connected to our based classes, update the event cache
 	//	with events from our ancestors.
 
@@ -237,7 +305,10 @@ ALERROR CDesignType::BindDesign (SDesignLoadCtx &Ctx)
 				{
 				SEventHandlerDesc *pInherit = m_pInheritFrom->GetInheritedCachedEvent((ECachedHandlers)i);
 				if (pInherit)
+					{
 					SetExtra()->EventsCache[i] = *pInherit;
+					m_pExtra->EventsCache[i].dwType = m_dwUNID;
+					}
 				}
 			}
 		}
@@ -408,6 +479,7 @@ void CDesignType::CreateClone (CDesignType **retpType)
 	pClone->m_dwInheritFrom = m_dwInheritFrom;
 	pClone->m_pInheritFrom = m_pInheritFrom;
 	pClone->m_sAttributes = m_sAttributes;
+	pClone->m_Attributes = m_Attributes;
 	pClone->m_Events = m_Events;
 
 	if (m_pExtra)
@@ -512,6 +584,8 @@ ALERROR CDesignType::CreateFromXML (SDesignLoadCtx &Ctx, CXMLElement *pDesc, CDe
 			if (!pDesc->FindAttribute(ATTRIBUTES_ATTRIB, &pType->m_sAttributes))
 				pType->m_sAttributes = pDesc->GetAttribute(MODIFIERS_ATTRIB);
 
+			pType->m_Attributes.InitFromList(pType->m_sAttributes);
+
 			if (retpType)
 				*retpType = pType;
 
@@ -563,16 +637,17 @@ ICCItem *CDesignType::FindBaseProperty (CCodeChainCtx &Ctx, const CString &sProp
 //	If we don't have the property, we return NULL.
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	int i;
 	CCodeChain &CC = g_pUniverse->GetCC();
 	CString sValue;
 	ICCItem *pResult;
 	ICCItemPtr pValue;
 
-	if (strEquals(sProperty, PROPERTY_API_VERSION))
+	if (iProp == propAPIVersion)
 		return CC.CreateInteger(GetAPIVersion());
 
-	else if (strEquals(sProperty, PROPERTY_ATTRIBUTES))
+	else if (iProp == propAttributes)
 		{
 		TArray<CString> Attribs;
 		ParseAttributes(GetAttributes(), &Attribs);
@@ -586,10 +661,10 @@ ICCItem *CDesignType::FindBaseProperty (CCodeChainCtx &Ctx, const CString &sProp
 		return pResult;
 		}
 
-	else if (strEquals(sProperty, PROPERTY_CLASS))
+	else if (iProp == propClass)
 		return CC.CreateString(GetTypeClassName());
 
-	else if (strEquals(sProperty, PROPERTY_EXTENSION))
+	else if (iProp == propExtension)
 		{
 		if (m_pExtension)
 			return CC.CreateInteger(m_pExtension->GetUNID());
@@ -597,13 +672,13 @@ ICCItem *CDesignType::FindBaseProperty (CCodeChainCtx &Ctx, const CString &sProp
 			return CC.CreateNil();
 		}
 
-    else if (strEquals(sProperty, PROPERTY_MAP_DESCRIPTION))
+    else if (iProp == propMapDescription)
         return CC.CreateString(GetMapDescription(SMapDescriptionCtx()));
 
-    else if (strEquals(sProperty, PROPERTY_MERGED))
+    else if (iProp == propMerged)
         return CC.CreateBool(m_bIsMerged);
 
-    else if (strEquals(sProperty, PROPERTY_NAME_PATTERN))
+    else if (iProp == propNamePattern)
 		{
 		pResult = CC.CreateSymbolTable();
 		DWORD dwFlags;
@@ -612,13 +687,13 @@ ICCItem *CDesignType::FindBaseProperty (CCodeChainCtx &Ctx, const CString &sProp
 		return pResult;
 		}
 
-	else if (strEquals(sProperty, PROPERTY_OBSOLETE_VERSION))
+	else if (iProp == propObsoleteVersion)
 		return (m_dwObsoleteVersion > 0 ? CC.CreateInteger(m_dwObsoleteVersion) : CC.CreateNil());
 
-	else if (strEquals(sProperty, PROPERTY_REQUIRED_VERSION))
+	else if (iProp == propRequiredVersion)
 		return (m_dwMinVersion > 0 ? CC.CreateInteger(m_dwMinVersion) : CC.CreateNil());
 
-    else if (strEquals(sProperty, PROPERTY_UNID))
+    else if (iProp == propUNID)
 		return CC.CreateInteger(GetUNID());
 
 	//	Otherwise, we see if there is a data field
@@ -727,7 +802,35 @@ bool CDesignType::FindEventHandler (const CString &sEvent, SEventHandlerDesc *re
 	//	Ask subclasses
 
 	if (OnFindEventHandler(sEvent, retEvent))
+		{
+		if (retEvent)
+			{
+			retEvent->dwType = m_dwUNID;
+			retEvent->iEvent = FindEventID(sEvent);
+			}
+
+		return true;
+		}
+
+	//	If we've been bound, then all our handlers (including inherited ones)
+	//	are in the event table. If no type has ever defined this event, then we
+	//	don't have it either.
+
+	if (m_bEventTable)
+		{
+		int iID = FindEventID(sEvent);
+		if (iID == 0)
+			return false;
+
+		const SEventHandlerDesc *pDesc = m_EventTable.GetAt(iID);
+		if (pDesc == NULL)
+			return false;
+
+		if (retEvent)
+			*retEvent = *pDesc;
+
 		return true;
+		}
 
 	//	If we have it, great
 
@@ -738,6 +841,8 @@ bool CDesignType::FindEventHandler (const CString &sEvent, SEventHandlerDesc *re
 			{
 			retEvent->pExtension = m_pExtension;
 			retEvent->pCode = pCode;
+			retEvent->dwType = m_dwUNID;
+			retEvent->iEvent = FindEventID(sEvent);
 			}
 
 		return true;
@@ -745,8 +850,13 @@ bool CDesignType::FindEventHandler (const CString &sEvent, SEventHandlerDesc *re
 
 	//	Otherwise, see if we inherit
 
-	if (m_pInheritFrom)
-		return m_pInheritFrom->FindEventHandler(sEvent, retEvent);
+	if (m_pInheritFrom && m_pInheritFrom->FindEventHandler(sEvent, retEvent))
+		{
+		if (retEvent)
+			retEvent->dwType = m_dwUNID;
+
+		return true;
+		}
 
 	//	Otherwise, nothing
 
@@ -1674,6 +1784,19 @@ CString CDesignType::GetEntityName (void) const
 	return m_pExtension->GetEntityName(GetUNID());
 	}
 
+CString CDesignType::GetEventName (int iEventID)
+
+//	GetEventName
+//
+//	Returns the name of the event with the given ID (see SEventHandlerDesc).
+
+	{
+	if (iEventID < 1 || iEventID > g_EventNames.GetCount())
+		return NULL_STR;
+
+	return g_EventNames[iEventID - 1];
+	}
+
 ICCItem *CDesignType::GetEventHandler (const CString &sEvent) const
 
 //	GetEventHandler
@@ -2236,6 +2359,25 @@ bool CDesignType::HasLanguageEntry (const CString &sID) const
 	return false;
 	}
 
+bool CDesignType::HasLiteralAttribute (const CString &sAttrib) const
+
+//	HasLiteralAttribute
+//
+//	Returns TRUE if we have the given literal attribute. A single attribute name
+//	is looked up in our atom set; anything else (e.g., a blank string or a list)
+//	is matched against the original string.
+
+	{
+	if (!CAttributeSet::IsAtom(sAttrib))
+		return ::HasModifier(m_sAttributes, sAttrib);
+
+	DWORD dwAtom;
+	if (!CAttributeSet::FindAtom(sAttrib, &dwAtom))
+		return false;
+
+	return m_Attributes.Has(dwAtom);
+	}
+
 bool CDesignType::HasSpecialAttribute (const CString &sAttrib) const
 
 //	HasSpecialAttribute
@@ -2351,12 +2493,68 @@ void CDesignType::InitCachedEvents (void)
 				{
 				SetExtra()->EventsCache[j].pExtension = m_pExtension;
 				SetExtra()->EventsCache[j].pCode = pCode;
+				SetExtra()->EventsCache[j].dwType = m_dwUNID;
+				SetExtra()->EventsCache[j].iEvent = AtomizeEvent(sEvent);
 				break;
 				}
 			}
 		}
 	}
 
+void CDesignType::InitEventTable (void)
+
+//	InitEventTable
+//
+//	Resolves the names of all our event handlers (including inherited ones) to
+//	event IDs and stores them in m_EventTable.
+
+	{
+	int i;
+
+	m_EventTable.DeleteAll();
+	m_bEventTable = false;
+
+	CDesignType *pType = this;
+	while (pType)
+		{
+		//	Effect creators find some handlers through OnFindEventHandler, so
+		//	if we inherit from one we keep walking the hierarchy at lookup.
+
+		if (pType != this && pType->GetType() == designEffectType)
+			{
+			m_EventTable.DeleteAll();
+			return;
+			}
+
+		for (i = 0; i < pType->m_Events.GetCount(); i++)
+			{
+			ICCItem *pCode;
+			const CString &sEvent = pType->m_Events.GetEvent(i, &pCode);
+
+			//	Each event name gets a unique ID the first time any type defines
+			//	it.
+
+			int iID = AtomizeEvent(sEvent);
+
+			//	Descendants override ancestors
+
+			bool bNew;
+			SEventHandlerDesc *pDesc = m_EventTable.SetAt(iID, &bNew);
+			if (bNew)
+				{
+				pDesc->pExtension = pType->m_pExtension;
+				pDesc->pCode = pCode;
+				pDesc->dwType = m_dwUNID;
+				pDesc->iEvent = iID;
+				}
+			}
+
+		pType = pType->m_pInheritFrom;
+		}
+
+	m_bEventTable = true;
+	}
+
 void CDesignType::InitCachedEvents (int iCount, char **pszEvents, SEventHandlerDesc *retEvents)
 
 //	InitCachedEvents
@@ -2449,6 +2647,8 @@ ALERROR CDesignType::InitFromXML (SDesignLoadCtx &Ctx, CXMLElement *pDesc, bool
 	if (!pDesc->FindAttribute(ATTRIBUTES_ATTRIB, &m_sAttributes))
 		m_sAttributes = pDesc->GetAttribute(MODIFIERS_ATTRIB);
 
+	m_Attributes.InitFromList(m_sAttributes);
+
 	//	Load various elements
 
 	for (i = 0; i < pDesc->GetContentElementCount(); i++)
@@ -2581,20 +2781,29 @@ bool CDesignType::MatchesCriteria (const CDesignTypeCriteria &Criteria)
 			return false;
 		}
 
-	//	Check required attributes
+	//	Check literal attributes. Usually the criteria has compiled them into
+	//	atoms, which is much faster.
 
-	for (i = 0; i < Criteria.GetRequiredAttribCount(); i++)
-		if (!HasLiteralAttribute(Criteria.GetRequiredAttrib(i)))
+	if (Criteria.HasAttribAtoms())
+		{
+		if (!HasLiteralAttributes(Criteria.GetRequiredAttribAtoms(), Criteria.GetExcludedAttribAtoms()))
 			return false;
+		}
+	else
+		{
+		for (i = 0; i < Criteria.GetRequiredAttribCount(); i++)
+			if (!HasLiteralAttribute(Criteria.GetRequiredAttrib(i)))
+				return false;
 
-	for (i = 0; i < Criteria.GetRequiredSpecialAttribCount(); i++)
-		if (!HasSpecialAttribute(Criteria.GetRequiredSpecialAttrib(i)))
-			return false;
+		for (i = 0; i < Criteria.GetExcludedAttribCount(); i++)
+			if (HasLiteralAttribute(Criteria.GetExcludedAttrib(i)))
+				return false;
+		}
 
-	//	Check excluded attributes
+	//	Check special attributes
 
-	for (i = 0; i < Criteria.GetExcludedAttribCount(); i++)
-		if (HasLiteralAttribute(Criteria.GetExcludedAttrib(i)))
+	for (i = 0; i < Criteria.GetRequiredSpecialAttribCount(); i++)
+		if (!HasSpecialAttribute(Criteria.GetRequiredSpecialAttrib(i)))
 			return false;
 
 	for (i = 0; i < Criteria.GetExcludedSpecialAttribCount(); i++)
@@ -10,7 +10,8 @@ CDesignTypeCriteria::CDesignTypeCriteria (void) :
 		m_iGreaterThanLevel(INVALID_COMPARE),
 		m_iLessThanLevel(INVALID_COMPARE),
 		m_bIncludeVirtual(false),
-        m_bStructuresOnly(false)
+        m_bStructuresOnly(false),
+		m_bAttribAtoms(true)
 
 //	CDesignTypeCriteria constructor
 
@@ -429,6 +430,12 @@ ALERROR CDesignTypeCriteria::ParseCriteria (const CString &sCriteria, CDesignTyp
 		pPos++;
 		}
 
+	//	Compile literal attributes into atoms so that matching does not need
+	//	to scan attribute strings.
+
+	retCriteria->m_bAttribAtoms = (retCriteria->m_RequireAtoms.InitFromArray(retCriteria->m_sRequire)
+			&& retCriteria->m_ExcludeAtoms.InitFromArray(retCriteria->m_sExclude));
+
 	return NOERROR;
 	}
 
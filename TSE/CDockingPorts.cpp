@@ -720,14 +720,22 @@ void CDockingPorts::MoveAll (CSpaceObject *pOwner)
 	DEBUG_TRY
 
 	CVector vVel = pOwner->GetVel();
+	bool bMoved = false;
 
 	for (int i = 0; i < m_iPortCount; i++)
 		if (m_pPort[i].iStatus == psInUse)
 			{
 			m_pPort[i].pObj->SetPos(GetPortPos(pOwner, m_pPort[i], m_pPort[i].pObj));
 			m_pPort[i].pObj->SetVel(vVel);
+			bMoved = true;
 			}
 
+	//	SetPos does not touch the system (it may be called from worker 
+	//	threads), so we tell the system that its position index is stale.
+
+	if (bMoved && pOwner->GetSystem())
+		pOwner->GetSystem()->InvalidatePosIndex();
+
 	DEBUG_CATCH
 	}
 
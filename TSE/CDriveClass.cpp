@@ -18,6 +18,24 @@
 
 #define TAG_SCALING                 CONSTLIT("Scaling")
 
+enum EDriveClassProperties
+	{
+	propDrivePower,
+	propMaxSpeed,
+	propPower,
+	propThrust,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propDrivePower,					PROPERTY_DRIVE_POWER	},
+		{	propMaxSpeed,					PROPERTY_MAX_SPEED	},
+		{	propPower,						PROPERTY_POWER	},
+		{	propThrust,						PROPERTY_THRUST	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CDriveClass::CDriveClass (void) :
         m_pDesc(NULL),
         m_pDamagedDesc(NULL),
@@ -254,19 +272,20 @@ ICCItem *CDriveClass::FindItemProperty (CItemCtx &Ctx, const CString &sProperty)
 //	understand the property.
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	const SScalableStats *pDesc = GetDesc(Ctx);
     if (pDesc == NULL)
         return CDeviceClass::FindItemProperty(Ctx, sProperty);
 
-	if (strEquals(sProperty, PROPERTY_MAX_SPEED))
+	if (iProp == propMaxSpeed)
 		return CC.CreateInteger((int)((100.0 * pDesc->DriveDesc.GetMaxSpeed() / LIGHT_SPEED) + 0.5));
 
-	else if (strEquals(sProperty, PROPERTY_THRUST))
+	else if (iProp == propThrust)
 		return CC.CreateInteger(pDesc->DriveDesc.GetThrustProperty());
 	
-	else if (strEquals(sProperty, PROPERTY_POWER)
-			|| strEquals(sProperty, PROPERTY_DRIVE_POWER))
+	else if (iProp == propPower
+			|| iProp == propDrivePower)
 		return CC.CreateInteger(pDesc->DriveDesc.GetPowerUse() * 100);
 
 	//	Otherwise, just get the property from the base class
@@ -299,16 +318,17 @@ ICCItem *CDriveClass::GetDriveProperty (const CDriveDesc &Desc, const CString &s
 //	Returns property for a built-in drive.
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	CCodeChain &CC = g_pUniverse->GetCC();
 
-	if (strEquals(sProperty, PROPERTY_MAX_SPEED))
+	if (iProp == propMaxSpeed)
 		return CC.CreateInteger((int)((100.0 * Desc.GetMaxSpeed() / LIGHT_SPEED) + 0.5));
 
-	else if (strEquals(sProperty, PROPERTY_THRUST))
+	else if (iProp == propThrust)
 		return CC.CreateInteger(Desc.GetThrustProperty());
 	
-	else if (strEquals(sProperty, PROPERTY_POWER)
-			|| strEquals(sProperty, PROPERTY_DRIVE_POWER))
+	else if (iProp == propPower
+			|| iProp == propDrivePower)
 		return CC.CreateInteger(Desc.GetPowerUse() * 100);
 	else
 		return CC.CreateNil();
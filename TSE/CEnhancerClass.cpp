@@ -24,6 +24,20 @@
 #define PROPERTY_ENHANCEMENT_HP_BONUS			CONSTLIT("enhancement.hpBonus")
 #define PROPERTY_ENHANCEMENT_TYPE				CONSTLIT("enhancement.type")
 
+enum EEnhancerClassProperties
+	{
+	propEnhancementDamageType,
+	propEnhancementHPBonus,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propEnhancementDamageType,		PROPERTY_ENHANCEMENT_DAMAGE_TYPE	},
+		{	propEnhancementHPBonus,			PROPERTY_ENHANCEMENT_HP_BONUS	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 bool CEnhancerClass::AccumulateOldStyle (CItemCtx &Device, CInstalledDevice *pTarget, TArray<CString> &EnhancementIDs, CItemEnhancementStack *pEnhancements)
 
 //	AccumulateOldStyle
@@ -229,9 +243,10 @@ ICCItem *CEnhancerClass::FindEnhancementProperty (CItemCtx &Ctx, const CItemEnha
 //	Returns a property of the given enhancement. Return NULL if not found.
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 
-	if (strEquals(sName, PROPERTY_ENHANCEMENT_DAMAGE_TYPE))
+	if (iProp == propEnhancementDamageType)
 		{
 		DamageTypes iDamage = Enhancement.GetDamageType();
 		if (iDamage == damageError)
@@ -240,7 +255,7 @@ ICCItem *CEnhancerClass::FindEnhancementProperty (CItemCtx &Ctx, const CItemEnha
 			return CC.CreateString(::GetDamageType(iDamage));
 		}
 
-	else if (strEquals(sName, PROPERTY_ENHANCEMENT_HP_BONUS))
+	else if (iProp == propEnhancementHPBonus)
 		return CC.CreateInteger(Enhancement.GetResistHPBonus());
 
 	else
@@ -146,6 +146,8 @@ ALERROR CEventHandler::InitFromXML (SDesignLoadCtx &Ctx, CXMLElement *pDesc)
 	{
 	int i;
 
+	CCodeChainCtx CCCtx;
+
 	for (i = 0; i < pDesc->GetContentElementCount(); i++)
 		{
 		CXMLElement *pHandler = pDesc->GetContentElement(i);
@@ -153,7 +155,7 @@ ALERROR CEventHandler::InitFromXML (SDesignLoadCtx &Ctx, CXMLElement *pDesc)
 		CCodeChain::SLinkOptions Options;
 		Options.bNullIfEmpty = true;
 
-		ICCItemPtr pCode = ICCItemPtr(g_pUniverse->GetCC().Link(pHandler->GetContentText(0), Options));
+		ICCItemPtr pCode = CCCtx.LinkCode(Ctx, pHandler->GetContentText(0), Options);
 
 		//	If Link returns NULL, then it means that this was just whitespace
 		//	or comments only.
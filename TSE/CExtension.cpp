@@ -59,6 +59,8 @@
 #define USES_XML_ATTRIB							CONSTLIT("usesXML")
 #define VERSION_ATTRIB							CONSTLIT("version")
 
+#define FILESPEC_CODE_CACHE_FOLDER				CONSTLIT("_Cache")
+#define FILESPEC_CODE_CACHE_PATTERN				CONSTLIT("%s.tlc")
 #define FILESPEC_TDB_EXTENSION					CONSTLIT("tdb")
 
 //	The center of an adventure cover image is at this position relative to the
@@ -1062,6 +1064,20 @@ ALERROR CExtension::Load (ELoadStates iDesiredState, IXMLParserController *pReso
 					}
 				}
 
+			//	If we have a digest, then we can reuse code linked on a previous
+			//	launch. The cache lives in a folder that starts with '_', so we
+			//	never try to load it as an extension.
+
+			CLinkedCodeCache CodeCache;
+			if (iDesiredState == loadComplete && !m_Digest.IsEmpty())
+				{
+				CString sCacheFilespec = pathAddComponent(pathAddComponent(pathGetPath(m_sFilespec), FILESPEC_CODE_CACHE_FOLDER),
+						strPatternSubst(FILESPEC_CODE_CACHE_PATTERN, pathStripExtension(pathGetFilename(m_sFilespec))));
+
+				CodeCache.Load(sCacheFilespec, m_Digest, GetAPIVersion());
+				Ctx.pCodeCache = &CodeCache;
+				}
+
 			//	If we've already loaded a root element, then we need to clean up
 
 			if (m_pRootXML)
@@ -1107,6 +1123,17 @@ ALERROR CExtension::Load (ELoadStates iDesiredState, IXMLParserController *pReso
 					}
 				}
 
+			//	Remember the code we linked. Failing to save the cache is not an
+			//	error; we'll just link from source next time.
+
+			if (Ctx.pCodeCache)
+				{
+				if (CodeCache.Save() != NOERROR)
+					::kernelDebugLogPattern("Unable to save code cache for: %s", m_sFilespec);
+
+				Ctx.pCodeCache = NULL;
+				}
+
 			//	Restore
 
 			Ctx.pExtension = NULL;
@@ -1369,7 +1396,7 @@ ALERROR CExtension::LoadGlobalsElement (SDesignLoadCtx &Ctx, CXMLElement *pDesc)
 
 	//	Parse the code and keep it
 
-	ICCItemPtr pCode = CCCtx.LinkCode(pDesc->GetContentText(0));
+	ICCItemPtr pCode = CCCtx.LinkCode(Ctx, pDesc->GetContentText(0));
 	if (pCode->IsNil())
 		return NOERROR;
 
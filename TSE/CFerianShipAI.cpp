@@ -31,6 +31,43 @@ const int MINE_CYCLE_DELAY =					37;
 
 #define ATTRIBUTE_ASTEROID						(CONSTLIT("asteroid"))
 
+class CNearestThreatVisitor : public ISpaceObjectGridVisitor
+	{
+	public:
+		CNearestThreatVisitor (CShip *pShip, Metric rMaxDist2) :
+				m_pShip(pShip),
+				m_iDestiny(pShip->GetDestiny()),
+				m_rNearestDist2(rMaxDist2),
+				m_pNearestObj(NULL)
+			{ }
+
+		inline CSpaceObject *GetNearestObj (void) const { return m_pNearestObj; }
+
+		virtual bool OnObj (CSpaceObject *pObj) override
+			{
+			//	NOTE: The grid only passes us ships.
+
+			if ((!m_pShip->IsFriend(pObj) || pObj->GetDestiny() < m_iDestiny)
+					&& pObj->CanAttack())
+				{
+				Metric rDist2 = m_pShip->GetDistance2(pObj);
+				if (rDist2 < m_rNearestDist2)
+					{
+					m_pNearestObj = pObj;
+					m_rNearestDist2 = rDist2;
+					}
+				}
+
+			return true;
+			}
+
+	private:
+		CShip *m_pShip;
+		int m_iDestiny;
+		Metric m_rNearestDist2;
+		CSpaceObject *m_pNearestObj;
+	};
+
 CFerianShipAI::CFerianShipAI (void) : 
 		m_State(stateNone),
 		m_pTarget(NULL),
@@ -457,37 +494,13 @@ bool CFerianShipAI::InRangeOfThreat (CSpaceObject **retpThreat)
 	if (m_pShip->IsDestinyTime(19))
 		{
 		CSystem *pSystem = m_pShip->GetSystem();
-		int iDestiny = m_pShip->GetDestiny();
-
-		//	Get the list of objects that intersect the object
-
-		SSpaceObjectGridEnumerator i;
-		pSystem->EnumObjectsInBoxStart(i, m_pShip->GetPos(), MAX_THREAT_DIST);
-
-		//	Loop over all objects
-
-		Metric rNearestDist2 = MAX_THREAT_DIST * MAX_THREAT_DIST2;
-		CSpaceObject *pNearestObj = NULL;
-
-		while (pSystem->EnumObjectsInBoxHasMore(i))
-			{
-			CSpaceObject *pObj = pSystem->EnumObjectsInBoxGetNext(i);
+		CVector vRange(MAX_THREAT_DIST, MAX_THREAT_DIST);
 
-			//	If the object is in the bounding box then remember
-			//	it so that we can do a more accurate calculation.
+		//	Look for the nearest ship in the bounding box
 
-			if (pObj->GetCategory() == CSpaceObject::catShip
-					&& (!m_pShip->IsFriend(pObj) || pObj->GetDestiny() < iDestiny)
-					&& pObj->CanAttack())
-				{
-				Metric rDist2 = m_pShip->GetDistance2(pObj);
-				if (rDist2 < rNearestDist2)
-					{
-					pNearestObj = pObj;
-					rNearestDist2 = rDist2;
-					}
-				}
-			}
+		CNearestThreatVisitor Visitor(m_pShip, MAX_THREAT_DIST * MAX_THREAT_DIST2);
+		pSystem->GetObjectGrid().VisitInBox(Visitor, m_pShip->GetPos() + vRange, m_pShip->GetPos() - vRange, 0, CSpaceObject::catShip);
+		CSpaceObject *pNearestObj = Visitor.GetNearestObj();
 
 		//	Done
 
@@ -0,0 +1,288 @@
+//	CFlockIndex.cpp
+//
+//	CFlockIndex class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const Metric CELL_SIZE =					(100.0 * KLICKS_PER_PIXEL);
+
+void CFlockIndex::AddCell (DWORD dwKey, const SCell &Cell, CSpaceObject *pShip, CSpaceObject *pLeader, const DWORD *pLeaderCell, Metric rFOVRange2, Metric rSeparationRange2, STotals &Totals) const
+
+//	AddCell
+//
+//	Adds the members of the given cell to the totals. If the whole cell is in
+//	range and in front of the ship (but not close enough to avoid) we use the
+//	running totals instead of looking at each member.
+
+	{
+	int i;
+
+	//	Cell bounds relative to the ship
+
+	int x = (int)(short)HIWORD(dwKey);
+	int y = (int)(short)LOWORD(dwKey);
+	Metric xMin = (x * CELL_SIZE) - pShip->GetPos().GetX();
+	Metric xMax = xMin + CELL_SIZE;
+	Metric yMin = (y * CELL_SIZE) - pShip->GetPos().GetY();
+	Metric yMax = yMin + CELL_SIZE;
+
+	//	If the nearest point of the cell is out of range, nothing to do.
+
+	Metric xNear = (xMin > 0.0 ? xMin : (xMax < 0.0 ? xMax : 0.0));
+	Metric yNear = (yMin > 0.0 ? yMin : (yMax < 0.0 ? yMax : 0.0));
+	Metric rNear2 = (xNear * xNear) + (yNear * yNear);
+	if (rNear2 >= rFOVRange2)
+		return;
+
+	//	See if we can take the whole cell. The leader is added separately by
+	//	our caller, so we can't take its cell whole.
+
+	bool bWholeCell = (rNear2 >= rSeparationRange2
+			&& (pLeaderCell == NULL || *pLeaderCell != dwKey));
+
+	if (bWholeCell)
+		{
+		CVector Corners[4] = { CVector(xMin, yMin), CVector(xMax, yMin), CVector(xMin, yMax), CVector(xMax, yMax) };
+		for (i = 0; i < 4 && bWholeCell; i++)
+			{
+			if (Corners[i].Length2() >= rFOVRange2
+					|| Corners[i].Rotate(360 - pShip->GetRotation()).GetX() <= 0.0)
+				bWholeCell = false;
+			}
+		}
+
+	if (!bWholeCell)
+		{
+		for (i = 0; i < Cell.Members.GetCount(); i++)
+			AddMember(Cell.Members[i], pShip, pLeader, rFOVRange2, rSeparationRange2, Totals);
+
+		return;
+		}
+
+	//	Members are sorted by descending destiny, so the ones we follow are at
+	//	the front.
+
+	int iDestiny = pShip->GetDestiny();
+	int iLow = 0;
+	int iHigh = Cell.Members.GetCount();
+	while (iLow < iHigh)
+		{
+		int iMid = (iLow + iHigh) / 2;
+		if (Cell.Members[iMid].iDestiny > iDestiny)
+			iLow = iMid + 1;
+		else
+			iHigh = iMid;
+		}
+
+	if (iLow == 0)
+		return;
+
+	const SMember &Last = Cell.Members[iLow - 1];
+	Metric rCount = (Metric)iLow;
+
+	Totals.vFlockPos = Totals.vFlockPos + (Last.vPosTotal - (pShip->GetPos() * rCount));
+	Totals.vFlockVel = Totals.vFlockVel + (Last.vVelTotal - (pShip->GetVel() * rCount));
+	Totals.vFlockHeading = Totals.vFlockHeading + Last.vHeadingTotal;
+	Totals.rFlockCount = Totals.rFlockCount + rCount;
+	}
+
+void CFlockIndex::AddMember (const SMember &Member, CSpaceObject *pShip, CSpaceObject *pLeader, Metric rFOVRange2, Metric rSeparationRange2, STotals &Totals) const
+
+//	AddMember
+//
+//	Adds a single member to the totals.
+
+	{
+	if (Member.pObj == pShip || Member.pObj == pLeader)
+		return;
+
+	CVector vTarget = Member.vPos - pShip->GetPos();
+	Metric rTargetDist2 = vTarget.Dot(vTarget);
+
+	//	Only consider ships within a certain range
+
+	if (rTargetDist2 >= rFOVRange2)
+		return;
+
+	//	Only consider ships in front of us
+
+	CVector vTargetRot = vTarget.Rotate(360 - pShip->GetRotation());
+	if (vTargetRot.GetX() <= 0.0)
+		return;
+
+	//	Only ships of a certain destiny
+
+	if (Member.iDestiny > pShip->GetDestiny())
+		{
+		Totals.vFlockPos = Totals.vFlockPos + vTarget;
+		Totals.vFlockVel = Totals.vFlockVel + (Member.vVel - pShip->GetVel());
+		Totals.vFlockHeading = Totals.vFlockHeading + Member.vHeading;
+		Totals.rFlockCount = Totals.rFlockCount + 1.0;
+		}
+
+	//	Avoid ships that are too close
+
+	if (rTargetDist2 < rSeparationRange2)
+		{
+		Totals.vAvoid = Totals.vAvoid + vTarget;
+		Totals.rAvoidCount = Totals.rAvoidCount + 1.0;
+		}
+	}
+
+DWORD CFlockIndex::CalcCellKey (const CVector &vPos)
+
+//	CalcCellKey
+//
+//	Returns the key of the cell that contains the given position.
+
+	{
+	return MakeCellKey((int)floor(vPos.GetX() / CELL_SIZE), (int)floor(vPos.GetY() / CELL_SIZE));
+	}
+
+void CFlockIndex::CalcTotals (CSpaceObject *pShip, CSpaceObject *pLeader, Metric rFOVRange, Metric rSeparationRange, STotals &retTotals) const
+
+//	CalcTotals
+//
+//	Adds up the ships of pShip's sovereign that are within rFOVRange and in
+//	front of it (excluding pLeader). Ships with a higher destiny count towards
+//	the flock; ships within rSeparationRange count towards avoidance.
+
+	{
+	int i;
+
+	retTotals = STotals();
+
+	const SFlock *pFlock = m_Flocks.GetAt(pShip->GetSovereign());
+	if (pFlock == NULL)
+		return;
+
+	Metric rFOVRange2 = rFOVRange * rFOVRange;
+	Metric rSeparationRange2 = rSeparationRange * rSeparationRange;
+	const DWORD *pLeaderCell = (pLeader ? m_Members.GetAt(pLeader) : NULL);
+
+	const CVector &vPos = pShip->GetPos();
+	int xFrom = (int)floor((vPos.GetX() - rFOVRange) / CELL_SIZE);
+	int xTo = (int)floor((vPos.GetX() + rFOVRange) / CELL_SIZE);
+	int yFrom = (int)floor((vPos.GetY() - rFOVRange) / CELL_SIZE);
+	int yTo = (int)floor((vPos.GetY() + rFOVRange) / CELL_SIZE);
+
+	//	If the box covers more cells than the flock has, it is faster to look
+	//	at each of the flock's cells.
+
+	if ((xTo - xFrom + 1) * (yTo - yFrom + 1) > pFlock->Cells.GetCount())
+		{
+		for (i = 0; i < pFlock->Cells.GetCount(); i++)
+			{
+			DWORD dwKey = pFlock->Cells.GetKey(i);
+			int x = (int)(short)HIWORD(dwKey);
+			int y = (int)(short)LOWORD(dwKey);
+
+			if (x >= xFrom && x <= xTo && y >= yFrom && y <= yTo)
+				AddCell(dwKey, pFlock->Cells[i], pShip, pLeader, pLeaderCell, rFOVRange2, rSeparationRange2, retTotals);
+			}
+		}
+	else
+		{
+		int x, y;
+		for (y = yFrom; y <= yTo; y++)
+			for (x = xFrom; x <= xTo; x++)
+				{
+				DWORD dwKey = MakeCellKey(x, y);
+				const SCell *pCell = pFlock->Cells.GetAt(dwKey);
+				if (pCell)
+					AddCell(dwKey, *pCell, pShip, pLeader, pLeaderCell, rFOVRange2, rSeparationRange2, retTotals);
+				}
+		}
+	}
+
+void CFlockIndex::Init (CSystem &System)
+
+//	Init
+//
+//	Takes a snapshot of all armed ships in the system. We only get called
+//	during behavior (before anything moves), so positions are the same for
+//	every ship that asks this tick.
+
+	{
+	int i, j, k;
+
+	m_Flocks.DeleteAll();
+	m_Members.DeleteAll();
+
+	for (i = 0; i < System.GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = System.GetObject(i);
+		if (pObj == NULL || !IsCandidate(pObj))
+			continue;
+
+		DWORD dwCell = CalcCellKey(pObj->GetPos());
+		SCell *pCell = m_Flocks.SetAt(pObj->GetSovereign())->Cells.SetAt(dwCell);
+
+		SMember Member;
+		Member.pObj = pObj;
+		Member.vPos = pObj->GetPos();
+		Member.vVel = pObj->GetVel();
+		Member.vHeading = PolarToVector(pObj->GetRotation(), 1.0);
+		Member.iDestiny = pObj->GetDestiny();
+
+		//	Keep the cell sorted by descending destiny
+
+		int iPos = 0;
+		while (iPos < pCell->Members.GetCount() && pCell->Members[iPos].iDestiny >= Member.iDestiny)
+			iPos++;
+
+		pCell->Members.Insert(Member, iPos);
+		m_Members.SetAt(pObj, dwCell);
+		}
+
+	//	Compute running totals
+
+	for (i = 0; i < m_Flocks.GetCount(); i++)
+		{
+		SFlock &Flock = m_Flocks[i];
+		for (j = 0; j < Flock.Cells.GetCount(); j++)
+			{
+			TArray<SMember> &Members = Flock.Cells[j].Members;
+			CVector vPosTotal;
+			CVector vVelTotal;
+			CVector vHeadingTotal;
+
+			for (k = 0; k < Members.GetCount(); k++)
+				{
+				vPosTotal = vPosTotal + Members[k].vPos;
+				vVelTotal = vVelTotal + Members[k].vVel;
+				vHeadingTotal = vHeadingTotal + Members[k].vHeading;
+
+				Members[k].vPosTotal = vPosTotal;
+				Members[k].vVelTotal = vVelTotal;
+				Members[k].vHeadingTotal = vHeadingTotal;
+				}
+			}
+		}
+
+	m_bValid = true;
+	}
+
+bool CFlockIndex::IsCandidate (CSpaceObject *pObj)
+
+//	IsCandidate
+//
+//	Returns TRUE if the object can be part of a flock.
+
+	{
+	return (pObj->GetCategory() == CSpaceObject::catShip
+			&& pObj->CanAttack());	//	Excludes attached ship sections
+	}
+
+void CFlockIndex::OnObjRemoved (CSpaceObject *pObj)
+
+//	OnObjRemoved
+//
+//	An object has been removed from the system. If it was in the snapshot, the
+//	next ship to ask takes a new one.
+
+	{
+	if (m_bValid && m_Members.GetAt(pObj))
+		m_bValid = false;
+	}
@@ -22,6 +22,32 @@
 
 //	CInstalledDevice class
 
+enum EInstalledDeviceProperties
+	{
+	propCapacitor,
+	propExternal,
+	propExtraPowerUse,
+	propFireArc,
+	propLinkedFireOptions,
+	propPos,
+	propSecondary,
+	propTemperature,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propCapacitor,					PROPERTY_CAPACITOR	},
+		{	propExternal,					PROPERTY_EXTERNAL	},
+		{	propExtraPowerUse,				PROPERTY_EXTRA_POWER_USE	},
+		{	propFireArc,					PROPERTY_FIRE_ARC	},
+		{	propLinkedFireOptions,			PROPERTY_LINKED_FIRE_OPTIONS	},
+		{	propPos,						PROPERTY_POS	},
+		{	propSecondary,					PROPERTY_SECONDARY	},
+		{	propTemperature,				PROPERTY_TEMPERATURE	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CInstalledDevice::CInstalledDevice (void) : 
 		m_pItem(NULL),
 		m_pOverlay(NULL),
@@ -954,6 +980,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 //	the property for some reason.
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	if (IsEmpty())
 		{
@@ -963,7 +990,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 
 	//	Figure out what to set
 
-    if (strEquals(sName, PROPERTY_CAPACITOR))
+    if (iProp == propCapacitor)
         {
         CSpaceObject *pSource = Ctx.GetSource();
         if (!m_pClass->SetCounter(this, pSource, CDeviceClass::cntCapacitor, pValue->GetIntegerValue()))
@@ -972,7 +999,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
             return false;
             }
         }
-	else if (strEquals(sName, PROPERTY_EXTERNAL))
+	else if (iProp == propExternal)
 		{
 		bool bSetExternal = (pValue && !pValue->IsNil());
 		if (IsExternal() != bSetExternal)
@@ -990,12 +1017,12 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 			}
 		}
 
-	else if (strEquals(sName, PROPERTY_EXTRA_POWER_USE))
+	else if (iProp == propExtraPowerUse)
 		{
 		m_iExtraPowerUse = pValue->GetIntegerValue();
 		}
 
-	else if (strEquals(sName, PROPERTY_FIRE_ARC))
+	else if (iProp == propFireArc)
 		{
 		//	A value of nil means no fire arc (and no omni)
 
@@ -1041,7 +1068,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 			}
 		}
 
-	else if (strEquals(sName, PROPERTY_LINKED_FIRE_OPTIONS))
+	else if (iProp == propLinkedFireOptions)
 		{
 		//	Parse the options
 
@@ -1057,7 +1084,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 		SetLinkedFireOptions(dwOptions);
 		}
 
-	else if (strEquals(sName, PROPERTY_POS))
+	else if (iProp == propPos)
 		{
 		//	Get the parameters. We accept a single list parameter with angle/radius/z.
 		//	(The latter is compatible with the return of objGetDevicePos.)
@@ -1094,7 +1121,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 		SetPosZ(iZ);
 		}
 
-	else if (strEquals(sName, PROPERTY_SECONDARY))
+	else if (iProp == propSecondary)
 		{
 		if (pValue == NULL || !pValue->IsNil())
 			SetSecondary(true);
@@ -1102,7 +1129,7 @@ bool CInstalledDevice::SetProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 			SetSecondary(false);
 		}
 
-    else if (strEquals(sName, PROPERTY_TEMPERATURE))
+    else if (iProp == propTemperature)
         {
         CSpaceObject *pSource = Ctx.GetSource();
         if (!m_pClass->SetCounter(this, pSource, CDeviceClass::cntTemperature, pValue->GetIntegerValue()))
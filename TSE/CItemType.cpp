@@ -137,6 +137,46 @@ static char g_RandomDamagedAttrib[] = "randomDamaged";
 
 const int FLOTSAM_IMAGE_WIDTH =					32;
 
+enum EItemTypeProperties
+	{
+	propCategory,
+	propComponentPrice,
+	propComponents,
+	propCurrency,
+	propCurrencyName,
+	propDescription,
+	propFrequency,
+	propKnown,
+	propLevel,
+	propMassBonusPerCharge,
+	propMaxCharges,
+	propMaxLevel,
+	propMinLevel,
+	propValueBonusPerCharge,
+	propWeaponTypes,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propCategory,					PROPERTY_CATEGORY	},
+		{	propComponentPrice,				PROPERTY_COMPONENT_PRICE	},
+		{	propComponents,					PROPERTY_COMPONENTS	},
+		{	propCurrency,					PROPERTY_CURRENCY	},
+		{	propCurrencyName,				PROPERTY_CURRENCY_NAME	},
+		{	propDescription,				PROPERTY_DESCRIPTION	},
+		{	propFrequency,					PROPERTY_FREQUENCY	},
+		{	propKnown,						PROPERTY_KNOWN	},
+		{	propLevel,						PROPERTY_LEVEL	},
+		{	propMassBonusPerCharge,			PROPERTY_MASS_BONUS_PER_CHARGE	},
+		{	propMaxCharges,					PROPERTY_MAX_CHARGES	},
+		{	propMaxLevel,					PROPERTY_MAX_LEVEL	},
+		{	propMinLevel,					PROPERTY_MIN_LEVEL	},
+		{	propValueBonusPerCharge,		PROPERTY_VALUE_BONUS_PER_CHARGE	},
+		{	propWeaponTypes,				PROPERTY_WEAPON_TYPES	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CItemType::SStdStats CItemType::m_Stats[MAX_ITEM_LEVEL] = 
     {
         //  Treasure Value
@@ -491,14 +531,15 @@ ICCItem *CItemType::FindItemTypeBaseProperty (CCodeChainCtx &Ctx, const CString
 //	We return NULL if we do not understand the property.
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	ICCItem *pResult;
 	int i;
 
-	if (strEquals(sProperty, PROPERTY_CATEGORY))
+	if (iProp == propCategory)
 		return CC.CreateString(GetItemCategoryID(GetCategory()));
 
-	else if (strEquals(sProperty, PROPERTY_COMPONENT_PRICE))
+	else if (iProp == propComponentPrice)
 		{
 		int iTotalPrice = 0;
 		for (i = 0; i < GetComponents().GetCount(); i++)
@@ -510,7 +551,7 @@ ICCItem *CItemType::FindItemTypeBaseProperty (CCodeChainCtx &Ctx, const CString
 		return (iTotalPrice > 0 ? CC.CreateInteger(iTotalPrice) : CC.CreateNil());
 		}
 
-	else if (strEquals(sProperty, PROPERTY_COMPONENTS))
+	else if (iProp == propComponents)
 		{
 		const CItemList &Components = GetComponents();
 		if (Components.GetCount() == 0)
@@ -527,40 +568,40 @@ ICCItem *CItemType::FindItemTypeBaseProperty (CCodeChainCtx &Ctx, const CString
 		return pList;
 		}
 
-	else if (strEquals(sProperty, PROPERTY_CURRENCY))
+	else if (iProp == propCurrency)
 		return CC.CreateInteger(GetCurrencyType()->GetUNID());
 
-	else if (strEquals(sProperty, PROPERTY_CURRENCY_NAME))
+	else if (iProp == propCurrencyName)
 		return CC.CreateString(GetCurrencyType()->GetSID());
 
-	else if (strEquals(sProperty, PROPERTY_DESCRIPTION))
+	else if (iProp == propDescription)
 		return CC.CreateString(GetDesc());
 
-	else if (strEquals(sProperty, PROPERTY_FREQUENCY))
+	else if (iProp == propFrequency)
 		return CC.CreateString(GetFrequencyName((FrequencyTypes)GetFrequency()));
 
-    else if (strEquals(sProperty, PROPERTY_KNOWN))
+    else if (iProp == propKnown)
         return CC.CreateBool(IsKnown());
 
-    else if (strEquals(sProperty, PROPERTY_LEVEL))
+    else if (iProp == propLevel)
         return CC.CreateInteger(GetLevel());
 
-	else if (strEquals(sProperty, PROPERTY_MASS_BONUS_PER_CHARGE))
+	else if (iProp == propMassBonusPerCharge)
 		return CC.CreateInteger(GetMassBonusPerCharge());
 
-	else if (strEquals(sProperty, PROPERTY_MAX_CHARGES))
+	else if (iProp == propMaxCharges)
 		return CC.CreateInteger(GetMaxCharges());
 
-    else if (strEquals(sProperty, PROPERTY_MAX_LEVEL))
+    else if (iProp == propMaxLevel)
         return CC.CreateInteger(GetMaxLevel());
 
-    else if (strEquals(sProperty, PROPERTY_MIN_LEVEL))
+    else if (iProp == propMinLevel)
         return CC.CreateInteger(GetLevel());
 
-	else if (strEquals(sProperty, PROPERTY_VALUE_BONUS_PER_CHARGE))
+	else if (iProp == propValueBonusPerCharge)
 		return CC.CreateInteger(GetValueBonusPerCharge());
 
-	else if (strEquals(sProperty, PROPERTY_WEAPON_TYPES))
+	else if (iProp == propWeaponTypes)
 		{
 		if (GetLaunchWeapons().GetCount() == 0)
 			return CC.CreateNil();
@@ -0,0 +1,117 @@
+//	CKinematicsStore.cpp
+//
+//	CKinematicsStore class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const int MIN_PARALLEL_MOVE_OBJS =					2048;
+
+class CIntegrateTask : public IThreadPoolTask
+	{
+	public:
+		CIntegrateTask (Metric *pPosX, Metric *pPosY, const Metric *pVelX, const Metric *pVelY, int iCount, Metric rSeconds) :
+				m_pPosX(pPosX),
+				m_pPosY(pPosY),
+				m_pVelX(pVelX),
+				m_pVelY(pVelY),
+				m_iCount(iCount),
+				m_rSeconds(rSeconds)
+			{ }
+
+		virtual void Run (void)
+			{
+			CKinematicsStore::IntegrateRange(m_pPosX, m_pPosY, m_pVelX, m_pVelY, m_iCount, m_rSeconds);
+			}
+
+	private:
+		Metric *m_pPosX;
+		Metric *m_pPosY;
+		const Metric *m_pVelX;
+		const Metric *m_pVelY;
+		int m_iCount;
+		Metric m_rSeconds;
+	};
+
+int CKinematicsStore::Add (CSpaceObject *pObj)
+
+//	Add
+//
+//	Adds the object's current position and velocity to the store and returns
+//	its index.
+
+	{
+	const CVector &vPos = pObj->GetPos();
+	const CVector &vVel = pObj->GetVel();
+
+	m_PosX.Insert(vPos.GetX());
+	m_PosY.Insert(vPos.GetY());
+	m_VelX.Insert(vVel.GetX());
+	m_VelY.Insert(vVel.GetY());
+
+	return m_PosX.GetCount() - 1;
+	}
+
+void CKinematicsStore::DeleteAll (void)
+
+//	DeleteAll
+//
+//	Removes all entries.
+
+	{
+	m_PosX.DeleteAll();
+	m_PosY.DeleteAll();
+	m_VelX.DeleteAll();
+	m_VelY.DeleteAll();
+	}
+
+void CKinematicsStore::Integrate (CThreadPool *pThreadPool, Metric rSeconds)
+
+//	Integrate
+//
+//	Moves every entry along its velocity for the given time. If we have a lot
+//	of entries (and a thread pool) we split the arrays across threads.
+
+	{
+	int iCount = GetCount();
+	if (iCount == 0)
+		return;
+
+	Metric *pPosX = &m_PosX[0];
+	Metric *pPosY = &m_PosY[0];
+	const Metric *pVelX = &m_VelX[0];
+	const Metric *pVelY = &m_VelY[0];
+
+	int iTaskCount = (pThreadPool && iCount >= MIN_PARALLEL_MOVE_OBJS ? Min(pThreadPool->GetThreadCount(), iCount / MIN_PARALLEL_MOVE_OBJS) : 1);
+	if (iTaskCount <= 1)
+		{
+		IntegrateRange(pPosX, pPosY, pVelX, pVelY, iCount, rSeconds);
+		return;
+		}
+
+	int iChunk = (iCount + iTaskCount - 1) / iTaskCount;
+	for (int i = 0; i < iTaskCount; i++)
+		{
+		int iStart = i * iChunk;
+		int iEnd = Min(iCount, iStart + iChunk);
+		if (iStart < iEnd)
+			pThreadPool->AddTask(new CIntegrateTask(pPosX + iStart, pPosY + iStart, pVelX + iStart, pVelY + iStart, iEnd - iStart, rSeconds));
+		}
+
+	pThreadPool->Run();
+	}
+
+void CKinematicsStore::IntegrateRange (Metric *pPosX, Metric *pPosY, const Metric *pVelX, const Metric *pVelY, int iCount, Metric rSeconds)
+
+//	IntegrateRange
+//
+//	Inner loop. This is kept free of branches and calls so that the compiler
+//	can vectorize it.
+
+	{
+	for (int i = 0; i < iCount; i++)
+		{
+		pPosX[i] += pVelX[i] * rSeconds;
+		pPosY[i] += pVelY[i] * rSeconds;
+		}
+	}
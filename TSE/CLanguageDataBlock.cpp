@@ -273,7 +273,7 @@ ALERROR CLanguageDataBlock::InitFromXML (SDesignLoadCtx &Ctx, CXMLElement *pDesc
 				//	Link the code
 
 				CCodeChainCtx CCCtx;
-				ICCItemPtr pCode = CCCtx.LinkCode(pItem->GetContentText(0));
+				ICCItemPtr pCode = CCCtx.LinkCode(Ctx, pItem->GetContentText(0));
 
 				//	Nil means blank
 
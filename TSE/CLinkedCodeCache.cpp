@@ -0,0 +1,451 @@
+//	CLinkedCodeCache.cpp
+//
+//	CLinkedCodeCache class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+//
+//	FILE FORMAT
+//
+//	DWORD		'TLCC'
+//	DWORD		Format version
+//	DWORD		Extension API version
+//	DWORD		Engine API version
+//	DWORD		Digest length (in bytes)
+//	BYTE[]		Digest
+//	DWORD		Number of entries
+//
+//	For each entry
+//	DWORD		Length of source text
+//	BYTE[]		Source text
+//	DWORD		Length of serialized code
+//	BYTE[]		Serialized code
+//
+//	SERIALIZED CODE
+//
+//	DWORD		Item type (EItemTypes) | itemQuoted
+//
+//	itemNil		(nothing)
+//	itemInteger	DWORD value
+//	itemDouble	double value
+//	itemString	DWORD length, followed by characters
+//	itemList	DWORD count, followed by that many items
+
+#include "PreComp.h"
+
+const DWORD CACHE_SIGNATURE =				'TLCC';
+const DWORD CACHE_VERSION =					1;
+
+ICCItemPtr CLinkedCodeCache::Link (CCodeChain &CC, const CString &sCode, CCodeChain::SLinkOptions &Options)
+
+//	Link
+//
+//	Links the given code. If we linked the same text on a previous launch, we
+//	rebuild the code from its serialized form instead of parsing it. Either way
+//	the caller gets its own copy of the code.
+
+	{
+	//	Offsets only come up when reporting errors inside a larger string, so
+	//	we don't bother caching them.
+
+	if (Options.iOffset != 0)
+		return ICCItemPtr(CC.Link(sCode, Options));
+
+	//	See if we have it
+
+	CString *pData = m_Entries.GetAt(sCode);
+	if (pData)
+		{
+		char *pPos = pData->GetPointer();
+		char *pEnd = pPos + pData->GetLength();
+
+		ICCItem *pCode = ReadItem(CC, pPos, pEnd);
+		if (pCode && pPos == pEnd)
+			return ICCItemPtr(pCode);
+
+		//	If the entry is bad, we forget it and link from source.
+
+		if (pCode)
+			pCode->Discard(&CC);
+
+		m_Entries.DeleteAt(sCode);
+		m_bModified = true;
+		}
+
+	//	Link from source
+
+	ICCItem *pCode = CC.Link(sCode, Options);
+
+	//	We don't cache errors or Nil (which is also what empty code links to).
+
+	if (pCode == NULL || pCode->IsError() || pCode->IsNil())
+		return ICCItemPtr(pCode);
+
+	//	Serialize. If the code has items we can't serialize, then we don't
+	//	cache it.
+
+	CMemoryWriteStream Stream;
+	if (Stream.Create() != NOERROR)
+		return ICCItemPtr(pCode);
+
+	if (!WriteItem(Stream, pCode))
+		return ICCItemPtr(pCode);
+
+	CString sData(Stream.GetPointer(), Stream.GetLength());
+	Stream.Close();
+
+	//	Make sure we get the same code back before we keep it.
+
+	char *pPos = sData.GetPointer();
+	char *pEnd = pPos + sData.GetLength();
+	ICCItem *pCopy = ReadItem(CC, pPos, pEnd);
+	if (pCopy == NULL)
+		return ICCItemPtr(pCode);
+
+	bool bSame = (pPos == pEnd && strEquals(CC.Unlink(pCopy), CC.Unlink(pCode)));
+	pCopy->Discard(&CC);
+
+	if (bSame)
+		{
+		m_Entries.SetAt(sCode, sData);
+		m_bModified = true;
+		}
+
+	return ICCItemPtr(pCode);
+	}
+
+void CLinkedCodeCache::Load (const CString &sFilespec, const CIntegerIP &Digest, DWORD dwAPIVersion)
+
+//	Load
+//
+//	Loads the cache file for an extension with the given digest and API
+//	version. If the file is missing, was written for a different digest or
+//	version, or is corrupt, we start with an empty cache (and Save will
+//	replace the file).
+
+	{
+	int i;
+
+	m_sFilespec = sFilespec;
+	m_Digest = Digest;
+	m_dwAPIVersion = dwAPIVersion;
+	m_Entries.DeleteAll();
+	m_bModified = false;
+
+	if (!pathExists(sFilespec))
+		return;
+
+	CFileReadBlock File(sFilespec);
+	if (File.Open() != NOERROR)
+		return;
+
+	char *pPos = File.GetPointer(0, File.GetLength());
+	if (pPos == NULL)
+		return;
+
+	char *pEnd = pPos + File.GetLength();
+
+	//	Header
+
+	DWORD dwSignature;
+	DWORD dwVersion;
+	DWORD dwFileAPIVersion;
+	DWORD dwEngineAPIVersion;
+	DWORD dwDigestLen;
+	if (!ReadDWORD(pPos, pEnd, &dwSignature) || dwSignature != CACHE_SIGNATURE
+			|| !ReadDWORD(pPos, pEnd, &dwVersion) || dwVersion != CACHE_VERSION
+			|| !ReadDWORD(pPos, pEnd, &dwFileAPIVersion) || dwFileAPIVersion != m_dwAPIVersion
+			|| !ReadDWORD(pPos, pEnd, &dwEngineAPIVersion) || dwEngineAPIVersion != API_VERSION
+			|| !ReadDWORD(pPos, pEnd, &dwDigestLen) || dwDigestLen != (DWORD)m_Digest.GetLength()
+			|| dwDigestLen > (DWORD)(pEnd - pPos))
+		{
+		m_bModified = true;
+		return;
+		}
+
+	CIntegerIP FileDigest((int)dwDigestLen, (BYTE *)pPos);
+	pPos += dwDigestLen;
+	if (!(FileDigest == m_Digest))
+		{
+		m_bModified = true;
+		return;
+		}
+
+	//	Entries
+
+	DWORD dwCount;
+	if (!ReadDWORD(pPos, pEnd, &dwCount))
+		{
+		m_bModified = true;
+		return;
+		}
+
+	for (i = 0; i < (int)dwCount; i++)
+		{
+		CString sCode;
+		CString sData;
+		if (!ReadString(pPos, pEnd, &sCode) || !ReadString(pPos, pEnd, &sData))
+			{
+			::kernelDebugLogPattern("Ignoring corrupt code cache: %s", sFilespec);
+			m_Entries.DeleteAll();
+			m_bModified = true;
+			return;
+			}
+
+		m_Entries.SetAt(sCode, sData);
+		}
+	}
+
+bool CLinkedCodeCache::ReadDWORD (char *&pPos, char *pEnd, DWORD *retdwValue)
+
+//	ReadDWORD
+//
+//	Reads a DWORD and advances. Returns FALSE if we run past the end.
+
+	{
+	if ((DWORD)(pEnd - pPos) < sizeof(DWORD))
+		return false;
+
+	*retdwValue = *(DWORD *)pPos;
+	pPos += sizeof(DWORD);
+	return true;
+	}
+
+ICCItem *CLinkedCodeCache::ReadItem (CCodeChain &CC, char *&pPos, char *pEnd)
+
+//	ReadItem
+//
+//	Reads a serialized item and advances. Returns NULL if the data is corrupt.
+
+	{
+	int i;
+
+	DWORD dwType;
+	if (!ReadDWORD(pPos, pEnd, &dwType))
+		return NULL;
+
+	ICCItem *pItem;
+	switch (dwType & itemTypeMask)
+		{
+		//	Nil is a shared item, so we never quote it.
+
+		case itemNil:
+			if (dwType & itemQuoted)
+				return NULL;
+
+			return CC.CreateNil();
+
+		case itemInteger:
+			{
+			DWORD dwValue;
+			if (!ReadDWORD(pPos, pEnd, &dwValue))
+				return NULL;
+
+			pItem = CC.CreateInteger((int)dwValue);
+			break;
+			}
+
+		case itemDouble:
+			{
+			if ((DWORD)(pEnd - pPos) < sizeof(double))
+				return NULL;
+
+			pItem = CC.CreateDouble(*(double *)pPos);
+			pPos += sizeof(double);
+			break;
+			}
+
+		case itemString:
+			{
+			CString sValue;
+			if (!ReadString(pPos, pEnd, &sValue))
+				return NULL;
+
+			pItem = CC.CreateString(sValue);
+			break;
+			}
+
+		case itemList:
+			{
+			DWORD dwCount;
+			if (!ReadDWORD(pPos, pEnd, &dwCount))
+				return NULL;
+
+			//	Every element takes at least a DWORD, so a bigger count means
+			//	the data is corrupt.
+
+			if (dwCount > (DWORD)(pEnd - pPos) / sizeof(DWORD))
+				return NULL;
+
+			pItem = CC.CreateLinkedList();
+			if (pItem->IsError())
+				return NULL;
+
+			CCLinkedList *pList = (CCLinkedList *)pItem;
+			for (i = 0; i < (int)dwCount; i++)
+				{
+				ICCItem *pElement = ReadItem(CC, pPos, pEnd);
+				if (pElement == NULL)
+					{
+					pItem->Discard(&CC);
+					return NULL;
+					}
+
+				pList->Append(CC, pElement);
+				pElement->Discard(&CC);
+				}
+			break;
+			}
+
+		default:
+			return NULL;
+		}
+
+	if (dwType & itemQuoted)
+		pItem->SetQuoted();
+
+	return pItem;
+	}
+
+bool CLinkedCodeCache::ReadString (char *&pPos, char *pEnd, CString *retsValue)
+
+//	ReadString
+//
+//	Reads a length-prefixed string and advances. Returns FALSE if we run past
+//	the end.
+
+	{
+	DWORD dwLen;
+	if (!ReadDWORD(pPos, pEnd, &dwLen))
+		return false;
+
+	if (dwLen > (DWORD)(pEnd - pPos))
+		return false;
+
+	*retsValue = CString(pPos, (int)dwLen);
+	pPos += dwLen;
+	return true;
+	}
+
+ALERROR CLinkedCodeCache::Save (void)
+
+//	Save
+//
+//	Writes the cache file, if anything changed since we loaded it.
+
+	{
+	ALERROR error;
+	int i;
+
+	if (!m_bModified || m_sFilespec.IsBlank())
+		return NOERROR;
+
+	if (!pathCreate(pathGetPath(m_sFilespec)))
+		return ERR_FAIL;
+
+	CFileWriteStream File(m_sFilespec, FALSE);
+	if (error = File.Create())
+		return error;
+
+	DWORD dwSave = CACHE_SIGNATURE;
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+
+	dwSave = CACHE_VERSION;
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+
+	dwSave = m_dwAPIVersion;
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+
+	dwSave = API_VERSION;
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+
+	dwSave = (DWORD)m_Digest.GetLength();
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+	File.Write((char *)m_Digest.GetBytes(), m_Digest.GetLength(), NULL);
+
+	dwSave = (DWORD)m_Entries.GetCount();
+	File.Write((char *)&dwSave, sizeof(DWORD), NULL);
+
+	for (i = 0; i < m_Entries.GetCount(); i++)
+		{
+		WriteString(File, m_Entries.GetKey(i));
+		WriteString(File, m_Entries.GetValue(i));
+		}
+
+	File.Close();
+	m_bModified = false;
+
+	return NOERROR;
+	}
+
+bool CLinkedCodeCache::WriteItem (IWriteStream &Stream, ICCItem *pItem)
+
+//	WriteItem
+//
+//	Serializes the item. Returns FALSE if the item (or one of its elements) is
+//	not something that the linker produces and that we know how to rebuild.
+
+	{
+	int i;
+
+	DWORD dwQuoted = (pItem->IsQuoted() ? itemQuoted : 0);
+	DWORD dwSave;
+
+	if (pItem->IsNil())
+		{
+		if (dwQuoted)
+			return false;
+
+		dwSave = itemNil;
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+		}
+	else if (pItem->IsInteger())
+		{
+		dwSave = itemInteger | dwQuoted;
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+
+		dwSave = (DWORD)pItem->GetIntegerValue();
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+		}
+	else if (pItem->IsDouble())
+		{
+		dwSave = itemDouble | dwQuoted;
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+
+		double rValue = pItem->GetDoubleValue();
+		Stream.Write((char *)&rValue, sizeof(double));
+		}
+	else if (pItem->GetValueType() == ICCItem::String)
+		{
+		dwSave = itemString | dwQuoted;
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+
+		WriteString(Stream, pItem->GetStringValue());
+		}
+	else if (pItem->GetValueType() == ICCItem::List && !pItem->IsSymbolTable())
+		{
+		dwSave = itemList | dwQuoted;
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+
+		dwSave = (DWORD)pItem->GetCount();
+		Stream.Write((char *)&dwSave, sizeof(DWORD));
+
+		for (i = 0; i < pItem->GetCount(); i++)
+			if (!WriteItem(Stream, pItem->GetElement(i)))
+				return false;
+		}
+	else
+		return false;
+
+	return true;
+	}
+
+void CLinkedCodeCache::WriteString (IWriteStream &Stream, const CString &sValue)
+
+//	WriteString
+//
+//	Writes a length-prefixed string.
+
+	{
+	DWORD dwSave = (DWORD)sValue.GetLength();
+	Stream.Write((char *)&dwSave, sizeof(DWORD));
+	Stream.Write(sValue.GetPointer(), sValue.GetLength());
+	}
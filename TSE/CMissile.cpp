@@ -576,6 +576,21 @@ bool CMissile::HasAttribute (const CString &sAttribute) const
 	return pType->HasLiteralAttribute(sAttribute);
 	}
 
+bool CMissile::HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const
+
+//	HasAttributes
+//
+//	Returns TRUE if we have all the required attributes and none of the
+//	excluded ones.
+
+	{
+	CItemType *pType = m_pDesc->GetWeaponType();
+	if (pType == NULL)
+		return Required.IsEmpty();
+
+	return pType->HasLiteralAttributes(Required, Excluded);
+	}
+
 bool CMissile::IsAngryAt (CSpaceObject *pObj) const
 
 //	IsAngryAt
@@ -0,0 +1,82 @@
+//	CNavObstacleIndex.cpp
+//
+//	CNavObstacleIndex class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+void CNavObstacleIndex::Add (CSpaceObject *pObj)
+
+//	Add
+//
+//	An object has been added to the system.
+
+	{
+	if (m_bValid && IsCandidate(pObj))
+		m_Objs.Insert(pObj);
+	}
+
+const TArray<CSpaceObject *> &CNavObstacleIndex::GetObjects (CSystem &System)
+
+//	GetObjects
+//
+//	Returns the list of candidate obstacles, building it if necessary.
+
+	{
+	int i;
+
+	if (!m_bValid)
+		{
+		m_Objs.DeleteAll();
+		for (i = 0; i < System.GetObjectCount(); i++)
+			{
+			CSpaceObject *pObj = System.GetObject(i);
+			if (pObj && IsCandidate(pObj))
+				m_Objs.Insert(pObj);
+			}
+
+		m_bValid = true;
+		}
+
+	return m_Objs;
+	}
+
+bool CNavObstacleIndex::IsCandidate (CSpaceObject *pObj)
+
+//	IsCandidate
+//
+//	Returns TRUE if the object could ever be an obstacle. This must include
+//	every object that CNavigationPath::AddObstacles might use. Stations can
+//	change whether they block ships, so we take all of them.
+
+	{
+	return (pObj->GetScale() != scaleFlotsam
+			|| pObj->GetCategory() == CSpaceObject::catStation
+			|| pObj->HasGravity()
+			|| pObj->BlocksShips());
+	}
+
+void CNavObstacleIndex::Remove (CSpaceObject *pObj)
+
+//	Remove
+//
+//	An object has been removed from the system.
+
+	{
+	int iIndex;
+
+	//	Most removed objects (e.g., missiles and effects) were never in the
+	//	list, so we don't bother looking for them. IsCandidate only depends on
+	//	properties that are fixed when the object is created.
+
+	if (!m_bValid || !IsCandidate(pObj))
+		return;
+
+	if (!m_Objs.Find(pObj, &iIndex))
+		return;
+
+	//	Order doesn't matter, so we swap in the last entry.
+
+	m_Objs[iIndex] = m_Objs[m_Objs.GetCount() - 1];
+	m_Objs.Delete(m_Objs.GetCount() - 1);
+	}
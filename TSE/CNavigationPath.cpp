@@ -20,7 +20,9 @@ CNavigationPath::CNavigationPath (void) :
 		m_iSuccesses(0),
 		m_iFailures(0),
 		m_iWaypointCount(0),
-		m_Waypoints(NULL)
+		m_Waypoints(NULL),
+		m_dwRevision(0),
+		m_bPending(false)
 
 //	CNavigationPath constructor
 
@@ -36,21 +38,23 @@ CNavigationPath::~CNavigationPath (void)
 		delete [] m_Waypoints;
 	}
 
-int CNavigationPath::ComputePath (CSystem *pSystem, CSovereign *pSovereign, const CVector &vFrom, const CVector &vTo, CVector **retpPoints)
+void CNavigationPath::AddObstacles (CSystem *pSystem, CSovereign *pSovereign, const CVector &vFrom, const CVector &vTo, CAStarPathFinder &AStar)
 
-//	ComputePath
+//	AddObstacles
 //
-//	This uses an A* algorithm to find a path from one place to another
+//	Adds to AStar all the obstacles that a ship of the given sovereign needs to
+//	avoid when going from vFrom to vTo.
 
 	{
 	int i;
-	CAStarPathFinder AStar;
 
-	//	Add the obstacles that we need to avoid
+	//	We only need to look at objects that could be obstacles (this skips
+	//	missiles, beams, effects, etc.).
 
-	for (i = 0; i < pSystem->GetObjectCount(); i++)
+	const TArray<CSpaceObject *> &Candidates = pSystem->GetNavObstacles();
+	for (i = 0; i < Candidates.GetCount(); i++)
 		{
-		CSpaceObject *pObj = pSystem->GetObject(i);
+		CSpaceObject *pObj = Candidates[i];
 		CSovereign *pObjSovereign;
 
 		if (pObj == NULL)
@@ -100,22 +104,19 @@ int CNavigationPath::ComputePath (CSystem *pSystem, CSovereign *pSovereign, cons
 				AStar.AddObstacle(vUR, vLL);
 			}
 		}
+	}
 
-	//	Compute a path
+int CNavigationPath::ComputePath (CSystem *pSystem, CSovereign *pSovereign, const CVector &vFrom, const CVector &vTo, CVector **retpPoints)
 
-	CVector *pPathList;
-	int iPathCount = AStar.FindPath(vFrom, vTo, &pPathList);
-	if (iPathCount <= 0)
-		{
-		*retpPoints = new CVector;
-		(*retpPoints)[0] = vTo;
-		return 1;
-		}
-	else
-		{
-		*retpPoints = pPathList;
-		return iPathCount;
-		}
+//	ComputePath
+//
+//	This uses an A* algorithm to find a path from one place to another
+
+	{
+	CAStarPathFinder AStar;
+
+	AddObstacles(pSystem, pSovereign, vFrom, vTo, AStar);
+	return FindPath(AStar, vFrom, vTo, retpPoints);
 	}
 
 #if 0
@@ -287,6 +288,35 @@ void CNavigationPath::Create (CSystem *pSystem, CSovereign *pSovereign, const CV
 	*retpPath = pNewPath;
 	}
 
+void CNavigationPath::CreatePending (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd, CNavigationPath **retpPath)
+
+//	CreatePending
+//
+//	Creates a path from pStart to pEnd whose only waypoint is pEnd. The caller
+//	must queue it with the path service, which will compute the real
+//	waypoints. Until then, ships following the path fly straight at the end.
+
+	{
+	ASSERT(pStart);
+	ASSERT(pEnd);
+
+	CNavigationPath *pNewPath = new CNavigationPath;
+	pNewPath->m_dwID = g_pUniverse->CreateGlobalID();
+	pNewPath->m_pSovereign = pSovereign;
+	pNewPath->m_iStartIndex = pStart->GetID();
+	pNewPath->m_iEndIndex = pEnd->GetID();
+
+	pNewPath->m_vStart = pStart->GetPos();
+	pNewPath->m_iWaypointCount = 1;
+	pNewPath->m_Waypoints = new CVector [1];
+	pNewPath->m_Waypoints[0] = pEnd->GetPos();
+	pNewPath->m_bPending = true;
+
+	//	Done
+
+	*retpPath = pNewPath;
+	}
+
 CString CNavigationPath::DebugDescribe (CSpaceObject *pObj, CNavigationPath *pNavPath)
 
 //	DebugDescribe
@@ -409,6 +439,30 @@ void CNavigationPath::DebugPaintInfo (CG32bitImage &Dest, int x, int y, const CM
 		}
 	}
 
+int CNavigationPath::FindPath (CAStarPathFinder &AStar, const CVector &vFrom, const CVector &vTo, CVector **retpPoints)
+
+//	FindPath
+//
+//	Runs the search on a path finder that already has its obstacles. If we
+//	can't find a path, we return a straight line to the destination. This does
+//	not touch the system, so it is safe to call from a worker thread.
+
+	{
+	CVector *pPathList;
+	int iPathCount = AStar.FindPath(vFrom, vTo, &pPathList);
+	if (iPathCount <= 0)
+		{
+		*retpPoints = new CVector;
+		(*retpPoints)[0] = vTo;
+		return 1;
+		}
+	else
+		{
+		*retpPoints = pPathList;
+		return iPathCount;
+		}
+	}
+
 CVector CNavigationPath::GetNavPoint (int iIndex) const
 
 //	GetNavPoint
@@ -512,8 +566,21 @@ void CNavigationPath::OnWriteToStream (CSystem *pSystem, IWriteStream *pStream)
 //	CVector		m_vStart
 //	DWORD		m_iWaypointCount
 //	CVector		Waypoints
+//
+//	NOTE: If we're still waiting for the path service, we save the waypoints
+//	that it would compute, but we leave this path pending. Saving must not
+//	change the game.
 
 	{
+	int iWaypointCount = m_iWaypointCount;
+	CVector *pWaypoints = m_Waypoints;
+	if (m_bPending)
+		{
+		CAStarPathFinder AStar;
+		AddObstacles(pSystem, m_pSovereign, m_vStart, GetPathEnd(), AStar);
+		iWaypointCount = FindPath(AStar, m_vStart, GetPathEnd(), &pWaypoints);
+		}
+
 	pStream->Write((char *)&m_dwID, sizeof(DWORD));
 	pSystem->WriteSovereignRefToStream(m_pSovereign, pStream);
 	pStream->Write((char *)&m_iStartIndex, sizeof(DWORD));
@@ -523,9 +590,12 @@ void CNavigationPath::OnWriteToStream (CSystem *pSystem, IWriteStream *pStream)
 	pStream->Write((char *)&m_iFailures, sizeof(DWORD));
 
 	pStream->Write((char *)&m_vStart, sizeof(CVector));
-	pStream->Write((char *)&m_iWaypointCount, sizeof(DWORD));
-	if (m_iWaypointCount)
-		pStream->Write((char *)m_Waypoints, sizeof(CVector) * m_iWaypointCount);
+	pStream->Write((char *)&iWaypointCount, sizeof(DWORD));
+	if (iWaypointCount)
+		pStream->Write((char *)pWaypoints, sizeof(CVector) * iWaypointCount);
+
+	if (pWaypoints != m_Waypoints)
+		delete [] pWaypoints;
 	}
 
 bool CNavigationPath::PathIsClear (CSystem *pSystem,
@@ -589,3 +659,21 @@ bool CNavigationPath::PathIsClear (CSystem *pSystem,
 	return true;
 	}
 
+void CNavigationPath::SetWaypoints (int iCount, CVector *pWaypoints)
+
+//	SetWaypoints
+//
+//	Replaces our waypoints with the given (allocated) array, which we take
+//	ownership of. This completes a pending path.
+
+	{
+	ASSERT(iCount > 0);
+
+	if (m_Waypoints)
+		delete [] m_Waypoints;
+
+	m_iWaypointCount = iCount;
+	m_Waypoints = pWaypoints;
+	m_dwRevision++;
+	m_bPending = false;
+	}
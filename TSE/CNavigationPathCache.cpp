@@ -0,0 +1,63 @@
+//	CNavigationPathCache.cpp
+//
+//	CNavigationPathCache class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+void CNavigationPathCache::Add (CNavigationPath *pPath)
+
+//	Add
+//
+//	Adds a path to the index. Paths added later take precedence over older
+//	paths with the same endpoints (this matches the order of the system's
+//	path list).
+
+	{
+	TArray<CNavigationPath *> *pList = m_ByEndpoints.SetAt(MakeKey(pPath->GetStartID(), pPath->GetEndID()));
+	pList->Insert(pPath, 0);
+
+	m_ByID.SetAt(pPath->GetID(), pPath);
+	}
+
+void CNavigationPathCache::DeleteAll (void)
+
+//	DeleteAll
+//
+//	Clears the index.
+
+	{
+	m_ByEndpoints.DeleteAll();
+	m_ByID.DeleteAll();
+	}
+
+CNavigationPath *CNavigationPathCache::Find (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd) const
+
+//	Find
+//
+//	Returns the newest path that matches the request (or NULL).
+
+	{
+	int i;
+
+	const TArray<CNavigationPath *> *pList = m_ByEndpoints.GetAt(MakeKey(pStart->GetID(), pEnd->GetID()));
+	if (pList == NULL)
+		return NULL;
+
+	for (i = 0; i < pList->GetCount(); i++)
+		if ((*pList)[i]->Matches(pSovereign, pStart, pEnd))
+			return (*pList)[i];
+
+	return NULL;
+	}
+
+CNavigationPath *CNavigationPathCache::FindByID (DWORD dwID) const
+
+//	FindByID
+//
+//	Returns the path with the given ID (or NULL).
+
+	{
+	CNavigationPath * const *ppPath = m_ByID.GetAt(dwID);
+	return (ppPath ? *ppPath : NULL);
+	}
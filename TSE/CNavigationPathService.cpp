@@ -0,0 +1,142 @@
+//	CNavigationPathService.cpp
+//
+//	CNavigationPathService class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+struct SNavPathJob
+	{
+	SNavPathJob (void) :
+			pPath(NULL),
+			pAStar(NULL),
+			iCount(0),
+			pWaypoints(NULL)
+		{ }
+
+	CNavigationPath *pPath;
+	CAStarPathFinder *pAStar;
+	CVector vFrom;
+	CVector vTo;
+
+	int iCount;
+	CVector *pWaypoints;
+	};
+
+class CFindNavPathTask : public IThreadPoolTask
+	{
+	public:
+		CFindNavPathTask (SNavPathJob *pJob) :
+				m_pJob(pJob)
+			{ }
+
+		virtual void Run (void)
+			{
+			m_pJob->iCount = CNavigationPath::FindPath(*m_pJob->pAStar, m_pJob->vFrom, m_pJob->vTo, &m_pJob->pWaypoints);
+			}
+
+	private:
+		SNavPathJob *m_pJob;
+	};
+
+void CNavigationPathService::Cancel (CNavigationPath *pPath)
+
+//	Cancel
+//
+//	Removes the path from the queue (if it is there). The path stays pending.
+
+	{
+	int iIndex;
+	if (m_Queue.Find(pPath, &iIndex))
+		m_Queue.Delete(iIndex);
+	}
+
+void CNavigationPathService::Complete (CSystem &System, CNavigationPath *pPath)
+
+//	Complete
+//
+//	Computes the given pending path right now. We use this when someone needs
+//	the real waypoints immediately (e.g., a script).
+
+	{
+	if (!pPath->IsPending())
+		return;
+
+	Cancel(pPath);
+
+	CAStarPathFinder AStar;
+	CNavigationPath::AddObstacles(&System, pPath->GetSovereign(), pPath->GetPathStart(), pPath->GetPathEnd(), AStar);
+
+	CVector *pWaypoints;
+	int iCount = CNavigationPath::FindPath(AStar, pPath->GetPathStart(), pPath->GetPathEnd(), &pWaypoints);
+	pPath->SetWaypoints(iCount, pWaypoints);
+	}
+
+void CNavigationPathService::Update (CSystem &System, CThreadPool *pThreadPool, int iMaxPaths)
+
+//	Update
+//
+//	Computes up to iMaxPaths pending paths, oldest first. Obstacles are
+//	collected here (since that looks at system objects); the searches
+//	themselves only look at their own obstacle list, so we can run them on the
+//	given thread pool (if any).
+
+	{
+	int i;
+
+	int iCount = Min(iMaxPaths, m_Queue.GetCount());
+	if (iCount <= 0)
+		return;
+
+	//	Set up a search for each path.
+
+	TArray<SNavPathJob> Jobs;
+	Jobs.InsertEmpty(iCount);
+	for (i = 0; i < iCount; i++)
+		{
+		SNavPathJob &Job = Jobs[i];
+		Job.pPath = m_Queue[i];
+		Job.vFrom = Job.pPath->GetPathStart();
+		Job.vTo = Job.pPath->GetPathEnd();
+		Job.pAStar = new CAStarPathFinder;
+
+		CNavigationPath::AddObstacles(&System, Job.pPath->GetSovereign(), Job.vFrom, Job.vTo, *Job.pAStar);
+		}
+
+	//	Take the paths off the queue (usually we take all of them).
+
+	if (iCount == m_Queue.GetCount())
+		m_Queue.DeleteAll();
+	else
+		{
+		int iLeft = m_Queue.GetCount() - iCount;
+		for (i = 0; i < iLeft; i++)
+			m_Queue[i] = m_Queue[iCount + i];
+
+		while (m_Queue.GetCount() > iLeft)
+			m_Queue.Delete(m_Queue.GetCount() - 1);
+		}
+
+	//	Search
+
+	if (pThreadPool && iCount > 1)
+		{
+		for (i = 0; i < iCount; i++)
+			pThreadPool->AddTask(new CFindNavPathTask(&Jobs[i]));
+
+		pThreadPool->Run();
+		}
+	else
+		{
+		for (i = 0; i < iCount; i++)
+			Jobs[i].iCount = CNavigationPath::FindPath(*Jobs[i].pAStar, Jobs[i].vFrom, Jobs[i].vTo, &Jobs[i].pWaypoints);
+		}
+
+	//	Hand the results to the paths.
+
+	for (i = 0; i < iCount; i++)
+		{
+		Jobs[i].pPath->SetWaypoints(Jobs[i].iCount, Jobs[i].pWaypoints);
+		delete Jobs[i].pAStar;
+		}
+	}
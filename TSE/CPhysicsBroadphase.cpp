@@ -0,0 +1,169 @@
+//	CPhysicsBroadphase.cpp
+//
+//	CPhysicsBroadphase class
+//	Copyright (c) 2018 by Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+int KeyCompare (const CPhysicsBroadphase::SEntry &Key1, const CPhysicsBroadphase::SEntry &Key2)
+	{
+	if (Key1.xMin > Key2.xMin)
+		return 1;
+	else if (Key1.xMin < Key2.xMin)
+		return -1;
+	else
+		return 0;
+	}
+
+void CPhysicsBroadphase::AddBarrier (CSpaceObject *pObj, const CVector &vUR, const CVector &vLL)
+
+//	AddBarrier
+//
+//	Adds an object that can block testers.
+
+	{
+	AddEntry(pObj, -1, vUR, vLL);
+	}
+
+void CPhysicsBroadphase::AddEntry (CSpaceObject *pObj, int iTester, const CVector &vUR, const CVector &vLL)
+
+//	AddEntry
+//
+//	Adds an entry to be sorted.
+
+	{
+	SEntry *pEntry = m_Entries.Insert();
+	pEntry->pObj = pObj;
+	pEntry->iTester = iTester;
+	pEntry->xMin = vLL.GetX();
+	pEntry->xMax = vUR.GetX();
+	pEntry->yMin = vLL.GetY();
+	pEntry->yMax = vUR.GetY();
+	}
+
+void CPhysicsBroadphase::AddTester (CSpaceObject *pObj, const CVector &vUR, const CVector &vLL)
+
+//	AddTester
+//
+//	Adds an object that needs to be tested against barriers. Testers are
+//	numbered in the order in which they are added.
+
+	{
+	AddEntry(pObj, m_Testers.GetCount(), vUR, vLL);
+	m_Testers.Insert(pObj);
+	}
+
+void CPhysicsBroadphase::CalcPairs (void)
+
+//	CalcPairs
+//
+//	Sorts all entries by their left edge and sweeps from left to right, keeping
+//	a list of testers and barriers whose x-extent overlaps the sweep line.
+//	Every tester/barrier pair that overlaps on both axes becomes a candidate.
+
+	{
+	int i, j;
+
+	m_Pairs.DeleteAll();
+	m_ActiveTesters.DeleteAll();
+	m_ActiveBarriers.DeleteAll();
+
+	m_Entries.Sort();
+
+	for (i = 0; i < m_Entries.GetCount(); i++)
+		{
+		const SEntry &Entry = m_Entries[i];
+
+		PruneActive(m_Entries, m_ActiveTesters, Entry.xMin);
+		PruneActive(m_Entries, m_ActiveBarriers, Entry.xMin);
+
+		//	Pair with every active entry of the opposite kind that overlaps us
+		//	on the y-axis.
+
+		TArray<int> &Others = (Entry.iTester != -1 ? m_ActiveBarriers : m_ActiveTesters);
+		for (j = 0; j < Others.GetCount(); j++)
+			{
+			const SEntry &Other = m_Entries[Others[j]];
+			if (Other.pObj == Entry.pObj
+					|| Other.yMax < Entry.yMin
+					|| Other.yMin > Entry.yMax)
+				continue;
+
+			SPair *pPair = m_Pairs.Insert();
+			if (Entry.iTester != -1)
+				{
+				pPair->iTester = Entry.iTester;
+				pPair->pBarrier = Other.pObj;
+				}
+			else
+				{
+				pPair->iTester = Other.iTester;
+				pPair->pBarrier = Entry.pObj;
+				}
+			}
+
+		if (Entry.iTester != -1)
+			m_ActiveTesters.Insert(i);
+		else
+			m_ActiveBarriers.Insert(i);
+		}
+
+	//	Group the pairs by tester (counting sort).
+
+	m_CandidateStart.DeleteAll();
+	m_CandidateStart.InsertEmpty(m_Testers.GetCount() + 1);
+	for (i = 0; i < m_CandidateStart.GetCount(); i++)
+		m_CandidateStart[i] = 0;
+
+	for (i = 0; i < m_Pairs.GetCount(); i++)
+		m_CandidateStart[m_Pairs[i].iTester + 1]++;
+
+	for (i = 1; i < m_CandidateStart.GetCount(); i++)
+		m_CandidateStart[i] += m_CandidateStart[i - 1];
+
+	m_Candidates.DeleteAll();
+	m_Candidates.InsertEmpty(m_Pairs.GetCount());
+
+	m_NextCandidate.DeleteAll();
+	m_NextCandidate.InsertEmpty(m_Testers.GetCount());
+	for (i = 0; i < m_Testers.GetCount(); i++)
+		m_NextCandidate[i] = m_CandidateStart[i];
+
+	for (i = 0; i < m_Pairs.GetCount(); i++)
+		m_Candidates[m_NextCandidate[m_Pairs[i].iTester]++] = m_Pairs[i].pBarrier;
+	}
+
+void CPhysicsBroadphase::DeleteAll (void)
+
+//	DeleteAll
+//
+//	Remove all entries.
+
+	{
+	m_Entries.DeleteAll();
+	m_Testers.DeleteAll();
+	m_CandidateStart.DeleteAll();
+	m_Candidates.DeleteAll();
+	}
+
+void CPhysicsBroadphase::PruneActive (const TArray<SEntry> &Entries, TArray<int> &Active, Metric xMin)
+
+//	PruneActive
+//
+//	Removes any entries that end before the sweep line.
+
+	{
+	int i = 0;
+	while (i < Active.GetCount())
+		{
+		if (Entries[Active[i]].xMax < xMin)
+			{
+			//	Order doesn't matter, so we swap in the last entry.
+
+			Active[i] = Active[Active.GetCount() - 1];
+			Active.Delete(Active.GetCount() - 1);
+			}
+		else
+			i++;
+		}
+	}
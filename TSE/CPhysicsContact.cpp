@@ -146,15 +146,20 @@ void CPhysicsContact::Resolve (void)
 
 //	Resolve
 //
-//	Resolve the contact
+//	Resolve the contact. We remember how much each object moved (in m_vMove1
+//	and m_vMove2) so that the resolver can update other contacts.
 
 	{
+	m_vMove1 = CVector();
+	m_vMove2 = CVector();
+
 	switch (m_iType)
 		{
 		//	Collisions of ship with barriers get handled differently so that we
 		//	avoid getting stuck.
 
 		case contactBarrierCollision:
+			m_vMove1 = m_pObj->GetOldPos() - m_pObj->GetPos();
 			m_pObj->SetPos(m_pObj->GetOldPos());
 			m_pObj->SetVel(-m_rRestitution * m_pObj->GetVel());
 			m_rPenetration = 0.0;
@@ -184,8 +189,11 @@ void CPhysicsContact::ResolveInterpenetration (void)
 
 	//	Move both objects
 
-	m_vMove1 = vMovePerInvMass * m_rInvMass1;
-	m_pObj->SetPos(m_pObj->GetPos() + m_vMove1);
+	if (m_rInvMass1 > 0.0)
+		{
+		m_vMove1 = vMovePerInvMass * m_rInvMass1;
+		m_pObj->SetPos(m_pObj->GetPos() + m_vMove1);
+		}
 
 	if (m_rInvMass2 > 0.0)
 		{
@@ -223,7 +231,8 @@ void CPhysicsContact::ResolveVelocity (void)
 
 	//	Apply impulse to both objects
 
-	m_pObj->DeltaV(vImpulsePerInvMass * m_rInvMass1);
+	if (m_rInvMass1 > 0.0)
+		m_pObj->DeltaV(vImpulsePerInvMass * m_rInvMass1);
 
 	if (m_rInvMass2 > 0.0)
 		m_pContactObj->DeltaV(vImpulsePerInvMass * -m_rInvMass2);
@@ -6,6 +6,29 @@
 #include "PreComp.h"
 
 const int MAX_CONTACTS = 100;
+const int MIN_PARALLEL_CONTACTS = 128;
+
+class CPhysicsContactResolver::CSolveIslandsTask : public IThreadPoolTask
+	{
+	public:
+		CSolveIslandsTask (CPhysicsContactResolver &Resolver, int iStart, int iEnd) :
+				m_Resolver(Resolver),
+				m_iStart(iStart),
+				m_iEnd(iEnd)
+			{ }
+
+		virtual void Run (void)
+			{
+			CQueue Queue;
+			for (int i = m_iStart; i < m_iEnd; i++)
+				m_Resolver.SolveIsland(m_Resolver.m_Islands[i], Queue);
+			}
+
+	private:
+		CPhysicsContactResolver &m_Resolver;
+		int m_iStart;
+		int m_iEnd;
+	};
 
 void CPhysicsContactResolver::AddCollision (CSpaceObject *pObj, CSpaceObject *pContactObj)
 
@@ -57,122 +80,464 @@ void CPhysicsContactResolver::BeginUpdate (void)
 	m_Contacts.GrowToFit(MAX_CONTACTS);
 	}
 
-CPhysicsContact *CPhysicsContactResolver::FindContactToResolve (void) const
+void CPhysicsContactResolver::CalcIslands (void)
 
-//	FindContactToResolve
+//	CalcIslands
 //
-//	Returns the best contact to resolve. If none found, we return NULL.
+//	Assigns a node to each object, builds the list of contacts for each node,
+//	and groups contacts into islands. Objects that cannot be moved by a contact
+//	(infinite mass) do not join islands, since resolving one contact cannot
+//	change anything about them.
 
 	{
-	//	This is an array, so we traverse by pointer for efficiency.
+	int i;
+	int iContactCount = m_Contacts.GetCount();
 
-	CPhysicsContact *pContact = &m_Contacts[0];
-	CPhysicsContact *pContactEnd = pContact + m_Contacts.GetCount();
+	//	Assign nodes
 
-	//	Find the contact with the largest negative separation velocity
-	//	(i.e., the one where we're colliding the fastest).
+	TSortMap<DWORD, int> NodeMap;
+	m_NodeDynamic.DeleteAll();
+	m_ContactNodes.DeleteAll();
+	m_ContactNodes.InsertEmpty(iContactCount);
 
-	CPhysicsContact *pBestContact = NULL;
-	Metric rBestV = DBL_MAX;
+	for (i = 0; i < iContactCount; i++)
+		{
+		const CPhysicsContact &Contact = m_Contacts[i];
+		SContactNodes &Nodes = m_ContactNodes[i];
 
-	while (pContact < pContactEnd)
+		Nodes.iNode1 = GetNode(Contact.GetObj1(), NodeMap);
+		Nodes.iNode2 = GetNode(Contact.GetObj2(), NodeMap);
+
+		//	Barrier collisions move the main object regardless of mass.
+
+		if (Contact.GetInvMass1() > 0.0 || Contact.GetType() == CPhysicsContact::contactBarrierCollision)
+			m_NodeDynamic[Nodes.iNode1] = true;
+
+		if (Contact.GetInvMass2() > 0.0)
+			m_NodeDynamic[Nodes.iNode2] = true;
+		}
+
+	int iNodeCount = m_NodeDynamic.GetCount();
+
+	//	Join dynamic nodes that share a contact (union-find with path halving)
+
+	TArray<int> Parent;
+	Parent.InsertEmpty(iNodeCount);
+	for (i = 0; i < iNodeCount; i++)
+		Parent[i] = i;
+
+	for (i = 0; i < iContactCount; i++)
 		{
-		Metric rSeparatingV = pContact->GetSeparatingVel();
-		if ((rSeparatingV < 0.0 || pContact->GetPenetration() > 0.0)
-				&& rSeparatingV < rBestV)
+		const SContactNodes &Nodes = m_ContactNodes[i];
+		if (!m_NodeDynamic[Nodes.iNode1] || !m_NodeDynamic[Nodes.iNode2])
+			continue;
+
+		int iRoot1 = Nodes.iNode1;
+		while (Parent[iRoot1] != iRoot1)
+			iRoot1 = Parent[iRoot1] = Parent[Parent[iRoot1]];
+
+		int iRoot2 = Nodes.iNode2;
+		while (Parent[iRoot2] != iRoot2)
+			iRoot2 = Parent[iRoot2] = Parent[Parent[iRoot2]];
+
+		if (iRoot1 != iRoot2)
+			Parent[iRoot2] = iRoot1;
+		}
+
+	//	Assign each contact to an island. Contacts between two immobile objects
+	//	get an island of their own.
+
+	TArray<int> IslandOfRoot;
+	IslandOfRoot.InsertEmpty(iNodeCount);
+	for (i = 0; i < iNodeCount; i++)
+		IslandOfRoot[i] = -1;
+
+	TArray<int> IslandOfContact;
+	IslandOfContact.InsertEmpty(iContactCount);
+
+	m_Islands.DeleteAll();
+	for (i = 0; i < iContactCount; i++)
+		{
+		const SContactNodes &Nodes = m_ContactNodes[i];
+		int iNode = (m_NodeDynamic[Nodes.iNode1] ? Nodes.iNode1 : (m_NodeDynamic[Nodes.iNode2] ? Nodes.iNode2 : -1));
+
+		int iIsland;
+		if (iNode == -1)
+			iIsland = -1;
+		else
 			{
-			pBestContact = pContact;
-			rBestV = rSeparatingV;
+			while (Parent[iNode] != iNode)
+				iNode = Parent[iNode];
+
+			iIsland = IslandOfRoot[iNode];
 			}
 
-		//	Next
+		if (iIsland == -1)
+			{
+			iIsland = m_Islands.GetCount();
+			SIsland *pIsland = m_Islands.Insert();
+			pIsland->iFirst = 0;
+			pIsland->iCount = 0;
 
-		pContact++;
+			if (iNode != -1)
+				IslandOfRoot[iNode] = iIsland;
+			}
+
+		IslandOfContact[i] = iIsland;
+		m_Islands[iIsland].iCount++;
+		}
+
+	//	Lay out contacts by island (keeping contact order inside each island).
+
+	int iNext = 0;
+	for (i = 0; i < m_Islands.GetCount(); i++)
+		{
+		m_Islands[i].iFirst = iNext;
+		iNext += m_Islands[i].iCount;
+		m_Islands[i].iCount = 0;
+		}
+
+	m_IslandContacts.DeleteAll();
+	m_IslandContacts.InsertEmpty(iContactCount);
+	for (i = 0; i < iContactCount; i++)
+		{
+		SIsland &Island = m_Islands[IslandOfContact[i]];
+		m_ContactNodes[i].iLocal = Island.iCount;
+		m_IslandContacts[Island.iFirst + Island.iCount++] = i;
 		}
 
-	return pBestContact;
+	//	Build the list of contacts for each dynamic node.
+
+	m_NodeContactStart.DeleteAll();
+	m_NodeContactStart.InsertEmpty(iNodeCount + 1);
+	for (i = 0; i < m_NodeContactStart.GetCount(); i++)
+		m_NodeContactStart[i] = 0;
+
+	for (i = 0; i < iContactCount; i++)
+		{
+		const SContactNodes &Nodes = m_ContactNodes[i];
+		if (m_NodeDynamic[Nodes.iNode1])
+			m_NodeContactStart[Nodes.iNode1 + 1]++;
+		if (m_NodeDynamic[Nodes.iNode2] && Nodes.iNode2 != Nodes.iNode1)
+			m_NodeContactStart[Nodes.iNode2 + 1]++;
+		}
+
+	for (i = 1; i < m_NodeContactStart.GetCount(); i++)
+		m_NodeContactStart[i] += m_NodeContactStart[i - 1];
+
+	TArray<int> NextPos;
+	NextPos.InsertEmpty(iNodeCount);
+	for (i = 0; i < iNodeCount; i++)
+		NextPos[i] = m_NodeContactStart[i];
+
+	m_NodeContacts.DeleteAll();
+	m_NodeContacts.InsertEmpty(m_NodeContactStart[iNodeCount]);
+	for (i = 0; i < iContactCount; i++)
+		{
+		const SContactNodes &Nodes = m_ContactNodes[i];
+		if (m_NodeDynamic[Nodes.iNode1])
+			m_NodeContacts[NextPos[Nodes.iNode1]++] = i;
+		if (m_NodeDynamic[Nodes.iNode2] && Nodes.iNode2 != Nodes.iNode1)
+			m_NodeContacts[NextPos[Nodes.iNode2]++] = i;
+		}
 	}
 
-void CPhysicsContactResolver::RecalcContacts (CPhysicsContact *pChanged)
+int CPhysicsContactResolver::GetNode (CSpaceObject *pObj, TSortMap<DWORD, int> &NodeMap)
 
-//	RecalcContacts
+//	GetNode
 //
-//	Invalidates other contacts involved with pChanged, which just got resolved.
+//	Returns the node index for the given object, adding one if necessary.
 
 	{
-	CPhysicsContact *pContact = &m_Contacts[0];
-	CPhysicsContact *pContactEnd = pContact + m_Contacts.GetCount();
-	while (pContact < pContactEnd)
+	bool bNew;
+	int *pNode = NodeMap.SetAt(pObj->GetID(), &bNew);
+	if (bNew)
 		{
-		//	Skip if this is the contact that changed because we update it in
-		//	the resolve step.
+		*pNode = m_NodeDynamic.GetCount();
+		m_NodeDynamic.Insert(false);
+		}
 
-		if (pContact == pChanged)
-			{ }
+	return *pNode;
+	}
 
-		//	Otherwise, recalc
+void CPhysicsContactResolver::RecalcContacts (int iChanged, CQueue &Queue)
 
-		else
+//	RecalcContacts
+//
+//	Updates the penetration of every other contact that shares a (movable)
+//	object with iChanged, which just got resolved.
+
+	{
+	const CPhysicsContact &Changed = m_Contacts[iChanged];
+	const SContactNodes &ChangedNodes = m_ContactNodes[iChanged];
+	int iNodes[2] = { ChangedNodes.iNode1, ChangedNodes.iNode2 };
+
+	for (int iPass = 0; iPass < 2; iPass++)
+		{
+		int iNode = iNodes[iPass];
+		if (!m_NodeDynamic[iNode] || (iPass == 1 && iNode == iNodes[0]))
+			continue;
+
+		for (int i = m_NodeContactStart[iNode]; i < m_NodeContactStart[iNode + 1]; i++)
 			{
-			if (pChanged->GetObj1() == pContact->GetObj1())
-				pContact->Recalc(-pChanged->GetMove1());
-			else if (pChanged->GetObj2() == pContact->GetObj1())
-				pContact->Recalc(-pChanged->GetMove2());
-		
-			if (pChanged->GetObj1() == pContact->GetObj2())
-				pContact->Recalc(pChanged->GetMove1());
-			else if (pChanged->GetObj2() == pContact->GetObj2())
-				pContact->Recalc(pChanged->GetMove2());
-			}
+			int iContact = m_NodeContacts[i];
+			if (iContact == iChanged)
+				continue;
 
-		pContact++;
+			//	On the second pass, skip contacts that we already handled in
+			//	the first pass (i.e., that also involve the first node).
+
+			const SContactNodes &Nodes = m_ContactNodes[iContact];
+			if (iPass == 1 && m_NodeDynamic[iNodes[0]] && (Nodes.iNode1 == iNodes[0] || Nodes.iNode2 == iNodes[0]))
+				continue;
+
+			CPhysicsContact &Contact = m_Contacts[iContact];
+
+			if (Changed.GetObj1() == Contact.GetObj1())
+				Contact.Recalc(-Changed.GetMove1());
+			else if (Changed.GetObj2() == Contact.GetObj1())
+				Contact.Recalc(-Changed.GetMove2());
+
+			if (Changed.GetObj1() == Contact.GetObj2())
+				Contact.Recalc(Changed.GetMove1());
+			else if (Changed.GetObj2() == Contact.GetObj2())
+				Contact.Recalc(Changed.GetMove2());
+
+			UpdateQueue(iContact, Queue);
+			}
 		}
 	}
 
-void CPhysicsContactResolver::Update (void)
+void CPhysicsContactResolver::SolveIsland (const SIsland &Island, CQueue &Queue)
 
-//	Update
+//	SolveIsland
 //
-//	Resolves all contacts.
+//	Resolves all contacts in the island, fastest collision first, until we've
+//	resolved everything or exhausted our iteration limit. This only touches
+//	objects in the island, so islands may be solved on different threads.
 
 	{
-	//	Keep looping util we've resolved everything or exhausted our iteration
-	//	limit.
+	int i;
 
-	int iIterationsLeft = 4 * m_Contacts.GetCount();
-	while (iIterationsLeft > 0)
-		{
-		//	Find the next contact to resolve. If we have no more, then we're
-		//	done with the loop.
+	Queue.Init(Island.iCount);
+	for (i = 0; i < Island.iCount; i++)
+		UpdateQueue(m_IslandContacts[Island.iFirst + i], Queue);
 
-		CPhysicsContact *pContact = FindContactToResolve();
-		if (pContact == NULL)
-			break;
+	int iIterationsLeft = 4 * Island.iCount;
+	while (iIterationsLeft > 0 && !Queue.IsEmpty())
+		{
+		int iContact = m_IslandContacts[Island.iFirst + Queue.GetTop()];
 
 		//	Resolve the contact
 
-		pContact->Resolve();
+		m_Contacts[iContact].Resolve();
+		UpdateQueue(iContact, Queue);
 
-		//	Invalidate the separating velocity for all contacts that involve 
+		//	Invalidate the separating velocity for all contacts that involve
 		//	these two objects.
 
-		RecalcContacts(pContact);
+		RecalcContacts(iContact, Queue);
 
 		//	Next
 
 		iIterationsLeft--;
 		}
+	}
+
+void CPhysicsContactResolver::Update (CThreadPool *pThreadPool)
 
-	//	Close out the contacts
+//	Update
+//
+//	Resolves all contacts.
 
-	if (m_Contacts.GetCount() > 0)
+	{
+	int i;
+
+	if (m_Contacts.GetCount() == 0)
+		return;
+
+	CalcIslands();
+
+	//	If we have enough work, split islands across threads.
+
+	int iTaskCount = 1;
+	if (pThreadPool
+			&& m_Islands.GetCount() > 1
+			&& m_Contacts.GetCount() >= MIN_PARALLEL_CONTACTS)
+		iTaskCount = Min(pThreadPool->GetThreadCount(), m_Islands.GetCount());
+
+	if (iTaskCount <= 1)
 		{
-		CPhysicsContact *pContact = &m_Contacts[0];
-		CPhysicsContact *pContactEnd = pContact + m_Contacts.GetCount();
-		while (pContact < pContactEnd)
+		CSolveIslandsTask Task(*this, 0, m_Islands.GetCount());
+		Task.Run();
+		}
+	else
+		{
+		int iChunk = (m_Islands.GetCount() + iTaskCount - 1) / iTaskCount;
+		for (i = 0; i < iTaskCount; i++)
 			{
-			pContact->OnUpdateDone();
-			pContact++;
+			int iStart = i * iChunk;
+			int iEnd = Min(m_Islands.GetCount(), iStart + iChunk);
+			if (iStart < iEnd)
+				pThreadPool->AddTask(new CSolveIslandsTask(*this, iStart, iEnd));
 			}
+
+		pThreadPool->Run();
+		}
+
+	//	Close out the contacts (on this thread, since this fires events)
+
+	CPhysicsContact *pContact = &m_Contacts[0];
+	CPhysicsContact *pContactEnd = pContact + m_Contacts.GetCount();
+	while (pContact < pContactEnd)
+		{
+		pContact->OnUpdateDone();
+		pContact++;
+		}
+	}
+
+void CPhysicsContactResolver::UpdateQueue (int iContact, CQueue &Queue) const
+
+//	UpdateQueue
+//
+//	Adds, moves, or removes the contact in the queue, depending on whether it
+//	still needs to be resolved.
+
+	{
+	const CPhysicsContact &Contact = m_Contacts[iContact];
+	int iLocal = m_ContactNodes[iContact].iLocal;
+
+	Metric rSeparatingV = Contact.GetSeparatingVel();
+	if (rSeparatingV < 0.0 || Contact.GetPenetration() > 0.0)
+		Queue.Set(iLocal, rSeparatingV);
+	else
+		Queue.Remove(iLocal);
+	}
+
+//	CQueue ---------------------------------------------------------------------
+
+void CPhysicsContactResolver::CQueue::Init (int iCount)
+
+//	Init
+//
+//	Initializes an empty queue for items 0 to iCount-1.
+
+	{
+	m_Heap.DeleteAll();
+	m_Pos.DeleteAll();
+	m_Pos.InsertEmpty(iCount);
+	m_Key.DeleteAll();
+	m_Key.InsertEmpty(iCount);
+
+	for (int i = 0; i < iCount; i++)
+		m_Pos[i] = -1;
+	}
+
+void CPhysicsContactResolver::CQueue::MoveDown (int iPos)
+
+//	MoveDown
+//
+//	Moves the item at iPos down until the heap property is restored.
+
+	{
+	int iCount = m_Heap.GetCount();
+	int iItem = m_Heap[iPos];
+
+	while (true)
+		{
+		int iChild = 2 * iPos + 1;
+		if (iChild >= iCount)
+			break;
+
+		if (iChild + 1 < iCount && IsBefore(m_Heap[iChild + 1], m_Heap[iChild]))
+			iChild++;
+
+		if (!IsBefore(m_Heap[iChild], iItem))
+			break;
+
+		SetAt(iPos, m_Heap[iChild]);
+		iPos = iChild;
+		}
+
+	SetAt(iPos, iItem);
+	}
+
+void CPhysicsContactResolver::CQueue::MoveUp (int iPos)
+
+//	MoveUp
+//
+//	Moves the item at iPos up until the heap property is restored.
+
+	{
+	int iItem = m_Heap[iPos];
+
+	while (iPos > 0)
+		{
+		int iParent = (iPos - 1) / 2;
+		if (!IsBefore(iItem, m_Heap[iParent]))
+			break;
+
+		SetAt(iPos, m_Heap[iParent]);
+		iPos = iParent;
+		}
+
+	SetAt(iPos, iItem);
+	}
+
+void CPhysicsContactResolver::CQueue::Remove (int iItem)
+
+//	Remove
+//
+//	Removes the item from the queue (if it is in the queue).
+
+	{
+	int iPos = m_Pos[iItem];
+	if (iPos == -1)
+		return;
+
+	int iLast = m_Heap[m_Heap.GetCount() - 1];
+	m_Heap.Delete(m_Heap.GetCount() - 1);
+	m_Pos[iItem] = -1;
+
+	if (iLast != iItem)
+		{
+		SetAt(iPos, iLast);
+		MoveUp(iPos);
+		MoveDown(m_Pos[iLast]);
 		}
 	}
+
+void CPhysicsContactResolver::CQueue::Set (int iItem, Metric rKey)
+
+//	Set
+//
+//	Adds the item with the given key or changes the key of an item already in
+//	the queue.
+
+	{
+	m_Key[iItem] = rKey;
+
+	int iPos = m_Pos[iItem];
+	if (iPos == -1)
+		{
+		m_Heap.Insert(iItem);
+		m_Pos[iItem] = m_Heap.GetCount() - 1;
+		MoveUp(m_Heap.GetCount() - 1);
+		}
+	else
+		{
+		MoveUp(iPos);
+		MoveDown(m_Pos[iItem]);
+		}
+	}
+
+void CPhysicsContactResolver::CQueue::SetAt (int iPos, int iItem)
+
+//	SetAt
+//
+//	Places the item at the given heap position.
+
+	{
+	m_Heap[iPos] = iItem;
+	m_Pos[iItem] = iPos;
+	}
@@ -0,0 +1,94 @@
+//	CPropertyIDTable.cpp
+//
+//	CPropertyIDTable class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+int CPropertyIDTable::Compare (const CString &sKey1, const CString &sKey2)
+
+//	Compare
+//
+//	Compares two property names, ignoring case. Returns -1, 0, or 1, like
+//	KeyCompare. Property names are plain ASCII.
+
+	{
+	const char *pPos1 = sKey1.GetASCIIZPointer();
+	const char *pPos2 = sKey2.GetASCIIZPointer();
+	const char *pEnd1 = pPos1 + sKey1.GetLength();
+	const char *pEnd2 = pPos2 + sKey2.GetLength();
+
+	while (pPos1 < pEnd1 && pPos2 < pEnd2)
+		{
+		char chChar1 = ((*pPos1 >= 'A' && *pPos1 <= 'Z') ? (*pPos1 - 'A' + 'a') : *pPos1);
+		char chChar2 = ((*pPos2 >= 'A' && *pPos2 <= 'Z') ? (*pPos2 - 'A' + 'a') : *pPos2);
+
+		if (chChar1 < chChar2)
+			return -1;
+		else if (chChar1 > chChar2)
+			return 1;
+
+		pPos1++;
+		pPos2++;
+		}
+
+	if (pPos1 < pEnd1)
+		return 1;
+	else if (pPos2 < pEnd2)
+		return -1;
+	else
+		return 0;
+	}
+
+int CPropertyIDTable::Find (const CString &sName) const
+
+//	Find
+//
+//	Returns the ID of the given property (or -1 if not in the table).
+
+	{
+	if (m_Sorted.GetCount() != m_iCount)
+		Init();
+
+	int iLow = 0;
+	int iHigh = m_Sorted.GetCount() - 1;
+	while (iLow <= iHigh)
+		{
+		int iMid = (iLow + iHigh) / 2;
+		const SEntry &Entry = m_pTable[m_Sorted[iMid]];
+
+		int iCompare = Compare(sName, Entry.sName);
+		if (iCompare == 0)
+			return Entry.iID;
+		else if (iCompare < 0)
+			iHigh = iMid - 1;
+		else
+			iLow = iMid + 1;
+		}
+
+	return -1;
+	}
+
+void CPropertyIDTable::Init (void) const
+
+//	Init
+//
+//	Sorts the table by name. We do this the first time someone asks (rather
+//	than at static initialization time) so that we don't depend on the order
+//	in which globals are constructed.
+
+	{
+	int i;
+
+	m_Sorted.DeleteAll();
+	m_Sorted.GrowToFit(m_iCount);
+
+	for (i = 0; i < m_iCount; i++)
+		{
+		int iPos = 0;
+		while (iPos < m_Sorted.GetCount() && Compare(m_pTable[m_Sorted[iPos]].sName, m_pTable[i].sName) < 0)
+			iPos++;
+
+		m_Sorted.Insert(i, iPos);
+		}
+	}
@@ -102,20 +102,13 @@ void CRangeTypeEvent::DoEvent (DWORD dwTick, CSystem *pSystem)
 
 		//	See if there are any objects in range
 
-		SSpaceObjectGridEnumerator i;
-		pSystem->EnumObjectsInBoxStart(i, vCenter, m_rRadius, gridNoBoxCheck);
-		while (pSystem->EnumObjectsInBoxHasMore(i))
+		for (CSpaceObject *pObj : pSystem->ObjectsInCircle(vCenter, m_rRadius))
 			{
-			CSpaceObject *pObj = pSystem->EnumObjectsInBoxGetNextFast(i);
 			if (pObj->MatchesCriteria(Ctx, m_Criteria)
 					&& (!pObj->IsIntangible() || pObj->IsVirtual()))
 				{
-				Metric rDist2 = (pObj->GetPos() - vCenter).Length2();
-				if (rDist2 < m_rRadius2)
-					{
-					pFound = pObj;
-					break;
-					}
+				pFound = pObj;
+				break;
 				}
 			}
 		}
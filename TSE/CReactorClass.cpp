@@ -9,6 +9,20 @@
 #define PROPERTY_MAX_POWER						CONSTLIT("maxPower")
 #define PROPERTY_POWER							CONSTLIT("power")
 
+enum EReactorClassProperties
+	{
+	propMaxPower,
+	propPower,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propMaxPower,					PROPERTY_MAX_POWER	},
+		{	propPower,						PROPERTY_POWER	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CReactorClass::CReactorClass (void) :
         m_pDesc(NULL),
         m_pDamagedDesc(NULL),
@@ -100,13 +114,14 @@ ICCItem *CReactorClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 //	understand the property.
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	const CReactorDesc &Desc = *GetReactorDesc(Ctx);
     ICCItem *pResult;
 
 	//	Some properties we handle ourselves
 
-	if (strEquals(sName, PROPERTY_MAX_POWER))
+	if (iProp == propMaxPower)
 		{
 		if (m_iExtraPowerPerCharge == 0 || Ctx.IsItemNull())
 			return CreatePowerResult(CC, 100.0 * GetMaxPower(Ctx, Desc));
@@ -118,7 +133,7 @@ ICCItem *CReactorClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 			}
 		}
 
-	else if (strEquals(sName, PROPERTY_POWER))
+	else if (iProp == propPower)
 		return CreatePowerResult(CC, 100.0 * GetMaxPower(Ctx, Desc));
 
 	//	Ask the descriptor
@@ -68,6 +68,26 @@ const Metric BALANCE_LEAKAGE_FACTOR =			-25.0;	//	Penalty from allowing some dam
 const Metric BALANCE_LEAKAGE_POWER =			0.5;	//	Curve for leakage
 const Metric BALANCE_MAX_DAMAGE_ADJ =			400.0;	//	Max change in balance due to a single damage type
 
+enum EShieldClassProperties
+	{
+	propDamageAdj,
+	propHP,
+	propHPBonus,
+	propMaxHP,
+	propRegen,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propDamageAdj,					PROPERTY_DAMAGE_ADJ	},
+		{	propHP,							PROPERTY_HP	},
+		{	propHPBonus,					PROPERTY_HP_BONUS	},
+		{	propMaxHP,						PROPERTY_MAX_HP	},
+		{	propRegen,						PROPERTY_REGEN	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 static CShieldClass::SStdStats STD_STATS[MAX_ITEM_LEVEL] =
 	{
 		//	HP		Regen	Cost			Power
@@ -1222,6 +1242,7 @@ ICCItem *CShieldClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 //	Returns a property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 
 	//	Enhancements
@@ -1230,19 +1251,19 @@ ICCItem *CShieldClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 
 	//	Get the property
 
-	if (strEquals(sName, PROPERTY_DAMAGE_ADJ))
+	if (iProp == propDamageAdj)
 		return m_DamageAdj.GetDamageAdjProperty(pEnhancements);
 
-	else if (strEquals(sName, PROPERTY_HP))
+	else if (iProp == propHP)
 		return CC.CreateInteger(GetHPLeft(Ctx));
 
-	else if (strEquals(sName, PROPERTY_HP_BONUS))
+	else if (iProp == propHPBonus)
 		return m_DamageAdj.GetHPBonusProperty(pEnhancements);
 
-	else if (strEquals(sName, PROPERTY_MAX_HP))
+	else if (iProp == propMaxHP)
 		return CC.CreateInteger(GetMaxHP(Ctx));
 
-	else if (strEquals(sName, PROPERTY_REGEN))
+	else if (iProp == propRegen)
 		return CC.CreateInteger(mathRound(CalcRegen180(Ctx)));
 
 	//	Otherwise, just get the property from the base class
@@ -1731,6 +1752,7 @@ bool CShieldClass::SetItemProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 //	Sets an item property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CSpaceObject *pSource = Ctx.GetSource();
 	CInstalledDevice *pDevice = Ctx.GetDevice();
 
@@ -1747,7 +1769,7 @@ bool CShieldClass::SetItemProperty (CItemCtx &Ctx, const CString &sName, ICCItem
 
 	//	Handle it.
 
-	if (strEquals(sName, PROPERTY_HP))
+	if (iProp == propHP)
 		{
 		//	Nil means we're depleting the shields
 
@@ -31,6 +31,8 @@ const Metric MAX_SPEED_FOR_DOCKING2 =			(0.04 * 0.04 * LIGHT_SPEED * LIGHT_SPEED
 
 const DWORD MAX_DISRUPT_TIME_BEFORE_DAMAGE =	(60 * g_TicksPerSecond);
 
+const int ANNOTATION_INNER_SPACING_Y =			2;
+
 #define FIELD_CARGO_SPACE						CONSTLIT("cargoSpace")
 #define FIELD_COUNTER_INCREMENT_RATE			CONSTLIT("counterIncrementRate")
 #define FIELD_LAUNCHER							CONSTLIT("launcher")
@@ -133,6 +135,120 @@ const DWORD CONTROLLER_PLAYERSHIP =				0x100000 + 100;
 
 const int DEFAULT_TIME_STOP_TIME =				150;
 
+enum EShipProperties
+	{
+	propAlwaysLeaveWreck,
+	propAutoTarget,
+	propAvailableDeviceSlots,
+	propAvailableNonWeaponSlots,
+	propAvailableWeaponSlots,
+	propBlindingImmune,
+	propCargoSpace,
+	propCargoSpaceFreeKg,
+	propCargoSpaceUsedKg,
+	propCounterIncrementRate,
+	propCounterValue,
+	propCounterValueIncrement,
+	propCharacter,
+	propDeviceDamageImmune,
+	propDeviceDisruptImmune,
+	propDisintegrationImmune,
+	propDockedAtID,
+	propDockingEnabled,
+	propDockingPortCount,
+	propDrivePowerUse,
+	propEMPImmune,
+	propExitGateTimer,
+	propFuelLeft,
+	propFuelLeftExact,
+	propHealerLeft,
+	propHP,
+	propHullPrice,
+	propInteriorHP,
+	propMaxCounter,
+	propMaxFuel,
+	propMaxFuelExact,
+	propMaxHP,
+	propMaxInteriorHP,
+	propMaxSpeed,
+	propOpenDockingPortCount,
+	propOperatingSpeed,
+	propPlayerBlacklisted,
+	propPlayerWingman,
+	propPowerUse,
+	propPrice,
+	propRadioactive,
+	propRadiationImmune,
+	propRotation,
+	propRotationSpeed,
+	propSelectedLauncher,
+	propSelectedMissile,
+	propSelectedWeapon,
+	propShatterImmune,
+	propShowMapLabel,
+	propTarget,
+	propThrust,
+	propThrustToWeight,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propAlwaysLeaveWreck,			PROPERTY_ALWAYS_LEAVE_WRECK	},
+		{	propAutoTarget,					PROPERTY_AUTO_TARGET	},
+		{	propAvailableDeviceSlots,		PROPERTY_AVAILABLE_DEVICE_SLOTS	},
+		{	propAvailableNonWeaponSlots,	PROPERTY_AVAILABLE_NON_WEAPON_SLOTS	},
+		{	propAvailableWeaponSlots,		PROPERTY_AVAILABLE_WEAPON_SLOTS	},
+		{	propBlindingImmune,				PROPERTY_BLINDING_IMMUNE	},
+		{	propCargoSpace,					PROPERTY_CARGO_SPACE	},
+		{	propCargoSpaceFreeKg,			PROPERTY_CARGO_SPACE_FREE_KG	},
+		{	propCargoSpaceUsedKg,			PROPERTY_CARGO_SPACE_USED_KG	},
+		{	propCounterIncrementRate,		PROPERTY_COUNTER_INCREMENT_RATE	},
+		{	propCounterValue,				PROPERTY_COUNTER_VALUE	},
+		{	propCounterValueIncrement,		PROPERTY_COUNTER_VALUE_INCREMENT	},
+		{	propCharacter,					PROPERTY_CHARACTER	},
+		{	propDeviceDamageImmune,			PROPERTY_DEVICE_DAMAGE_IMMUNE	},
+		{	propDeviceDisruptImmune,		PROPERTY_DEVICE_DISRUPT_IMMUNE	},
+		{	propDisintegrationImmune,		PROPERTY_DISINTEGRATION_IMMUNE	},
+		{	propDockedAtID,					PROPERTY_DOCKED_AT_ID	},
+		{	propDockingEnabled,				PROPERTY_DOCKING_ENABLED	},
+		{	propDockingPortCount,			PROPERTY_DOCKING_PORT_COUNT	},
+		{	propDrivePowerUse,				PROPERTY_DRIVE_POWER	},
+		{	propEMPImmune,					PROPERTY_EMP_IMMUNE	},
+		{	propExitGateTimer,				PROPERTY_EXIT_GATE_TIMER	},
+		{	propFuelLeft,					PROPERTY_FUEL_LEFT	},
+		{	propFuelLeftExact,				PROPERTY_FUEL_LEFT_EXACT	},
+		{	propHealerLeft,					PROPERTY_HEALER_LEFT	},
+		{	propHP,							PROPERTY_HP	},
+		{	propHullPrice,					PROPERTY_HULL_PRICE	},
+		{	propInteriorHP,					PROPERTY_INTERIOR_HP	},
+		{	propMaxCounter,					PROPERTY_MAX_COUNTER	},
+		{	propMaxFuel,					PROPERTY_MAX_FUEL	},
+		{	propMaxFuelExact,				PROPERTY_MAX_FUEL_EXACT	},
+		{	propMaxHP,						PROPERTY_MAX_HP	},
+		{	propMaxInteriorHP,				PROPERTY_MAX_INTERIOR_HP	},
+		{	propMaxSpeed,					PROPERTY_MAX_SPEED	},
+		{	propOpenDockingPortCount,		PROPERTY_OPEN_DOCKING_PORT_COUNT	},
+		{	propOperatingSpeed,				PROPERTY_OPERATING_SPEED	},
+		{	propPlayerBlacklisted,			PROPERTY_PLAYER_BLACKLISTED	},
+		{	propPlayerWingman,				PROPERTY_PLAYER_WINGMAN	},
+		{	propPowerUse,					PROPERTY_POWER_USE	},
+		{	propPrice,						PROPERTY_PRICE	},
+		{	propRadioactive,				PROPERTY_RADIOACTIVE	},
+		{	propRadiationImmune,			PROPERTY_RADIATION_IMMUNE	},
+		{	propRotation,					PROPERTY_ROTATION	},
+		{	propRotationSpeed,				PROPERTY_ROTATION_SPEED	},
+		{	propSelectedLauncher,			PROPERTY_SELECTED_LAUNCHER	},
+		{	propSelectedMissile,			PROPERTY_SELECTED_MISSILE	},
+		{	propSelectedWeapon,				PROPERTY_SELECTED_WEAPON	},
+		{	propShatterImmune,				PROPERTY_SHATTER_IMMUNE	},
+		{	propShowMapLabel,				PROPERTY_SHOW_MAP_LABEL	},
+		{	propTarget,						PROPERTY_TARGET	},
+		{	propThrust,						PROPERTY_THRUST	},
+		{	propThrustToWeight,				PROPERTY_THRUST_TO_WEIGHT	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CShip::CShip (void) : CSpaceObject(&g_Class),
 		m_pDocked(NULL),
 		m_pController(NULL),
@@ -142,7 +258,9 @@ CShip::CShip (void) : CSpaceObject(&g_Class),
 		m_pPowerUse(NULL),
 		m_dwNameFlags(0),
 		m_pExitGate(NULL),
-		m_pDeferredOrders(NULL)
+		m_pDeferredOrders(NULL),
+		m_iLastBehaviorTime(0),
+		m_iDestinyTimeSpan(1)
 
 //	CShip constructor
 
@@ -286,7 +404,38 @@ void CShip::Behavior (SUpdateCtx &Ctx)
 
 	if (!IsInactive() && !m_fControllerDisabled)
 		{
-		m_pController->Behavior(Ctx);
+		//	Distant, idle ships don't need to think every tick. On the ticks
+		//	that they skip, they keep flying their last course.
+
+		if (Ctx.pSystem->GetAILODScheduler().UpdateShip(this))
+			{
+			//	This update covers every tick since our last behavior (which
+			//	may not match our current cadence if our level changed). If we
+			//	were inactive for a while, we only cover the longest cadence.
+
+			int iTick = g_pUniverse->GetTicks();
+			int iTicksSinceBehavior = 1;
+			if (m_iLastBehaviorTime > 0)
+				iTicksSinceBehavior = Max(1, Min(iTick - m_iLastBehaviorTime, CAILODScheduler::GetCadence(CAILODScheduler::lodMinimal)));
+			m_iLastBehaviorTime = iTick;
+
+			//	While the controller runs, our IsDestinyTime covers all those
+			//	ticks. Other objects are not affected.
+
+			m_iDestinyTimeSpan = iTicksSinceBehavior;
+			try
+				{
+				m_pController->Behavior(Ctx);
+				}
+			catch (...)
+				{
+				m_iDestinyTimeSpan = 1;
+				throw;
+				}
+			m_iDestinyTimeSpan = 1;
+			}
+		else
+			m_pController->CoastBehavior(Ctx);
 
 		//	If we're targeting the player, then the player is under attack
 
@@ -1550,6 +1699,8 @@ ALERROR CShip::CreateFromClass (CSystem *pSystem,
 	pShip->m_pIrradiatedBy = NULL;
 	pShip->m_iLastFireTime = 0;
 	pShip->m_iLastHitTime = 0;
+	pShip->m_iLastBehaviorTime = 0;
+	pShip->m_iDestinyTimeSpan = 1;
 	pShip->m_rItemMass = 0.0;
 	pShip->m_rCargoMass = 0.0;
 	pShip->m_pTrade = NULL;
@@ -3043,125 +3194,126 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 //	Returns a property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
     ICCItem *pResult;
 
-	if (strEquals(sName, PROPERTY_ALWAYS_LEAVE_WRECK))
+	if (iProp == propAlwaysLeaveWreck)
 		return CC.CreateBool(m_fAlwaysLeaveWreck || m_pClass->GetWreckChance() >= 100);
 
-	else if (strEquals(sName, PROPERTY_AUTO_TARGET))
+	else if (iProp == propAutoTarget)
 		{
 		CSpaceObject *pTarget = GetTarget(CItemCtx(), false);
 		return (pTarget ? CC.CreateInteger((int)pTarget) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_AVAILABLE_DEVICE_SLOTS))
+	else if (iProp == propAvailableDeviceSlots)
 		{
 		int iAll = CalcDeviceSlotsInUse();
 
 		return CC.CreateInteger(m_pClass->GetHullDesc().GetMaxDevices() - iAll);
 		}
-	else if (strEquals(sName, PROPERTY_AVAILABLE_NON_WEAPON_SLOTS))
+	else if (iProp == propAvailableNonWeaponSlots)
 		{
 		int iNonWeapon;
 		int iAll = CalcDeviceSlotsInUse(NULL, &iNonWeapon);
 
 		return CC.CreateInteger(Max(0, Min(m_pClass->GetHullDesc().GetMaxNonWeapons() - iNonWeapon, m_pClass->GetHullDesc().GetMaxDevices() - iAll)));
 		}
-	else if (strEquals(sName, PROPERTY_AVAILABLE_WEAPON_SLOTS))
+	else if (iProp == propAvailableWeaponSlots)
 		{
 		int iWeapon;
 		int iAll = CalcDeviceSlotsInUse(&iWeapon);
 
 		return CC.CreateInteger(Max(0, Min(m_pClass->GetHullDesc().GetMaxWeapons() - iWeapon, m_pClass->GetHullDesc().GetMaxDevices() - iAll)));
 		}
-	else if (strEquals(sName, PROPERTY_BLINDING_IMMUNE))
+	else if (iProp == propBlindingImmune)
 		return CC.CreateBool(IsImmuneTo(CConditionSet::cndBlind));
 
-	else if (strEquals(sName, PROPERTY_CARGO_SPACE))
+	else if (iProp == propCargoSpace)
 		return CC.CreateInteger(CalcMaxCargoSpace());
 
-	else if (strEquals(sName, PROPERTY_CARGO_SPACE_FREE_KG))
+	else if (iProp == propCargoSpaceFreeKg)
 		return CC.CreateInteger(mathRound(GetCargoSpaceLeft() * 1000.0));
 
-	else if (strEquals(sName, PROPERTY_CARGO_SPACE_USED_KG))
+	else if (iProp == propCargoSpaceUsedKg)
 		{
 		OnComponentChanged(comCargo);
 		return CC.CreateInteger(mathRound(GetCargoMass() * 1000.0));
 		}
 
-	else if (strEquals(sName, PROPERTY_COUNTER_VALUE))
+	else if (iProp == propCounterValue)
 		return CC.CreateInteger(GetCounterValue());
 
-	else if (strEquals(sName, PROPERTY_COUNTER_INCREMENT_RATE))
+	else if (iProp == propCounterIncrementRate)
 		return CC.CreateInteger(GetCounterIncrementRate());
 
-	else if (strEquals(sName, PROPERTY_CHARACTER))
+	else if (iProp == propCharacter)
 		return (m_pCharacter ? CC.CreateInteger(m_pCharacter->GetUNID()) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_DEVICE_DAMAGE_IMMUNE))
+	else if (iProp == propDeviceDamageImmune)
 		return CC.CreateBool(m_Armor.IsImmune(this, specialDeviceDamage));
 
-	else if (strEquals(sName, PROPERTY_DEVICE_DISRUPT_IMMUNE))
+	else if (iProp == propDeviceDisruptImmune)
 		return CC.CreateBool(m_Armor.IsImmune(this, specialDeviceDisrupt));
 
-	else if (strEquals(sName, PROPERTY_DISINTEGRATION_IMMUNE))
+	else if (iProp == propDisintegrationImmune)
 		return CC.CreateBool(m_Armor.IsImmune(this, specialDisintegration));
 
-	else if (strEquals(sName, PROPERTY_DOCKED_AT_ID))
+	else if (iProp == propDockedAtID)
 		return (!m_fShipCompartment && m_pDocked ? CC.CreateInteger(m_pDocked->GetID()) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_DOCKING_ENABLED))
+	else if (iProp == propDockingEnabled)
 		return CC.CreateBool(CanObjRequestDock(GetPlayerShip()) == CSpaceObject::dockingOK);
 
-    else if (strEquals(sName, PROPERTY_DOCKING_PORT_COUNT))
+    else if (iProp == propDockingPortCount)
         return CC.CreateInteger(m_DockingPorts.GetPortCount(this));
 
-	else if (strEquals(sName, PROPERTY_EMP_IMMUNE))
+	else if (iProp == propEMPImmune)
 		return CC.CreateBool(IsImmuneTo(CConditionSet::cndParalyzed));
 
-	else if (strEquals(sName, PROPERTY_EXIT_GATE_TIMER))
+	else if (iProp == propExitGateTimer)
 		return (IsInGate() ? CC.CreateInteger(m_iExitGateTimer) : CC.CreateNil());
 
-    else if (strEquals(sName, PROPERTY_FUEL_LEFT))
+    else if (iProp == propFuelLeft)
         return CC.CreateInteger(mathRound(GetFuelLeft() / FUEL_UNITS_PER_STD_ROD));
 
-    else if (strEquals(sName, PROPERTY_FUEL_LEFT_EXACT))
+    else if (iProp == propFuelLeftExact)
         return CC.CreateDouble(GetFuelLeft());
 
-    else if (strEquals(sName, PROPERTY_HEALER_LEFT))
+    else if (iProp == propHealerLeft)
         return CC.CreateInteger(m_Armor.GetHealerLeft());
 
-	else if (strEquals(sName, PROPERTY_HP))
+	else if (iProp == propHP)
 		return CC.CreateInteger(GetTotalArmorHP());
 
-	else if (strEquals(sName, PROPERTY_HULL_PRICE))
+	else if (iProp == propHullPrice)
 		return CC.CreateInteger((int)GetHullValue().GetValue());
 
-	else if (strEquals(sName, PROPERTY_INTERIOR_HP))
+	else if (iProp == propInteriorHP)
 		{
 		int iHP;
 		m_Interior.GetHitPoints(this, m_pClass->GetInteriorDesc(), &iHP);
 		return CC.CreateInteger(iHP);
 		}
 
-	else if (strEquals(sName, PROPERTY_MAX_COUNTER))
+	else if (iProp == propMaxCounter)
 		return CC.CreateInteger(m_pClass->GetHullDesc().GetMaxCounter());
 
-	else if (strEquals(sName, PROPERTY_MAX_FUEL))
+	else if (iProp == propMaxFuel)
         return CC.CreateInteger(mathRound(GetMaxFuel() / FUEL_UNITS_PER_STD_ROD));
 
-    else if (strEquals(sName, PROPERTY_MAX_FUEL_EXACT))
+    else if (iProp == propMaxFuelExact)
         return CC.CreateDouble(GetMaxFuel());
 
-	else if (strEquals(sName, PROPERTY_MAX_HP))
+	else if (iProp == propMaxHP)
 		{
 		int iMaxHP;
 		GetTotalArmorHP(&iMaxHP);
 		return CC.CreateInteger(iMaxHP);
 		}
 
-	else if (strEquals(sName, PROPERTY_MAX_INTERIOR_HP))
+	else if (iProp == propMaxInteriorHP)
 		{
 		int iHP;
 		int iMaxHP;
@@ -3169,10 +3321,10 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return CC.CreateInteger(iMaxHP);
 		}
 
-	else if (strEquals(sName, PROPERTY_OPEN_DOCKING_PORT_COUNT))
+	else if (iProp == propOpenDockingPortCount)
 		return CC.CreateInteger(GetOpenDockingPortCount());
 
-	else if (strEquals(sName, PROPERTY_OPERATING_SPEED))
+	else if (iProp == propOperatingSpeed)
 		{
 		if (m_fEmergencySpeed)
 			return CC.CreateString(SPEED_EMERGENCY);
@@ -3184,28 +3336,28 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			return CC.CreateString(SPEED_FULL);
 		}
 
-	else if (strEquals(sName, PROPERTY_PLAYER_BLACKLISTED))
+	else if (iProp == propPlayerBlacklisted)
 		return CC.CreateBool(m_pController->IsPlayerBlacklisted());
 
-	else if (strEquals(sName, PROPERTY_PLAYER_WINGMAN))
+	else if (iProp == propPlayerWingman)
 		return CC.CreateBool(m_pController->IsPlayerWingman());
 
-    else if (strEquals(sName, PROPERTY_POWER_USE))
+    else if (iProp == propPowerUse)
         return CC.CreateDouble(GetPowerConsumption() * 100.0);
 
-	else if (strEquals(sName, PROPERTY_PRICE))
+	else if (iProp == propPrice)
 		return CC.CreateInteger((int)GetTradePrice(NULL).GetValue());
 
-	else if (strEquals(sName, PROPERTY_RADIATION_IMMUNE))
+	else if (iProp == propRadiationImmune)
 		return CC.CreateBool(IsImmuneTo(CConditionSet::cndRadioactive));
 
-	else if (strEquals(sName, PROPERTY_ROTATION))
+	else if (iProp == propRotation)
 		return CC.CreateInteger(GetRotation());
 
-	else if (strEquals(sName, PROPERTY_ROTATION_SPEED))
+	else if (iProp == propRotationSpeed)
 		return CC.CreateDouble(m_Rotation.GetRotationSpeedDegrees(m_Perf.GetIntegralRotationDesc()));
 
-	else if (strEquals(sName, PROPERTY_SELECTED_LAUNCHER))
+	else if (iProp == propSelectedLauncher)
 		{
 		CItem theItem = GetNamedDeviceItem(devMissileWeapon);
 		if (theItem.GetType() == NULL)
@@ -3213,7 +3365,7 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 
 		return CreateListFromItem(CC, theItem);
 		}
-	else if (strEquals(sName, PROPERTY_SELECTED_MISSILE))
+	else if (iProp == propSelectedMissile)
 		{
 		CInstalledDevice *pLauncher = GetNamedDevice(devMissileWeapon);
 		if (pLauncher == NULL)
@@ -3246,7 +3398,7 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			return CreateListFromItem(CC, theItem);
 			}
 		}
-	else if (strEquals(sName, PROPERTY_SELECTED_WEAPON))
+	else if (iProp == propSelectedWeapon)
 		{
 		CItem theItem = GetNamedDeviceItem(devPrimaryWeapon);
 		if (theItem.GetType() == NULL)
@@ -3254,30 +3406,30 @@ ICCItem *CShip::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 
 		return CreateListFromItem(CC, theItem);
 		}
-	else if (strEquals(sName, PROPERTY_SHATTER_IMMUNE))
+	else if (iProp == propShatterImmune)
 		return CC.CreateBool(m_Armor.IsImmune(this, specialShatter));
 
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_LABEL))
+	else if (iProp == propShowMapLabel)
 		return CC.CreateBool(m_fShowMapLabel);
 
 	//	Drive properties
 
-	else if (strEquals(sName, PROPERTY_DRIVE_POWER))
+	else if (iProp == propDrivePowerUse)
 		return CC.CreateInteger(m_Perf.GetDriveDesc().GetPowerUse() * 100);
 
-	else if (strEquals(sName, PROPERTY_MAX_SPEED))
+	else if (iProp == propMaxSpeed)
 		return CC.CreateInteger((int)((100.0 * GetMaxSpeed() / LIGHT_SPEED) + 0.5));
 
-	else if (strEquals(sName, PROPERTY_TARGET))
+	else if (iProp == propTarget)
 		{
 		CSpaceObject *pTarget = GetTarget(CItemCtx(), true);
 		return (pTarget ? CC.CreateInteger((int)pTarget) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_THRUST))
+	else if (iProp == propThrust)
 		return CC.CreateInteger((int)GetThrustProperty());
 
-	else if (strEquals(sName, PROPERTY_THRUST_TO_WEIGHT))
+	else if (iProp == propThrustToWeight)
 		{
 		Metric rMass = GetMass();
 		int iRatio = (int)((200.0 * (rMass > 0.0 ? GetThrust() / rMass : 0.0)) + 0.5);
@@ -3670,6 +3822,17 @@ bool CShip::HasAttribute (const CString &sAttribute) const
 	return m_pClass->HasLiteralAttribute(sAttribute);
 	}
 
+bool CShip::HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const
+
+//	HasAttributes
+//
+//	Returns TRUE if we have all the required attributes and none of the
+//	excluded ones.
+
+	{
+	return m_pClass->HasLiteralAttributes(Required, Excluded);
+	}
+
 bool CShip::HasNamedDevice (DeviceNames iDev) const
 
 //	HasNamedDevice
@@ -5244,6 +5407,24 @@ void CShip::OnPaintAnnotations (CG32bitImage &Dest, int x, int y, SViewportPaint
 				sText,
 				CG16bitFont::AlignCenter);
 		}
+
+	//	Paint AI level of detail
+
+	if (Ctx.bShowAILOD && !IsPlayer() && GetSystem())
+		{
+		CAILODScheduler::ELevels iLevel = GetSystem()->GetAILODScheduler().CalcLevel(this);
+
+		const CG16bitFont &MessageFont = g_pUniverse->GetNamedFont(CUniverse::fontSRSMessage);
+		CString sText = strPatternSubst(CONSTLIT("AI LOD: %d (every %d ticks)"), (int)iLevel, CAILODScheduler::GetCadence(iLevel));
+		MessageFont.DrawText(Dest,
+				x,
+				Ctx.yAnnotations,
+				GetSymbolColor(),
+				sText,
+				CG16bitFont::AlignCenter);
+
+		Ctx.yAnnotations += MessageFont.GetHeight() + ANNOTATION_INNER_SPACING_Y;
+		}
 	}
 
 void CShip::OnPaintMap (CMapViewportCtx &Ctx, CG32bitImage &Dest, int x, int y)
@@ -5355,6 +5536,7 @@ void CShip::OnReadFromStream (SLoadCtx &Ctx)
 //	DWORD		m_pExitGate (CSpaceObject ref)
 //	DWORD		m_iLastFireTime
 //	DWORD		m_iLastHitTime
+//	DWORD		m_iLastBehaviorTime
 //	DWORD		flags
 //
 //	CArmorSystem m_Armor
@@ -5508,6 +5690,11 @@ void CShip::OnReadFromStream (SLoadCtx &Ctx)
 	else
 		m_iLastHitTime = 0;
 
+	if (Ctx.dwVersion >= 169)
+		Ctx.pStream->Read(m_iLastBehaviorTime);
+	else
+		m_iLastBehaviorTime = 0;
+
 	//	Load flags
 
 	Ctx.pStream->Read(dwLoad);
@@ -6447,6 +6634,7 @@ void CShip::OnWriteToStream (IWriteStream *pStream)
 //	DWORD		m_pExitGate (CSpaceObject ref)
 //	DWORD		m_iLastFireTime
 //	DWORD		m_iLastHitTime
+//	DWORD		m_iLastBehaviorTime
 //	DWORD		flags
 //
 //  CArmorSystem m_Armor
@@ -6515,6 +6703,7 @@ void CShip::OnWriteToStream (IWriteStream *pStream)
 	WriteObjRefToStream(m_pExitGate, pStream);
 	pStream->Write(m_iLastFireTime);
 	pStream->Write(m_iLastHitTime);
+	pStream->Write(m_iLastBehaviorTime);
 
 	dwSave = 0;
 	dwSave |= (m_fLRSDisabledByNebula ? 0x00000001 : 0);
@@ -7705,24 +7894,25 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 //	Sets an object property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 
-	if (strEquals(sName, PROPERTY_ALWAYS_LEAVE_WRECK))
+	if (iProp == propAlwaysLeaveWreck)
 		{
 		m_fAlwaysLeaveWreck = !pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_COUNTER_VALUE))
+	else if (iProp == propCounterValue)
 		{
 		SetCounterValue(pValue->GetIntegerValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_COUNTER_VALUE_INCREMENT))
+	else if (iProp == propCounterValueIncrement)
 		{
 		IncCounterValue(pValue->GetIntegerValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_CHARACTER))
+	else if (iProp == propCharacter)
 		{
 		if (pValue->IsNil())
 			m_pCharacter = NULL;
@@ -7740,33 +7930,33 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 		return true;
 		}
 
-	else if (strEquals(sName, PROPERTY_DOCKING_ENABLED))
+	else if (iProp == propDockingEnabled)
 		{
 		m_fDockingDisabled = pValue->IsNil();
 		return true;
 		}
-    else if (strEquals(sName, PROPERTY_FUEL_LEFT))
+    else if (iProp == propFuelLeft)
         {
 		if (m_pPowerUse)
 			m_pPowerUse->SetFuelLeft(Max(0.0, Min(pValue->GetIntegerValue() * FUEL_UNITS_PER_STD_ROD, GetMaxFuel())));
         return true;
         }
 
-    else if (strEquals(sName, PROPERTY_FUEL_LEFT_EXACT))
+    else if (iProp == propFuelLeftExact)
         {
 		if (m_pPowerUse)
 			m_pPowerUse->SetFuelLeft(Max(0.0, Min(pValue->GetDoubleValue(), GetMaxFuel())));
         return true;
         }
 
-	else if (strEquals(sName, PROPERTY_EXIT_GATE_TIMER))
+	else if (iProp == propExitGateTimer)
 		{
 		if (IsInGate())
 			m_iExitGateTimer = Max(0, pValue->GetIntegerValue());
 		return true;
 		}
 
-    else if (strEquals(sName, PROPERTY_HEALER_LEFT))
+    else if (iProp == propHealerLeft)
         {
         m_Armor.SetHealerLeft(pValue->GetIntegerValue());
 
@@ -7776,18 +7966,18 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
         return true;
         }
 
-	else if (strEquals(sName, PROPERTY_HP))
+	else if (iProp == propHP)
 		{
 		SetTotalArmorHP(pValue->GetIntegerValue());
 		return true;
 		}
 
-	else if (strEquals(sName, PROPERTY_INTERIOR_HP))
+	else if (iProp == propInteriorHP)
 		{
 		m_Interior.SetHitPoints(this, m_pClass->GetInteriorDesc(), pValue->GetIntegerValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_OPERATING_SPEED))
+	else if (iProp == propOperatingSpeed)
 		{
 		CString sSpeed = pValue->GetStringValue();
 		if (strEquals(sSpeed, SPEED_EMERGENCY))
@@ -7806,17 +7996,17 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_PLAYER_BLACKLISTED))
+	else if (iProp == propPlayerBlacklisted)
 		{
 		m_pController->SetPlayerBlacklisted(!pValue->IsNil());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_PLAYER_WINGMAN))
+	else if (iProp == propPlayerWingman)
 		{
 		SetPlayerWingman(!pValue->IsNil());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_RADIOACTIVE))
+	else if (iProp == propRadioactive)
 		{
 		if (pValue->IsNil())
 			ClearCondition(CConditionSet::cndRadioactive);
@@ -7824,18 +8014,18 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 			SetCondition(CConditionSet::cndRadioactive);
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ROTATION))
+	else if (iProp == propRotation)
 		{
 		SetRotation(pValue->GetIntegerValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ROTATION_SPEED))
+	else if (iProp == propRotationSpeed)
 		{
 		m_Rotation.SetRotationSpeedDegrees(m_Perf.GetIntegralRotationDesc(), pValue->GetDoubleValue());
 		return true;
 		}
 
-	else if (strEquals(sName, PROPERTY_SELECTED_MISSILE))
+	else if (iProp == propSelectedMissile)
 		{
 		//	Nil means that we don't want to make a change
 
@@ -7875,7 +8065,7 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 		SelectWeapon(m_Devices.GetNamedIndex(devMissileWeapon), iVariant);
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SELECTED_WEAPON))
+	else if (iProp == propSelectedWeapon)
 		{
 		//	Nil means that we don't want to make a change
 
@@ -7898,7 +8088,7 @@ bool CShip::SetProperty (const CString &sName, ICCItem *pValue, CString *retsErr
 		SelectWeapon(iDev, 0);
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_LABEL))
+	else if (iProp == propShowMapLabel)
 		{
 		m_fShowMapLabel = !pValue->IsNil();
 		return true;
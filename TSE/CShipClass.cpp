@@ -4110,6 +4110,11 @@ void CShipClass::OnUnbindDesign (void)
 
 	m_fCommsHandlerInit = false;
 	m_CommsHandler.DeleteAll();
+
+	//	Device classes might change, so we can't reuse invariants computed
+	//	from the old ones.
+
+	m_AIInvariants.CleanUp();
 	}
 
 void CShipClass::OnWriteToStream (IWriteStream *pStream)
@@ -199,7 +199,9 @@ CSovereign::CSovereign (void) :
 		m_pInitialRelationships(NULL),
 		m_iStationsDestroyedByPlayer(0),
 		m_iShipsDestroyedByPlayer(0),
-		m_bSelfRel(false)
+		m_bSelfRel(false),
+		m_dwEnemyObjectsVersion(0),
+		m_iOrdinal(-1)
 
 //	CSovereign constructor
 
@@ -214,6 +216,24 @@ CSovereign::~CSovereign (void)
 	DeleteRelationships();
 	}
 
+void CSovereign::AddEnemyObject (CSystem *pSystem, CSpaceObject *pObj, CSovereign *pObjSovereign)
+
+//	AddEnemyObject
+//
+//	An object that can attack has been added to the given system (or has
+//	changed to the given sovereign). If we have a valid enemy list for the
+//	system, we add the object to it if it is our enemy. Otherwise we leave it
+//	alone; the list will be recomputed the next time someone asks.
+
+	{
+	if (!IsEnemyObjectListValid(pSystem)
+			|| pObj->IsDestroyed()
+			|| !IsEnemy(pObjSovereign))
+		return;
+
+	m_EnemyObjects.FastAdd(pObj);
+	}
+
 bool CSovereign::CalcSelfRel (void)
 
 //	CalcSelfRel
@@ -233,9 +253,13 @@ void CSovereign::DebugObjDeleted (CSpaceObject *pObj) const
 
 //	DebugObjDeleted
 //
-//	Make sure this object is not in our cache.
+//	Make sure this object is not in our cache. A stale list is never used (it
+//	will be recomputed), so it may still hold deleted objects.
 
 	{
+	if (m_dwEnemyObjectsVersion != g_pUniverse->GetSovereignDispositions().GetVersion())
+		return;
+
 	for (int i = 0; i < m_EnemyObjects.GetCount(); i++)
 		if (pObj == m_EnemyObjects.GetObj(i))
 			{
@@ -264,6 +288,9 @@ void CSovereign::DeleteRelationships (void)
 	m_pFirstRelationship = NULL;
 	m_bSelfRel = false;
 
+	if (g_pUniverse)
+		g_pUniverse->GetSovereignDispositions().Invalidate();
+
 	DEBUG_CATCH
 	}
 
@@ -493,8 +520,9 @@ void CSovereign::InitEnemyObjectList (CSystem *pSystem)
 	{
 	int i;
 
-	if (m_pEnemyObjectsSystem != pSystem)
+	if (!IsEnemyObjectListValid(pSystem))
 		{
+		m_EnemyObjects.DeleteAll();
 		m_EnemyObjects.SetAllocSize(pSystem->GetObjectCount());
 
 		for (i = 0; i < pSystem->GetObjectCount(); i++)
@@ -509,6 +537,7 @@ void CSovereign::InitEnemyObjectList (CSystem *pSystem)
 			}
 
 		m_pEnemyObjectsSystem = pSystem;
+		m_dwEnemyObjectsVersion = g_pUniverse->GetSovereignDispositions().GetVersion();
 		}
 	}
 
@@ -591,6 +620,39 @@ void CSovereign::InitRelationships (void)
 	DEBUG_CATCH
 	}
 
+bool CSovereign::IsEnemy (CSovereign *pSovereign)
+
+//	IsEnemy
+//
+//	Returns TRUE if we are enemies of the given sovereign. Our entry for
+//	ourselves is only dispEnemy if we have an explicit self-relationship.
+
+	{
+	return (g_pUniverse->GetSovereignDispositions().GetDisposition(this, pSovereign) == dispEnemy);
+	}
+
+bool CSovereign::IsEnemyObjectListValid (CSystem *pSystem) const
+
+//	IsEnemyObjectListValid
+//
+//	Returns TRUE if m_EnemyObjects is up to date for the given system. The list
+//	goes stale if any disposition has changed since we computed it.
+
+	{
+	return (m_pEnemyObjectsSystem == pSystem
+			&& m_dwEnemyObjectsVersion == g_pUniverse->GetSovereignDispositions().GetVersion());
+	}
+
+bool CSovereign::IsFriend (CSovereign *pSovereign)
+
+//	IsFriend
+//
+//	Returns TRUE if we are friends of the given sovereign.
+
+	{
+	return (g_pUniverse->GetSovereignDispositions().GetDisposition(this, pSovereign) == dispFriend);
+	}
+
 void CSovereign::MessageFromObj (CSpaceObject *pSender, const CString &sText)
 
 //	MessageFromObj
@@ -952,6 +1014,21 @@ CSovereign::Disposition CSovereign::ParseDisposition (const CString &sValue)
 		return dispNeutral;
 	}
 
+void CSovereign::RemoveEnemyObject (CSystem *pSystem, CSpaceObject *pObj, CSovereign *pObjSovereign)
+
+//	RemoveEnemyObject
+//
+//	An object that can attack is leaving the given system (or is changing away
+//	from the given sovereign). We remove it from our enemy list, if we have one.
+
+	{
+	if (!IsEnemyObjectListValid(pSystem)
+			|| !IsEnemy(pObjSovereign))
+		return;
+
+	m_EnemyObjects.Delete(pObj);
+	}
+
 void CSovereign::SetDispositionTowards (CSovereign *pSovereign, Disposition iDisp, bool bMutual)
 
 //	SetDispositionTowards
@@ -973,9 +1050,11 @@ void CSovereign::SetDispositionTowards (CSovereign *pSovereign, Disposition iDis
 	if (pSovereign == this)
 		m_bSelfRel = true;
 
-	//	Flush cache of enemy objects
+	//	Flush cache of enemy objects. Sovereigns that inherit from us may have
+	//	changed too, so we invalidate the whole disposition matrix.
 
 	FlushEnemyObjectCache();
+	g_pUniverse->GetSovereignDispositions().Invalidate();
 
 	//	If this is a mutual relationship, try to set it.
 
@@ -0,0 +1,42 @@
+//	CSovereignDispositionMatrix.cpp
+//
+//	CSovereignDispositionMatrix class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+void CSovereignDispositionMatrix::Init (void)
+
+//	Init
+//
+//	Recomputes the table from the relationship lists of all sovereigns. We
+//	store the result of the IsEnemy/IsFriend tests, so a sovereign's entry
+//	for itself is dispFriend unless it has an explicit self-relationship.
+
+	{
+	int i, j;
+
+	m_iCount = g_pUniverse->GetSovereignCount();
+
+	m_Sovereigns.DeleteAll();
+	m_Sovereigns.InsertEmpty(m_iCount);
+	for (i = 0; i < m_iCount; i++)
+		{
+		CSovereign *pSovereign = g_pUniverse->GetSovereign(i);
+		pSovereign->m_iOrdinal = i;
+		m_Sovereigns[i] = pSovereign;
+		}
+
+	m_Disp.DeleteAll();
+	m_Disp.InsertEmpty(m_iCount * m_iCount);
+	for (i = 0; i < m_iCount; i++)
+		{
+		CSovereign *pFrom = m_Sovereigns[i];
+		BYTE *pRow = &m_Disp[i * m_iCount];
+
+		for (j = 0; j < m_iCount; j++)
+			pRow[j] = (BYTE)pFrom->GetDispositionTowards(m_Sovereigns[j]);
+		}
+
+	m_bValid = true;
+	}
@@ -0,0 +1,414 @@
+//	CSovereignInfluenceMap.cpp
+//
+//	CSovereignInfluenceMap class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const Metric CELL_SIZE =					g_LRSRange;
+const int UPDATE_INTERVAL =					10;
+
+void CSovereignInfluenceMap::Add (CSpaceObject *pObj)
+
+//	Add
+//
+//	Adds the object to the map (or moves it, if its sovereign has changed).
+//	We don't know its power yet (it might still be initializing), so we count
+//	it as the weakest ship until the next update.
+
+	{
+	if (!IsCandidate(pObj) || pObj->IsDestroyed())
+		return;
+
+	SEntry *pEntry = m_Objects.GetAt(pObj);
+	int iPower = (pEntry ? pEntry->iPower : 1);
+
+	SetEntry(pObj, pObj->GetSovereign(), CalcCellKey(pObj->GetPos()), iPower);
+	}
+
+void CSovereignInfluenceMap::AddPower (CSpaceObject *pObj, CSovereign *pSovereign, DWORD dwCell, int iPower)
+
+//	AddPower
+//
+//	Adds (or, if iPower is negative, removes) the given ship's power for its
+//	sovereign in the given cell, and updates the views of every sovereign that
+//	has asked about the map. Ships without a sovereign are tracked under NULL
+//	(sovereigns treat NULL as neutrally aligned, which some of them consider
+//	an enemy).
+
+	{
+	int i;
+
+	if (iPower == 0)
+		return;
+
+	//	Update the raw power
+
+	SCell *pCell = m_Cells.SetAt(dwCell);
+	for (i = 0; i < pCell->Power.GetCount(); i++)
+		if (pCell->Power[i].pSovereign == pSovereign)
+			break;
+
+	if (i == pCell->Power.GetCount())
+		{
+		SSovereignPower *pPower = pCell->Power.Insert();
+		pPower->pSovereign = pSovereign;
+		pPower->iPower = 0;
+		}
+
+	pCell->Power[i].iPower += iPower;
+	if (iPower > 0)
+		pCell->Power[i].Ships.Insert(pObj);
+	else
+		{
+		int iIndex;
+		if (pCell->Power[i].Ships.Find(pObj, &iIndex))
+			pCell->Power[i].Ships.Delete(iIndex);
+		}
+
+	if (pCell->Power[i].iPower <= 0)
+		{
+		pCell->Power.Delete(i);
+		if (pCell->Power.GetCount() == 0)
+			m_Cells.DeleteAt(dwCell);
+		}
+
+	//	Update the views. Stale views are rebuilt the next time someone asks,
+	//	so we don't bother with them.
+
+	DWORD dwVersion = g_pUniverse->GetSovereignDispositions().GetVersion();
+	for (i = 0; i < m_Views.GetCount(); i++)
+		{
+		SView &View = m_Views[i];
+		if (View.dwVersion != dwVersion)
+			continue;
+
+		CSovereign *pViewer = m_Views.GetKey(i);
+		if (pViewer->IsEnemy(pSovereign))
+			{
+			SInfluence *pInfluence = View.Cells.SetAt(dwCell);
+			pInfluence->iEnemy += iPower;
+			if (pInfluence->iEnemy <= 0 && pInfluence->iFriend <= 0)
+				View.Cells.DeleteAt(dwCell);
+			}
+		else if (pViewer->IsFriend(pSovereign))
+			{
+			SInfluence *pInfluence = View.Cells.SetAt(dwCell);
+			pInfluence->iFriend += iPower;
+			if (pInfluence->iEnemy <= 0 && pInfluence->iFriend <= 0)
+				View.Cells.DeleteAt(dwCell);
+			}
+		}
+	}
+
+DWORD CSovereignInfluenceMap::CalcCellKey (const CVector &vPos)
+
+//	CalcCellKey
+//
+//	Returns the key of the cell that contains the given position.
+
+	{
+	return MakeCellKey((int)floor(vPos.GetX() / CELL_SIZE), (int)floor(vPos.GetY() / CELL_SIZE));
+	}
+
+void CSovereignInfluenceMap::CalcInfluence (SView &View, const CVector &vPos, Metric rRadius, int *retiEnemy, int *retiFriend) const
+
+//	CalcInfluence
+//
+//	Adds up the power in all cells that overlap the given box.
+
+	{
+	int i;
+
+	int xFrom = (int)floor((vPos.GetX() - rRadius) / CELL_SIZE);
+	int xTo = (int)floor((vPos.GetX() + rRadius) / CELL_SIZE);
+	int yFrom = (int)floor((vPos.GetY() - rRadius) / CELL_SIZE);
+	int yTo = (int)floor((vPos.GetY() + rRadius) / CELL_SIZE);
+
+	int iEnemy = 0;
+	int iFriend = 0;
+
+	//	If the box covers more cells than we have, it is faster to look at each
+	//	of our cells.
+
+	if ((xTo - xFrom + 1) * (yTo - yFrom + 1) > View.Cells.GetCount())
+		{
+		for (i = 0; i < View.Cells.GetCount(); i++)
+			{
+			DWORD dwKey = View.Cells.GetKey(i);
+			int x = (int)(short)HIWORD(dwKey);
+			int y = (int)(short)LOWORD(dwKey);
+
+			if (x >= xFrom && x <= xTo && y >= yFrom && y <= yTo)
+				{
+				iEnemy += View.Cells[i].iEnemy;
+				iFriend += View.Cells[i].iFriend;
+				}
+			}
+		}
+	else
+		{
+		int x, y;
+		for (y = yFrom; y <= yTo; y++)
+			for (x = xFrom; x <= xTo; x++)
+				{
+				const SInfluence *pInfluence = View.Cells.GetAt(MakeCellKey(x, y));
+				if (pInfluence)
+					{
+					iEnemy += pInfluence->iEnemy;
+					iFriend += pInfluence->iFriend;
+					}
+				}
+		}
+
+	if (retiEnemy)
+		*retiEnemy = iEnemy;
+
+	if (retiFriend)
+		*retiFriend = iFriend;
+	}
+
+Metric CSovereignInfluenceMap::CalcMargin (void) const
+
+//	CalcMargin
+//
+//	Positions in the map can be a few ticks old. Returns the distance that a
+//	ship could have traveled since then.
+
+	{
+	int iTicks = g_pUniverse->GetTicks() - m_iLastUpdate + 1;
+	return LIGHT_SPEED * g_SecondsPerUpdate * Max(1, iTicks);
+	}
+
+bool CSovereignInfluenceMap::GetEnemyShips (CSovereign *pSovereign, const CVector &vPos, Metric rRadius, TArray<CSpaceObject *> &retList)
+
+//	GetEnemyShips
+//
+//	Returns all ships that pSovereign considers enemies and that might be
+//	within the given radius (callers must still check the actual distance).
+//	Returns FALSE if the map has never been updated (in which case we don't
+//	know and the caller must look at all enemies).
+
+	{
+	int i, j;
+
+	retList.DeleteAll();
+
+	if (m_iLastUpdate == -1)
+		return false;
+
+	if (pSovereign == NULL)
+		return true;
+
+	Metric rBox = rRadius + CalcMargin();
+	int xFrom = (int)floor((vPos.GetX() - rBox) / CELL_SIZE);
+	int xTo = (int)floor((vPos.GetX() + rBox) / CELL_SIZE);
+	int yFrom = (int)floor((vPos.GetY() - rBox) / CELL_SIZE);
+	int yTo = (int)floor((vPos.GetY() + rBox) / CELL_SIZE);
+
+	//	The view tells us which cells have any enemies at all, so we only look
+	//	at the sovereigns in those.
+
+	SView &View = GetView(pSovereign);
+
+	int x, y;
+	for (y = yFrom; y <= yTo; y++)
+		for (x = xFrom; x <= xTo; x++)
+			{
+			DWORD dwKey = MakeCellKey(x, y);
+			const SInfluence *pInfluence = View.Cells.GetAt(dwKey);
+			if (pInfluence == NULL || pInfluence->iEnemy <= 0)
+				continue;
+
+			const SCell *pCell = m_Cells.GetAt(dwKey);
+			if (pCell == NULL)
+				continue;
+
+			for (i = 0; i < pCell->Power.GetCount(); i++)
+				{
+				const SSovereignPower &Power = pCell->Power[i];
+				if (!pSovereign->IsEnemy(Power.pSovereign))
+					continue;
+
+				for (j = 0; j < Power.Ships.GetCount(); j++)
+					retList.Insert(Power.Ships[j]);
+				}
+			}
+
+	return true;
+	}
+
+void CSovereignInfluenceMap::GetInfluence (CSovereign *pSovereign, const CVector &vPos, Metric rRadius, int *retiEnemy, int *retiFriend)
+
+//	GetInfluence
+//
+//	Returns the total combat power of ships that pSovereign considers enemies
+//	(and friends) within the cells that overlap the given radius.
+
+	{
+	if (pSovereign == NULL)
+		{
+		if (retiEnemy)
+			*retiEnemy = 0;
+
+		if (retiFriend)
+			*retiFriend = 0;
+
+		return;
+		}
+
+	CalcInfluence(GetView(pSovereign), vPos, rRadius, retiEnemy, retiFriend);
+	}
+
+CSovereignInfluenceMap::SView &CSovereignInfluenceMap::GetView (CSovereign *pSovereign)
+
+//	GetView
+//
+//	Returns the map as seen by the given sovereign, computing it if necessary.
+
+	{
+	DWORD dwVersion = g_pUniverse->GetSovereignDispositions().GetVersion();
+
+	SView *pView = m_Views.SetAt(pSovereign);
+	if (pView->dwVersion != dwVersion)
+		{
+		InitView(pSovereign, *pView);
+		pView->dwVersion = dwVersion;
+		}
+
+	return *pView;
+	}
+
+bool CSovereignInfluenceMap::HasEnemyPower (CSovereign *pSovereign, const CVector &vPos, Metric rRadius)
+
+//	HasEnemyPower
+//
+//	Returns TRUE if there might be an enemy ship of pSovereign within the given
+//	radius. Positions in the map can be a few ticks old, so we add the distance
+//	that a ship could have traveled since then. If this returns FALSE, there
+//	are no enemy ships in range.
+
+	{
+	if (pSovereign == NULL)
+		return false;
+
+	//	If we've never been updated, we don't know.
+
+	if (m_iLastUpdate == -1)
+		return true;
+
+	int iEnemy;
+	CalcInfluence(GetView(pSovereign), vPos, rRadius + CalcMargin(), &iEnemy, NULL);
+	return (iEnemy > 0);
+	}
+
+void CSovereignInfluenceMap::InitView (CSovereign *pSovereign, SView &View) const
+
+//	InitView
+//
+//	Computes the view of the given sovereign from the raw power.
+
+	{
+	int i, j;
+
+	View.Cells.DeleteAll();
+
+	for (i = 0; i < m_Cells.GetCount(); i++)
+		{
+		const SCell &Cell = m_Cells[i];
+		SInfluence Influence;
+
+		for (j = 0; j < Cell.Power.GetCount(); j++)
+			{
+			if (pSovereign->IsEnemy(Cell.Power[j].pSovereign))
+				Influence.iEnemy += Cell.Power[j].iPower;
+			else if (pSovereign->IsFriend(Cell.Power[j].pSovereign))
+				Influence.iFriend += Cell.Power[j].iPower;
+			}
+
+		if (Influence.iEnemy > 0 || Influence.iFriend > 0)
+			View.Cells.SetAt(m_Cells.GetKey(i), Influence);
+		}
+	}
+
+bool CSovereignInfluenceMap::IsCandidate (CSpaceObject *pObj)
+
+//	IsCandidate
+//
+//	Returns TRUE if the object contributes to the map.
+
+	{
+	return (pObj->GetCategory() == CSpaceObject::catShip && pObj->ClassCanAttack());
+	}
+
+void CSovereignInfluenceMap::Remove (CSpaceObject *pObj)
+
+//	Remove
+//
+//	Removes the object from the map.
+
+	{
+	SEntry *pEntry = m_Objects.GetAt(pObj);
+	if (pEntry == NULL)
+		return;
+
+	AddPower(pObj, pEntry->pSovereign, pEntry->dwCell, -pEntry->iPower);
+	m_Objects.DeleteAt(pObj);
+	}
+
+void CSovereignInfluenceMap::SetEntry (CSpaceObject *pObj, CSovereign *pSovereign, DWORD dwCell, int iPower)
+
+//	SetEntry
+//
+//	Sets the contribution of the given object, adjusting the map if anything
+//	changed.
+
+	{
+	bool bNew;
+	SEntry *pEntry = m_Objects.SetAt(pObj, &bNew);
+	if (!bNew)
+		{
+		if (pEntry->pSovereign == pSovereign
+				&& pEntry->dwCell == dwCell
+				&& pEntry->iPower == iPower)
+			return;
+
+		AddPower(pObj, pEntry->pSovereign, pEntry->dwCell, -pEntry->iPower);
+		}
+
+	pEntry->pSovereign = pSovereign;
+	pEntry->dwCell = dwCell;
+	pEntry->iPower = iPower;
+
+	AddPower(pObj, pSovereign, dwCell, iPower);
+	}
+
+void CSovereignInfluenceMap::Update (CSystem &System)
+
+//	Update
+//
+//	Called once per system update, before ship behavior. Every few ticks we
+//	refresh the position and power of each ship. Only ships that changed cells
+//	(or power) touch the grid.
+
+	{
+	int i;
+
+	int iTick = g_pUniverse->GetTicks();
+	if (m_iLastUpdate != -1 && iTick - m_iLastUpdate < UPDATE_INTERVAL)
+		return;
+
+	m_iLastUpdate = iTick;
+
+	for (i = 0; i < System.GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = System.GetObject(i);
+		if (pObj == NULL || !IsCandidate(pObj))
+			continue;
+
+		if (pObj->IsDestroyed())
+			Remove(pObj);
+		else
+			SetEntry(pObj, pObj->GetSovereign(), CalcCellKey(pObj->GetPos()), Max(1, pObj->GetCombatPower()));
+		}
+	}
@@ -214,6 +214,78 @@ bool CSpaceObject::m_bObjDestroyed = false;
 
 CString ParseParam (char **ioPos);
 
+enum ESpaceObjectProperties
+	{
+	propAscended,
+	propCategory,
+	propCommsKey,
+	propCurrency,
+	propCurrencyName,
+	propCyberDefenseLevel,
+	propDamageDesc,
+	propDestiny,
+	propDockingPorts,
+	propEventSubscribers,
+	propHasDockingPorts,
+	propID,
+	propIdentified,
+	propInstallArmorMaxLevel,
+	propInstallDeviceMaxLevel,
+	propInstallDeviceUpgradeOnly,
+	propKnown,
+	propLevel,
+	propMass,
+	propNamePattern,
+	propPaintLayer,
+	propPlayerMissionsGiven,
+	propRadioactive,
+	propRefuelMaxLevel,
+	propRemoveDeviceMaxLevel,
+	propRepairArmorMaxLevel,
+	propScale,
+	propSovereign,
+	propStealth,
+	propSuspended,
+	propUnderAttack,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propAscended,					PROPERTY_ASCENDED	},
+		{	propCategory,					PROPERTY_CATEGORY	},
+		{	propCommsKey,					PROPERTY_COMMS_KEY	},
+		{	propCurrency,					PROPERTY_CURRENCY	},
+		{	propCurrencyName,				PROPERTY_CURRENCY_NAME	},
+		{	propCyberDefenseLevel,			PROPERTY_CYBER_DEFENSE_LEVEL	},
+		{	propDamageDesc,					PROPERTY_DAMAGE_DESC	},
+		{	propDestiny,					PROPERTY_DESTINY	},
+		{	propDockingPorts,				PROPERTY_DOCKING_PORTS	},
+		{	propEventSubscribers,			PROPERTY_EVENT_SUBSCRIBERS	},
+		{	propHasDockingPorts,			PROPERTY_HAS_DOCKING_PORTS	},
+		{	propID,							PROPERTY_ID	},
+		{	propIdentified,					PROPERTY_IDENTIFIED	},
+		{	propInstallArmorMaxLevel,		PROPERTY_INSTALL_ARMOR_MAX_LEVEL	},
+		{	propInstallDeviceMaxLevel,		PROPERTY_INSTALL_DEVICE_MAX_LEVEL	},
+		{	propInstallDeviceUpgradeOnly,	PROPERTY_INSTALL_DEVICE_UPGRADE_ONLY	},
+		{	propKnown,						PROPERTY_KNOWN	},
+		{	propLevel,						PROPERTY_LEVEL	},
+		{	propMass,						PROPERTY_MASS	},
+		{	propNamePattern,				PROPERTY_NAME_PATTERN	},
+		{	propPaintLayer,					PROPERTY_PAINT_LAYER	},
+		{	propPlayerMissionsGiven,		PROPERTY_PLAYER_MISSIONS_GIVEN	},
+		{	propRadioactive,				PROPERTY_RADIOACTIVE	},
+		{	propRefuelMaxLevel,				PROPERTY_REFUEL_MAX_LEVEL	},
+		{	propRemoveDeviceMaxLevel,		PROPERTY_REMOVE_DEVICE_MAX_LEVEL	},
+		{	propRepairArmorMaxLevel,		PROPERTY_REPAIR_ARMOR_MAX_LEVEL	},
+		{	propScale,						PROPERTY_SCALE	},
+		{	propSovereign,					PROPERTY_SOVEREIGN	},
+		{	propStealth,					PROPERTY_STEALTH	},
+		{	propSuspended,					PROPERTY_SUSPENDED	},
+		{	propUnderAttack,				PROPERTY_UNDER_ATTACK	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CSpaceObject::CSpaceObject (void) : CObject(&g_Class)
 
 //	CSpaceObject constructor
@@ -224,6 +296,7 @@ CSpaceObject::CSpaceObject (void) : CObject(&g_Class)
 CSpaceObject::CSpaceObject (IObjectClass *pClass) : CObject(pClass),
 		m_pSystem(NULL),
 		m_iIndex(-1),
+		m_pGridNode(NULL),
 		m_rBoundsX(0.0),
 		m_rBoundsY(0.0),
 
@@ -4214,13 +4287,14 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 
 	{
 	int i;
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	CDesignType *pType;
 
-	if (strEquals(sName, PROPERTY_ASCENDED))
+	if (iProp == propAscended)
 		return CC.CreateBool(IsAscended());
 
-	else if (strEquals(sName, PROPERTY_CATEGORY))
+	else if (iProp == propCategory)
 		{
 		switch (GetCategory())
 			{
@@ -4243,7 +4317,7 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 				return CC.CreateString(CATEGORY_EFFECT);
 			}
 		}
-	else if (strEquals(sName, PROPERTY_COMMS_KEY))
+	else if (iProp == propCommsKey)
 		{
 		if (m_iHighlightChar)
 			{
@@ -4258,16 +4332,16 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		else
 			return CC.CreateNil();
 		}
-	else if (strEquals(sName, PROPERTY_CURRENCY))
+	else if (iProp == propCurrency)
 		return CC.CreateInteger(GetDefaultEconomy()->GetUNID());
 
-	else if (strEquals(sName, PROPERTY_CURRENCY_NAME))
+	else if (iProp == propCurrencyName)
 		return CC.CreateString(GetDefaultEconomy()->GetSID());
 
-	else if (strEquals(sName, PROPERTY_CYBER_DEFENSE_LEVEL))
+	else if (iProp == propCyberDefenseLevel)
 		return CC.CreateInteger(GetCyberDefenseLevel());
 
-	else if (strEquals(sName, PROPERTY_DAMAGE_DESC))
+	else if (iProp == propDamageDesc)
 		{
 		ICCItem *pResult = CC.CreateSymbolTable();
 		SVisibleDamage Damage;
@@ -4285,10 +4359,10 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return pResult;
 		}
 
-	else if (strEquals(sName, PROPERTY_DESTINY))
+	else if (iProp == propDestiny)
 		return CC.CreateInteger(GetDestiny());
 
-	else if (strEquals(sName, PROPERTY_DOCKING_PORTS))
+	else if (iProp == propDockingPorts)
 		{
 		CDockingPorts *pPorts = GetDockingPorts();
 		if (pPorts == NULL || pPorts->GetPortCount(this) == 0)
@@ -4327,7 +4401,7 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return pList;
 		}
 
-	else if (strEquals(sName, PROPERTY_EVENT_SUBSCRIBERS))
+	else if (iProp == propEventSubscribers)
 		{
 		ICCItem *pResult = CC.CreateLinkedList();
 		for (int i = 0; i < m_SubscribedObjs.GetCount(); i++)
@@ -4346,40 +4420,40 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			return pResult;
 		}
 
-	else if (strEquals(sName, PROPERTY_HAS_DOCKING_PORTS))
+	else if (iProp == propHasDockingPorts)
 		return CC.CreateBool(GetDockingPortCount() > 0);
 
-	else if (strEquals(sName, PROPERTY_ID))
+	else if (iProp == propID)
 		return CC.CreateInteger(GetID());
 
-	else if (strEquals(sName, PROPERTY_IDENTIFIED))
+	else if (iProp == propIdentified)
 		return CC.CreateBool(IsIdentified());
 
-	else if (strEquals(sName, PROPERTY_INSTALL_ARMOR_MAX_LEVEL))
+	else if (iProp == propInstallArmorMaxLevel)
 		{
 		int iMaxLevel = GetTradeMaxLevel(serviceReplaceArmor);
 		return (iMaxLevel != -1 ? CC.CreateInteger(iMaxLevel) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_INSTALL_DEVICE_MAX_LEVEL))
+	else if (iProp == propInstallDeviceMaxLevel)
 		{
 		int iMaxLevel = GetTradeMaxLevel(serviceInstallDevice);
 		return (iMaxLevel != -1 ? CC.CreateInteger(iMaxLevel) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_INSTALL_DEVICE_UPGRADE_ONLY))
+	else if (iProp == propInstallDeviceUpgradeOnly)
 		return CC.CreateBool(HasTradeUpgradeOnly(serviceInstallDevice));
 
-	else if (strEquals(sName, PROPERTY_KNOWN))
+	else if (iProp == propKnown)
 		return CC.CreateBool(IsKnown());
 
-	else if (strEquals(sName, PROPERTY_LEVEL))
+	else if (iProp == propLevel)
 		return CC.CreateInteger(GetLevel());
 
-	else if (strEquals(sName, PROPERTY_MASS))
+	else if (iProp == propMass)
 		return CC.CreateInteger((int)GetMass());
 
-    else if (strEquals(sName, PROPERTY_NAME_PATTERN))
+    else if (iProp == propNamePattern)
 		{
 		ICCItem *pResult = CC.CreateSymbolTable();
 		DWORD dwFlags;
@@ -4388,10 +4462,10 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return pResult;
 		}
 
-	else if (strEquals(sName, PROPERTY_PAINT_LAYER))
+	else if (iProp == propPaintLayer)
 		return CC.CreateString(GetPaintLayerID(GetPaintLayer()));
 
-	else if (strEquals(sName, PROPERTY_PLAYER_MISSIONS_GIVEN))
+	else if (iProp == propPlayerMissionsGiven)
 		{
 		int iCount = g_pUniverse->GetObjStats(GetID()).iPlayerMissionsGiven;
 		if (iCount > 0)
@@ -4400,28 +4474,28 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			return CC.CreateNil();
 		}
 
-	else if (strEquals(sName, PROPERTY_RADIOACTIVE))
+	else if (iProp == propRadioactive)
 		return CC.CreateBool(IsRadioactive());
 
-	else if (strEquals(sName, PROPERTY_REFUEL_MAX_LEVEL))
+	else if (iProp == propRefuelMaxLevel)
 		{
 		int iMaxLevel = GetTradeMaxLevel(serviceRefuel);
 		return (iMaxLevel != -1 ? CC.CreateInteger(iMaxLevel) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_REMOVE_DEVICE_MAX_LEVEL))
+	else if (iProp == propRemoveDeviceMaxLevel)
 		{
 		int iMaxLevel = GetTradeMaxLevel(serviceRemoveDevice);
 		return (iMaxLevel != -1 ? CC.CreateInteger(iMaxLevel) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_REPAIR_ARMOR_MAX_LEVEL))
+	else if (iProp == propRepairArmorMaxLevel)
 		{
 		int iMaxLevel = GetTradeMaxLevel(serviceRepairArmor);
 		return (iMaxLevel != -1 ? CC.CreateInteger(iMaxLevel) : CC.CreateNil());
 		}
 
-	else if (strEquals(sName, PROPERTY_SCALE))
+	else if (iProp == propScale)
 		{
 		switch (GetScale())
 			{
@@ -4445,7 +4519,7 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			}
 		}
 
-	else if (strEquals(sName, PROPERTY_SOVEREIGN))
+	else if (iProp == propSovereign)
 		{
 		CSovereign *pSovereign = GetSovereign();
 		if (pSovereign)
@@ -4454,13 +4528,13 @@ ICCItem *CSpaceObject::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 			return CC.CreateNil();
 		}
 
-	else if (strEquals(sName, PROPERTY_STEALTH))
+	else if (iProp == propStealth)
 		return CC.CreateInteger(GetStealth());
 
-	else if (strEquals(sName, PROPERTY_SUSPENDED))
+	else if (iProp == propSuspended)
 		return CC.CreateBool(IsSuspended());
 
-	else if (strEquals(sName, PROPERTY_UNDER_ATTACK))
+	else if (iProp == propUnderAttack)
 		return CC.CreateBool(IsUnderAttack());
 
 	else if (pType = GetType())
@@ -5582,9 +5656,23 @@ bool CSpaceObject::IsDestinyTime (int iCycle, int iOffset)
 //	the given cycle. A cycle of n aligns with a space object
 //	once every n ticks. Each object aligns at different times
 //	depending on its destiny.
+//
+//	If the current behavior update covers more than one tick, then we return
+//	TRUE if the cycle aligned on any of those ticks.
  
 	{
-	return (((g_pUniverse->GetTicks() + GetDestiny()) % iCycle) == iOffset);
+	int iTime = g_pUniverse->GetTicks() + GetDestiny();
+	int iTimeSpan = GetDestinyTimeSpan();
+	if (iTimeSpan <= 1)
+		return ((iTime % iCycle) == iOffset);
+
+	//	Number of ticks since the cycle last aligned
+
+	int iSinceAligned = (iTime - iOffset) % iCycle;
+	if (iSinceAligned < 0)
+		iSinceAligned += iCycle;
+
+	return (iSinceAligned < iTimeSpan);
 	}
 
 bool CSpaceObject::IsEnemy (const CSpaceObject *pObj) const
@@ -6124,20 +6212,28 @@ void CSpaceObject::Move (SUpdateCtx &Ctx, Metric rSeconds)
 
 	OnMove(m_vOldPos, rSeconds);
 
-	//	Clear painted (until the next tick)
+	//	Done
 
-	ClearPainted();
+	OnMoveDone(Ctx);
 
-	//	Set a flag so we check collisions
+	DEBUG_CATCH;
+	}
 
-	if (IsAnchored())
-		SetCollisionTestNeeded(false);
-	else if (Ctx.bHasShipBarriers)
-		SetCollisionTestNeeded(GetCategory() == CSpaceObject::catShip || GetCategory() == CSpaceObject::catStation);
-	else
-		SetCollisionTestNeeded(GetCategory() == CSpaceObject::catStation);
+void CSpaceObject::MoveBatched (SUpdateCtx &Ctx, const CVector &vNewPos)
 
-	DEBUG_CATCH;
+//	MoveBatched
+//
+//	The system has already computed our new position in a batch (see 
+//	CKinematicsStore). This is only called for objects that move linearly and
+//	that don't need OnMove.
+
+	{
+	ASSERT(!m_fNonLinearMove);
+
+	m_vOldPos = m_vPos;
+	m_vPos = vNewPos;
+
+	OnMoveDone(Ctx);
 	}
 
 void CSpaceObject::NotifyOnNewSystem (CSystem *pNewSystem)
@@ -6280,6 +6376,27 @@ void CSpaceObject::OnModifyItemComplete (IDockScreenUI::SModifyItemCtx &ModifyCt
 	g_pUniverse->GetDockSession().OnModifyItemComplete(ModifyCtx, this, Result);
 	}
 
+void CSpaceObject::OnMoveDone (SUpdateCtx &Ctx)
+
+//	OnMoveDone
+//
+//	Called after the object has moved this tick.
+
+	{
+	//	Clear painted (until the next tick)
+
+	ClearPainted();
+
+	//	Set a flag so we check collisions
+
+	if (IsAnchored())
+		SetCollisionTestNeeded(false);
+	else if (Ctx.bHasShipBarriers)
+		SetCollisionTestNeeded(GetCategory() == CSpaceObject::catShip || GetCategory() == CSpaceObject::catStation);
+	else
+		SetCollisionTestNeeded(GetCategory() == CSpaceObject::catStation);
+	}
+
 void CSpaceObject::OnObjDestroyed (const SDestroyCtx &Ctx)
 
 //	OnObjDestroyed
@@ -7155,23 +7272,24 @@ bool CSpaceObject::SetProperty (const CString &sName, ICCItem *pValue, CString *
 //	Sets an object property
 
 	{
-	if (strEquals(sName, PROPERTY_IDENTIFIED))
+	int iProp = g_Properties.Find(sName);
+	if (iProp == propIdentified)
 		{
 		SetIdentified(!pValue->IsNil());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_COMMS_KEY))
+	else if (iProp == propCommsKey)
 		{
 		CString sKey = pValue->GetStringValue();
 		m_iDesiredHighlightChar = *sKey.GetASCIIZPointer();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_KNOWN))
+	else if (iProp == propKnown)
 		{
 		SetKnown(!pValue->IsNil());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SOVEREIGN))
+	else if (iProp == propSovereign)
 		{
 		CSovereign *pSovereign = g_pUniverse->FindSovereign(pValue->GetIntegerValue());
 		if (pSovereign == NULL)
@@ -7194,14 +7312,22 @@ void CSpaceObject::SetSovereign (CSovereign *pSovereign)
 //	Sets the object sovereign
 
 	{
-	OnSetSovereign(pSovereign);
+	CSystem *pSystem = GetSystem();
+	CSovereign *pOldSovereign = GetSovereign();
+
+	//	If we're part of a system, we need to move between enemy object lists
+	//	when we change sovereigns.
+
+	if (pSystem)
+		pSystem->RemoveFromEnemyObjectCache(this, pOldSovereign);
 
-	//	If we're part of a system, we need to flush the enemy object cache when
-	//	we change sovereigns.
+	OnSetSovereign(pSovereign);
 
-	CSystem *pSystem;
-	if (ClassCanAttack() && (pSystem = GetSystem()))
-		pSystem->FlushEnemyObjectCache();
+	if (pSystem)
+		{
+		pSystem->AddToEnemyObjectCache(this, GetSovereign());
+		pSystem->GetInfluenceMap().Add(this);
+		}
 	}
 
 bool CSpaceObject::Translate (const CString &sID, ICCItem *pData, ICCItem **retpResult)
@@ -32,15 +32,25 @@ bool CSpaceObjectCriteria::MatchesAttributes (const CSpaceObject &Obj) const
 	{
 	int i;
 
-	for (i = 0; i < m_AttribsRequired.GetCount(); i++)
-		if (!Obj.HasAttribute(m_AttribsRequired[i]))
+	//	Usually we've compiled the attributes into atoms, which is much faster.
+
+	if (m_bAttribAtoms)
+		{
+		if (!Obj.HasAttributes(m_AttribsRequiredAtoms, m_AttribsNotAllowedAtoms))
 			return false;
+		}
+	else
+		{
+		for (i = 0; i < m_AttribsRequired.GetCount(); i++)
+			if (!Obj.HasAttribute(m_AttribsRequired[i]))
+				return false;
 
-	//	Check attributes not allowed
+		//	Check attributes not allowed
 
-	for (i = 0; i < m_AttribsNotAllowed.GetCount(); i++)
-		if (Obj.HasAttribute(m_AttribsNotAllowed[i]))
-			return false;
+		for (i = 0; i < m_AttribsNotAllowed.GetCount(); i++)
+			if (Obj.HasAttribute(m_AttribsNotAllowed[i]))
+				return false;
+		}
 
 	//	Check special attribs required
 
@@ -536,6 +546,12 @@ void CSpaceObjectCriteria::Parse (CSpaceObject *pSource, const CString &sCriteri
 
 		pPos++;
 		}
+
+	//	Compile attributes into atoms so that we can match quickly. If any 
+	//	attribute is not a single name, we match with strings.
+
+	m_bAttribAtoms = (m_AttribsRequiredAtoms.InitFromArray(m_AttribsRequired)
+			&& m_AttribsNotAllowedAtoms.InitFromArray(m_AttribsNotAllowed));
 	}
 
 void CSpaceObjectCriteria::SetSource (CSpaceObject *pSource)
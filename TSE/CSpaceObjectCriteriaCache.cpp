@@ -0,0 +1,29 @@
+//	CSpaceObjectCriteriaCache.cpp
+//
+//	CSpaceObjectCriteriaCache class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const int MAX_CACHED_CRITERIA =							1024;
+
+const CSpaceObjectCriteria &CSpaceObjectCriteriaCache::Get (const CString &sCriteria)
+
+//	Get
+//
+//	Returns the parsed criteria for the given string (without a source). Some
+//	scripts generate criteria strings on the fly, so we start over if the
+//	cache gets too big.
+
+	{
+	CSpaceObjectCriteria *pCriteria = m_Cache.GetAt(sCriteria);
+	if (pCriteria)
+		return *pCriteria;
+
+	if (m_Cache.GetCount() >= MAX_CACHED_CRITERIA)
+		m_Cache.DeleteAll();
+
+	pCriteria = m_Cache.SetAt(sCriteria);
+	pCriteria->Init(sCriteria);
+	return *pCriteria;
+	}
@@ -21,6 +21,7 @@ CSpaceObjectGrid::CSpaceObjectGrid (int iGridSize, Metric rCellSize, Metric rCel
 	m_Outer.pList = NULL;
 
 	m_iGridSize = iGridSize;
+	m_iOuterCell = iTotal;
 	m_rCellSize = rCellSize;
 	m_rCellBorder = rCellBorder;
 
@@ -38,17 +39,19 @@ CSpaceObjectGrid::~CSpaceObjectGrid (void)
 	delete [] m_pGrid;
 	}
 
-void CSpaceObjectGrid::AddObject (CSpaceObject *pObj)
+void CSpaceObjectGrid::AddObject (CSpaceObject *pObj, int iCell)
 
 //	AddObject
 //
-//	Adds an object to the list.
+//	Adds an object to the given cell.
 	
 	{
 	ASSERT(pObj->GetID() != 0xdddddddd);
+	ASSERT(pObj->GetGridNode() == NULL);
 	
-	SList &List = GetList(pObj->GetPos());
-	List.pList = m_Pool.AllocObj(List.pList, pObj);
+	CSpaceObjectPool::SNode *pNode = m_Pool.AllocNode(pObj);
+	LinkNode(pNode, iCell);
+	pObj->SetGridNode(pNode);
 	}
 
 void CSpaceObjectGrid::DebugObjDeleted (CSpaceObject *pObj) const
@@ -73,38 +76,36 @@ void CSpaceObjectGrid::Delete (CSpaceObject *pObj)
 
 //	Delete
 //
-//	Delete the given object from the grid. NOTE: This is a relatively expensive
-//	operation, so we only do it when we really need to.
+//	Delete the given object from the grid. This is safe to call in the middle
+//	of an enumeration (the node is unlinked, but its pNext is preserved and the
+//	node is not reused until the next call to Update).
 
 	{
-	int iTotal = m_iGridSize * m_iGridSize;
-	for (int i = 0; i < iTotal; i++)
-		{
-		bool bDeleted;
-		m_pGrid[i].pList = m_Pool.DeleteObj(m_pGrid[i].pList, pObj, &bDeleted);
-		if (bDeleted)
-			{
-			//	We assume that an object can only be on one list in the grid.
-			return;
-			}
-		}
+	CSpaceObjectPool::SNode *pNode = pObj->GetGridNode();
+	if (pNode == NULL)
+		return;
 
-	//	If we get this far, then try to delete from the outer list.
-
-	m_Outer.pList = m_Pool.DeleteObj(m_Outer.pList, pObj);
+	UnlinkNode(pNode);
+	m_Pool.FreeNode(pNode);
+	pObj->SetGridNode(NULL);
 	}
 
-void CSpaceObjectGrid::DeleteAll (void)
+int CSpaceObjectGrid::GetCell (const CVector &vPos) const
 
-//	DeleteAll
+//	GetCell
 //
-//	Remove all objects
+//	Returns the index of the cell that contains the given position. If the 
+//	position is outside the grid, we return m_iOuterCell.
 
 	{
-	int iTotal = m_iGridSize * m_iGridSize;
-	utlMemSet(m_pGrid, sizeof(SList) * iTotal, 0);
+	CVector vGridPos = vPos - m_vLL;
+	int x = (int)(vGridPos.GetX() / m_rCellSize);
+	int y = (int)(vGridPos.GetY() / m_rCellSize);
 
-	m_Outer.pList = NULL;
+	if (x < 0 || y < 0 || x >= m_iGridSize || y >= m_iGridSize)
+		return m_iOuterCell;
+	else
+		return y * m_iGridSize + x;
 	}
 
 bool CSpaceObjectGrid::GetGridCoord (const CVector &vPos, int *retx, int *rety) const
@@ -124,131 +125,6 @@ bool CSpaceObjectGrid::GetGridCoord (const CVector &vPos, int *retx, int *rety)
 	return (x >= 0 && y >= 0 && x < m_iGridSize && y < m_iGridSize);
 	}
 
-const CSpaceObjectGrid::SList &CSpaceObjectGrid::GetList (const CVector &vPos) const
-
-//	GetList
-//
-//	Returns the object list at the given position
-
-	{
-	CVector vGridPos = vPos - m_vLL;
-	int x = (int)(vGridPos.GetX() / m_rCellSize);
-	int y = (int)(vGridPos.GetY() / m_rCellSize);
-
-	if (x < 0 || y < 0 || x >= m_iGridSize || y >= m_iGridSize)
-		return m_Outer;
-	else
-		return GetList(x, y);
-	}
-
-CSpaceObjectGrid::SList &CSpaceObjectGrid::GetList (const CVector &vPos)
-
-//	GetList
-//
-//	Returns the object list at the given position
-
-	{
-	CVector vGridPos = vPos - m_vLL;
-	int x = (int)(vGridPos.GetX() / m_rCellSize);
-	int y = (int)(vGridPos.GetY() / m_rCellSize);
-
-	if (x < 0 || y < 0 || x >= m_iGridSize || y >= m_iGridSize)
-		return m_Outer;
-	else
-		return GetList(x, y);
-	}
-
-void CSpaceObjectGrid::EnumStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags) const
-
-//	EnumStart
-//
-//	Begins enumeration
-
-	{
-	DEBUG_TRY
-
-	//	Init params and options
-
-	i.vLL = vLL;
-	i.vUR = vUR;
-	i.bCheckBox = ((dwFlags & gridNoBoxCheck) ? false : true);
-
-	//	First we need to generate a box that will contain enough grid cells
-	//	so that we can find the objects even if their center is outside
-	//	the input range
-
-	CVector vGridLL = vLL - m_vLL - CVector(m_rCellBorder, m_rCellBorder);
-	CVector vGridUR = vUR - m_vLL + CVector(m_rCellBorder, m_rCellBorder);
-
-	int xStart = (int)(vGridLL.GetX() / m_rCellSize);
-	int yStart = (int)(vGridLL.GetY() / m_rCellSize);
-
-	int xEnd = (int)(vGridUR.GetX() / m_rCellSize);
-	int yEnd = (int)(vGridUR.GetY() / m_rCellSize);
-
-	//	Generate a list of all grid cells to traverse
-
-	int iMaxSize = (xEnd - xStart + 1) * (yEnd - yStart + 1);
-	i.pGridIndexList = new const SList * [iMaxSize];
-	i.iGridIndexCount = 0;
-	bool bOuterAdded = (m_Outer.pList == NULL);
-
-	//	Always start with the center cell
-
-	int xCenter = xStart + (xEnd - xStart) / 2;
-	int yCenter = yStart + (yEnd - yStart) / 2;
-	if (xCenter >= 0 && yCenter >= 0 && xCenter < m_iGridSize && yCenter < m_iGridSize)
-		{
-		const CSpaceObjectGrid::SList *pList = &GetList(xCenter, yCenter);
-		if (pList->pList)
-			i.pGridIndexList[i.iGridIndexCount++] = pList;
-		}
-	else if (!bOuterAdded)
-		{
-		i.pGridIndexList[i.iGridIndexCount++] = &m_Outer;
-		bOuterAdded = true;
-		}
-
-	//	Add the remaining cells
-
-	for (int y = yStart; y <= yEnd; y++)
-		for (int x = xStart; x <= xEnd; x++)
-			if (x == xCenter && y == yCenter)
-				NULL;
-			else if (x >= 0 && y >= 0 && x < m_iGridSize && y < m_iGridSize)
-				{
-				const CSpaceObjectGrid::SList *pList = &GetList(x, y);
-				if (pList->pList)
-					i.pGridIndexList[i.iGridIndexCount++] = pList;
-				}
-			else if (!bOuterAdded)
-				{
-				i.pGridIndexList[i.iGridIndexCount++] = &m_Outer;
-				bOuterAdded = true;
-				}
-
-	//	Initialize
-
-	ASSERT(i.iGridIndexCount <= iMaxSize);
-	i.bMore = (i.iGridIndexCount > 0);
-
-	//	Set the initial list
-
-	if (i.bMore)
-		{
-		i.iGridIndex = 0;
-		i.pList = i.pGridIndexList[0];
-		i.pNode = NULL;
-		i.pObj = NULL;
-
-		//	Start with the first
-
-		EnumGetNext(i);
-		}
-
-	DEBUG_CATCH
-	}
-
 CSpaceObject *CSpaceObjectGrid::EnumGetNext (SSpaceObjectGridEnumerator &i) const
 
 //	EnumGetNext
@@ -280,8 +156,7 @@ CSpaceObject *CSpaceObjectGrid::EnumGetNext (SSpaceObjectGridEnumerator &i) cons
 			{
 			i.pObj = i.pNode->pObj;
 
-			if (!i.pObj->IsDestroyed() 
-					&& (!i.bCheckBox || i.pObj->InBox(i.vUR, i.vLL)))
+			if (EnumMatches(i, i.pObj))
 				return pCurrentObj;
 			}
 
@@ -289,15 +164,8 @@ CSpaceObject *CSpaceObjectGrid::EnumGetNext (SSpaceObjectGridEnumerator &i) cons
 
 		else
 			{
-			i.iGridIndex++;
-			if (i.iGridIndex < i.iGridIndexCount)
-				{
-				ASSERT(i.iGridIndex >= 0);
-
-				i.pList = i.pGridIndexList[i.iGridIndex];
-				i.pNode = NULL;
-				}
-			else
+			i.pList = EnumNextCell(i);
+			if (i.pList == NULL)
 				{
 				i.bMore = false;
 				return pCurrentObj;
@@ -313,7 +181,8 @@ CSpaceObject *CSpaceObjectGrid::EnumGetNextFast (SSpaceObjectGridEnumerator &i)
 
 //	EnumGetNextFast
 //
-//	Returns the next object in the enumeration
+//	Returns the next object in the enumeration. NOTE: This does not apply any
+//	filters (not even the destroyed check) after the first object.
 
 	{
 	ASSERT(i.pNode != NULL);
@@ -362,15 +231,8 @@ CSpaceObject *CSpaceObjectGrid::EnumGetNextInBoxPoint (SSpaceObjectGridEnumerato
 
 		else
 			{
-			i.iGridIndex++;
-			if (i.iGridIndex < i.iGridIndexCount)
-				{
-				ASSERT(i.iGridIndex >= 0);
-
-				i.pList = i.pGridIndexList[i.iGridIndex];
-				i.pNode = NULL;
-				}
-			else
+			i.pList = EnumNextCell(i);
+			if (i.pList == NULL)
 				{
 				i.bMore = false;
 				return pCurrentObj;
@@ -387,19 +249,194 @@ bool CSpaceObjectGrid::EnumGetNextList (SSpaceObjectGridEnumerator &i) const
 //	Sets up the next list. Returns FALSE if we have reached the end
 
 	{
-	i.iGridIndex++;
-	if (i.iGridIndex >= i.iGridIndexCount)
+	do
 		{
-		i.bMore = false;
-		return false;
+		i.pList = EnumNextCell(i);
+		if (i.pList == NULL)
+			{
+			i.bMore = false;
+			return false;
+			}
+
+		i.pNode = i.pList->pList;
 		}
+	while (i.pNode == NULL);
+
+	return true;
+	}
+
+void CSpaceObjectGrid::EnumInitCells (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL) const
+
+//	EnumInitCells
+//
+//	Computes the range of cells to traverse for the given box and positions the
+//	enumerator on the first object. Filters must already be set.
+
+	{
+	//	First we need to generate a box that will contain enough grid cells
+	//	so that we can find the objects even if their center is outside
+	//	the input range
+
+	CVector vGridLL = vLL - m_vLL - CVector(m_rCellBorder, m_rCellBorder);
+	CVector vGridUR = vUR - m_vLL + CVector(m_rCellBorder, m_rCellBorder);
+
+	int xStart = (int)(vGridLL.GetX() / m_rCellSize);
+	int yStart = (int)(vGridLL.GetY() / m_rCellSize);
+
+	int xEnd = (int)(vGridUR.GetX() / m_rCellSize);
+	int yEnd = (int)(vGridUR.GetY() / m_rCellSize);
+
+	//	We always start with the center cell
+
+	i.xCenter = xStart + (xEnd - xStart) / 2;
+	i.yCenter = yStart + (yEnd - yStart) / 2;
+	i.bCenterDone = false;
 
-	i.pList = i.pGridIndexList[i.iGridIndex];
-	i.pNode = i.pList->pList;
+	//	All cells outside the grid map to the same outer list, so we only need
+	//	one row/column of them on each side. This does not change the order in
+	//	which we first reach the outer list.
+
+	i.xStart = Max(-1, xStart);
+	i.yStart = Max(-1, yStart);
+	i.xEnd = Min(m_iGridSize, xEnd);
+	i.yEnd = Min(m_iGridSize, yEnd);
+	i.xNext = i.xStart;
+	i.yNext = i.yStart;
+	i.bOuterDone = (m_Outer.pList == NULL);
+
+	//	Set the initial list
+
+	i.pList = EnumNextCell(i);
+	i.bMore = (i.pList != NULL);
+	i.pNode = NULL;
+	i.pObj = NULL;
+
+	//	Start with the first
+
+	if (i.bMore)
+		EnumGetNext(i);
+	}
+
+bool CSpaceObjectGrid::EnumMatches (const SSpaceObjectGridEnumerator &i, CSpaceObject *pObj) const
+
+//	EnumMatches
+//
+//	Returns TRUE if the object passes the enumerator's filters.
+
+	{
+	if (pObj->IsDestroyed())
+		return false;
+
+	if (i.bCheckBox && !pObj->InBox(i.vUR, i.vLL))
+		return false;
+
+	if (i.bCheckCircle && (pObj->GetPos() - i.vCenter).Length2() >= i.rRadius2)
+		return false;
+
+	if (i.dwCategories && !(pObj->GetCategory() & i.dwCategories))
+		return false;
 
 	return true;
 	}
 
+const CSpaceObjectGrid::SList *CSpaceObjectGrid::EnumNextCell (SSpaceObjectGridEnumerator &i) const
+
+//	EnumNextCell
+//
+//	Returns the next non-empty list to traverse (or NULL if there are no more).
+//	We return the center cell first and then all the others in row order. The
+//	outer list is returned at most once.
+
+	{
+	while (true)
+		{
+		int x, y;
+
+		if (!i.bCenterDone)
+			{
+			x = i.xCenter;
+			y = i.yCenter;
+			i.bCenterDone = true;
+			}
+		else
+			{
+			if (i.yNext > i.yEnd)
+				return NULL;
+
+			x = i.xNext;
+			y = i.yNext;
+
+			if (++i.xNext > i.xEnd)
+				{
+				i.xNext = i.xStart;
+				i.yNext++;
+				}
+
+			if (x == i.xCenter && y == i.yCenter)
+				continue;
+			}
+
+		if (x >= 0 && y >= 0 && x < m_iGridSize && y < m_iGridSize)
+			{
+			const SList *pList = &GetList(x, y);
+			if (pList->pList)
+				return pList;
+			}
+		else if (!i.bOuterDone)
+			{
+			i.bOuterDone = true;
+			return &m_Outer;
+			}
+		}
+	}
+
+void CSpaceObjectGrid::EnumStart (SSpaceObjectGridEnumerator &i, const CVector &vUR, const CVector &vLL, DWORD dwFlags, DWORD dwCategories) const
+
+//	EnumStart
+//
+//	Begins enumeration of all objects in the given box.
+
+	{
+	DEBUG_TRY
+
+	//	Init params and options
+
+	i.vLL = vLL;
+	i.vUR = vUR;
+	i.bCheckBox = ((dwFlags & gridNoBoxCheck) ? false : true);
+	i.bCheckCircle = false;
+	i.dwCategories = dwCategories;
+
+	EnumInitCells(i, vUR, vLL);
+
+	DEBUG_CATCH
+	}
+
+void CSpaceObjectGrid::EnumStartCircle (SSpaceObjectGridEnumerator &i, const CVector &vCenter, Metric rRadius, DWORD dwFlags, DWORD dwCategories) const
+
+//	EnumStartCircle
+//
+//	Begins enumeration of all objects whose center is inside the given circle.
+//	gridNoBoxCheck is ignored (we always check the circle).
+
+	{
+	DEBUG_TRY
+
+	CVector vRadius(rRadius, rRadius);
+
+	i.vLL = vCenter - vRadius;
+	i.vUR = vCenter + vRadius;
+	i.bCheckBox = false;
+	i.vCenter = vCenter;
+	i.rRadius2 = rRadius * rRadius;
+	i.bCheckCircle = true;
+	i.dwCategories = dwCategories;
+
+	EnumInitCells(i, i.vUR, i.vLL);
+
+	DEBUG_CATCH
+	}
+
 void CSpaceObjectGrid::GetObjectsInBox (const CVector &vUR, const CVector &vLL, CSpaceObjectList &Result)
 
 //	GetObjectsInBox
@@ -448,25 +485,111 @@ void CSpaceObjectGrid::GetObjectsInBox (const CVector &vUR, const CVector &vLL,
 			}
 	}
 
-void CSpaceObjectGrid::Init (CSystem *pSystem, SUpdateCtx &Ctx)
+void CSpaceObjectGrid::LinkNode (CSpaceObjectPool::SNode *pNode, int iCell)
+
+//	LinkNode
+//
+//	Adds the node to the given cell list. We keep each list sorted by
+//	descending object index, which is the order we got when we rebuilt the grid
+//	every tick. Callers that take the first match (e.g., FindObjectInRange)
+//	depend on this, so the order must not depend on when objects entered the
+//	cell.
+
+	{
+	SList &List = GetListByCell(iCell);
+	int iIndex = pNode->pObj->GetIndex();
+
+	CSpaceObjectPool::SNode *pPrev = NULL;
+	CSpaceObjectPool::SNode *pNext = List.pList;
+	while (pNext && pNext->pObj->GetIndex() > iIndex)
+		{
+		pPrev = pNext;
+		pNext = pNext->pNext;
+		}
+
+	pNode->iCell = iCell;
+	pNode->pPrev = pPrev;
+	pNode->pNext = pNext;
+	if (pNext)
+		pNext->pPrev = pNode;
+
+	if (pPrev)
+		pPrev->pNext = pNode;
+	else
+		List.pList = pNode;
+	}
+
+CSpaceObjectGridRange CSpaceObjectGrid::ObjectsInBox (const CVector &vUR, const CVector &vLL, DWORD dwFlags, DWORD dwCategories) const
+
+//	ObjectsInBox
+//
+//	Returns a range (for use in a range-based for loop) of objects in the box.
+
+	{
+	CSpaceObjectGridRange Range(*this);
+	EnumStart(Range.GetEnumerator(), vUR, vLL, dwFlags, dwCategories);
+	return Range;
+	}
+
+CSpaceObjectGridRange CSpaceObjectGrid::ObjectsInCircle (const CVector &vCenter, Metric rRadius, DWORD dwFlags, DWORD dwCategories) const
+
+//	ObjectsInCircle
+//
+//	Returns a range (for use in a range-based for loop) of objects whose center
+//	is inside the circle.
+
+	{
+	CSpaceObjectGridRange Range(*this);
+	EnumStartCircle(Range.GetEnumerator(), vCenter, rRadius, dwFlags, dwCategories);
+	return Range;
+	}
+
+void CSpaceObjectGrid::UnlinkNode (CSpaceObjectPool::SNode *pNode)
 
-//	Init
+//	UnlinkNode
 //
-//	Initialize the object grid from the system.
+//	Removes the node from its cell list. We leave pNode->pNext alone so that
+//	any enumerator sitting on this node can continue.
 
 	{
-	DeleteAll();
-	m_Pool.Init(pSystem->GetObjectCount());
+	if (pNode->pPrev)
+		pNode->pPrev->pNext = pNode->pNext;
+	else
+		GetListByCell(pNode->iCell).pList = pNode->pNext;
+
+	if (pNode->pNext)
+		pNode->pNext->pPrev = pNode->pPrev;
+	}
 
+void CSpaceObjectGrid::Update (CSystem *pSystem, SUpdateCtx &Ctx)
+
+//	Update
+//
+//	Brings the grid up to date with the system. Objects keep a pointer to their
+//	node, so we only touch the lists for objects that have crossed into a 
+//	different cell (or that have started or stopped being hittable). Objects
+//	are removed from the grid in CSystem::RemoveObject.
+
+	{
 	for (int i = 0; i < pSystem->GetObjectCount(); i++)
 		{
 		CSpaceObject *pObj = pSystem->GetObject(i);
 		if (pObj == NULL)
 			continue;
 
+		CSpaceObjectPool::SNode *pNode = pObj->GetGridNode();
+
 		if (pObj->CanBeHit())
 			{
-			AddObject(pObj);
+			int iCell = GetCell(pObj->GetPos());
+
+			if (pNode == NULL)
+				AddObject(pObj, iCell);
+			else if (pNode->iCell != iCell)
+				{
+				UnlinkNode(pNode);
+				LinkNode(pNode, iCell);
+				}
 
 			//	If this is an object that can block ships, then we remember it
 			//	so that we can optimize systems without it.
@@ -477,5 +600,42 @@ void CSpaceObjectGrid::Init (CSystem *pSystem, SUpdateCtx &Ctx)
 			if (pObj->BlocksShips())
 				Ctx.bHasShipBarriers = true;
 			}
+		else if (pNode)
+			Delete(pObj);
+		}
+	}
+
+void CSpaceObjectGrid::VisitInBox (ISpaceObjectGridVisitor &Visitor, const CVector &vUR, const CVector &vLL, DWORD dwFlags, DWORD dwCategories) const
+
+//	VisitInBox
+//
+//	Calls the visitor for every object in the box until it returns FALSE.
+
+	{
+	SSpaceObjectGridEnumerator i;
+	EnumStart(i, vUR, vLL, dwFlags, dwCategories);
+
+	while (i.bMore)
+		{
+		if (!Visitor.OnObj(EnumGetNext(i)))
+			return;
+		}
+	}
+
+void CSpaceObjectGrid::VisitInCircle (ISpaceObjectGridVisitor &Visitor, const CVector &vCenter, Metric rRadius, DWORD dwFlags, DWORD dwCategories) const
+
+//	VisitInCircle
+//
+//	Calls the visitor for every object whose center is inside the circle until
+//	it returns FALSE.
+
+	{
+	SSpaceObjectGridEnumerator i;
+	EnumStartCircle(i, vCenter, rRadius, dwFlags, dwCategories);
+
+	while (i.bMore)
+		{
+		if (!Visitor.OnObj(EnumGetNext(i)))
+			return;
 		}
 	}
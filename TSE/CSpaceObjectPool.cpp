@@ -5,90 +5,72 @@
 
 #include "PreComp.h"
 
-CSpaceObjectPool::SNode *CSpaceObjectPool::AllocObj (SNode *pList, CSpaceObject *pObj)
+const int NODES_PER_BLOCK =								1024;
 
-//	AllocObj
+CSpaceObjectPool::SNode *CSpaceObjectPool::AllocNode (CSpaceObject *pObj)
+
+//	AllocNode
 //
-//	Adds a new object to the given list and returns the newly allocated node,
-//	which becomes the new head of the list. pList may be NULL.
+//	Allocates a new node for the given object. The caller is responsible for
+//	linking it into a list.
 
 	{
-	if (m_iNextNode == m_iSize)
-		throw CException(ERR_MEMORY);
+	SNode *pNewNode;
 
-	SNode *pNewNode = &m_Pool[m_iNextNode++];
-	pNewNode->pObj = pObj;
-	pNewNode->pNext = pList;
+	//	Reuse a freed node, if we have one.
 
-	return pNewNode;
-	}
+	if (m_pFree)
+		{
+		pNewNode = m_pFree;
+		m_pFree = pNewNode->pPrev;
+		}
 
-void CSpaceObjectPool::DeleteAll (void)
+	//	Otherwise, take the next node from the last block (allocating a new
+	//	block if necessary). Blocks are never moved, so node pointers remain
+	//	valid until DeleteAll.
 
-//	DeleteAll
-//
-//	Delete the pool. Callers must call Init again before allocating.
-
-	{
-	if (m_Pool)
+	else
 		{
-		delete [] m_Pool;
-		m_Pool = NULL;
+		if (m_Blocks.GetCount() == 0 || m_iNextNode == NODES_PER_BLOCK)
+			{
+			m_Blocks.Insert(new SNode [NODES_PER_BLOCK]);
+			m_iNextNode = 0;
+			}
+
+		pNewNode = &m_Blocks[m_Blocks.GetCount() - 1][m_iNextNode++];
 		}
 
-	m_iSize = 0;
-	m_iNextNode = 0;
+	pNewNode->pObj = pObj;
+	pNewNode->pNext = NULL;
+	pNewNode->pPrev = NULL;
+	pNewNode->iCell = -1;
+
+	return pNewNode;
 	}
 
-CSpaceObjectPool::SNode *CSpaceObjectPool::DeleteObj (SNode *pList, CSpaceObject *pObj, bool *retbDeleted)
+void CSpaceObjectPool::DeleteAll (void)
 
-//	DeleteObj
-//
-//	Deletes the given object from the given list. Returns the new head of the 
-//	list.
+//	DeleteAll
 //
-//	LATER: For now, deleted nodes are leaked, but in the future we could add 
-//	them to a free list.
+//	Frees all nodes.
 
 	{
-	SNode *pPrev = NULL;
-	SNode *pNext = pList;
-	while (pNext)
-		{
-		if (pNext->pObj == pObj)
-			{
-			if (pPrev)
-				{
-				pPrev->pNext = pNext->pNext;
-				if (retbDeleted) *retbDeleted = true;
-				return pList;
-				}
-			else
-				{
-				if (retbDeleted) *retbDeleted = true;
-				return pNext->pNext;
-				}
-			}
+	for (int i = 0; i < m_Blocks.GetCount(); i++)
+		delete [] m_Blocks[i];
 
-		pPrev = pNext;
-		pNext = pNext->pNext;
-		}
-
-	//	Not found; just return the original list so that callers don'g have to
-	//	do any special checking.
-
-	if (retbDeleted) *retbDeleted = false;
-	return pList;
+	m_Blocks.DeleteAll();
+	m_pFree = NULL;
+	m_iNextNode = 0;
 	}
 
-bool CSpaceObjectPool::FindObj (SNode *pList, CSpaceObject *pObj) const
+bool CSpaceObjectPool::FindObj (const SNode *pList, CSpaceObject *pObj) const
 
 //	FindObj
 //
 //	Find object in the given list
 
 	{
-	SNode *pNext = pList;
+	const SNode *pNext = pList;
 	while (pNext)
 		{
 		if (pNext->pObj == pObj)
@@ -100,21 +82,16 @@ bool CSpaceObjectPool::FindObj (SNode *pList, CSpaceObject *pObj) const
 	return false;
 	}
 
-void CSpaceObjectPool::Init (int iSize)
+void CSpaceObjectPool::FreeNode (SNode *pNode)
 
-//	Init
+//	FreeNode
 //
-//	Initializes the pool to hold at least the given number of objects. If we try
-//	to allocate more than this amount, we throw ERR_MEMORY.
+//	Returns a node to the pool. We chain free nodes through pPrev so that
+//	pObj and pNext stay intact: an enumerator that is currently on this node
+//	can still advance to the rest of the list.
 
 	{
-	ASSERT(iSize >= 0);
-
-	DeleteAll();
-	if (iSize > 0)
-		{
-		m_Pool = new SNode [iSize];
-		m_iSize = iSize;
-		m_iNextNode = 0;
-		}
+	pNode->pPrev = m_pFree;
+	pNode->iCell = -1;
+	m_pFree = pNode;
 	}
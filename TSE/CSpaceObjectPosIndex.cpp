@@ -0,0 +1,159 @@
+//	CSpaceObjectPosIndex.cpp
+//
+//	CSpaceObjectPosIndex class
+//	Copyright (c) 2018 Kronosaur Productions, LLC. All Rights Reserved.
+
+#include "PreComp.h"
+
+const int MAX_GRID_SIZE =								64;
+const Metric MIN_CELL_SIZE =							(10.0 * LIGHT_SECOND);
+
+void CSpaceObjectPosIndex::DeleteAll (void)
+
+//	DeleteAll
+//
+//	Empty the index.
+
+	{
+	m_iGridSize = 0;
+	m_CellStart.DeleteAll();
+	m_Objects.DeleteAll();
+	}
+
+Metric CSpaceObjectPosIndex::GetMaxRadius (const CVector &vCenter) const
+
+//	GetMaxRadius
+//
+//	Returns a radius around vCenter that covers every cell in the index.
+
+	{
+	if (m_iGridSize == 0)
+		return 0.0;
+
+	Metric rDX = Max(Absolute(vCenter.GetX() - m_vLL.GetX()), Absolute(m_vUR.GetX() - vCenter.GetX()));
+	Metric rDY = Max(Absolute(vCenter.GetY() - m_vLL.GetY()), Absolute(m_vUR.GetY() - vCenter.GetY()));
+
+	return CVector(rDX, rDY).Length() + m_rCellSize;
+	}
+
+void CSpaceObjectPosIndex::GetObjectsInCircle (const CVector &vCenter, Metric rRadius, TArray<int> &Result) const
+
+//	GetObjectsInCircle
+//
+//	Appends the index of every object in a cell that overlaps the given circle.
+//	The caller must check the actual distance, since we return whole cells.
+
+	{
+	int x, y, i;
+
+	if (m_iGridSize == 0)
+		return;
+
+	int xStart = (int)floor((vCenter.GetX() - rRadius - m_vLL.GetX()) / m_rCellSize);
+	int yStart = (int)floor((vCenter.GetY() - rRadius - m_vLL.GetY()) / m_rCellSize);
+	int xEnd = (int)floor((vCenter.GetX() + rRadius - m_vLL.GetX()) / m_rCellSize);
+	int yEnd = (int)floor((vCenter.GetY() + rRadius - m_vLL.GetY()) / m_rCellSize);
+
+	if (xEnd < 0 || yEnd < 0 || xStart >= m_iGridSize || yStart >= m_iGridSize)
+		return;
+
+	xStart = Max(0, xStart);
+	yStart = Max(0, yStart);
+	xEnd = Min(m_iGridSize - 1, xEnd);
+	yEnd = Min(m_iGridSize - 1, yEnd);
+
+	for (y = yStart; y <= yEnd; y++)
+		{
+		int iRow = y * m_iGridSize;
+		for (x = xStart; x <= xEnd; x++)
+			{
+			for (i = m_CellStart[iRow + x]; i < m_CellStart[iRow + x + 1]; i++)
+				Result.Insert(m_Objects[i]);
+			}
+		}
+	}
+
+void CSpaceObjectPosIndex::Init (CSystem &System)
+
+//	Init
+//
+//	Buckets all objects in the system by their current position. The grid
+//	covers the bounding box of all objects, so every object lands in a cell.
+
+	{
+	int i;
+
+	DeleteAll();
+
+	//	Compute the bounding box
+
+	int iObjCount = 0;
+	for (i = 0; i < System.GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = System.GetObject(i);
+		if (pObj == NULL)
+			continue;
+
+		const CVector &vPos = pObj->GetPos();
+		if (iObjCount == 0)
+			{
+			m_vLL = vPos;
+			m_vUR = vPos;
+			}
+		else
+			{
+			m_vLL = CVector(Min(m_vLL.GetX(), vPos.GetX()), Min(m_vLL.GetY(), vPos.GetY()));
+			m_vUR = CVector(Max(m_vUR.GetX(), vPos.GetX()), Max(m_vUR.GetY(), vPos.GetY()));
+			}
+
+		iObjCount++;
+		}
+
+	if (iObjCount == 0)
+		return;
+
+	Metric rExtent = Max(m_vUR.GetX() - m_vLL.GetX(), m_vUR.GetY() - m_vLL.GetY());
+	m_rCellSize = Max(MIN_CELL_SIZE, rExtent / MAX_GRID_SIZE);
+	m_iGridSize = Min(MAX_GRID_SIZE, (int)(rExtent / m_rCellSize) + 1);
+
+	//	Bucket objects by cell (counting sort)
+
+	TArray<int> ObjCell;
+	ObjCell.InsertEmpty(System.GetObjectCount());
+
+	m_CellStart.InsertEmpty(m_iGridSize * m_iGridSize + 1);
+	for (i = 0; i < m_CellStart.GetCount(); i++)
+		m_CellStart[i] = 0;
+
+	for (i = 0; i < System.GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = System.GetObject(i);
+		if (pObj == NULL)
+			{
+			ObjCell[i] = -1;
+			continue;
+			}
+
+		const CVector &vPos = pObj->GetPos();
+		int x = Min(m_iGridSize - 1, (int)((vPos.GetX() - m_vLL.GetX()) / m_rCellSize));
+		int y = Min(m_iGridSize - 1, (int)((vPos.GetY() - m_vLL.GetY()) / m_rCellSize));
+
+		ObjCell[i] = y * m_iGridSize + x;
+		m_CellStart[ObjCell[i] + 1]++;
+		}
+
+	for (i = 1; i < m_CellStart.GetCount(); i++)
+		m_CellStart[i] += m_CellStart[i - 1];
+
+	//	Objects are added in index order, so each cell is sorted by index.
+
+	TArray<int> Next;
+	Next.InsertEmpty(m_iGridSize * m_iGridSize);
+	for (i = 0; i < Next.GetCount(); i++)
+		Next[i] = m_CellStart[i];
+
+	m_Objects.InsertEmpty(iObjCount);
+	for (i = 0; i < ObjCell.GetCount(); i++)
+		if (ObjCell[i] != -1)
+			m_Objects[Next[ObjCell[i]]++] = i;
+	}
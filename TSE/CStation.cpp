@@ -107,6 +107,66 @@ const int g_iMapScale = 5;
 
 const int DEFAULT_TIME_STOP_TIME =				150;
 
+enum EStationProperties
+	{
+	propAbandoned,
+	propActive,
+	propAngry,
+	propBarrier,
+	propDestNodeID,
+	propDestStargateID,
+	propDockingPortCount,
+	propExplored,
+	propIgnoreFriendlyFire,
+	propImageSelector,
+	propOpenDockingPortCount,
+	propOrbit,
+	propPaintLayer,
+	propParallax,
+	propPlayerBlacklisted,
+	propRadioactive,
+	propRotation,
+	propRotationSpeed,
+	propShipConstructionEnabled,
+	propShipReinforcementEnabled,
+	propShowMapLabel,
+	propShowMapOrbit,
+	propStargateID,
+	propSubordinates,
+	propSuperior,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propAbandoned,					PROPERTY_ABANDONED	},
+		{	propActive,						PROPERTY_ACTIVE	},
+		{	propAngry,						PROPERTY_ANGRY	},
+		{	propBarrier,					PROPERTY_BARRIER	},
+		{	propDestNodeID,					PROPERTY_DEST_NODE_ID	},
+		{	propDestStargateID,				PROPERTY_DEST_STARGATE_ID	},
+		{	propDockingPortCount,			PROPERTY_DOCKING_PORT_COUNT	},
+		{	propExplored,					PROPERTY_EXPLORED	},
+		{	propIgnoreFriendlyFire,			PROPERTY_IGNORE_FRIENDLY_FIRE	},
+		{	propImageSelector,				PROPERTY_IMAGE_SELECTOR	},
+		{	propOpenDockingPortCount,		PROPERTY_OPEN_DOCKING_PORT_COUNT	},
+		{	propOrbit,						PROPERTY_ORBIT	},
+		{	propPaintLayer,					PROPERTY_PAINT_LAYER	},
+		{	propParallax,					PROPERTY_PARALLAX	},
+		{	propPlayerBlacklisted,			PROPERTY_PLAYER_BACKLISTED	},
+		{	propRadioactive,				PROPERTY_RADIOACTIVE	},
+		{	propRotation,					PROPERTY_ROTATION	},
+		{	propRotationSpeed,				PROPERTY_ROTATION_SPEED	},
+		{	propShipConstructionEnabled,	PROPERTY_SHIP_CONSTRUCTION_ENABLED	},
+		{	propShipReinforcementEnabled,	PROPERTY_SHIP_REINFORCEMENT_ENABLED	},
+		{	propShowMapLabel,				PROPERTY_SHOW_MAP_LABEL	},
+		{	propShowMapOrbit,				PROPERTY_SHOW_MAP_ORBIT	},
+		{	propStargateID,					PROPERTY_STARGATE_ID	},
+		{	propSubordinates,				PROPERTY_SUBORDINATES	},
+		{	propSuperior,					PROPERTY_SUPERIOR	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 CStation::CStation (void) : CSpaceObject(&g_Class),
 		m_fArmed(false),
 		m_dwSpare(0),
@@ -1604,71 +1664,72 @@ ICCItem *CStation::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 //	Returns a property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	int i;
 	CCodeChain &CC = g_pUniverse->GetCC();
 	ICCItem *pResult;
 
-	if (strEquals(sName, PROPERTY_ABANDONED))
+	if (iProp == propAbandoned)
 		return CC.CreateBool(IsAbandoned());
 
-	else if (strEquals(sName, PROPERTY_ACTIVE))
+	else if (iProp == propActive)
 		return CC.CreateBool(m_fActive);
 
-	else if (strEquals(sName, PROPERTY_ANGRY))
+	else if (iProp == propAngry)
 		return (m_iAngryCounter > 0 ? CC.CreateInteger(m_iAngryCounter) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_BARRIER))
+	else if (iProp == propBarrier)
 		return CC.CreateBool(m_fBlocksShips);
 
-	else if (strEquals(sName, PROPERTY_DEST_NODE_ID))
+	else if (iProp == propDestNodeID)
 		return (IsStargate() ? CC.CreateString(m_sStargateDestNode) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_DEST_STARGATE_ID))
+	else if (iProp == propDestStargateID)
 		return (IsStargate() ? CC.CreateString(m_sStargateDestEntryPoint) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_DOCKING_PORT_COUNT))
+	else if (iProp == propDockingPortCount)
 		return CC.CreateInteger(m_DockingPorts.GetPortCount(this));
 
-	else if (strEquals(sName, PROPERTY_EXPLORED))
+	else if (iProp == propExplored)
 		return CC.CreateBool(m_fExplored);
 
-	else if (strEquals(sName, PROPERTY_IGNORE_FRIENDLY_FIRE))
+	else if (iProp == propIgnoreFriendlyFire)
 		return CC.CreateBool(!CanBlacklist());
 
-	else if (strEquals(sName, PROPERTY_IMAGE_SELECTOR))
+	else if (iProp == propImageSelector)
 		return m_ImageSelector.WriteToItem()->Reference();
 
-	else if (strEquals(sName, PROPERTY_OPEN_DOCKING_PORT_COUNT))
+	else if (iProp == propOpenDockingPortCount)
 		return CC.CreateInteger(GetOpenDockingPortCount());
 
-	else if (strEquals(sName, PROPERTY_ORBIT))
+	else if (iProp == propOrbit)
 		return (m_pMapOrbit ? CreateListFromOrbit(CC, *m_pMapOrbit) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_PARALLAX))
+	else if (iProp == propParallax)
 		return (m_rParallaxDist != 1.0 ? CC.CreateInteger((int)(m_rParallaxDist * 100.0)) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_PLAYER_BACKLISTED))
+	else if (iProp == propPlayerBlacklisted)
 		return CC.CreateBool(IsBlacklisted(NULL));
 
-	else if (strEquals(sName, PROPERTY_ROTATION))
+	else if (iProp == propRotation)
 		return CC.CreateInteger(GetRotation());
 
-	else if (strEquals(sName, PROPERTY_ROTATION_SPEED))
+	else if (iProp == propRotationSpeed)
 		return CC.CreateDouble(m_pRotation ? m_pRotation->GetRotationSpeedDegrees(m_pType->GetRotationDesc()) : 0.0);
 
-	else if (strEquals(sName, PROPERTY_SHIP_CONSTRUCTION_ENABLED))
+	else if (iProp == propShipConstructionEnabled)
 		return CC.CreateBool(!m_fNoConstruction);
 
-	else if (strEquals(sName, PROPERTY_SHIP_REINFORCEMENT_ENABLED))
+	else if (iProp == propShipReinforcementEnabled)
 		return CC.CreateBool(!m_fNoReinforcements);
 
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_LABEL))
+	else if (iProp == propShowMapLabel)
 		return CC.CreateBool(ShowMapLabel());
 
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_ORBIT))
+	else if (iProp == propShowMapOrbit)
 		return CC.CreateBool(m_pMapOrbit && m_fShowMapOrbit);
 
-	else if (strEquals(sName, PROPERTY_STARGATE_ID))
+	else if (iProp == propStargateID)
 		{
 		CSystem *pSystem;
 		CString sGateID;
@@ -1680,7 +1741,7 @@ ICCItem *CStation::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return CC.CreateString(sGateID);
 		}
 
-	else if (strEquals(sName, PROPERTY_SUBORDINATES))
+	else if (iProp == propSubordinates)
 		{
 		if (GetSubordinateCount() == 0)
 			return CC.CreateNil();
@@ -1696,7 +1757,7 @@ ICCItem *CStation::GetProperty (CCodeChainCtx &Ctx, const CString &sName)
 		return pResult;
 		}
 
-	else if (strEquals(sName, PROPERTY_SUPERIOR))
+	else if (iProp == propSuperior)
 		return CreateObjPointer(CC, GetBase());
 
 	else if (pResult = m_Hull.FindProperty(sName))
@@ -1814,6 +1875,17 @@ bool CStation::HasAttribute (const CString &sAttribute) const
 	return m_pType->HasLiteralAttribute(sAttribute);
 	}
 
+bool CStation::HasAttributes (const CAttributeSet &Required, const CAttributeSet &Excluded) const
+
+//	HasAttributes
+//
+//	Returns TRUE if we have all the required attributes and none of the
+//	excluded ones.
+
+	{
+	return m_pType->HasLiteralAttributes(Required, Excluded);
+	}
+
 bool CStation::HasMapLabel (void)
 
 //	HasMapLabel
@@ -4622,10 +4694,11 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 //	Sets a station property
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
 	CString sError;
 
-	if (strEquals(sName, PROPERTY_ACTIVE))
+	if (iProp == propActive)
 		{
 		if (pValue->IsNil())
 			SetInactive();
@@ -4633,7 +4706,7 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 			SetActive();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ANGRY))
+	else if (iProp == propAngry)
 		{
 		if (pValue->IsNil())
 			m_iAngryCounter = 0;
@@ -4643,27 +4716,27 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 			SetAngry();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_BARRIER))
+	else if (iProp == propBarrier)
 		{
 		m_fBlocksShips = !pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_EXPLORED))
+	else if (iProp == propExplored)
 		{
 		m_fExplored = !pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_IGNORE_FRIENDLY_FIRE))
+	else if (iProp == propIgnoreFriendlyFire)
 		{
 		m_fNoBlacklist = !pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_IMAGE_SELECTOR))
+	else if (iProp == propImageSelector)
 		{
 		m_ImageSelector.ReadFromItem(ICCItemPtr(pValue->Reference()));
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_PAINT_LAYER))
+	else if (iProp == propPaintLayer)
 		{
 		if (pValue->IsNil())
 			m_fPaintOverhang = false;
@@ -4677,7 +4750,7 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_PARALLAX))
+	else if (iProp == propParallax)
 		{
 		if (pValue->IsNil())
 			{
@@ -4701,7 +4774,7 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ORBIT))
+	else if (iProp == propOrbit)
 		{
 		if (pValue->IsNil())
 			{
@@ -4727,7 +4800,7 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 			return true;
 			}
 		}
-	else if (strEquals(sName, PROPERTY_PLAYER_BACKLISTED))
+	else if (iProp == propPlayerBlacklisted)
 		{
 		CSpaceObject *pPlayer = g_pUniverse->GetPlayerShip();
 
@@ -4741,7 +4814,7 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_RADIOACTIVE))
+	else if (iProp == propRadioactive)
 		{
 		if (pValue->IsNil())
 			ClearCondition(CConditionSet::cndRadioactive);
@@ -4749,33 +4822,33 @@ bool CStation::SetProperty (const CString &sName, ICCItem *pValue, CString *rets
 			SetCondition(CConditionSet::cndRadioactive);
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ROTATION))
+	else if (iProp == propRotation)
 		{
 		SetRotation(pValue->GetIntegerValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_ROTATION_SPEED))
+	else if (iProp == propRotationSpeed)
 		{
 		if (m_pRotation)
 			m_pRotation->SetRotationSpeedDegrees(m_pType->GetRotationDesc(), pValue->GetDoubleValue());
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SHIP_CONSTRUCTION_ENABLED))
+	else if (iProp == propShipConstructionEnabled)
 		{
 		m_fNoConstruction = pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SHIP_REINFORCEMENT_ENABLED))
+	else if (iProp == propShipReinforcementEnabled)
 		{
 		m_fNoReinforcements = pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_LABEL))
+	else if (iProp == propShowMapLabel)
 		{
 		m_fNoMapLabel = pValue->IsNil();
 		return true;
 		}
-	else if (strEquals(sName, PROPERTY_SHOW_MAP_ORBIT))
+	else if (iProp == propShowMapOrbit)
 		{
 		m_fShowMapOrbit = !pValue->IsNil();
 		return true;
@@ -50,6 +50,32 @@ const Metric SAME_POS_THRESHOLD2 =						(g_KlicksPerPixel * g_KlicksPerPixel);
 
 const Metric MAP_GRID_SIZE =							3000.0 * LIGHT_SECOND;
 
+const int MIN_PARALLEL_BEHAVIOR_OBJS =					16;
+const int MAX_SWEPT_COLLISION_STEPS =					64;
+const Metric NEAREST_SEARCH_RADIUS =					(50.0 * LIGHT_SECOND);
+const int MAX_NAV_PATHS_PER_TICK =						8;
+
+class CParallelBehaviorTask : public IThreadPoolTask
+	{
+	public:
+		CParallelBehaviorTask (const TArray<CSpaceObject *> &Objs, int iStart, int iEnd) :
+				m_Objs(Objs),
+				m_iStart(iStart),
+				m_iEnd(iEnd)
+			{ }
+
+		virtual void Run (void)
+			{
+			for (int i = m_iStart; i < m_iEnd; i++)
+				m_Objs[i]->ParallelBehavior();
+			}
+
+	private:
+		const TArray<CSpaceObject *> &m_Objs;
+		int m_iStart;
+		int m_iEnd;
+	};
+
 CSystem::CSystem (CUniverse *pUniv, CTopologyNode *pTopology) : 
 		m_dwID(OBJID_NULL),
 		m_pTopology(pTopology),
@@ -68,6 +94,7 @@ CSystem::CSystem (CUniverse *pUniv, CTopologyNode *pTopology) :
 		m_fEnemiesInSRS(false),
 		m_fPlayerUnderAttack(false),
 		m_fLocationsBlocked(false),
+		m_fPosIndexValid(false),
 		m_pThreadPool(NULL),
 		m_ObjGrid(GRID_SIZE, CELL_SIZE, CELL_BORDER)
 
@@ -192,6 +219,24 @@ void CSystem::AddToDeleteList (CSpaceObject *pObj)
 	m_DeletedObjects.FastAdd(pObj);
 	}
 
+void CSystem::AddToEnemyObjectCache (CSpaceObject *pObj, CSovereign *pObjSovereign)
+
+//	AddToEnemyObjectCache
+//
+//	Adds the object to the cached enemy lists of all sovereigns that consider
+//	pObjSovereign an enemy. We pass in the sovereign explicitly so that callers
+//	can handle an object changing sovereigns.
+
+	{
+	int i;
+
+	if (!pObj->ClassCanAttack())
+		return;
+
+	for (i = 0; i < g_pUniverse->GetSovereignCount(); i++)
+		g_pUniverse->GetSovereign(i)->AddEnemyObject(this, pObj, pObjSovereign);
+	}
+
 ALERROR CSystem::AddToSystem (CSpaceObject *pObj, int *retiIndex)
 
 //	AddToSystem
@@ -201,11 +246,16 @@ ALERROR CSystem::AddToSystem (CSpaceObject *pObj, int *retiIndex)
 	{
 	int i;
 
-	//	If this object affects the enemy object cache, then
-	//	flush the cache
+	//	If this object can attack, add it to the enemy lists of any sovereign
+	//	that hates it.
+
+	AddToEnemyObjectCache(pObj, pObj->GetSovereign());
 
-	if (pObj->ClassCanAttack())
-		FlushEnemyObjectCache();
+	//	Keep track of objects that nav paths might need to avoid
+
+	m_NavObstacles.Add(pObj);
+	m_AvoidField.OnObjAdded(pObj);
+	m_InfluenceMap.Add(pObj);
 
 	//	If this is a star, add it to our list of stars
 
@@ -215,6 +265,8 @@ ALERROR CSystem::AddToSystem (CSpaceObject *pObj, int *retiIndex)
 		pDesc->pStarObj = pObj;
 		}
 
+	InvalidatePosIndex();
+
 	//	Reuse a slot first
 
 	for (i = 0; i < m_AllObjects.GetCount(); i++)
@@ -594,6 +646,7 @@ void CSystem::CalcViewportCtx (SViewportPaintCtx &Ctx, const RECT &rcView, CSpac
 
 	Ctx.bShowBounds = g_pUniverse->GetDebugOptions().IsShowBoundsEnabled();
 	Ctx.bShowFacingsAngle = g_pUniverse->GetDebugOptions().IsShowFacingsAngleEnabled();
+	Ctx.bShowAILOD = g_pUniverse->GetDebugOptions().IsShowAILODEnabled();
 
 	//	Figure out what color space should be. Space gets lighter as we get
 	//	near the central star
@@ -605,15 +658,7 @@ void CSystem::CalcViewportCtx (SViewportPaintCtx &Ctx, const RECT &rcView, CSpac
 
 	Ctx.rIndicatorRadius = Min(RectWidth(rcView), RectHeight(rcView)) / 2.0;
 
-	//	If we don't have a thread pool yet, create it
-
-	if (m_pThreadPool == NULL)
-		{
-		m_pThreadPool = new CThreadPool;
-		m_pThreadPool->Boot(Min(MAX_THREAD_COUNT, sysGetProcessorCount()));
-		}
-
-	Ctx.pThreadPool = m_pThreadPool;
+	Ctx.pThreadPool = GetThreadPool();
 
 	DEBUG_CATCH
 	}
@@ -682,23 +727,7 @@ void CSystem::CancelTimedEvent (CDesignType *pSource, const CString &sEvent, boo
 //	Cancel event by name
 
 	{
-	int i;
-
-	for (i = 0; i < GetTimedEventCount(); i++)
-		{
-		CSystemEvent *pEvent = GetTimedEvent(i);
-		if (pEvent->GetEventHandlerType() == pSource 
-				&& strEquals(pEvent->GetEventHandlerName(), sEvent))
-			{
-			if (bInDoEvent)
-				pEvent->SetDestroyed();
-			else
-				{
-				m_TimedEvents.RemoveEvent(i);
-				i--;
-				}
-			}
-		}
+	m_TimedEvents.CancelEvent(pSource, sEvent, bInDoEvent);
 	}
 
 void CSystem::ComputeRandomEncounters (void)
@@ -929,7 +958,10 @@ ALERROR CSystem::CreateFromStream (CUniverse *pUniv,
 	//	because objects might have references to paths)
 
 	if (Ctx.dwVersion >= 10)
+		{
 		Ctx.pSystem->m_NavPaths.ReadFromStream(Ctx);
+		Ctx.pSystem->InitNavPathCache();
+		}
 
 	//	Load the system event handlers
 
@@ -1871,26 +1903,17 @@ CSpaceObject *CSystem::FindObjectInRange (const CVector &vCenter, Metric rRange,
 //	the range.
 
 	{
-	Metric rRange2 = rRange * rRange;
-
 	//	If we have a criteria, we need to check.
 
 	if (!Criteria.IsEmpty())
 		{
 		CSpaceObjectCriteria::SCtx Ctx(Criteria);
 
-		SSpaceObjectGridEnumerator i;
-		EnumObjectsInBoxStart(i, vCenter, rRange, gridNoBoxCheck);
-		while (EnumObjectsInBoxHasMore(i))
+		for (CSpaceObject *pObj : ObjectsInCircle(vCenter, rRange))
 			{
-			CSpaceObject *pObj = EnumObjectsInBoxGetNextFast(i);
 			if (pObj->MatchesCriteria(Ctx, Criteria)
 					&& (!pObj->IsIntangible() || pObj->IsVirtual()))
-				{
-				Metric rDist2 = (pObj->GetPos() - vCenter).Length2();
-				if (rDist2 < rRange2)
-					return pObj;
-				}
+				return pObj;
 			}
 		}
 
@@ -1898,17 +1921,10 @@ CSpaceObject *CSystem::FindObjectInRange (const CVector &vCenter, Metric rRange,
 
 	else 
 		{
-		SSpaceObjectGridEnumerator i;
-		EnumObjectsInBoxStart(i, vCenter, rRange, gridNoBoxCheck);
-		while (EnumObjectsInBoxHasMore(i))
+		for (CSpaceObject *pObj : ObjectsInCircle(vCenter, rRange))
 			{
-			CSpaceObject *pObj = EnumObjectsInBoxGetNextFast(i);
 			if (!pObj->IsIntangible() || pObj->IsVirtual())
-				{
-				Metric rDist2 = (pObj->GetPos() - vCenter).Length2();
-				if (rDist2 < rRange2)
-					return pObj;
-				}
+				return pObj;
 			}
 		}
 
@@ -1961,6 +1977,97 @@ bool CSystem::FindObjectName (CSpaceObject *pObj, CString *retsName)
 	return false;
 	}
 
+void CSystem::FindObjectsMatching (const CSpaceObjectCriteria &Criteria, CSpaceObjectCriteria::SCtx &Ctx, TArray<CSpaceObject *> *retList)
+
+//	FindObjectsMatching
+//
+//	Finds all objects that match the criteria (and that are tangible or 
+//	virtual). Matches are added to retList (if not NULL) in object order. If
+//	the criteria wants the nearest object, the result is in Ctx.pBestObj.
+//
+//	If the criteria has a maximum distance (or wants the nearest object) we
+//	only look at nearby objects: for the nearest object, we search in 
+//	expanding rings until we find a match.
+
+	{
+	int i;
+
+	//	If the criteria does not limit distance, then we need to check every
+	//	object.
+
+	if (!Criteria.MatchesNearerThan() && !Criteria.MatchesNearestOnly())
+		{
+		for (i = 0; i < GetObjectCount(); i++)
+			{
+			CSpaceObject *pObj = GetObject(i);
+
+			//	NOTE: Sometimes we want to find virtual objects, so always 
+			//	include them if they match.
+
+			if (pObj 
+					&& pObj->MatchesCriteria(Ctx, Criteria)
+					&& (!pObj->IsIntangible() || pObj->IsVirtual())
+					&& retList)
+				retList->Insert(pObj);
+			}
+
+		return;
+		}
+
+	//	Make sure the index is up to date
+
+	if (!m_fPosIndexValid)
+		{
+		m_PosIndex.Init(*this);
+		m_fPosIndexValid = true;
+		}
+
+	CVector vCenter = (Criteria.GetSource() ? Criteria.GetSource()->GetPos() : CVector());
+	Metric rLimit = (Criteria.MatchesNearerThan() ? Criteria.MatchesMaxRadius() : m_PosIndex.GetMaxRadius(vCenter));
+	Metric rInner2 = 0.0;
+	Metric rOuter = (Criteria.MatchesNearestOnly() ? Min(rLimit, NEAREST_SEARCH_RADIUS) : rLimit);
+
+	TArray<int> Candidates;
+	while (true)
+		{
+		bool bLastRing = (rOuter >= rLimit);
+		Metric rOuter2 = rOuter * rOuter;
+
+		Candidates.DeleteAll();
+		m_PosIndex.GetObjectsInCircle(vCenter, rOuter, Candidates);
+		Candidates.Sort();
+
+		for (i = 0; i < Candidates.GetCount(); i++)
+			{
+			CSpaceObject *pObj = GetObject(Candidates[i]);
+			if (pObj == NULL)
+				continue;
+
+			//	Skip objects that we checked in a previous ring or that belong
+			//	to the next ring. The last ring takes everything else (the
+			//	criteria checks the actual limit).
+
+			Metric rDist2 = (pObj->GetPos() - vCenter).Length2();
+			if (rDist2 < rInner2 || (!bLastRing && rDist2 >= rOuter2))
+				continue;
+
+			if (pObj->MatchesCriteria(Ctx, Criteria)
+					&& (!pObj->IsIntangible() || pObj->IsVirtual())
+					&& retList)
+				retList->Insert(pObj);
+			}
+
+		//	If we found the nearest object inside this ring, then it is the
+		//	nearest of all, since we've checked everything closer.
+
+		if (bLastRing || Ctx.pBestObj)
+			break;
+
+		rInner2 = rOuter2;
+		rOuter = Min(rLimit, 2.0 * rOuter);
+		}
+	}
+
 bool CSystem::FindRandomLocation (const SLocationCriteria &Criteria, DWORD dwFlags, const COrbit &CenterOrbitDesc, CStationType *pStationToPlace, int *retiLocID)
 
 //	FindRandomLocation
@@ -2108,11 +2215,8 @@ void CSystem::FlushDeletedObjects (void)
 //	Flush deleted objects from the deleted list.
 
 	{
-	//	Clear out the grid, so that it's not holding on to stale objects.
-
-	m_ObjGrid.DeleteAll();
-
-	//	Flush objects deleted last tick
+	//	Flush objects deleted last tick. NOTE: These objects were already 
+	//	removed from the grid in RemoveObject.
 
 	for (int i = 0; i < m_DeletedObjects.GetCount(); i++)
 		{
@@ -2349,24 +2453,25 @@ CNavigationPath *CSystem::GetNavPath (CSovereign *pSovereign, CSpaceObject *pSta
 
 //	GetNavPath
 //
-//	Returns the navigation path for the given parameters
+//	Returns the navigation path for the given parameters. If the path is still
+//	waiting for the path service, we compute it now.
 
 	{
-	CNavigationPath *pNext = m_NavPaths.GetNext();
-	while (pNext)
+	CNavigationPath *pPath = m_NavPathCache.Find(pSovereign, pStart, pEnd);
+	if (pPath)
 		{
-		if (pNext->Matches(pSovereign, pStart, pEnd))
-			return pNext;
+		if (pPath->IsPending())
+			m_NavPathService.Complete(*this, pPath);
 
-		pNext = pNext->GetNext();
+		return pPath;
 		}
 
 	//	If we cannot find an appropriate path, we create a new one
 
-	CNavigationPath *pPath;
 	CNavigationPath::Create(this, pSovereign, pStart, pEnd, &pPath);
 
 	m_NavPaths.Insert(pPath);
+	m_NavPathCache.Add(pPath);
 
 	return pPath;
 	}
@@ -2378,16 +2483,7 @@ CNavigationPath *CSystem::GetNavPathByID (DWORD dwID)
 //	Returns the nav path with the given ID (or NULL if not found)
 
 	{
-	CNavigationPath *pNext = m_NavPaths.GetNext();
-	while (pNext)
-		{
-		if (pNext->GetID() == dwID)
-			return pNext;
-
-		pNext = pNext->GetNext();
-		}
-
-	return NULL;
+	return m_NavPathCache.FindByID(dwID);
 	}
 
 CSpaceObject *CSystem::GetPlayerShip (void) const
@@ -2470,6 +2566,22 @@ CTopologyNode *CSystem::GetStargateDestination (const CString &sStargate, CStrin
 	return m_pTopology->GetGateDest(sStargate, retsEntryPoint);
 	}
 
+CThreadPool *CSystem::GetThreadPool (void)
+
+//	GetThreadPool
+//
+//	Returns the thread pool, creating it if necessary.
+
+	{
+	if (m_pThreadPool == NULL)
+		{
+		m_pThreadPool = new CThreadPool;
+		m_pThreadPool->Boot(Min(MAX_THREAD_COUNT, sysGetProcessorCount()));
+		}
+
+	return m_pThreadPool;
+	}
+
 int CSystem::GetTileSize (void) const
 
 //	GetTileSize
@@ -2679,6 +2791,29 @@ CSpaceObject *CSystem::HitTest (CSpaceObject *pExclude, const CVector &vPos, boo
 	return NULL;
 	}
 
+void CSystem::InitNavPathCache (void)
+
+//	InitNavPathCache
+//
+//	Indexes m_NavPaths after load. The list is newest first, so we add in
+//	reverse order.
+
+	{
+	int i;
+
+	TArray<CNavigationPath *> Paths;
+	CNavigationPath *pNext = m_NavPaths.GetNext();
+	while (pNext)
+		{
+		Paths.Insert(pNext);
+		pNext = pNext->GetNext();
+		}
+
+	m_NavPathCache.DeleteAll();
+	for (i = Paths.GetCount() - 1; i >= 0; i--)
+		m_NavPathCache.Add(Paths[i]);
+	}
+
 void CSystem::InitSpaceEnvironment (void) const
 
 //	InitSpaceEnvironment
@@ -2706,6 +2841,51 @@ void CSystem::InitVolumetricMask (void)
 		}
 	}
 
+bool CSystem::HitsCollisionObj (CSpaceObject *pObj, const CVector &vPos, CSpaceObject *pContactObj)
+
+//	HitsCollisionObj
+//
+//	Returns TRUE if pObj (at vPos) collides with pContactObj. For objects 
+//	against immobile barriers we do a point test because we might get stuck due
+//	to rotation changes.
+
+	{
+	if (pContactObj->IsAnchored())
+		return pContactObj->PointInObject(pContactObj->GetPos(), vPos);
+	else
+		return pObj->ObjectInObject(vPos, pContactObj, pContactObj->GetPos());
+	}
+
+bool CSystem::HitsCollisionObjSwept (CSpaceObject *pObj, CSpaceObject *pContactObj, CVector *retvHitPos)
+
+//	HitsCollisionObjSwept
+//
+//	Steps pObj along its path this tick (strictly between its old position and
+//	its current position) and returns the first position at which it collides 
+//	with pContactObj. Steps are at most half the object's size.
+
+	{
+	Metric rStep = 0.5 * pObj->GetHitSize();
+	if (rStep <= 0.0)
+		return false;
+
+	CVector vStart = pObj->GetOldPos();
+	CVector vDelta = pObj->GetPos() - vStart;
+	int iSteps = Min(MAX_SWEPT_COLLISION_STEPS, (int)(vDelta.Length() / rStep) + 1);
+
+	for (int i = 1; i < iSteps; i++)
+		{
+		CVector vTest = vStart + (vDelta * ((Metric)i / (Metric)iSteps));
+		if (HitsCollisionObj(pObj, vTest, pContactObj))
+			{
+			*retvHitPos = vTest;
+			return true;
+			}
+		}
+
+	return false;
+	}
+
 bool CSystem::IsExclusionZoneClear (const CVector &vPos, CStationType *pType)
 
 //	IsExclusionZoneClear
@@ -2794,6 +2974,18 @@ bool CSystem::IsExclusionZoneClear (const CVector &vPos, CStationType *pType)
 	return true;
 	}
 
+bool CSystem::IsFastMover (CSpaceObject *pObj)
+
+//	IsFastMover
+//
+//	Returns TRUE if the object moved more than its own size this tick, in which
+//	case it might have passed through a thin barrier.
+
+	{
+	Metric rSize = pObj->GetHitSize();
+	return (rSize > 0.0 && (pObj->GetPos() - pObj->GetOldPos()).Length2() > rSize * rSize);
+	}
+
 bool CSystem::IsStarAtPos (const CVector &vPos)
 
 //	IsStarAtPos
@@ -3300,6 +3492,11 @@ void CSystem::PaintViewport (CG32bitImage &Dest,
 	if (pAnnotations)
 		PaintViewportAnnotations(Dest, *pAnnotations, Ctx);
 
+	//	Debug overlays
+
+	if (Ctx.bShowAILOD)
+		m_AILOD.PaintStats(Dest, Ctx);
+
 	//	Done
 
 	Dest.ResetClipRect();
@@ -3955,6 +4152,23 @@ void CSystem::RegisterForOnSystemCreated (CSpaceObject *pObj, CStationType *pEnc
 	pDeferred->Orbit = Orbit;
 	}
 
+void CSystem::RemoveFromEnemyObjectCache (CSpaceObject *pObj, CSovereign *pObjSovereign)
+
+//	RemoveFromEnemyObjectCache
+//
+//	Removes the object from the cached enemy lists of all sovereigns that
+//	consider pObjSovereign an enemy.
+
+	{
+	int i;
+
+	if (!pObj->ClassCanAttack())
+		return;
+
+	for (i = 0; i < g_pUniverse->GetSovereignCount(); i++)
+		g_pUniverse->GetSovereign(i)->RemoveEnemyObject(this, pObj, pObjSovereign);
+	}
+
 void CSystem::RemoveObject (SDestroyCtx &Ctx)
 
 //	RemoveObject
@@ -4009,15 +4223,11 @@ void CSystem::RemoveObject (SDestroyCtx &Ctx)
 	m_TimedEvents.OnObjDestroyed(Ctx.pObj);
 	m_EventHandlers.ObjDestroyed(Ctx.pObj);
 
-	//	If this is the player and we're resurrecting, then remove the player from
-	//	the grid. We need to do this because resurrecting player ships don't have
-	//	the destroyed flag set, but we don't want them to show up in future 
-	//	searches.
+	//	Remove from the grid. This also covers resurrecting player ships, which
+	//	don't have the destroyed flag set, but which we don't want to show up in
+	//	future searches.
 
-	if (Ctx.pObj->IsPlayer() && Ctx.bResurrectPending)
-		{
-		m_ObjGrid.Delete(Ctx.pObj);
-		}
+	m_ObjGrid.Delete(Ctx.pObj);
 
 	//	Deal with joints
 
@@ -4044,9 +4254,13 @@ void CSystem::RemoveObject (SDestroyCtx &Ctx)
 
 	m_AllObjects[Ctx.pObj->GetIndex()] = NULL;
 
-	//	Invalidate cache of enemy objects
+	//	Remove from the cache of enemy objects
 
-	FlushEnemyObjectCache();
+	RemoveFromEnemyObjectCache(Ctx.pObj, Ctx.pObj->GetSovereign());
+	m_NavObstacles.Remove(Ctx.pObj);
+	m_AvoidField.OnObjRemoved(Ctx.pObj);
+	m_InfluenceMap.Remove(Ctx.pObj);
+	m_FlockIndex.OnObjRemoved(Ctx.pObj);
 
 	//	Invalidate encounter table cache
 
@@ -4181,6 +4395,29 @@ void CSystem::RemoveVolumetricShadow (CSpaceObject *pObj)
 		}
 	}
 
+CNavigationPath *CSystem::RequestNavPath (CSovereign *pSovereign, CSpaceObject *pStart, CSpaceObject *pEnd)
+
+//	RequestNavPath
+//
+//	Returns the navigation path for the given parameters without blocking. If
+//	we don't already have the path, we return a pending path that heads
+//	straight for pEnd; the path service fills in the real waypoints during a
+//	later update.
+
+	{
+	CNavigationPath *pPath = m_NavPathCache.Find(pSovereign, pStart, pEnd);
+	if (pPath)
+		return pPath;
+
+	CNavigationPath::CreatePending(pSovereign, pStart, pEnd, &pPath);
+
+	m_NavPaths.Insert(pPath);
+	m_NavPathCache.Add(pPath);
+	m_NavPathService.Request(pPath);
+
+	return pPath;
+	}
+
 void CSystem::RestartTime (void)
 
 //	RestartTime
@@ -4285,7 +4522,8 @@ ALERROR CSystem::SaveToStream (IWriteStream *pStream)
 	pStream->Write((char *)&m_rTimeScale, sizeof(Metric));
 	pStream->Write((char *)&m_iLastUpdated, sizeof(DWORD));
 
-	//	Save navigation paths
+	//	Save navigation paths (pending paths are saved with the waypoints that
+	//	the path service will compute; see CNavigationPath::OnWriteToStream)
 
 	m_NavPaths.WriteToStream(this, pStream);
 
@@ -4517,24 +4755,11 @@ void CSystem::TransferObjEventsIn (CSpaceObject *pObj, CSystemEventList &ObjEven
 
 //	TransferObjEventsIn
 //
-//	Moves all of the timed events in ObjEvents to the system
+//	Moves all of the timed events in ObjEvents to the system. We set the ticks
+//	to be relative to the new system.
 
 	{
-	int i;
-
-	for (i = 0; i < ObjEvents.GetCount(); i++)
-		{
-		CSystemEvent *pEvent = ObjEvents.GetEvent(i);
-
-		//	Set tick to be relative to new system
-
-		pEvent->SetTick(m_iTick + pEvent->GetTick());
-
-		//	Move
-
-		ObjEvents.MoveEvent(i, m_TimedEvents);
-		i--;
-		}
+	ObjEvents.MoveEvents(m_TimedEvents, m_iTick);
 	}
 
 void CSystem::TransferObjEventsOut (CSpaceObject *pObj, CSystemEventList &ObjEvents)
@@ -4542,26 +4767,10 @@ void CSystem::TransferObjEventsOut (CSpaceObject *pObj, CSystemEventList &ObjEve
 //	TransferObjEventsOut
 //
 //	Moves any timed events for the given object out of the system and into
-//	ObjEvents.
+//	ObjEvents. We set the ticks to an offset from system time.
 
 	{
-	int i;
-
-	for (i = 0; i < GetTimedEventCount(); i++)
-		{
-		CSystemEvent *pEvent = GetTimedEvent(i);
-		if (pEvent->OnObjChangedSystems(pObj))
-			{
-			//	Set the tick to an offset from system time
-
-			pEvent->SetTick(pEvent->GetTick() - m_iTick);
-
-			//	Move to list
-
-			m_TimedEvents.MoveEvent(i, ObjEvents);
-			i--;
-			}
-		}
+	m_TimedEvents.MoveObjEvents(pObj, ObjEvents, -m_iTick);
 	}
 
 void CSystem::UnnameObject (CSpaceObject *pObj)
@@ -4631,10 +4840,10 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 
 	CalcAutoTarget(Ctx);
 
-	//	Add all objects to the grid so that we can do faster
-	//	hit tests
+	//	Bring the grid up to date so that we can do faster hit tests. Only 
+	//	objects that changed cells since last tick are touched.
 
-	m_ObjGrid.Init(this, Ctx);
+	m_ObjGrid.Update(this, Ctx);
 
 	//	Fire timed events
 	//	NOTE: We only do this if we have a player because otherwise, some
@@ -4654,6 +4863,34 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 
 	m_fPlayerUnderAttack = false;
 	DebugStartTimer();
+
+	//	Figure out how often AI ships should think this tick
+
+	m_AILOD.BeginUpdate(*this);
+
+	//	Make sure the hazard field is up to date (ships use it to compute
+	//	their avoid potential).
+
+	m_AvoidField.Update(*this);
+
+	//	Refresh where each sovereign's ships are (AI uses this to decide whether
+	//	to look for enemies).
+
+	m_InfluenceMap.Update(*this);
+
+	//	Ships take a new snapshot of their flocks the first time they ask this
+	//	tick.
+
+	m_FlockIndex.Invalidate();
+
+	//	If requested, objects compute the parts of their behavior that only
+	//	read from the system on worker threads. The serial loop below still
+	//	makes all decisions (using those results) so that the outcome is the
+	//	same as a purely serial update.
+
+	if (SystemCtx.bParallelBehavior && !IsTimeStopped())
+		UpdateParallelBehavior();
+
 	for (i = 0; i < GetObjectCount(); i++)
 		{
 		CSpaceObject *pObj = GetObject(i);
@@ -4720,6 +4957,34 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 	//	paint right after a move. Otherwise, when a laser/missile hits
 	//	an object, the laser/missile is deleted (in update) before it
 	//	gets a chance to paint.
+	//
+	//	Objects that move in a straight line and have nothing to do in OnMove
+	//	are integrated in a single batch first. We still hand out the results
+	//	in object order below so that objects with OnMove logic see the same
+	//	positions as if everything had moved one at a time.
+
+	m_Kinematics.DeleteAll();
+	m_KinematicsIndex.DeleteAll();
+	m_KinematicsIndex.InsertEmpty(GetObjectCount());
+
+	for (i = 0; i < GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = GetObject(i);
+
+		if (pObj 
+				&& !pObj->IsDestroyed()
+				&& pObj->CanMove()
+				&& !pObj->IsSuspended()
+				&& !pObj->IsTimeStopped()
+				&& !pObj->IsAnchored()
+				&& !pObj->HasNonLinearMove()
+				&& !pObj->HasOnMove())
+			m_KinematicsIndex[i] = m_Kinematics.Add(pObj);
+		else
+			m_KinematicsIndex[i] = -1;
+		}
+
+	m_Kinematics.Integrate(GetThreadPool(), g_SecondsPerUpdate);
 
 	for (i = 0; i < GetObjectCount(); i++)
 		{
@@ -4734,7 +4999,10 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 			//	Move the objects
 
 			SetProgramState(psUpdatingMove, pObj);
-			pObj->Move(Ctx, SystemCtx.rSecondsPerTick);
+			if (i < m_KinematicsIndex.GetCount() && m_KinematicsIndex[i] != -1)
+				pObj->MoveBatched(Ctx, m_Kinematics.GetPos(m_KinematicsIndex[i]));
+			else
+				pObj->Move(Ctx, SystemCtx.rSecondsPerTick);
 
 #ifdef DEBUG_PERFORMANCE
 			iMoveObj++;
@@ -4742,6 +5010,7 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 			}
 		}
 	DebugStopTimer("Moving objects");
+	InvalidatePosIndex();
 
 	//	Update collisions. This function will iterate over each object that 
 	//	needs collision testing and add a CPhysicsContact for each unique pair
@@ -4755,8 +5024,14 @@ void CSystem::Update (SSystemUpdateCtx &SystemCtx, SViewportAnnotations *pAnnota
 
 	//	Now resolve all contacts
 
-	m_ContactResolver.Update();
+	m_ContactResolver.Update(GetThreadPool());
 	m_Joints.Update(Ctx);
+	InvalidatePosIndex();
+
+	//	Compute nav paths that ships requested during behavior
+
+	if (m_NavPathService.GetCount() > 0)
+		m_NavPathService.Update(*this, GetThreadPool(), MAX_NAV_PATHS_PER_TICK);
 
 	//	Update random encounters
 
@@ -4814,33 +5089,73 @@ void CSystem::UpdateCollisionTesting (SUpdateCtx &Ctx)
 //	contacts for every unique pair of collisions detected.
 
 	{
-	int i;
+	int i, j;
+
+	//	Add all objects that need testing and all barriers to the broadphase.
+	//	Objects that moved more than their size this tick get a test box that 
+	//	covers their whole path so that we can catch them tunneling through
+	//	thin barriers.
 
+	Metric rTestRange = g_SecondsPerUpdate * LIGHT_SECOND;
+	CVector vTestRange(rTestRange, rTestRange);
+
+	m_Broadphase.DeleteAll();
 	for (i = 0; i < GetObjectCount(); i++)
 		{
 		CSpaceObject *pObj = GetObject(i);
-		if (pObj == NULL || !pObj->IsCollisionTestNeeded())
+		if (pObj == NULL || pObj->IsDestroyed())
 			continue;
 
+		if (pObj->IsCollisionTestNeeded())
+			{
+			const CVector &vPos = pObj->GetPos();
+			const CVector &vOldPos = pObj->GetOldPos();
+			if (IsFastMover(pObj))
+				m_Broadphase.AddTester(pObj, 
+						CVector(Max(vPos.GetX(), vOldPos.GetX()), Max(vPos.GetY(), vOldPos.GetY())) + vTestRange,
+						CVector(Min(vPos.GetX(), vOldPos.GetX()), Min(vPos.GetY(), vOldPos.GetY())) - vTestRange);
+			else
+				m_Broadphase.AddTester(pObj, vPos + vTestRange, vPos - vTestRange);
+			}
+
+		if (pObj->IsBarrier() && pObj->CanBeHit())
+			{
+			Metric rBounds = pObj->GetBoundsRadius();
+			CVector vBounds(rBounds, rBounds);
+			m_Broadphase.AddBarrier(pObj, pObj->GetPos() + vBounds, pObj->GetPos() - vBounds);
+			}
+		}
+
+	if (m_Broadphase.GetTesterCount() == 0)
+		return;
+
+	m_Broadphase.CalcPairs();
+
+	//	Testers are in object order.
+
+	for (i = 0; i < m_Broadphase.GetTesterCount(); i++)
+		{
+		CSpaceObject *pObj = m_Broadphase.GetTester(i);
+
 		//	Reset the collision flag so we don't consider this object again.
 
 		pObj->SetCollisionTestNeeded(false);
 		bool bBlocked = false;
+		bool bSwept = IsFastMover(pObj);
 
-		//	Loop over all objects in range.
+		//	Loop over all candidates
 
-		SSpaceObjectGridEnumerator j;
-		EnumObjectsInBoxStart(j, pObj->GetPos(), g_SecondsPerUpdate * LIGHT_SECOND);
-		while (EnumObjectsInBoxHasMore(j))
+		for (j = 0; j < m_Broadphase.GetCandidateCount(i); j++)
 			{
-			CSpaceObject *pContactObj = EnumObjectsInBoxGetNext(j);
+			CSpaceObject *pContactObj = m_Broadphase.GetCandidate(i, j);
 
 			//	If this contact object is a moving object and if we've already
 			//	handled it, then we don't need anything further. This can happen,
 			//	for example, with two wrecks running into each other.
 
-			if (pContactObj->CanMove() 
-					&& !pContactObj->IsCollisionTestNeeded())
+			if (pContactObj->IsDestroyed()
+					|| (pContactObj->CanMove() 
+						&& !pContactObj->IsCollisionTestNeeded()))
 				continue;
 
 			//	If the contact object cannot block us, then continue.
@@ -4848,18 +5163,27 @@ void CSystem::UpdateCollisionTesting (SUpdateCtx &Ctx)
 			if (!pContactObj->Blocks(pObj))
 				continue;
 
-			//	See if we collided. For objects against immobile barriers we do a
-			//	point test because we might get stuck due to rotation changes.
+			//	See if we intersect at our current position.
 
-			if (pContactObj->IsAnchored())
+			if (HitsCollisionObj(pObj, pObj->GetPos(), pContactObj))
+				NULL;
+
+			//	If we're moving fast, see if we passed through the object on
+			//	the way here. If so, we back up to where we first touched it.
+
+			else if (bSwept)
 				{
-				if (!pContactObj->PointInObject(pContactObj->GetPos(), pObj->GetPos()))
+				CVector vHitPos;
+				if (!HitsCollisionObjSwept(pObj, pContactObj, &vHitPos))
 					continue;
-				}
-
-			//	See if we intersect. If we do, then we add a collision.
 
-			else if (!pObj->ObjectInObject(pObj->GetPos(), pContactObj, pContactObj->GetPos()))
+				if (!pObj->IsInsideBarrier())
+					{
+					pObj->SetPos(vHitPos);
+					InvalidatePosIndex();
+					}
+				}
+			else
 				continue;
 
 			//	At this point we know that we've hit pContactObj.
@@ -5002,6 +5326,69 @@ void CSystem::UpdateGravity (SUpdateCtx &Ctx, CSpaceObject *pGravityObj)
 		}
 	}
 
+void CSystem::UpdateParallelBehavior (void)
+
+//	UpdateParallelBehavior
+//
+//	Calls ParallelBehavior on all objects that want it, splitting the objects
+//	across the thread pool. Objects must not modify anything outside 
+//	themselves (they may only read the rest of the system), so the results do
+//	not depend on thread scheduling.
+
+	{
+	DEBUG_TRY
+
+	int i;
+
+	//	Make a list of objects (on the main thread, so that the order is
+	//	deterministic).
+
+	m_ParallelBehaviorObjs.DeleteAll();
+	for (i = 0; i < GetObjectCount(); i++)
+		{
+		CSpaceObject *pObj = GetObject(i);
+		if (pObj
+				&& !pObj->IsDestroyed()
+				&& !pObj->IsTimeStopped()
+				&& pObj->HasParallelBehavior())
+			m_ParallelBehaviorObjs.Insert(pObj);
+		}
+
+	int iObjCount = m_ParallelBehaviorObjs.GetCount();
+	if (iObjCount == 0)
+		return;
+
+	//	Split into contiguous chunks, one per task. With only a few objects it 
+	//	is not worth waking up the threads, so we run a single chunk here.
+
+	int iTaskCount;
+	if (iObjCount < MIN_PARALLEL_BEHAVIOR_OBJS)
+		iTaskCount = 1;
+	else
+		iTaskCount = Max(1, Min(GetThreadPool()->GetThreadCount(), iObjCount / MIN_PARALLEL_BEHAVIOR_OBJS));
+
+	if (iTaskCount == 1)
+		{
+		CParallelBehaviorTask Task(m_ParallelBehaviorObjs, 0, iObjCount);
+		Task.Run();
+		}
+	else
+		{
+		int iChunk = (iObjCount + iTaskCount - 1) / iTaskCount;
+		for (i = 0; i < iTaskCount; i++)
+			{
+			int iStart = i * iChunk;
+			int iEnd = Min(iObjCount, iStart + iChunk);
+			if (iStart < iEnd)
+				m_pThreadPool->AddTask(new CParallelBehaviorTask(m_ParallelBehaviorObjs, iStart, iEnd));
+			}
+
+		m_pThreadPool->Run();
+		}
+
+	DEBUG_CATCH
+	}
+
 void CSystem::UpdateRandomEncounters (void)
 
 //	UpdateRandomEncounters
@@ -2,9 +2,23 @@
 //
 //	CSystemEventList class
 //	Copyright (c) 2012 by Kronosaur Productions, LLC. All Rights Reserved.
+//
+//	We keep pending events in a binary min-heap ordered by tick (ties are
+//	broken by the order in which events were added) so that Update only
+//	touches events that are due.
+//
+//	Cancelled events are not removed from the heap right away. Instead we mark
+//	them as destroyed and delete them when they reach the front of the queue,
+//	or when destroyed events make up more than half of the queue.
+//
+//	Callers that enumerate events by index (GetCount/GetEvent) see only live
+//	events, in the order in which they were added, as if this were still a
+//	flat list. We build that list on demand.
 
 #include "PreComp.h"
 
+const int MIN_DESTROYED_TO_COMPACT =				32;
+
 CSystemEventList::~CSystemEventList (void)
 
 //	CSystemEventList destructor
@@ -13,33 +27,67 @@ CSystemEventList::~CSystemEventList (void)
 	DeleteAll();
 	}
 
+void CSystemEventList::AddEvent (CSystemEvent *pEvent)
+
+//	AddEvent
+//
+//	Adds an event to the list. We take ownership of the event.
+
+	{
+	pEvent->m_dwSeq = m_dwNextSeq++;
+	AddToIndex(pEvent);
+	PushQueue(pEvent);
+	m_bSortedValid = false;
+
+	if (pEvent->IsDestroyed())
+		m_iDestroyed++;
+	}
+
+void CSystemEventList::AddToIndex (CSystemEvent *pEvent)
+
+//	AddToIndex
+//
+//	Adds the event to the handler indices so that we can cancel it without
+//	looking at every event.
+
+	{
+	CSpaceObject *pObj = pEvent->GetEventHandlerObj();
+	if (pObj)
+		m_ObjIndex.SetAt(pObj)->Insert(pEvent);
+
+	CDesignType *pType = pEvent->GetEventHandlerType();
+	if (pType)
+		m_TypeIndex.SetAt(pType)->Insert(pEvent);
+	}
+
 bool CSystemEventList::CancelEvent (CSpaceObject *pObj, bool bInDoEvent)
 
 //	CancelEvent
 //
 //	Cancels the given event
+//
+//	NOTE: We never delete an event here (we only mark it) so it is always safe
+//	to cancel an event from inside an event, regardless of bInDoEvent.
 
 	{
 	int i;
 	bool bFound = false;
 
-	for (i = 0; i < GetCount(); i++)
+	TArray<CSystemEvent *> *pList = m_ObjIndex.GetAt(pObj);
+	if (pList == NULL)
+		return false;
+
+	for (i = 0; i < pList->GetCount(); i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		if (pEvent->GetEventHandlerObj() == pObj)
+		CSystemEvent *pEvent = (*pList)[i];
+		if (!pEvent->IsDestroyed())
 			{
 			bFound = true;
-
-			if (bInDoEvent)
-				pEvent->SetDestroyed();
-			else
-				{
-				RemoveEvent(i);
-				i--;
-				}
+			MarkDestroyed(pEvent);
 			}
 		}
 
+	CompactQueue();
 	return bFound;
 	}
 
@@ -53,24 +101,22 @@ bool CSystemEventList::CancelEvent (CSpaceObject *pObj, const CString &sEvent, b
 	int i;
 	bool bFound = false;
 
-	for (i = 0; i < GetCount(); i++)
+	TArray<CSystemEvent *> *pList = m_ObjIndex.GetAt(pObj);
+	if (pList == NULL)
+		return false;
+
+	for (i = 0; i < pList->GetCount(); i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		if (pEvent->GetEventHandlerObj() == pObj 
+		CSystemEvent *pEvent = (*pList)[i];
+		if (!pEvent->IsDestroyed()
 				&& strEquals(pEvent->GetEventHandlerName(), sEvent))
 			{
 			bFound = true;
-
-			if (bInDoEvent)
-				pEvent->SetDestroyed();
-			else
-				{
-				RemoveEvent(i);
-				i--;
-				}
+			MarkDestroyed(pEvent);
 			}
 		}
 
+	CompactQueue();
 	return bFound;
 	}
 
@@ -84,27 +130,76 @@ bool CSystemEventList::CancelEvent (CDesignType *pType, const CString &sEvent, b
 	int i;
 	bool bFound = false;
 
-	for (i = 0; i < GetCount(); i++)
+	TArray<CSystemEvent *> *pList = m_TypeIndex.GetAt(pType);
+	if (pList == NULL)
+		return false;
+
+	for (i = 0; i < pList->GetCount(); i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		if (pEvent->GetEventHandlerType() == pType 
+		CSystemEvent *pEvent = (*pList)[i];
+		if (!pEvent->IsDestroyed()
 				&& strEquals(pEvent->GetEventHandlerName(), sEvent))
 			{
 			bFound = true;
-
-			if (bInDoEvent)
-				pEvent->SetDestroyed();
-			else
-				{
-				RemoveEvent(i);
-				i--;
-				}
+			MarkDestroyed(pEvent);
 			}
 		}
 
+	CompactQueue();
 	return bFound;
 	}
 
+void CSystemEventList::CollectEvents (TSortMap<DWORD, CSystemEvent *> &Result) const
+
+//	CollectEvents
+//
+//	Returns all events that have not been destroyed, in the order in which
+//	they were added.
+
+	{
+	int i;
+
+	for (i = 0; i < GetQueuedCount(); i++)
+		{
+		CSystemEvent *pEvent = GetQueuedEvent(i);
+		if (pEvent && !pEvent->IsDestroyed())
+			Result.SetAt(pEvent->m_dwSeq, pEvent);
+		}
+	}
+
+void CSystemEventList::CompactQueue (void)
+
+//	CompactQueue
+//
+//	If the queue has accumulated enough destroyed events, we delete them all
+//	and rebuild the heap. This keeps cancellation cheap (amortized).
+
+	{
+	int i;
+
+	if (m_iDestroyed < MIN_DESTROYED_TO_COMPACT || m_iDestroyed * 2 < m_Queue.GetCount())
+		return;
+
+	int iKept = 0;
+	for (i = 0; i < m_Queue.GetCount(); i++)
+		{
+		CSystemEvent *pEvent = m_Queue[i];
+		if (pEvent->IsDestroyed())
+			{
+			pEvent->m_bQueued = false;
+			DeleteEvent(pEvent);
+			}
+		else
+			m_Queue[iKept++] = pEvent;
+		}
+
+	while (m_Queue.GetCount() > iKept)
+		m_Queue.Delete(m_Queue.GetCount() - 1);
+
+	m_iDestroyed = 0;
+	HeapifyQueue();
+	}
+
 void CSystemEventList::DeleteAll (void)
 
 //	DeleteAll
@@ -114,10 +209,248 @@ void CSystemEventList::DeleteAll (void)
 	{
 	int i;
 
-	for (i = 0; i < m_List.GetCount(); i++)
-		delete m_List[i];
+	for (i = 0; i < m_Queue.GetCount(); i++)
+		delete m_Queue[i];
+
+	for (i = 0; i < m_Firing.GetCount(); i++)
+		if (m_Firing[i])
+			delete m_Firing[i];
+
+	m_Queue.DeleteAll();
+	m_Firing.DeleteAll();
+	m_ObjIndex.DeleteAll();
+	m_TypeIndex.DeleteAll();
+	m_iDestroyed = 0;
+	m_bSortedValid = false;
+	}
+
+void CSystemEventList::DeleteEvent (CSystemEvent *pEvent)
+
+//	DeleteEvent
+//
+//	Removes the event from the indices and frees it. The caller must already
+//	have removed it from the queue.
+
+	{
+	RemoveFromIndex(pEvent);
+	delete pEvent;
+	}
+
+const TArray<CSystemEvent *> &CSystemEventList::GetSorted (void) const
+
+//	GetSorted
+//
+//	Returns all live events in the order in which they were added.
+
+	{
+	int i;
+
+	if (!m_bSortedValid)
+		{
+		TSortMap<DWORD, CSystemEvent *> Events;
+		CollectEvents(Events);
+
+		m_Sorted.DeleteAll();
+		m_Sorted.InsertEmpty(Events.GetCount());
+		for (i = 0; i < Events.GetCount(); i++)
+			m_Sorted[i] = Events[i];
+
+		m_bSortedValid = true;
+		}
+
+	return m_Sorted;
+	}
+
+void CSystemEventList::HeapifyQueue (void)
+
+//	HeapifyQueue
+//
+//	Restores the heap property for the whole queue.
+
+	{
+	for (int i = m_Queue.GetCount() / 2 - 1; i >= 0; i--)
+		MoveDown(i);
+	}
+
+bool CSystemEventList::IsBefore (const CSystemEvent *pEvent1, const CSystemEvent *pEvent2)
+
+//	IsBefore
+//
+//	Returns TRUE if pEvent1 should fire before pEvent2.
+
+	{
+	if (pEvent1->m_dwTick != pEvent2->m_dwTick)
+		return (pEvent1->m_dwTick < pEvent2->m_dwTick);
+
+	return (pEvent1->m_dwSeq < pEvent2->m_dwSeq);
+	}
+
+void CSystemEventList::MarkDestroyed (CSystemEvent *pEvent)
+
+//	MarkDestroyed
+//
+//	Marks the event as destroyed. It will be deleted later.
+
+	{
+	if (pEvent->IsDestroyed())
+		return;
+
+	pEvent->SetDestroyed();
+	if (pEvent->m_bQueued)
+		m_iDestroyed++;
+
+	m_bSortedValid = false;
+	}
+
+void CSystemEventList::MoveDown (int iPos)
+
+//	MoveDown
+//
+//	Moves the event at the given heap position down until it is before both of
+//	its children.
+
+	{
+	CSystemEvent *pEvent = m_Queue[iPos];
+	int iCount = m_Queue.GetCount();
+
+	while (true)
+		{
+		int iChild = 2 * iPos + 1;
+		if (iChild >= iCount)
+			break;
+
+		if (iChild + 1 < iCount && IsBefore(m_Queue[iChild + 1], m_Queue[iChild]))
+			iChild++;
+
+		if (!IsBefore(m_Queue[iChild], pEvent))
+			break;
+
+		m_Queue[iPos] = m_Queue[iChild];
+		iPos = iChild;
+		}
+
+	m_Queue[iPos] = pEvent;
+	}
+
+void CSystemEventList::MoveEvents (CSystemEventList &Dest, int iTickOffset)
+
+//	MoveEvents
+//
+//	Moves all events to the destination list, adding iTickOffset to each
+//	event's tick. Destroyed events are deleted.
+
+	{
+	int i;
+
+	TSortMap<DWORD, CSystemEvent *> Moved;
+	CollectEvents(Moved);
+
+	//	Free anything we're not moving
+
+	for (i = 0; i < GetQueuedCount(); i++)
+		{
+		CSystemEvent *pEvent = GetQueuedEvent(i);
+		if (pEvent && pEvent->IsDestroyed())
+			delete pEvent;
+		}
+
+	m_Queue.DeleteAll();
+	m_Firing.DeleteAll();
+	m_ObjIndex.DeleteAll();
+	m_TypeIndex.DeleteAll();
+	m_iDestroyed = 0;
+	m_bSortedValid = false;
+
+	//	Add to the destination in the original order
+
+	for (i = 0; i < Moved.GetCount(); i++)
+		{
+		CSystemEvent *pEvent = Moved[i];
+		pEvent->m_bQueued = false;
+		pEvent->SetTick(pEvent->GetTick() + iTickOffset);
+		Dest.AddEvent(pEvent);
+		}
+	}
+
+void CSystemEventList::MoveObjEvents (CSpaceObject *pObj, CSystemEventList &Dest, int iTickOffset)
+
+//	MoveObjEvents
+//
+//	Moves any events that should follow the given object (when it changes
+//	systems) to the destination list, adding iTickOffset to each event's tick.
+
+	{
+	int i;
+
+	TSortMap<DWORD, CSystemEvent *> Moved;
+
+	int iKept = 0;
+	for (i = 0; i < m_Queue.GetCount(); i++)
+		{
+		CSystemEvent *pEvent = m_Queue[i];
+		if (!pEvent->IsDestroyed() && pEvent->OnObjChangedSystems(pObj))
+			{
+			pEvent->m_bQueued = false;
+			Moved.SetAt(pEvent->m_dwSeq, pEvent);
+			}
+		else
+			m_Queue[iKept++] = pEvent;
+		}
+
+	if (Moved.GetCount() == 0 && m_Firing.GetCount() == 0)
+		return;
+
+	while (m_Queue.GetCount() > iKept)
+		m_Queue.Delete(m_Queue.GetCount() - 1);
+
+	HeapifyQueue();
+
+	//	If we're in the middle of Update, then the object's events might be
+	//	waiting to be re-queued.
+
+	for (i = 0; i < m_Firing.GetCount(); i++)
+		{
+		CSystemEvent *pEvent = m_Firing[i];
+		if (pEvent && !pEvent->IsDestroyed() && pEvent->OnObjChangedSystems(pObj))
+			{
+			Moved.SetAt(pEvent->m_dwSeq, pEvent);
+			m_Firing[i] = NULL;
+			}
+		}
+
+	//	Move
+
+	m_bSortedValid = false;
+	for (i = 0; i < Moved.GetCount(); i++)
+		{
+		CSystemEvent *pEvent = Moved[i];
+		RemoveFromIndex(pEvent);
+		pEvent->SetTick(pEvent->GetTick() + iTickOffset);
+		Dest.AddEvent(pEvent);
+		}
+	}
+
+void CSystemEventList::MoveUp (int iPos)
+
+//	MoveUp
+//
+//	Moves the event at the given heap position up until it is after its
+//	parent.
+
+	{
+	CSystemEvent *pEvent = m_Queue[iPos];
+
+	while (iPos > 0)
+		{
+		int iParent = (iPos - 1) / 2;
+		if (!IsBefore(pEvent, m_Queue[iParent]))
+			break;
+
+		m_Queue[iPos] = m_Queue[iParent];
+		iPos = iParent;
+		}
 
-	m_List.DeleteAll();
+	m_Queue[iPos] = pEvent;
 	}
 
 void CSystemEventList::OnObjDestroyed (CSpaceObject *pObj)
@@ -127,12 +460,14 @@ void CSystemEventList::OnObjDestroyed (CSpaceObject *pObj)
 //	An object has been destroyed
 
 	{
-	for (int i = 0; i < GetCount(); i++)
+	for (int i = 0; i < GetQueuedCount(); i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		if (pEvent->OnObjDestroyed(pObj))
-			pEvent->SetDestroyed();
+		CSystemEvent *pEvent = GetQueuedEvent(i);
+		if (pEvent && !pEvent->IsDestroyed() && pEvent->OnObjDestroyed(pObj))
+			MarkDestroyed(pEvent);
 		}
+
+	CompactQueue();
 	}
 
 void CSystemEventList::OnStationDestroyed (CSpaceObject *pObj)
@@ -142,12 +477,47 @@ void CSystemEventList::OnStationDestroyed (CSpaceObject *pObj)
 //	A station has been destroyed.
 
 	{
-	for (int i = 0; i < GetCount(); i++)
+	for (int i = 0; i < GetQueuedCount(); i++)
+		{
+		CSystemEvent *pEvent = GetQueuedEvent(i);
+		if (pEvent && !pEvent->IsDestroyed() && pEvent->OnStationDestroyed(pObj))
+			MarkDestroyed(pEvent);
+		}
+
+	CompactQueue();
+	}
+
+CSystemEvent *CSystemEventList::PopQueue (void)
+
+//	PopQueue
+//
+//	Removes the first event in the queue and returns it.
+
+	{
+	CSystemEvent *pTop = m_Queue[0];
+	CSystemEvent *pLast = m_Queue[m_Queue.GetCount() - 1];
+	m_Queue.Delete(m_Queue.GetCount() - 1);
+
+	if (m_Queue.GetCount() > 0)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		if (pEvent->OnStationDestroyed(pObj))
-			pEvent->SetDestroyed();
+		m_Queue[0] = pLast;
+		MoveDown(0);
 		}
+
+	pTop->m_bQueued = false;
+	return pTop;
+	}
+
+void CSystemEventList::PushQueue (CSystemEvent *pEvent)
+
+//	PushQueue
+//
+//	Adds the event to the queue.
+
+	{
+	pEvent->m_bQueued = true;
+	m_Queue.Insert(pEvent);
+	MoveUp(m_Queue.GetCount() - 1);
 	}
 
 void CSystemEventList::ReadFromStream (SLoadCtx &Ctx)
@@ -172,6 +542,37 @@ void CSystemEventList::ReadFromStream (SLoadCtx &Ctx)
 		}
 	}
 
+void CSystemEventList::RemoveFromIndex (CSystemEvent *pEvent)
+
+//	RemoveFromIndex
+//
+//	Removes the event from the handler indices.
+
+	{
+	int iIndex;
+
+	CSpaceObject *pObj = pEvent->GetEventHandlerObj();
+	TArray<CSystemEvent *> *pList;
+	if (pObj && (pList = m_ObjIndex.GetAt(pObj)))
+		{
+		if (pList->Find(pEvent, &iIndex))
+			pList->Delete(iIndex);
+
+		if (pList->GetCount() == 0)
+			m_ObjIndex.DeleteAt(pObj);
+		}
+
+	CDesignType *pType = pEvent->GetEventHandlerType();
+	if (pType && (pList = m_TypeIndex.GetAt(pType)))
+		{
+		if (pList->Find(pEvent, &iIndex))
+			pList->Delete(iIndex);
+
+		if (pList->GetCount() == 0)
+			m_TypeIndex.DeleteAt(pType);
+		}
+	}
+
 void CSystemEventList::Update (DWORD dwTick, CSystem *pSystem)
 
 //	Update
@@ -183,29 +584,66 @@ void CSystemEventList::Update (DWORD dwTick, CSystem *pSystem)
 
 	int i;
 
-	for (i = 0; i < GetCount(); i++)
+	//	We pull due events off the queue and fire them. Events added while we
+	//	fire that are due this tick get fired too (in another pass), but an
+	//	event that reschedules itself is not re-queued until we're done, so it
+	//	fires at most once per tick.
+
+	int iNext = 0;
+	while (true)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
-		SetProgramEvent(pEvent);
+		while (m_Queue.GetCount() > 0 && m_Queue[0]->GetTick() <= dwTick)
+			{
+			CSystemEvent *pEvent = PopQueue();
+			if (pEvent->IsDestroyed())
+				{
+				m_iDestroyed--;
+				DeleteEvent(pEvent);
+				}
+			else
+				m_Firing.Insert(pEvent);
+			}
+
+		if (iNext == m_Firing.GetCount())
+			break;
 
-		if (!pEvent->IsDestroyed() && pEvent->GetTick() <= dwTick)
+		for (; iNext < m_Firing.GetCount(); iNext++)
+			{
+			CSystemEvent *pEvent = m_Firing[iNext];
+			if (pEvent == NULL || pEvent->IsDestroyed())
+				continue;
+
+			SetProgramEvent(pEvent);
 			pEvent->DoEvent(dwTick, pSystem);
+
+			//	One-shot events destroy themselves when they fire
+
+			if (pEvent->IsDestroyed())
+				m_bSortedValid = false;
+			}
 		}
 
 	SetProgramEvent(NULL);
 
-	//	Delete events that were destroyed
+	//	Re-queue events that are still alive and delete events that were
+	//	destroyed.
 
-	for (i = 0; i < GetCount(); i++)
+	for (i = 0; i < m_Firing.GetCount(); i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
+		CSystemEvent *pEvent = m_Firing[i];
+		if (pEvent == NULL)
+			continue;
+
 		if (pEvent->IsDestroyed())
-			{
-			RemoveEvent(i);
-			i--;
-			}
+			DeleteEvent(pEvent);
+		else
+			PushQueue(pEvent);
 		}
 
+	m_Firing.DeleteAll();
+
+	CompactQueue();
+
 	DEBUG_CATCH
 	}
 
@@ -217,17 +655,22 @@ void CSystemEventList::WriteToStream (CSystem *pSystem, IWriteStream *pStream)
 //
 //	DWORD		No of events
 //	CSystemEvent	Event
+//
+//	NOTE: We write events in the order in which they were added (and we skip
+//	destroyed events) so the format is the same as when this was a flat list.
 
 	{
 	int i;
 
-	DWORD dwCount = GetCount();
+	TSortMap<DWORD, CSystemEvent *> Events;
+	CollectEvents(Events);
+
+	DWORD dwCount = Events.GetCount();
 	pStream->Write((char *)&dwCount, sizeof(DWORD));
 
 	for (i = 0; i < (int)dwCount; i++)
 		{
-		CSystemEvent *pEvent = GetEvent(i);
+		CSystemEvent *pEvent = Events[i];
 		pEvent->WriteToStream(pSystem, pStream);
 		}
 	}
-
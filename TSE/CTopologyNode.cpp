@@ -95,6 +95,8 @@ void CTopologyNode::AddAttributes (const CString &sAttribs)
 			if (!::HasModifier(m_sAttributes, Attribs[i]))
 				m_sAttributes = ::AppendModifiers(m_sAttributes, Attribs[i]);
 		}
+
+	m_Attributes.InitFromList(m_sAttributes);
 	}
 
 ALERROR CTopologyNode::AddStargate (const SStargateDesc &GateDesc)
@@ -276,7 +278,10 @@ void CTopologyNode::CreateFromStream (SUniverseLoadCtx &Ctx, CTopologyNode **ret
 	
 	pNode->m_sName.ReadFromStream(Ctx.pStream);
 	if (Ctx.dwVersion >= 23)
+		{
 		pNode->m_sAttributes.ReadFromStream(Ctx.pStream);
+		pNode->m_Attributes.InitFromList(pNode->m_sAttributes);
+		}
 
 	Ctx.pStream->Read((char *)&pNode->m_iLevel, sizeof(DWORD));
 	Ctx.pStream->Read((char *)&pNode->m_dwID, sizeof(DWORD));
@@ -819,17 +824,24 @@ bool CTopologyNode::MatchesAttributeCriteria (const SAttributeCriteria &Crit) co
 	{
 	int i;
 
-	//	Check required attributes
+	//	Check required and disallowed attributes. Parsed criteria have these
+	//	as atoms, which is much faster.
 
-	for (i = 0; i < Crit.AttribsRequired.GetCount(); i++)
-		if (!::HasModifier(m_sAttributes, Crit.AttribsRequired[i]))
+	if (Crit.bAtoms)
+		{
+		if (!m_Attributes.HasAll(Crit.RequiredAtoms) || m_Attributes.HasAny(Crit.NotAllowedAtoms))
 			return false;
+		}
+	else
+		{
+		for (i = 0; i < Crit.AttribsRequired.GetCount(); i++)
+			if (!::HasModifier(m_sAttributes, Crit.AttribsRequired[i]))
+				return false;
 
-	//	Check disallowed attributes
-
-	for (i = 0; i < Crit.AttribsNotAllowed.GetCount(); i++)
-		if (::HasModifier(m_sAttributes, Crit.AttribsNotAllowed[i]))
-			return false;
+		for (i = 0; i < Crit.AttribsNotAllowed.GetCount(); i++)
+			if (::HasModifier(m_sAttributes, Crit.AttribsNotAllowed[i]))
+				return false;
+		}
 
 	//	Check special required attributes
 
@@ -969,6 +981,11 @@ ALERROR CTopologyNode::ParseAttributeCriteria (const CString &sCriteria, SAttrib
 		pPos++;
 		}
 
+	//	Compile literal attributes into atoms
+
+	retCrit->bAtoms = (retCrit->RequiredAtoms.InitFromArray(retCrit->AttribsRequired)
+			&& retCrit->NotAllowedAtoms.InitFromArray(retCrit->AttribsNotAllowed));
+
 	return NOERROR;
 	}
 
@@ -2878,7 +2878,11 @@ void CUniverse::Update (SSystemUpdateCtx &Ctx)
 	if (m_pCurrentSystem == NULL)
 		return;
 
-	//	Update system
+	//	Update system. Parallel AI behavior is opt-in (via the debug options)
+	//	until it has had more testing.
+
+	if (m_DebugOptions.IsParallelBehaviorEnabled())
+		Ctx.bParallelBehavior = true;
 
 	m_pCurrentSystem->Update(Ctx, &m_ViewportAnnotations);
 
@@ -175,6 +175,58 @@ const Metric BALANCE_TIME_STOP_LEVEL_FACTOR =	50;         //  Bonus to balance p
 const Metric PARTICLE_CLOUD_DAMAGE_FACTOR =		0.75;
 const Metric SHOCKWAVE_DAMAGE_FACTOR =			4.0;
 
+enum EWeaponClassProperties
+	{
+	propAmmoTypes,
+	propAverageDamage,
+	propBalance,
+	propBalanceCost,
+	propBalanceDamage,
+	propBalanceExcludeCost,
+	propDamage180,
+	propDamagePerProjectile,
+	propDamageWMD180,
+	propEffectiveRange,
+	propFireArc,
+	propFireDelay,
+	propFireRate,
+	propLinkedFireOptions,
+	propMaxDamage,
+	propMinDamage,
+	propMultiShot,
+	propOmnidirectional,
+	propRepeating,
+	propShipCounterPerShot,
+	propStdCost,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propAmmoTypes,					PROPERTY_AMMO_TYPES	},
+		{	propAverageDamage,				PROPERTY_AVERAGE_DAMAGE	},
+		{	propBalance,					PROPERTY_BALANCE	},
+		{	propBalanceCost,				PROPERTY_BALANCE_COST	},
+		{	propBalanceDamage,				PROPERTY_BALANCE_DAMAGE	},
+		{	propBalanceExcludeCost,			PROPERTY_BALANCE_EXCLUDE_COST	},
+		{	propDamage180,					PROPERTY_DAMAGE_180	},
+		{	propDamagePerProjectile,		PROPERTY_DAMAGE_PER_PROJECTILE	},
+		{	propDamageWMD180,				PROPERTY_DAMAGE_WMD_180	},
+		{	propEffectiveRange,				PROPERTY_EFFECTIVE_RANGE	},
+		{	propFireArc,					PROPERTY_FIRE_ARC	},
+		{	propFireDelay,					PROPERTY_FIRE_DELAY	},
+		{	propFireRate,					PROPERTY_FIRE_RATE	},
+		{	propLinkedFireOptions,			PROPERTY_LINKED_FIRE_OPTIONS	},
+		{	propMaxDamage,					PROPERTY_MAX_DAMAGE	},
+		{	propMinDamage,					PROPERTY_MIN_DAMAGE	},
+		{	propMultiShot,					PROPERTY_MULTI_SHOT	},
+		{	propOmnidirectional,			PROPERTY_OMNIDIRECTIONAL	},
+		{	propRepeating,					PROPERTY_REPEATING	},
+		{	propShipCounterPerShot,			PROPERTY_SHIP_COUNTER_PER_SHOT	},
+		{	propStdCost,					PROPERTY_STD_COST	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 static CWeaponClass::SStdStats STD_WEAPON_STATS[MAX_ITEM_LEVEL] =
 	{
 		//	Damage	Power	        Cost     Ammo Cost   Over	Under
@@ -2275,7 +2327,7 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 	//	Get the property
 
 	ICCItem *pResult;
-	if (strEquals(sProperty, PROPERTY_AMMO_TYPES))
+	if (iProp == propAmmoTypes)
 		{
 		if (UsesAmmo())
 			{
@@ -2290,10 +2342,10 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 			return CC.CreateNil();
 		}
 
-	else if (strEquals(sProperty, PROPERTY_AVERAGE_DAMAGE))
+	else if (iProp == propAverageDamage)
 		return CC.CreateDouble(CalcDamagePerShot(pShot, pEnhancements));
 
-    else if (strEquals(sProperty, PROPERTY_BALANCE))
+    else if (iProp == propBalance)
         {
         SBalance Balance;
         CalcBalance(Ctx, Balance);
@@ -2302,7 +2354,7 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 
         return CC.CreateInteger((int)Balance.rBalance);
         }
-    else if (strEquals(sProperty, PROPERTY_BALANCE_DAMAGE))
+    else if (iProp == propBalanceDamage)
         {
         SBalance Balance;
         CalcBalance(Ctx, Balance);
@@ -2321,7 +2373,7 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 
         return CC.CreateInteger((int)(rDamage + 0.5));
         }
-    else if (strEquals(sProperty, PROPERTY_BALANCE_COST))
+    else if (iProp == propBalanceCost)
         {
         SBalance Balance;
         CalcBalance(Ctx, Balance);
@@ -2341,7 +2393,7 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 
         return CC.CreateInteger((int)GetItemType()->GetCurrencyType()->Exchange(CEconomyType::Default(), (CurrencyValue)rCostCredits));
         }
-    else if (strEquals(sProperty, PROPERTY_BALANCE_EXCLUDE_COST))
+    else if (iProp == propBalanceExcludeCost)
         {
         SBalance Balance;
         CalcBalance(Ctx, Balance);
@@ -2350,27 +2402,27 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 
         return CC.CreateInteger((int)(Balance.rBalance - Balance.rCost));
         }
-	else if (strEquals(sProperty, PROPERTY_DAMAGE_180))
+	else if (iProp == propDamage180)
 		{
 		Metric rDamagePerShot = CalcDamagePerShot(pShot, pEnhancements);
 		int iDelay = CalcActivateDelay(Ctx);
 		return CC.CreateInteger(iDelay > 0 ? (int)((rDamagePerShot * 180.0 / iDelay) + 0.5) : (int)(rDamagePerShot + 0.5));
 		}
 
-	else if (strEquals(sProperty, PROPERTY_DAMAGE_PER_PROJECTILE))
+	else if (iProp == propDamagePerProjectile)
 		return CC.CreateDouble(CalcDamage(pShot, pEnhancements));
 
-	else if (strEquals(sProperty, PROPERTY_DAMAGE_WMD_180))
+	else if (iProp == propDamageWMD180)
 		{
 		Metric rDamagePerShot = CalcDamagePerShot(pShot, pEnhancements, DamageDesc::flagWMDAdj);
 		int iDelay = CalcActivateDelay(Ctx);
 		return CC.CreateInteger(iDelay > 0 ? (int)((rDamagePerShot * 180.0 / iDelay) + 0.5) : (int)(rDamagePerShot + 0.5));
 		}
 
-    else if (strEquals(sProperty, PROPERTY_EFFECTIVE_RANGE))
+    else if (iProp == propEffectiveRange)
         return CC.CreateInteger((int)(pShot->GetEffectiveRange() / LIGHT_SECOND));
 
-	else if (strEquals(sProperty, PROPERTY_FIRE_ARC))
+	else if (iProp == propFireArc)
 		{
 		int iMinFireArc;
 		int iMaxFireArc;
@@ -2404,10 +2456,10 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 			}
 		}
 
-	else if (strEquals(sProperty, PROPERTY_FIRE_DELAY))
+	else if (iProp == propFireDelay)
 		return CC.CreateInteger(CalcActivateDelay(Ctx));
 
-	else if (strEquals(sProperty, PROPERTY_FIRE_RATE))
+	else if (iProp == propFireRate)
 		{
 		Metric rDelay = CalcActivateDelay(Ctx);
 		if (rDelay <= 0.0)
@@ -2416,7 +2468,7 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 		return CC.CreateInteger((int)(1000.0 / rDelay));
 		}
 
-	else if (strEquals(sProperty, PROPERTY_LINKED_FIRE_OPTIONS))
+	else if (iProp == propLinkedFireOptions)
 		{
 		//	Get the options from the device
 
@@ -2446,28 +2498,28 @@ ICCItem *CWeaponClass::FindAmmoItemProperty (CItemCtx &Ctx, const CItem &Ammo, c
 		return pResult;
 		}
 
-	else if (strEquals(sProperty, PROPERTY_MAX_DAMAGE))
+	else if (iProp == propMaxDamage)
 		return CC.CreateDouble(CalcDamagePerShot(pShot, pEnhancements, DamageDesc::flagMaxDamage));
 
-	else if (strEquals(sProperty, PROPERTY_MIN_DAMAGE))
+	else if (iProp == propMinDamage)
 		return CC.CreateDouble(CalcDamagePerShot(pShot, pEnhancements, DamageDesc::flagMinDamage));
 
-	else if (strEquals(sProperty, PROPERTY_MULTI_SHOT))
+	else if (iProp == propMultiShot)
 		return CC.CreateBool(m_Configuration != ctSingle);
 
-	else if (strEquals(sProperty, PROPERTY_OMNIDIRECTIONAL))
+	else if (iProp == propOmnidirectional)
 		return CC.CreateBool(GetRotationType(Ctx) == rotOmnidirectional);
 
-	else if (strEquals(sProperty, PROPERTY_REPEATING))
+	else if (iProp == propRepeating)
 		{ 
 		CWeaponFireDesc *pShot = GetWeaponFireDesc(Ctx);
 		return CC.CreateInteger(pShot->GetContinuous());
 		}
-	else if (strEquals(sProperty, PROPERTY_SHIP_COUNTER_PER_SHOT))
+	else if (iProp == propShipCounterPerShot)
 		{
 		return CC.CreateInteger(m_iCounterPerShot);
 		}
-    else if (strEquals(sProperty, PROPERTY_STD_COST))
+    else if (iProp == propStdCost)
         {
         const SStdStats &Stats = STD_WEAPON_STATS[CalcLevel(pShot) - 1];
         return CC.CreateDouble(Stats.rCost);
@@ -2507,6 +2559,7 @@ int CWeaponClass::GetAmmoVariant (const CItemType *pItem) const
 //	does not fire the ammo)
 
 	{
+	int iProp = g_Properties.Find(sProperty);
 	int i;
 
 	DWORD dwItemUNID = (pItem ? pItem->GetUNID() : 0);
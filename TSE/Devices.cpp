@@ -90,6 +90,42 @@ static SStdDeviceStats STD_DEVICE_STATS[MAX_ITEM_LEVEL] =
  		{	1800000000,	},
 	};
 
+enum EDeviceClassProperties
+	{
+	propCanBeDamaged,
+	propCanBeDisabled,
+	propCanBeDisrupted,
+	propCapacitor,
+	propDeviceSlots,
+	propEnabled,
+	propExternal,
+	propExtraPowerUse,
+	propPos,
+	propPower,
+	propSecondary,
+	propSlotID,
+	propTemperature,
+	};
+
+static CPropertyIDTable::SEntry g_PropertyTable[] =
+	{
+		{	propCanBeDamaged,				PROPERTY_CAN_BE_DAMAGED	},
+		{	propCanBeDisabled,				PROPERTY_CAN_BE_DISABLED	},
+		{	propCanBeDisrupted,				PROPERTY_CAN_BE_DISRUPTED	},
+		{	propCapacitor,					PROPERTY_CAPACITOR	},
+		{	propDeviceSlots,				PROPERTY_DEVICE_SLOTS	},
+		{	propEnabled,					PROPERTY_ENABLED	},
+		{	propExternal,					PROPERTY_EXTERNAL	},
+		{	propExtraPowerUse,				PROPERTY_EXTRA_POWER_USE	},
+		{	propPos,						PROPERTY_POS	},
+		{	propPower,						PROPERTY_POWER	},
+		{	propSecondary,					PROPERTY_SECONDARY	},
+		{	propSlotID,						PROPERTY_SLOT_ID	},
+		{	propTemperature,				PROPERTY_TEMPERATURE	},
+	};
+
+static CPropertyIDTable g_Properties(g_PropertyTable, sizeof(g_PropertyTable) / sizeof(g_PropertyTable[0]));
+
 static char *CACHED_EVENTS[CDeviceClass::evtCount] =
 	{
 		"GetOverlayType",
@@ -451,6 +487,7 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 //	item properties.
 
 	{
+	int iProp = g_Properties.Find(sName);
 	CCodeChain &CC = g_pUniverse->GetCC();
     CString sFieldValue;
 
@@ -460,13 +497,13 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 
 	//	Get the property
 
-	if (strEquals(sName, PROPERTY_CAN_BE_DAMAGED))
+	if (iProp == propCanBeDamaged)
 		return (pDevice ? CC.CreateBool(pDevice->CanBeDamaged()) : CC.CreateBool(CanBeDamaged()));
-    else if (strEquals(sName, PROPERTY_CAN_BE_DISABLED))
+    else if (iProp == propCanBeDisabled)
         return (pDevice ? CC.CreateBool(pDevice->CanBeDisabled(Ctx)) : CC.CreateBool(CanBeDisabled(Ctx)));
-	else if (strEquals(sName, PROPERTY_CAN_BE_DISRUPTED))
+	else if (iProp == propCanBeDisrupted)
 		return (pDevice ? CC.CreateBool(pDevice->CanBeDisrupted()) : CC.CreateBool(CanBeDisrupted()));
-    else if (strEquals(sName, PROPERTY_CAPACITOR))
+    else if (iProp == propCapacitor)
         {
         CSpaceObject *pSource = Ctx.GetSource();
         CounterTypes iType;
@@ -478,16 +515,16 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
         return CC.CreateInteger(iLevel);
         }
 
-    else if (strEquals(sName, PROPERTY_DEVICE_SLOTS))
+    else if (iProp == propDeviceSlots)
         return CC.CreateInteger(GetSlotsRequired());
 
-    else if (strEquals(sName, PROPERTY_ENABLED))
+    else if (iProp == propEnabled)
         return (pDevice ? CC.CreateBool(pDevice->IsEnabled()) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_EXTERNAL))
+	else if (iProp == propExternal)
 		return CC.CreateBool(pDevice ? pDevice->IsExternal() : IsExternal());
 
-	else if (strEquals(sName, PROPERTY_EXTRA_POWER_USE))
+	else if (iProp == propExtraPowerUse)
 		{
 		if (pDevice == NULL)
 			return CC.CreateNil();
@@ -495,7 +532,7 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 		return CC.CreateInteger(pDevice->GetExtraPowerUse());
 		}
 
-    else if (strEquals(sName, PROPERTY_POS))
+    else if (iProp == propPos)
         {
         if (pDevice == NULL)
             return CC.CreateNil();
@@ -520,7 +557,7 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
         return pResult;
         }
 
-	else if (strEquals(sName, PROPERTY_POWER))
+	else if (iProp == propPower)
 		{
 		if (GetCategory() == itemcatReactor)
 			return CreatePowerResult(CC, GetPowerOutput(Ctx) * 100.0);
@@ -528,13 +565,13 @@ ICCItem *CDeviceClass::FindItemProperty (CItemCtx &Ctx, const CString &sName)
 			return CreatePowerResult(CC, GetPowerRating(Ctx) * 100.0);
 		}
 
-    else if (strEquals(sName, PROPERTY_SECONDARY))
+    else if (iProp == propSecondary)
         return (pDevice ? CC.CreateBool(pDevice->IsSecondaryWeapon()) : CC.CreateNil());
 
-	else if (strEquals(sName, PROPERTY_SLOT_ID))
+	else if (iProp == propSlotID)
 		return (pDevice ? CC.CreateString(pDevice->GetID()) : CC.CreateNil());
 
-    else if (strEquals(sName, PROPERTY_TEMPERATURE))
+    else if (iProp == propTemperature)
         {
         CSpaceObject *pSource = Ctx.GetSource();
         CounterTypes iType;
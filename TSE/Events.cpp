@@ -11,7 +11,9 @@ static const Metric MIN_SEPARATION =			20.0 * LIGHT_SECOND;
 static const Metric MIN_PLAYER_SEPARATION =		100.0 * LIGHT_SECOND;
 static const Metric MIN_PLAYER_SEPARATION2 =	MIN_PLAYER_SEPARATION * MIN_PLAYER_SEPARATION;
 
-CSystemEvent::CSystemEvent (SLoadCtx &Ctx)
+CSystemEvent::CSystemEvent (SLoadCtx &Ctx) :
+		m_dwSeq(0),
+		m_bQueued(false)
 
 //	CSystemEvent constructo
 
@@ -96,6 +96,7 @@ class CFleetCommandAI : public CBaseShipAI
 
 		//	IShipController virtuals
 		virtual void Behavior (SUpdateCtx &Ctx) override;
+		virtual bool CanReduceBehaviorRate (void) override { return (m_iCounter <= 0 && CBaseShipAI::CanReduceBehaviorRate()); }
 		virtual CString DebugCrashInfo (void) override;
 		virtual CString GetClass (void) override { return CONSTLIT("fleetcommand"); }
 		virtual CSpaceObject *GetTarget (CItemCtx &ItemCtx, bool bNoAutoTarget = false) const override { return m_pTarget; }
@@ -192,6 +193,7 @@ class CFleetShipAI : public CBaseShipAI
 
 		//	IShipController virtuals
 		virtual void Behavior (SUpdateCtx &Ctx) override;
+		virtual bool CanReduceBehaviorRate (void) override { return (m_iCounter == 0 && CBaseShipAI::CanReduceBehaviorRate()); }
 		virtual CString DebugCrashInfo (void) override;
 		virtual CString GetClass (void) override { return CONSTLIT("fleet"); }
 		virtual CSpaceObject *GetTarget (CItemCtx &ItemCtx, bool bNoAutoTarget = false) const override;
@@ -330,6 +332,9 @@ class CStandardShipAI : public CBaseShipAI
 
 		static void SetDebugShip (CShip *pShip);
 
+		//	IShipController virtuals
+		virtual bool CanReduceBehaviorRate (void) override { return (m_iCountdown == -1 && CBaseShipAI::CanReduceBehaviorRate()); }
+
 	protected:
 		//	CBaseShipAI overrides
 		virtual void OnAttackedNotify (CSpaceObject *pAttacker, const SDamageCtx &Damage) override;
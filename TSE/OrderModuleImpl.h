@@ -50,6 +50,7 @@ class CAttackOrder : public IOrderModule
 		virtual void OnAttacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire) override;
 		virtual void OnBehavior (CShip *pShip, CAIBehaviorCtx &Ctx) override;
 		virtual void OnBehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) override;
+		virtual bool OnCanReduceBehaviorRate (void) override { return (m_iCountdown == -1); }
 		virtual CString OnDebugCrashInfo (void) override;
 		virtual IShipController::OrderTypes OnGetOrder (void) override { return m_iOrder; }
 		virtual CSpaceObject *OnGetTarget (void) override { return m_Objs[objTarget]; }
@@ -106,6 +107,7 @@ class CAttackStationOrder : public IOrderModule
 		virtual void OnAttacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire) override;
 		virtual void OnBehavior (CShip *pShip, CAIBehaviorCtx &Ctx) override;
 		virtual void OnBehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) override;
+		virtual bool OnCanReduceBehaviorRate (void) override { return (m_iCountdown == -1); }
 		virtual CString OnDebugCrashInfo (void) override;
 		virtual IShipController::OrderTypes OnGetOrder (void) override { return IShipController::orderAttackStation; }
 		virtual CSpaceObject *OnGetTarget (void) override { return m_Objs[objTarget]; }
@@ -289,6 +291,7 @@ class CSentryOrder : public IOrderModule
 		virtual void OnAttacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire) override;
 		virtual void OnBehavior (CShip *pShip, CAIBehaviorCtx &Ctx) override;
 		virtual void OnBehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) override;
+		virtual bool OnCanReduceBehaviorRate (void) override { return (m_iCountdown == -1); }
 		virtual DWORD OnCommunicate (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pSender, MessageTypes iMessage, CSpaceObject *pParam1, DWORD dwParam2) override;
 		virtual void OnDestroyed (CShip *pShip, SDestroyCtx &Ctx) override;
 		virtual CSpaceObject *OnGetBase (void) override { return m_Objs[objBase]; }
@@ -359,6 +362,7 @@ class CWaitOrder : public IOrderModule
 		virtual void OnAttacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire) override;
 		virtual void OnBehavior (CShip *pShip, CAIBehaviorCtx &Ctx) override;
 		virtual void OnBehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) override;
+		virtual bool OnCanReduceBehaviorRate (void) override { return (m_iCountdown == -1); }
 		virtual DWORD OnCommunicate (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pSender, MessageTypes iMessage, CSpaceObject *pParam1, DWORD dwParam2) override;
 		virtual void OnDestroyed (CShip *pShip, SDestroyCtx &Ctx) override;
 		virtual IShipController::OrderTypes OnGetOrder (void) override { return m_iOrder; }
@@ -42,6 +42,8 @@ class CAIBehaviorCtx
 		inline bool AvoidsExplodingStations (void) const { return m_fAvoidExplodingStations; }
 		inline void ClearBestWeapon (void) { m_fRecalcBestWeapon = true; }
 		void ClearNavPath (void);
+		inline void ClearWeaponScores (void) { if (!m_fCalcingBestWeapon) m_fWeaponScoresValid = false; }
+		void CoastManeuver (CShip *pShip);
 		void DebugPaintInfo (CG32bitImage &Dest, int x, int y, SViewportPaintCtx &Ctx);
 		inline CString GetAISetting (const CString &sSetting) { return m_AISettings.GetValue(sSetting); }
 		inline const CAISettings &GetAISettings (void) const { return m_AISettings; }
@@ -72,14 +74,16 @@ class CAIBehaviorCtx
 		inline bool HasEscorts (void) const { return m_fHasEscorts; }
 		inline bool HasMultipleWeapons (void) const { return m_fHasMultipleWeapons; }
 		inline bool HasSecondaryWeapons (void) const { return m_fHasSecondaryWeapons; }
-		inline bool HasSuperconductingShields (void) const { return m_fSuperconductingShields; }
+		inline bool HasSuperconductingShields (void) const { return (m_pInvariants && m_pInvariants->HasSuperconductingShields()); }
 		inline bool IsAggressor (void) const { return m_AISettings.IsAggressor(); }
 		bool IsBeingAttacked (int iThreshold = 150) const;
 		inline bool IsDockingRequested (void) const { return m_fDockingRequested; }
-		inline bool IsImmobile (void) const { return m_fImmobile; }
+		inline bool IsImmobile (void) const { return (m_pInvariants && m_pInvariants->IsImmobile()); }
 		inline bool IsNonCombatant (void) const { return m_AISettings.IsNonCombatant(); }
+		inline bool IsRecoveringFromBarrier (void) const { return (m_iBarrierClock != -1); }
 		bool IsSecondAttack (void) const;
 		inline bool IsWaitingForShieldsToRegen (void) const { return m_fWaitForShieldsToRegen; }
+		bool NeedsAvoidPotentialParallel (CShip *pShip);
 		inline bool NoAttackOnThreat (void) const { return m_AISettings.NoAttackOnThreat(); }
 		inline bool NoDogfights (void) const { return m_AISettings.NoDogfights(); }
 		inline bool NoFriendlyFire (void) const { return m_AISettings.NoFriendlyFire(); }
@@ -99,7 +103,7 @@ class CAIBehaviorCtx
 		inline void SetLastTurnCount (int iCount) { m_iLastTurnCount = iCount; }
 		inline void SetManeuver (EManeuverTypes iManeuver) { m_ShipControls.SetManeuver(iManeuver); }
 		inline void SetManeuverCounter (int iCount) { m_iManeuverCounter = iCount; }
-		inline void SetNavPath (CNavigationPath *pNavPath, int iNavPathPos, bool bOwned = false) { ClearNavPath(); m_pNavPath = pNavPath; m_iNavPathPos = iNavPathPos; m_fFreeNavPath = bOwned; }
+		inline void SetNavPath (CNavigationPath *pNavPath, int iNavPathPos, bool bOwned = false) { ClearNavPath(); m_pNavPath = pNavPath; m_iNavPathPos = iNavPathPos; m_dwNavPathRevision = (pNavPath ? pNavPath->GetRevision() : 0); m_fFreeNavPath = bOwned; }
 		inline void SetPotential (const CVector &vVec) { m_vPotential = vVec; }
 		inline void SetSystemUpdateCtx (SUpdateCtx *pCtx) { m_pUpdateCtx = pCtx;  }
 		inline void SetThrust (bool bThrust) { m_ShipControls.SetThrust(bThrust); }
@@ -141,26 +145,52 @@ class CAIBehaviorCtx
 		CVector CalcFlankPos (CShip *pShip, const CVector &vInterceptPos);
 		bool CalcFormationParams (CShip *pShip, const CVector &vDestPos, const CVector &vDestVel, int iDestAngle, CVector *retvRecommendedVel, Metric *retrDeltaPos2 = NULL, Metric *retrDeltaVel2 = NULL);
 		void CalcAvoidPotential (CShip *pShip, CSpaceObject *pTarget);
+		void CalcAvoidPotentialParallel (CShip *pShip);
 		void CalcBestWeapon (CShip *pShip, CSpaceObject *pTarget, Metric rTargetDist2);
 		bool CalcFlockingFormation (CShip *pShip, CSpaceObject *pLeader, CVector *retvPos, CVector *retvVel, int *retiFacing);
+		static bool CalcHazardPotential (CSpaceObject *pObj, const CVector &vPos, CVector &iovPotential);
 		void CalcInvariants (CShip *pShip);
 		bool CalcIsBetterTarget (CShip *pShip, CSpaceObject *pCurTarget, CSpaceObject *pNewTarget) const;
 		bool CalcNavPath (CShip *pShip, const CVector &vTo);
 		bool CalcNavPath (CShip *pShip, CSpaceObject *pTo);
 		void CalcNavPath (CShip *pShip, CSpaceObject *pFrom, CSpaceObject *pTo);
 		void CalcNavPath (CShip *pShip, CNavigationPath *pPath, bool bOwned = false);
+		static int CalcNavPathPos (CShip *pShip, CNavigationPath *pPath);
 		void CalcShieldState (CShip *pShip);
-		int CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, CInstalledDevice *pWeapon, Metric rTargetDist2);
+		int CalcWeaponScore (CShip *pShip, CSpaceObject *pTarget, int iDevice, int iVariant, Metric rTargetDist2);
 		void CancelDocking (CShip *pShip, CSpaceObject *pBase);
 		inline bool CheckForFriendsInLineOfFire (CShip *pShip, CInstalledDevice *pDevice, CSpaceObject *pTarget, int iFireAngle, Metric rMaxRange)
 			{ return (NoFriendlyFireCheck() || pShip->IsLineOfFireClear(pDevice, pTarget, iFireAngle, rMaxRange)); }
 		inline CVector CombinePotential (const CVector &vDir)
 			{ return GetPotential() + (vDir.Normal() * 100.0 * g_KlicksPerPixel);	}
 		void CommunicateWithEscorts (CShip *pShip, MessageTypes iMessage, CSpaceObject *pParam1 = NULL, DWORD dwParam2 = 0);
+		static Metric GetHazardRange (CSpaceObject *pObj);
 		void Undock (CShip *pShip);
 
 	private:
+		struct SAvoidCandidate
+			{
+			CSpaceObject *pObj;					//	Object found in the grid
+			CVector vPos;						//	Position of object when computed
+			CVector vPotential;					//	Potential to add (if bContributes)
+			bool bContributes;					//	TRUE if this object adds potential
+			};
+
+		struct SWeaponScore
+			{
+			CItemType *pVariantType;			//	Weapon or ammo that we computed for
+			int iLevel;							//	Level of the variant
+			bool bAmmo;							//	TRUE if the variant uses ammo (or is a missile)
+			Metric rMaxRange;					//	Max effective range (regardless of target)
+			Metric rTargetRange;				//	Max effective range against target
+			int iDamageEffect;					//	Damage effectiveness against target (if any)
+			};
+
+		bool AddAvoidPotential (CShip *pShip, CSpaceObject *pObj, Metric rMinSeparation2, Metric rSeparationForce, CVector &iovPotential) const;
+		bool AddHazardFieldPotential (CShip *pShip, CSpaceObject *pTarget, const CAvoidPotentialField &Field, CVector &iovPotential) const;
+		bool ApplyAvoidPotentialParallel (CShip *pShip, CSpaceObject *pTarget);
 		void DebugAIOutput (CShip *pShip, LPCSTR pText);
+		const SWeaponScore &GetWeaponScore (CShip *pShip, CSpaceObject *pTarget, int iDevice, int iVariant);
 		void CalcEscortFormation (CShip *pShip, CSpaceObject *pLeader, CVector *retvPos, CVector *retvVel, int *retiFacing);
 		bool CalcFlockingFormationCloud (CShip *pShip, CSpaceObject *pLeader, Metric rFOVRange, Metric rSeparationRange, CVector *retvPos, CVector *retvVel, int *retiFacing);
 		bool CalcFlockingFormationRandom (CShip *pShip, CSpaceObject *pLeader, CVector *retvPos, CVector *retvVel, int *retiFacing);
@@ -180,14 +210,17 @@ class CAIBehaviorCtx
 		CNavigationPath *m_pNavPath;			//	Current navigation path
 		int m_iNavPathPos:16;					//	-1 = not in nav path
 		int m_iBarrierClock:16;					//	We've hit a barrier, so try to recover
+		DWORD m_dwNavPathRevision;				//	m_pNavPath revision that m_iNavPathPos refers to
+		int m_iManeuverDir;						//	Direction picked by ImplementManeuver (-1 = none)
 
 		DWORD m_fDockingRequested:1;			//	TRUE if we've requested docking
 		DWORD m_fWaitForShieldsToRegen:1;		//	TRUE if ship is waiting for shields to regen
-		DWORD m_dwSpare1:30;
+		DWORD m_fManeuverThrust:1;				//	TRUE if we want to thrust once we face m_iManeuverDir
+		DWORD m_dwSpare1:29;
 
 		//	Cached values
 		SUpdateCtx *m_pUpdateCtx;				//	System update context
-		CInstalledDevice *m_pShields;			//	Shields (NULL if none)
+		CAIShipInvariants *m_pInvariants;		//	Class and loadout properties (shared with similar ships)
 		CInstalledDevice *m_pBestWeapon;		//	Best weapon
 		DeviceNames m_iBestWeapon;
 		Metric m_rBestWeaponRange;				//	Range of best weapon
@@ -198,8 +231,19 @@ class CAIBehaviorCtx
 		int m_iBestNonLauncherWeaponLevel;		//	Level of best non-launcher weapon
 		int m_iPrematureFireChance;				//	Chance of firing prematurely
 
-		DWORD m_fImmobile:1;					//	TRUE if ship does not move
-		DWORD m_fSuperconductingShields:1;		//	TRUE if ship has superconducting shields
+		//	Computed by CalcAvoidPotentialParallel
+		TArray<SAvoidCandidate> m_AvoidCandidates;	//	Objects near us in the grid (in grid order)
+		int m_iAvoidCandidatesTick;				//	Tick on which candidates were computed (-1 = never)
+		CVector m_vAvoidCandidatesPos;			//	Our position when candidates were computed
+		Metric m_rAvoidCandidatesSeparation;	//	Min combat separation used
+		bool m_bAvoidCandidatesUseField;		//	TRUE if candidates exclude hazards (see CAvoidPotentialField)
+
+		//	Computed by CalcBestWeapon
+		TSortMap<DWORD, SWeaponScore> m_WeaponScores;	//	Target-dependent weapon invariants (by device and variant)
+		DWORD m_dwWeaponScoresTarget;			//	ID of target that m_WeaponScores is for (OBJID_NULL = none)
+
+		DWORD m_fSpare1:1;
+		DWORD m_fSpare2:1;
 		DWORD m_fHasMultipleWeapons:1;			//	TRUE if ship has more than 1 primary
 		DWORD m_fThrustThroughTurn:1;			//	TRUE if ship thrusts through a turn
 		DWORD m_fAvoidExplodingStations:1;		//	TRUE if ship avoids exploding stations
@@ -207,13 +251,13 @@ class CAIBehaviorCtx
 		DWORD m_fHasSecondaryWeapons:1;			//	TRUE if ship has secondary weapons
 		DWORD m_fHasEscorts:1;					//	TRUE if ship has escorts
 
-		DWORD m_fHasMultiplePrimaries:1;		//	TRUE if ship has multiple primary weapons (non-launchers)
+		DWORD m_fSpare3:1;
 		DWORD m_fFreeNavPath:1;					//	TRUE if we own the nav path object
 		DWORD m_fHasAvoidPotential:1;			//	TRUE if there is something to avoid
-		DWORD m_fSpare4:1;
-		DWORD m_fSpare5:1;
-		DWORD m_fSpare6:1;
-		DWORD m_fSpare7:1;
+		DWORD m_fWeaponScoresValid:1;			//	TRUE if m_WeaponScores is up to date with our loadout
+		DWORD m_fWeaponScoresShieldsUp:1;		//	TRUE if m_WeaponScores assumes target shields are up
+		DWORD m_fWeaponScoresTargetThrusts:1;	//	TRUE if m_WeaponScores assumes target can thrust
+		DWORD m_fCalcingBestWeapon:1;			//	TRUE while CalcBestWeapon selects a weapon
 		DWORD m_fSpare8:1;
 
 		DWORD m_dwSpare:16;
@@ -230,6 +274,7 @@ class IOrderModule
 		void Attacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire);
 		inline void Behavior (CShip *pShip, CAIBehaviorCtx &Ctx) { OnBehavior(pShip, Ctx); }
 		inline void BehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) { OnBehaviorStart(pShip, Ctx, pOrderTarget, Data); }
+		inline bool CanReduceBehaviorRate (void) { return OnCanReduceBehaviorRate(); }
 		DWORD Communicate (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pSender, MessageTypes iMessage, CSpaceObject *pParam1, DWORD dwParam2);
 		static IOrderModule *Create (IShipController::OrderTypes iOrder);
 		CString DebugCrashInfo (CShip *pShip);
@@ -247,6 +292,7 @@ class IOrderModule
 		virtual void OnAttacked (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pAttacker, const SDamageCtx &Damage, bool bFriendlyFire) { }
 		virtual void OnBehavior (CShip *pShip, CAIBehaviorCtx &Ctx) = 0;
 		virtual void OnBehaviorStart (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pOrderTarget, const IShipController::SData &Data) { }
+		virtual bool OnCanReduceBehaviorRate (void) { return true; }
 		virtual DWORD OnCommunicate (CShip *pShip, CAIBehaviorCtx &Ctx, CSpaceObject *pSender, MessageTypes iMessage, CSpaceObject *pParam1, DWORD dwParam2) { return resNoAnswer; }
 		virtual CString OnDebugCrashInfo (void) { return NULL_STR; }
 		virtual void OnDestroyed (CShip *pShip, SDestroyCtx &Ctx) { }
@@ -321,6 +367,8 @@ class CBaseShipAI : public IShipController
 		//	IShipController virtuals
 		virtual void Behavior (SUpdateCtx &Ctx) override;
 		virtual bool CanObjRequestDock (void) const override;
+		virtual bool CanReduceBehaviorRate (void) override;
+		virtual void CoastBehavior (SUpdateCtx &Ctx) override;
 		virtual CString DebugCrashInfo (void) override;
 		virtual void DebugPaintInfo (CG32bitImage &Dest, int x, int y, SViewportPaintCtx &Ctx) override;
 		virtual bool FollowsObjThroughGate (CSpaceObject *pLeader = NULL) override;
@@ -340,6 +388,7 @@ class CBaseShipAI : public IShipController
 		virtual CSpaceObject *GetTarget (CItemCtx &ItemCtx, bool bNoAutoTarget = false) const override;
 		virtual bool GetThrust (void) override { return m_AICtx.GetThrust(m_pShip); }
 		virtual void GetWeaponTarget (STargetingCtx &TargetingCtx, CItemCtx &ItemCtx, CSpaceObject **retpTarget, int *retiFireSolution) override;
+		virtual bool HasParallelBehavior (void) override { return m_AICtx.NeedsAvoidPotentialParallel(m_pShip); }
 		virtual bool IsAngryAt (CSpaceObject *pObj) const override;
 		virtual bool IsPlayerBlacklisted (void) const override { return (m_fPlayerBlacklisted ? true : false); }
 		virtual bool IsPlayerWingman (void) const override { return (m_fIsPlayerWingman ? true : false); }
@@ -349,7 +398,7 @@ class CBaseShipAI : public IShipController
 		virtual void OnDocked (CSpaceObject *pObj) override;
 		virtual void OnEnterGate (CTopologyNode *pDestNode, const CString &sDestEntryPoint, CSpaceObject *pStargate, bool bAscend) override;
 		virtual void OnNewSystem (CSystem *pSystem) override;
-		virtual void OnWeaponStatusChanged (void) override { m_AICtx.ClearBestWeapon(); }
+		virtual void OnWeaponStatusChanged (void) override { m_AICtx.ClearBestWeapon(); m_AICtx.ClearWeaponScores(); }
 		virtual void OnObjEnteredGate (CSpaceObject *pObj, CTopologyNode *pDestNode, const CString &sDestEntryPoint, CSpaceObject *pStargate) override;
 		virtual void OnObjDestroyed (const SDestroyCtx &Ctx) override;
 		virtual void OnPlayerChangedShips (CSpaceObject *pOldShip, SPlayerChangedShipsCtx &Options) override;
@@ -358,6 +407,7 @@ class CBaseShipAI : public IShipController
 		virtual void OnStationDestroyed (const SDestroyCtx &Ctx) override;
 		virtual void OnStatsChanged (void) override { m_AICtx.CalcInvariants(m_pShip); }
 		virtual void OnSystemLoaded (void) override { m_AICtx.CalcInvariants(m_pShip); OnSystemLoadedNotify(); }
+		virtual void ParallelBehavior (void) override { m_AICtx.CalcAvoidPotentialParallel(m_pShip); }
 		virtual int SetAISettingInteger (const CString &sSetting, int iValue) override;
 		virtual CString SetAISettingString (const CString &sSetting, const CString &sValue) override;
 		virtual void SetCommandCode (ICCItem *pCode) override;
@@ -434,6 +484,8 @@ class CBaseShipAI : public IShipController
 
 		CAttackDetector m_Blacklist;			//	Player blacklisted
 
+		TArray<CSpaceObject *> m_EnemyShips;	//	Scratch for CalcEnemyShipInRange (not saved)
+
 		//	Flags
 
 		DWORD m_fDeviceActivate:1;